@@ -0,0 +1,79 @@
+# This file is Copyright 2014 The OpenPilot Team.
+#
+# This file is part of the Python-on-a-Chip program.
+# Python-on-a-Chip is free software: you can redistribute it and/or modify
+# it under the terms of the GNU LESSER GENERAL PUBLIC LICENSE Version 2.1.
+#
+# Python-on-a-Chip is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+# A copy of the GNU LESSER GENERAL PUBLIC LICENSE Version 2.1
+# is seen in the file COPYING up one directory from this.
+
+#
+# Interpreter dispatch benchmark.
+# Runs loops shaped like flight plan control logic and prints the time
+# each one takes in ms. "make bench" runs it with the switch dispatch and
+# plain bytecode, then with threaded dispatch and superinstructions.
+#
+
+import sys
+
+
+# Integer PI controller with clamping
+def pid(n):
+    i = 0
+    integ = 0
+    prev = 0
+    out = 0
+    while i < n:
+        err = 1000 - out
+        integ += err
+        if integ > 20000:
+            integ = 20000
+        if integ < -20000:
+            integ = -20000
+        deriv = err - prev
+        prev = err
+        out = out + (err * 4 + integ / 32 + deriv) / 16
+        i += 1
+    return out
+
+
+# Float low pass filter over a ramp
+def lowpass(n):
+    i = 0
+    y = 0.0
+    x = 0.0
+    while i < n:
+        x = x + 0.5
+        y = y + (x - y) * 0.1
+        i = i + 1
+    return y
+
+
+# Waypoint selection: nested loops over small lists
+def waypoints(n):
+    wp = [10, 250, 400, 610, 900]
+    hits = 0
+    i = 0
+    while i < n:
+        j = 0
+        while j < 5:
+            if wp[j] > i - 5 and wp[j] < i + 5:
+                hits += 1
+            j += 1
+        i += 1
+    return hits
+
+
+def run(name, f, n):
+    t = sys.time()
+    r = f(n)
+    t = sys.time() - t
+    print name, t, "ms", r
+
+
+run("pid", pid, 50000)
+run("lowpass", lowpass, 50000)
+run("waypoints", waypoints, 10000)
@@ -18,6 +18,11 @@
 
 extern unsigned char usrlib_img[];
 
+/** Name of the module to run */
+#ifndef PM_MAIN_MODULE
+#define PM_MAIN_MODULE "main"
+#endif
+
 
 int main(void)
 {
@@ -26,6 +31,6 @@ int main(void)
     retval = pm_init(MEMSPACE_PROG, usrlib_img);
     PM_RETURN_IF_ERROR(retval);
 
-    retval = pm_run((uint8_t *)"main");
+    retval = pm_run((uint8_t *)PM_MAIN_MODULE);
     return (int)retval;
 }
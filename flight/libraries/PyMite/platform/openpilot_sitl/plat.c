@@ -24,6 +24,10 @@
 
 #include "pm.h"
 #include "openpilot.h"
+#include "flightplanstatus.h"
+
+/* Minimum time between GC statistics updates of FlightPlanStatus */
+#define GC_STATS_PERIOD_MS 1000
 
 PmReturn_t plat_init(void)
 {
@@ -99,6 +103,37 @@ PmReturn_t plat_getMsTicks(uint32_t *r_ticks)
     return PM_RET_OK;
 }
 
+uint32_t plat_getUsTicks(void)
+{
+    return PIOS_DELAY_GetuS();
+}
+
+/*
+ * Called by the heap after each collection.  Copies the statistics to
+ * FlightPlanStatus, at most once per GC_STATS_PERIOD_MS.
+ */
+void plat_gcDone(struct PmGcStats_s *pstats)
+{
+    static uint32_t lastUpdate;
+    uint32_t now = xTaskGetTickCount() * portTICK_RATE_MS;
+    FlightPlanStatusData status;
+
+    if ((now - lastUpdate) < GC_STATS_PERIOD_MS)
+    {
+        return;
+    }
+    lastUpdate = now;
+
+    FlightPlanStatusGet(&status);
+    status.GCCycles     = pstats->cycles;
+    status.GCFullCycles = pstats->full;
+    status.GCLastPause  = pstats->lastpause;
+    status.GCMaxPause   = pstats->maxpause;
+    status.GCMaxStep    = pstats->maxstep;
+    status.HeapFree     = heap_getAvail();
+    FlightPlanStatusSet(&status);
+}
+
 void plat_reportError(PmReturn_t result)
 {
 #ifdef HAVE_DEBUG_INFO
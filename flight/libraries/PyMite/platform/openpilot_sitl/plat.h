@@ -28,4 +28,12 @@
 #define PM_HEAP_SIZE 0x20000
 #define PM_FLOAT_LITTLE_ENDIAN
 
+/* Time the GC and publish its statistics in FlightPlanStatus */
+#define PM_PLAT_GET_USECS()     plat_getUsTicks()
+#define PM_PLAT_GC_DONE(pstats) plat_gcDone(pstats)
+
+struct PmGcStats_s;
+uint32_t plat_getUsTicks(void);
+void plat_gcDone(struct PmGcStats_s *pstats);
+
 #endif /* _PLAT_H_ */
@@ -13,3 +13,4 @@
 #define HAVE_FLOAT
 #define HAVE_GC
 #define HAVE_IMPORTS
+#define HAVE_SUPERINSTRUCTIONS
@@ -246,7 +246,7 @@ def PmObjectClass(dumpversion, features):
             PmTypeInfo("CIO", "data:B:*"),
             PmTypeInfo("MTH", "instance:P,func:P,attrs:P"),
             PmTypeInfo("LST", "len:H,sgl:P"),
-            PmTypeInfo("DIC", "len:H,keys:P,vals:P"),
+            PmTypeInfo("DIC", "len:H,version:H,keys:P,vals:P,hash:P"),
             PmTypeInfo("x", ""),
             PmTypeInfo("x", ""),
             PmTypeInfo("x", ""),
@@ -262,6 +262,7 @@ def PmObjectClass(dumpversion, features):
             PmTypeInfo("SQI", "sequence:P,index:H"),
             PmTypeInfo("NFM", "back:P,func:P,stack:P,active:B,numlocals:B,"
                               "locals:P:8"),
+            PmTypeInfo("DHI", "size:H,slots:h:size"),
             )
 
         FREE_TYPE = PmTypeInfo("FRE", "prev:P,next:P")
@@ -160,6 +160,24 @@ UNIMPLEMENTED_BCODES = [
     "EXTENDED_ARG",
     ]
 
+# Superinstructions: bcode sequences and the bcode written over the first
+# bcode of the sequence when HAVE_SUPERINSTRUCTIONS is enabled.
+# Longer sequences come first. Must match PmBcode_t in vm/interp.h.
+SUPERINSTRUCTIONS = [
+    (("LOAD_FAST", "LOAD_CONST", "BINARY_ADD"), 0xF3),
+    (("LOAD_FAST", "LOAD_CONST", "INPLACE_ADD"), 0xF3),
+    (("LOAD_FAST", "LOAD_CONST", "BINARY_SUBTRACT"), 0xF4),
+    (("LOAD_FAST", "LOAD_CONST", "INPLACE_SUBTRACT"), 0xF4),
+    (("LOAD_FAST", "LOAD_FAST", "COMPARE_OP"), 0xF5),
+    (("LOAD_FAST", "LOAD_CONST", "COMPARE_OP"), 0xF6),
+    (("LOAD_FAST", "LOAD_FAST"), 0xF0),
+    (("LOAD_FAST", "LOAD_CONST"), 0xF1),
+    (("STORE_FAST", "LOAD_FAST"), 0xF2),
+    ]
+
+# Only the ordering compares (<, <=, ==, !=, >, >=) are fused
+SUPERINSTRUCTION_MAX_COMPARE = 5
+
 
 ################################################################
 # CLASS
@@ -653,6 +671,10 @@ class PmImgCreator:
                 code += s[i:i+3]
                 i += 3
 
+        ## Superinstruction filter
+        if PM_FEATURES["HAVE_SUPERINSTRUCTIONS"]:
+            code = self._fuse_bcodes(code)
+
         # if the first const is a String,
         if (len(consts) > 0 and type(consts[0]) == types.StringType):
 
@@ -718,6 +740,45 @@ class PmImgCreator:
         return consts, names, code, nativecode
 
 
+    def _fuse_bcodes(self, code):
+        """Replace the first bcode of common sequences by a superinstruction.
+
+        Only that one byte changes; the args and bcodes that follow are kept,
+        so jump offsets stay valid and a jump into the middle of a sequence
+        still runs the original bcodes.
+        """
+        # split code into (offset, bcode name, compare arg) tuples
+        instrs = []
+        i = 0
+        while i < len(code):
+            c = ord(code[i])
+            arg = None
+            if c >= dis.HAVE_ARGUMENT:
+                arg = self._str_to_U16(code[i+1:i+3])
+                n = 3
+            else:
+                n = 1
+            instrs.append((i, dis.opname[c], arg))
+            i += n
+
+        code = list(code)
+        i = 0
+        while i < len(instrs):
+            for seq, fused in SUPERINSTRUCTIONS:
+                names = [ins[1] for ins in instrs[i:i+len(seq)]]
+                if tuple(names) != seq:
+                    continue
+                if (seq[-1] == "COMPARE_OP" and instrs[i+len(seq)-1][2]
+                    > SUPERINSTRUCTION_MAX_COMPARE):
+                    continue
+                code[instrs[i][0]] = self._U8_to_str(fused)
+                i += len(seq) - 1
+                break
+            i += 1
+
+        return "".join(code)
+
+
 ################################################################
 # IMAGE WRITING FUNCTIONS
 ################################################################
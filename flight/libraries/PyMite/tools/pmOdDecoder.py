@@ -64,6 +64,7 @@ TYPES = (
     'OBJ_TYPE_SGL',
     'OBJ_TYPE_SQI',
     'OBJ_TYPE_NFM',
+    'OBJ_TYPE_DHI',
 )
 
 
@@ -28,6 +28,266 @@
 #include "pm.h"
 
 
+/**
+ * Marks the dict as changed so cached lookups are revalidated.
+ * If the version counter wraps, all lookup caches are flushed
+ * so an old version can never be mistaken for the current one.
+ */
+static void
+dict_touch(pPmDict_t pdict)
+{
+    pdict->version++;
+    if (pdict->version == 0)
+    {
+        interp_flushNameCache();
+    }
+}
+
+
+/*
+ * Computes the hash of a key.
+ * Keys that obj_compare() considers equal must hash equal.
+ */
+static uint16_t
+dict_hashKey(pPmObj_t pkey)
+{
+    uint16_t hash;
+    uint16_t i;
+    int32_t ival;
+
+    switch (OBJ_GET_TYPE(pkey))
+    {
+        case OBJ_TYPE_NON:
+            return 0;
+
+        case OBJ_TYPE_INT:
+        case OBJ_TYPE_BOOL:
+            ival = ((pPmInt_t)pkey)->val;
+            return (uint16_t)(ival ^ (ival >> 16));
+
+#ifdef HAVE_FLOAT
+        case OBJ_TYPE_FLT:
+        {
+            union
+            {
+                float f;
+                uint32_t u;
+            } fval;
+
+            /* 0.0 and -0.0 compare equal */
+            fval.f = ((pPmFloat_t)pkey)->val;
+            if (fval.f == 0.0)
+            {
+                return 0;
+            }
+            return (uint16_t)(fval.u ^ (fval.u >> 16));
+        }
+#endif /* HAVE_FLOAT */
+
+        case OBJ_TYPE_STR:
+            /* FNV-1a folded to 16 bits */
+            {
+                uint32_t h32 = 2166136261u;
+
+                for (i = 0; i < ((pPmString_t)pkey)->length; i++)
+                {
+                    h32 ^= ((pPmString_t)pkey)->val[i];
+                    h32 *= 16777619u;
+                }
+                return (uint16_t)(h32 ^ (h32 >> 16));
+            }
+
+        case OBJ_TYPE_TUP:
+            /* Tuples compare by items; unhashable items only add their type */
+            hash = ((pPmTuple_t)pkey)->length;
+            for (i = 0; i < ((pPmTuple_t)pkey)->length; i++)
+            {
+                pPmObj_t pitem = ((pPmTuple_t)pkey)->val[i];
+
+                hash = (uint16_t)(hash * 31u);
+                if (OBJ_GET_TYPE(pitem) <= OBJ_TYPE_HASHABLE_MAX)
+                {
+                    hash ^= dict_hashKey(pitem);
+                }
+                else
+                {
+                    hash ^= OBJ_GET_TYPE(pitem);
+                }
+            }
+            return hash;
+
+#ifdef HAVE_BYTEARRAY
+        case OBJ_TYPE_CLI:
+            /* Instances may compare by the contained object, see obj_compare */
+            return OBJ_TYPE_CLI;
+#endif /* HAVE_BYTEARRAY */
+
+        default:
+            /* All other objects only compare equal to themselves */
+            return (uint16_t)(((uintptr_t)pkey >> 2) ^ ((uintptr_t)pkey >> 18));
+    }
+}
+
+
+/*
+ * Finds the seglist index of the key.
+ * Returns PM_RET_OK if found, PM_RET_NO if not.
+ */
+static PmReturn_t
+dict_findKey(pPmDict_t pdict, pPmObj_t pkey, int16_t *r_indx)
+{
+    PmReturn_t retval;
+    pPmDictHash_t phash = pdict->d_hash;
+    pPmObj_t pobj;
+    uint16_t mask;
+    uint16_t slot;
+    int16_t indx;
+
+    if (pdict->length <= 0)
+    {
+        return PM_RET_NO;
+    }
+
+    /* Small dicts live in the first segment; scan it in place */
+    if (pdict->length <= DICT_HASH_MIN_LENGTH)
+    {
+        pSegment_t pseg = pdict->d_keys->sl_rootseg;
+
+        for (indx = 0; indx < pdict->length; indx++)
+        {
+            pobj = pseg->s_val[indx];
+            if ((pobj == pkey) || (obj_compare(pobj, pkey) == C_SAME))
+            {
+                *r_indx = indx;
+                return PM_RET_OK;
+            }
+        }
+        return PM_RET_NO;
+    }
+
+    /* Without an index (too big or out of memory) use a linear search */
+    if (phash == C_NULL)
+    {
+        *r_indx = 0;
+        return seglist_findEqual(pdict->d_keys, pkey, r_indx);
+    }
+
+    /* Probe the hash index */
+    mask = phash->size - 1;
+    slot = dict_hashKey(pkey) & mask;
+    while ((indx = phash->slot[slot]) != DICT_HASH_EMPTY)
+    {
+        retval = seglist_getItem(pdict->d_keys, indx, &pobj);
+        PM_RETURN_IF_ERROR(retval);
+        if ((pobj == pkey) || (obj_compare(pobj, pkey) == C_SAME))
+        {
+            *r_indx = indx;
+            return PM_RET_OK;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return PM_RET_NO;
+}
+
+
+/* Puts the seglist index of the key in the first free slot of its chain */
+static void
+dict_hashInsert(pPmDictHash_t phash, pPmObj_t pkey, int16_t indx)
+{
+    uint16_t mask = phash->size - 1;
+    uint16_t slot = dict_hashKey(pkey) & mask;
+
+    while (phash->slot[slot] != DICT_HASH_EMPTY)
+    {
+        slot = (slot + 1) & mask;
+    }
+    phash->slot[slot] = indx;
+}
+
+
+/*
+ * Makes sure the hash index matches the dict's keys.
+ * pkey is the key that was just appended, or C_NULL to rebuild the index
+ * (e.g. after a removal shifted the keys).
+ * The index is also rebuilt when the dict outgrows the current table.
+ * Running out of memory is not an error, the dict then uses a linear search.
+ */
+static PmReturn_t
+dict_hashUpdate(pPmDict_t pdict, pPmObj_t pkey)
+{
+    PmReturn_t retval;
+    pPmDictHash_t phash = pdict->d_hash;
+    pSegment_t pseg;
+    uint16_t size;
+    int16_t indx;
+    uint8_t *pchunk;
+
+    /* Small and huge dicts do not have an index */
+    if ((pdict->length <= DICT_HASH_MIN_LENGTH)
+        || (pdict->length > DICT_HASH_MAX_LENGTH))
+    {
+        if (phash != C_NULL)
+        {
+            pdict->d_hash = C_NULL;
+            retval = heap_freeChunk((pPmObj_t)phash);
+            PM_RETURN_IF_ERROR(retval);
+        }
+        return PM_RET_OK;
+    }
+
+    /* Keep the load factor at or below one half */
+    if ((phash != C_NULL) && (pkey != C_NULL)
+        && (pdict->length * 2 <= phash->size))
+    {
+        dict_hashInsert(phash, pkey, pdict->length - 1);
+        return PM_RET_OK;
+    }
+
+    for (size = 2 * DICT_HASH_MIN_LENGTH; size < pdict->length * 2; size <<= 1)
+    {
+        ;
+    }
+
+    /* Drop the old index first so its memory can be reused */
+    pdict->d_hash = C_NULL;
+    if (phash != C_NULL)
+    {
+        retval = heap_freeChunk((pPmObj_t)phash);
+        PM_RETURN_IF_ERROR(retval);
+    }
+
+    retval = heap_getChunk(sizeof(PmDictHash_t) + (size - 1) * sizeof(int16_t),
+                           &pchunk);
+    if (retval == PM_RET_EX_MEM)
+    {
+        return PM_RET_OK;
+    }
+    PM_RETURN_IF_ERROR(retval);
+
+    phash = (pPmDictHash_t)pchunk;
+    OBJ_SET_TYPE(phash, OBJ_TYPE_DHI);
+    phash->size = size;
+    for (indx = 0; indx < size; indx++)
+    {
+        phash->slot[indx] = DICT_HASH_EMPTY;
+    }
+
+    /* Index every key, walking the segments once */
+    pseg = pdict->d_keys->sl_rootseg;
+    for (indx = 0; indx < pdict->length; indx++)
+    {
+        if ((indx > 0) && ((indx % SEGLIST_OBJS_PER_SEG) == 0))
+        {
+            pseg = pseg->next;
+        }
+        dict_hashInsert(phash, pseg->s_val[indx % SEGLIST_OBJS_PER_SEG], indx);
+    }
+    pdict->d_hash = phash;
+
+    return heap_gcWriteBarrier((pPmObj_t)phash);
+}
+
+
 PmReturn_t
 dict_new(pPmObj_t *r_pdict)
 {
@@ -43,8 +303,10 @@ dict_new(pPmObj_t *r_pdict)
     pdict = (pPmDict_t)pchunk;
     OBJ_SET_TYPE(pdict, OBJ_TYPE_DIC);
     pdict->length = 0;
+    pdict->version = 0;
     pdict->d_keys = C_NULL;
     pdict->d_vals = C_NULL;
+    pdict->d_hash = C_NULL;
 
     *r_pdict = (pPmObj_t)pchunk;
     return retval;
@@ -67,6 +329,15 @@ dict_clear(pPmObj_t pdict)
 
     /* clear length */
     ((pPmDict_t)pdict)->length = 0;
+    dict_touch((pPmDict_t)pdict);
+
+    /* Free the hash index */
+    if (((pPmDict_t)pdict)->d_hash != C_NULL)
+    {
+        PM_RETURN_IF_ERROR(heap_freeChunk((pPmObj_t)
+                                          ((pPmDict_t)pdict)->d_hash));
+        ((pPmDict_t)pdict)->d_hash = C_NULL;
+    }
 
     /* Free the keys and values seglists if needed */
     if (((pPmDict_t)pdict)->d_keys != C_NULL)
@@ -89,8 +360,8 @@ dict_clear(pPmObj_t pdict)
 /*
  * Sets a value in the dict using the given key.
  *
- * Scans dict for the key.  If key val found, replace old
- * with new val.  If no key found, add key/val pair to dict.
+ * Looks up the key.  If key val found, replace old
+ * with new val.  If no key found, append key/val pair to dict.
  */
 PmReturn_t
 dict_setItem(pPmObj_t pdict, pPmObj_t pkey, pPmObj_t pval)
@@ -135,29 +406,41 @@ dict_setItem(pPmObj_t pdict, pPmObj_t pkey, pPmObj_t pval)
     {
         retval = seglist_new(&((pPmDict_t)pdict)->d_keys);
         PM_RETURN_IF_ERROR(retval);
+        retval = heap_gcWriteBarrier((pPmObj_t)((pPmDict_t)pdict)->d_keys);
+        PM_RETURN_IF_ERROR(retval);
         retval = seglist_new(&((pPmDict_t)pdict)->d_vals);
         PM_RETURN_IF_ERROR(retval);
+        retval = heap_gcWriteBarrier((pPmObj_t)((pPmDict_t)pdict)->d_vals);
+        PM_RETURN_IF_ERROR(retval);
     }
     else
     {
         /* Check for matching key */
-        indx = 0;
-        retval = seglist_findEqual(((pPmDict_t)pdict)->d_keys, pkey, &indx);
+        retval = dict_findKey((pPmDict_t)pdict, pkey, &indx);
 
         /* If found a matching key, replace val obj */
         if (retval == PM_RET_OK)
         {
+            dict_touch((pPmDict_t)pdict);
             retval = seglist_setItem(((pPmDict_t)pdict)->d_vals, pval, indx);
             return retval;
         }
     }
 
-    /* Otherwise, insert the key,val pair */
-    retval = seglist_insertItem(((pPmDict_t)pdict)->d_keys, pkey, 0);
+    /*
+     * Otherwise, append the key,val pair.
+     * Appending keeps the seglist index of the existing keys stable.
+     */
+    dict_touch((pPmDict_t)pdict);
+    retval = seglist_appendItem(((pPmDict_t)pdict)->d_keys, pkey);
+    PM_RETURN_IF_ERROR(retval);
+    retval = seglist_appendItem(((pPmDict_t)pdict)->d_vals, pval);
     PM_RETURN_IF_ERROR(retval);
-    retval = seglist_insertItem(((pPmDict_t)pdict)->d_vals, pval, 0);
     ((pPmDict_t)pdict)->length++;
 
+    /* Index the new key (the pair is reachable from the dict by now) */
+    retval = dict_hashUpdate((pPmDict_t)pdict, pkey);
+
     return retval;
 }
 
@@ -167,6 +450,7 @@ dict_getItem(pPmObj_t pdict, pPmObj_t pkey, pPmObj_t *r_pobj)
 {
     PmReturn_t retval = PM_RET_OK;
     int16_t indx = 0;
+    pSegment_t pseg;
 
 /*    C_ASSERT(pdict != C_NULL);*/
 
@@ -195,7 +479,7 @@ dict_getItem(pPmObj_t pdict, pPmObj_t pkey, pPmObj_t *r_pobj)
     }
 
     /* check for matching key */
-    retval = seglist_findEqual(((pPmDict_t)pdict)->d_keys, pkey, &indx);
+    retval = dict_findKey((pPmDict_t)pdict, pkey, &indx);
     /* if key not found, raise KeyError */
     if (retval == PM_RET_NO)
     {
@@ -204,7 +488,13 @@ dict_getItem(pPmObj_t pdict, pPmObj_t pkey, pPmObj_t *r_pobj)
     /* return any other error */
     PM_RETURN_IF_ERROR(retval);
 
-    /* key was found, get obj from vals */
+    /* key was found, get obj from vals (small dicts: first segment) */
+    if (indx < SEGLIST_OBJS_PER_SEG)
+    {
+        pseg = ((pPmDict_t)pdict)->d_vals->sl_rootseg;
+        *r_pobj = pseg->s_val[indx];
+        return PM_RET_OK;
+    }
     retval = seglist_getItem(((pPmDict_t)pdict)->d_vals, indx, r_pobj);
     return retval;
 }
@@ -219,8 +509,25 @@ dict_delItem(pPmObj_t pdict, pPmObj_t pkey)
 
     C_ASSERT(pdict != C_NULL);
 
+    /* Raise KeyError if dict is empty (no seglists yet) */
+    if (((pPmDict_t)pdict)->length <= 0)
+    {
+        PM_RAISE(retval, PM_RET_EX_KEY);
+        return retval;
+    }
+
+    /* #147: Change boolean keys to integers (as dict_setItem does) */
+    if (pkey == PM_TRUE)
+    {
+        pkey = PM_ONE;
+    }
+    else if (pkey == PM_FALSE)
+    {
+        pkey = PM_ZERO;
+    }
+
     /* Check for matching key */
-    retval = seglist_findEqual(((pPmDict_t)pdict)->d_keys, pkey, &indx);
+    retval = dict_findKey((pPmDict_t)pdict, pkey, &indx);
 
     /* Raise KeyError if key is not found */
     if (retval == PM_RET_NO)
@@ -236,8 +543,14 @@ dict_delItem(pPmObj_t pdict, pPmObj_t pkey)
     PM_RETURN_IF_ERROR(retval);
     retval = seglist_removeItem(((pPmDict_t)pdict)->d_vals, indx);
 
+    PM_RETURN_IF_ERROR(retval);
+
     /* Reduce the item count */
     ((pPmDict_t)pdict)->length--;
+    dict_touch((pPmDict_t)pdict);
+
+    /* The following keys moved down one place, reindex them */
+    retval = dict_hashUpdate((pPmDict_t)pdict, C_NULL);
 
     return retval;
 }
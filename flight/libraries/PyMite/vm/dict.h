@@ -25,12 +25,47 @@
  */
 
 
+/**
+ * Dicts with at most this many items are searched linearly.
+ * They fit in the first segment of the key seglist, so no hash index is kept.
+ */
+#define DICT_HASH_MIN_LENGTH SEGLIST_OBJS_PER_SEG
+
+/**
+ * Dicts with more items than this fall back to a linear search
+ * (the index would not fit in a single heap chunk).
+ */
+#define DICT_HASH_MAX_LENGTH 256
+
+/** Marks an unused slot in the hash index */
+#define DICT_HASH_EMPTY (-1)
+
+
+/**
+ * Dict hash index
+ *
+ * Open addressing table (linear probing) that maps the hash of a key
+ * to the key's position in the dict's key seglist.
+ */
+typedef struct PmDictHash_s
+{
+    /** object descriptor */
+    PmObjDesc_t od;
+    /** number of slots (a power of two) */
+    uint16_t size;
+    /** seglist index of the key in this slot or DICT_HASH_EMPTY */
+    int16_t slot[1];
+} PmDictHash_t,
+ *pPmDictHash_t;
+
+
 /**
  * Dict
  *
  * Contains ptr to two seglists,
  * one for keys, the other for values;
  * and a length, the number of key/value pairs.
+ * Dicts longer than DICT_HASH_MIN_LENGTH also have a hash index over the keys.
  */
 typedef struct PmDict_s
 {
@@ -38,10 +73,14 @@ typedef struct PmDict_s
     PmObjDesc_t od;
     /** number of key,value pairs in the dict */
     int16_t length;
+    /** changes whenever the contents change; validates lookup caches */
+    uint16_t version;
     /** ptr to seglist containing keys */
     pSeglist_t d_keys;
     /** ptr to seglist containing values */
     pSeglist_t d_vals;
+    /** ptr to the hash index over the keys (C_NULL for small dicts) */
+    pPmDictHash_t d_hash;
 } PmDict_t,
  *pPmDict_t;
 
@@ -92,8 +131,8 @@ PmReturn_t dict_new(pPmObj_t *r_pdict);
  * Sets a value in the dict using the given key.
  *
  * If the dict already contains a matching key, the value is
- * replaced; otherwise the new key,val pair is inserted
- * at the front of the dict (for fast lookup).
+ * replaced; otherwise the new key,val pair is appended
+ * to the dict and the hash index is updated.
  * In the later case, the length of the dict is incremented.
  *
  * @param   pdict ptr to dict in which (key,val) will go
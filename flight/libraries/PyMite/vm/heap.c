@@ -41,6 +41,12 @@
 /** The size of the temporary roots stack */
 #define HEAP_NUM_TEMP_ROOTS 24
 
+/**
+ * The size of the stack of objects marked but not yet scanned by the GC.
+ * When it is full, objects are scanned recursively as they are marked.
+ */
+#define HEAP_GC_GRAY_STACK_SIZE 32
+
 /**
  * The maximum size a live chunk can be (a live chunk is one that is in use).
  * The live chunk size is limited by the size field in the *object* descriptor.
@@ -60,6 +66,22 @@
 /** The minimum size a chunk can be (rounded up to a multiple of 4) */
 #define HEAP_MIN_CHUNK_SIZE ((sizeof(PmHeapDesc_t) + 3) & ~3)
 
+/** The largest chunk size that has a free list of its own */
+#define HEAP_SIZE_CLASS_MAX 64
+
+/**
+ * The number of exact-size free lists, one per multiple of four bytes from
+ * HEAP_MIN_CHUNK_SIZE to HEAP_SIZE_CLASS_MAX.  The list after them holds
+ * all larger chunks.
+ */
+#define HEAP_LARGE_CLASS (((HEAP_SIZE_CLASS_MAX - HEAP_MIN_CHUNK_SIZE) >> 2) + 1)
+
+/** Index of the free list for chunks of the given size */
+#define HEAP_SIZE_CLASS(size) \
+    (((size) <= HEAP_SIZE_CLASS_MAX) \
+     ? (uint8_t)(((size) - HEAP_MIN_CHUNK_SIZE) >> 2) \
+     : (uint8_t)HEAP_LARGE_CLASS)
+
 
 /**
  * Gets the GC's mark bit for the object.
@@ -128,8 +150,15 @@ typedef struct PmHeap_s
     /** Global declaration of heap. */
     uint8_t base[PM_HEAP_SIZE];
 
-    /** Ptr to list of free chunks; sorted smallest to largest. */
-    pPmHeapDesc_t pfreelist;
+    /**
+     * Ptrs to lists of free chunks.  The small chunk lists each hold chunks
+     * of one size; the last list holds the larger chunks sorted smallest
+     * to largest.
+     */
+    pPmHeapDesc_t pfreelist[HEAP_LARGE_CLASS + 1];
+
+    /** Bit n is set when the small chunk list n is not empty */
+    uint32_t freemask;
 
     /** The amount of heap space available in free list */
 #if PM_HEAP_SIZE > 65535
@@ -150,29 +179,66 @@ typedef struct PmHeap_s
     pPmObj_t temp_roots[HEAP_NUM_TEMP_ROOTS];
 
     uint8_t temp_root_index;
+
+    /** State of the incremental collection */
+    uint8_t gcstate;
+
+    /** Stack of objects that are marked but not yet scanned */
+    pPmObj_t gray[HEAP_GC_GRAY_STACK_SIZE];
+
+    uint8_t gray_index;
+
+    /** Collection statistics */
+    PmGcStats_t gcstats;
 #endif                          /* HAVE_GC */
 
 } PmHeap_t,
  *pPmHeap_t;
 
 
+/** The states of an incremental collection */
+typedef enum PmGcState_e
+{
+    /** No collection in progress */
+    HEAP_GC_IDLE = 0,
+
+    /** Marking a few objects after each allocation */
+    HEAP_GC_MARK,
+
+    /** Marking done; the sweep waits for the interpreter's loop top */
+    HEAP_GC_FINISH
+} PmGcState_t;
+
+
 /** The PyMite heap */
 static PmHeap_t pmHeap PM_PLAT_HEAP_ATTR;
 
 
+#ifdef HAVE_GC
+static void heap_gcForget(pPmObj_t pobj);
+#if PM_GC_STEP_BUDGET > 0
+static PmReturn_t heap_gcStep(void);
+#endif /* PM_GC_STEP_BUDGET */
+#endif /* HAVE_GC */
+
+
 #if 0
 static void
 heap_gcPrintFreelist(void)
 {
-    pPmHeapDesc_t pchunk = pmHeap.pfreelist;
+    pPmHeapDesc_t pchunk;
+    uint8_t i;
 
     printf("DEBUG: pmHeap.avail = %d\n", pmHeap.avail);
-    printf("DEBUG: freelist:\n");
-    while (pchunk != C_NULL)
+    for (i = 0; i <= HEAP_LARGE_CLASS; i++)
     {
-        printf("DEBUG:     free chunk (%d bytes) @ 0x%0x\n",
-               OBJ_GET_SIZE(pchunk), (int)pchunk);
-        pchunk = pchunk->next;
+        printf("DEBUG: freelist %d:\n", i);
+        for (pchunk = pmHeap.pfreelist[i]; pchunk != C_NULL;
+             pchunk = pchunk->next)
+        {
+            printf("DEBUG:     free chunk (%d bytes) @ 0x%0x\n",
+                   OBJ_GET_SIZE(pchunk), (int)pchunk);
+        }
     }
 }
 #endif
@@ -254,10 +320,12 @@ heap_dump(void)
 #endif
 
 
-/* Removes the given chunk from the free list; leaves list in sorted order */
+/* Removes the given chunk from its free list; leaves list in sorted order */
 static PmReturn_t
 heap_unlinkFromFreelist(pPmHeapDesc_t pchunk)
 {
+    uint8_t sc;
+
     C_ASSERT(pchunk != C_NULL);
 
     pmHeap.avail -= OBJ_GET_SIZE(pchunk);
@@ -270,7 +338,12 @@ heap_unlinkFromFreelist(pPmHeapDesc_t pchunk)
     /* If pchunk was the first chunk in the free list, update the heap ptr */
     if (pchunk->prev == C_NULL)
     {
-        pmHeap.pfreelist = pchunk->next;
+        sc = HEAP_SIZE_CLASS(OBJ_GET_SIZE(pchunk));
+        pmHeap.pfreelist[sc] = pchunk->next;
+        if ((pchunk->next == C_NULL) && (sc < HEAP_LARGE_CLASS))
+        {
+            pmHeap.freemask &= ~((uint32_t)1 << sc);
+        }
     }
     else
     {
@@ -281,22 +354,40 @@ heap_unlinkFromFreelist(pPmHeapDesc_t pchunk)
 }
 
 
-/* Inserts in order a chunk into the free list.  Caller adjusts heap state */
+/* Inserts in order a chunk into its free list.  Caller adjusts heap state */
 static PmReturn_t
 heap_linkToFreelist(pPmHeapDesc_t pchunk)
 {
     uint16_t size;
+    uint8_t sc;
     pPmHeapDesc_t pscan;
 
     /* Ensure the object is already free */
     C_ASSERT(OBJ_GET_FREE(pchunk) != 0);
 
-    pmHeap.avail += OBJ_GET_SIZE(pchunk);
+    size = OBJ_GET_SIZE(pchunk);
+    pmHeap.avail += size;
+
+    /* A small chunk goes to the head of the list for its size */
+    sc = HEAP_SIZE_CLASS(size);
+    if (sc < HEAP_LARGE_CLASS)
+    {
+        pchunk->prev = C_NULL;
+        pchunk->next = pmHeap.pfreelist[sc];
+        if (pchunk->next != C_NULL)
+        {
+            pchunk->next->prev = pchunk;
+        }
+        pmHeap.pfreelist[sc] = pchunk;
+        pmHeap.freemask |= (uint32_t)1 << sc;
+
+        return PM_RET_OK;
+    }
 
     /* If free list is empty, add to head of list */
-    if (pmHeap.pfreelist == C_NULL)
+    if (pmHeap.pfreelist[HEAP_LARGE_CLASS] == C_NULL)
     {
-        pmHeap.pfreelist = pchunk;
+        pmHeap.pfreelist[HEAP_LARGE_CLASS] = pchunk;
         pchunk->next = C_NULL;
         pchunk->prev = C_NULL;
 
@@ -304,8 +395,7 @@ heap_linkToFreelist(pPmHeapDesc_t pchunk)
     }
 
     /* Scan free list for insertion point */
-    pscan = pmHeap.pfreelist;
-    size = OBJ_GET_SIZE(pchunk);
+    pscan = pmHeap.pfreelist[HEAP_LARGE_CLASS];
     while ((OBJ_GET_SIZE(pscan) < size) && (pscan->next != C_NULL))
     {
         pscan = pscan->next;
@@ -332,7 +422,7 @@ heap_linkToFreelist(pPmHeapDesc_t pchunk)
         /* If chunk will be first item in free list */
         if (pscan->prev == C_NULL)
         {
-            pmHeap.pfreelist = pchunk;
+            pmHeap.pfreelist[HEAP_LARGE_CLASS] = pchunk;
         }
         else
         {
@@ -352,6 +442,7 @@ PmReturn_t
 heap_init(void)
 {
     pPmHeapDesc_t pchunk;
+    uint8_t i;
 
 #if PM_HEAP_SIZE > 65535
     uint32_t hs;
@@ -365,14 +456,24 @@ heap_init(void)
 #endif
 
     /* Init heap globals */
-    pmHeap.pfreelist = C_NULL;
+    for (i = 0; i <= HEAP_LARGE_CLASS; i++)
+    {
+        pmHeap.pfreelist[i] = C_NULL;
+    }
+    pmHeap.freemask = 0;
     pmHeap.avail = 0;
 #ifdef HAVE_GC
     pmHeap.gcval = (uint8_t)0;
     pmHeap.temp_root_index = (uint8_t)0;
+    pmHeap.gcstate = HEAP_GC_IDLE;
+    pmHeap.gray_index = (uint8_t)0;
+    sli_memset((unsigned char *)&pmHeap.gcstats, 0, sizeof(PmGcStats_t));
     heap_gcSetAuto(C_TRUE);
 #endif /* HAVE_GC */
 
+    /* Nothing that was cached before can be found in the new heap */
+    interp_flushNameCache();
+
     /* Create as many max-sized chunks as possible in the freelist */
     for (pchunk = (pPmHeapDesc_t)pmHeap.base, hs = PM_HEAP_SIZE;
          hs >= HEAP_MAX_FREE_CHUNK_SIZE; hs -= HEAP_MAX_FREE_CHUNK_SIZE)
@@ -407,7 +508,8 @@ heap_init(void)
  * Obtains a chunk of memory from the free list
  *
  * Performs the Best Fit algorithm.
- * Iterates through the freelist to see if a chunk of suitable size exists.
+ * Takes the first chunk of the smallest non-empty size class that fits,
+ * else iterates through the sorted list of large chunks.
  * Shaves a chunk to perfect size iff the remainder is greater than
  * the minimum chunk size.
  *
@@ -419,16 +521,34 @@ static PmReturn_t
 heap_getChunkImpl(uint16_t size, uint8_t **r_pchunk)
 {
     PmReturn_t retval;
-    pPmHeapDesc_t pchunk;
+    pPmHeapDesc_t pchunk = C_NULL;
     pPmHeapDesc_t premainderChunk;
+    uint32_t mask;
+    uint8_t sc;
 
     C_ASSERT(r_pchunk != C_NULL);
 
-    /* Skip to the first chunk that can hold the requested size */
-    pchunk = pmHeap.pfreelist;
-    while ((pchunk != C_NULL) && (OBJ_GET_SIZE(pchunk) < size))
+    /* Find the smallest non-empty size class that can hold the request */
+    sc = HEAP_SIZE_CLASS(size);
+    mask = pmHeap.freemask >> sc;
+    if ((sc < HEAP_LARGE_CLASS) && (mask != 0))
     {
-        pchunk = pchunk->next;
+        while ((mask & 1) == 0)
+        {
+            mask >>= 1;
+            sc++;
+        }
+        pchunk = pmHeap.pfreelist[sc];
+    }
+
+    /* Else skip to the first large chunk that can hold the requested size */
+    else
+    {
+        pchunk = pmHeap.pfreelist[HEAP_LARGE_CLASS];
+        while ((pchunk != C_NULL) && (OBJ_GET_SIZE(pchunk) < size))
+        {
+            pchunk = pchunk->next;
+        }
     }
 
     /* No chunk of appropriate size was found, raise OutOfMemory exception */
@@ -477,9 +597,13 @@ heap_getChunkImpl(uint16_t size, uint8_t **r_pchunk)
 
     /*
      * Set the chunk's GC mark so it will be collected during the next GC cycle
-     * if it is not reachable
+     * if it is not reachable.  During an incremental mark new chunks start
+     * unmarked, so they are kept only if the mark reaches them.
      */
-    OBJ_SET_GCVAL(pchunk, pmHeap.gcval);
+#ifdef HAVE_GC
+    OBJ_SET_GCVAL(pchunk, (pmHeap.gcstate == HEAP_GC_IDLE)
+                          ? pmHeap.gcval : (pmHeap.gcval ^ 1));
+#endif /* HAVE_GC */
 
     /* Return the chunk */
     *r_pchunk = (uint8_t *)pchunk;
@@ -532,6 +656,14 @@ heap_getChunk(uint16_t requestedsize, uint8_t **r_pchunk)
         /* Attempt to get a chunk */
         retval = heap_getChunkImpl(adjustedsize, r_pchunk);
     }
+
+#if PM_GC_STEP_BUDGET > 0
+    /* Do a slice of incremental collection work */
+    else if ((retval == PM_RET_OK) && (pmHeap.auto_gc == C_TRUE))
+    {
+        retval = heap_gcStep();
+    }
+#endif /* PM_GC_STEP_BUDGET */
 #endif /* HAVE_GC */
 
     /* Ensure that the pointer is 4-byte aligned */
@@ -557,6 +689,14 @@ heap_freeChunk(pPmObj_t ptr)
     C_ASSERT(((uint8_t *)ptr >= pmHeap.base)
              && ((uint8_t *)ptr < pmHeap.base + PM_HEAP_SIZE));
 
+#ifdef HAVE_GC
+    /* The incremental mark must not scan the chunk after it is reused */
+    if (pmHeap.gcstate != HEAP_GC_IDLE)
+    {
+        heap_gcForget(ptr);
+    }
+#endif /* HAVE_GC */
+
     /* Insert the chunk into the freelist */
     OBJ_SET_FREE(ptr, 1);
 
@@ -582,8 +722,12 @@ heap_getAvail(void)
 
 
 #ifdef HAVE_GC
+static PmReturn_t heap_gcScanObj(pPmObj_t pobj);
+
+
 /*
- * Marks the given object and the objects it references.
+ * Marks the given object.  An object that references others is pushed on
+ * the gray stack to be scanned later, or is scanned now if the stack is full.
  *
  * @param   pobj Any non-free heap object
  * @return  Return code
@@ -591,19 +735,14 @@ heap_getAvail(void)
 static PmReturn_t
 heap_gcMarkObj(pPmObj_t pobj)
 {
-    PmReturn_t retval = PM_RET_OK;
-    int16_t i = 0;
-    int16_t n;
-    PmType_t type;
-
     /* Return if ptr is null or object is already marked */
     if (pobj == C_NULL)
     {
-        return retval;
+        return PM_RET_OK;
     }
     if (OBJ_GET_GCVAL(pobj) == pmHeap.gcval)
     {
-        return retval;
+        return PM_RET_OK;
     }
 
     /* The pointer must be within the heap (native frame is special case) */
@@ -614,6 +753,53 @@ heap_gcMarkObj(pPmObj_t pobj)
     /* The object must not already be free */
     C_ASSERT(OBJ_GET_FREE(pobj) == 0);
 
+    OBJ_SET_GCVAL(pobj, pmHeap.gcval);
+
+    switch (OBJ_GET_TYPE(pobj))
+    {
+            /* Objects with no references to other objects are done */
+        case OBJ_TYPE_NON:
+        case OBJ_TYPE_INT:
+        case OBJ_TYPE_FLT:
+        case OBJ_TYPE_STR:
+        case OBJ_TYPE_NOB:
+        case OBJ_TYPE_BOOL:
+        case OBJ_TYPE_CIO:
+        case OBJ_TYPE_DHI:
+        case OBJ_TYPE_SEG:
+#ifdef HAVE_BYTEARRAY
+        case OBJ_TYPE_BYS:
+#endif /* HAVE_BYTEARRAY */
+            return PM_RET_OK;
+
+        default:
+            break;
+    }
+
+    if (pmHeap.gray_index < HEAP_GC_GRAY_STACK_SIZE)
+    {
+        pmHeap.gray[pmHeap.gray_index++] = pobj;
+        return PM_RET_OK;
+    }
+    return heap_gcScanObj(pobj);
+}
+
+
+/*
+ * Marks the objects referenced by the given marked object.
+ * Segments are marked along with their seglist.
+ *
+ * @param   pobj Any marked heap object
+ * @return  Return code
+ */
+static PmReturn_t
+heap_gcScanObj(pPmObj_t pobj)
+{
+    PmReturn_t retval = PM_RET_OK;
+    int16_t i = 0;
+    int16_t n;
+    PmType_t type;
+
     type = (PmType_t)OBJ_GET_TYPE(pobj);
     switch (type)
     {
@@ -625,15 +811,16 @@ heap_gcMarkObj(pPmObj_t pobj)
         case OBJ_TYPE_NOB:
         case OBJ_TYPE_BOOL:
         case OBJ_TYPE_CIO:
-            OBJ_SET_GCVAL(pobj, pmHeap.gcval);
+        case OBJ_TYPE_DHI:
+        case OBJ_TYPE_SEG:
+#ifdef HAVE_BYTEARRAY
+        case OBJ_TYPE_BYS:
+#endif /* HAVE_BYTEARRAY */
             break;
 
         case OBJ_TYPE_TUP:
             i = ((pPmTuple_t)pobj)->length;
 
-            /* Mark tuple head */
-            OBJ_SET_GCVAL(pobj, pmHeap.gcval);
-
             /* Mark each obj in tuple */
             while (--i >= 0)
             {
@@ -644,29 +831,24 @@ heap_gcMarkObj(pPmObj_t pobj)
 
         case OBJ_TYPE_LST:
 
-            /* Mark the list */
-            OBJ_SET_GCVAL(pobj, pmHeap.gcval);
-
             /* Mark the seglist */
             retval = heap_gcMarkObj((pPmObj_t)((pPmList_t)pobj)->val);
             break;
 
         case OBJ_TYPE_DIC:
-            /* Mark the dict head */
-            OBJ_SET_GCVAL(pobj, pmHeap.gcval);
-
             /* Mark the keys seglist */
             retval = heap_gcMarkObj((pPmObj_t)((pPmDict_t)pobj)->d_keys);
             PM_RETURN_IF_ERROR(retval);
 
             /* Mark the vals seglist */
             retval = heap_gcMarkObj((pPmObj_t)((pPmDict_t)pobj)->d_vals);
+            PM_RETURN_IF_ERROR(retval);
+
+            /* Mark the hash index */
+            retval = heap_gcMarkObj((pPmObj_t)((pPmDict_t)pobj)->d_hash);
             break;
 
         case OBJ_TYPE_COB:
-            /* Mark the code obj head */
-            OBJ_SET_GCVAL(pobj, pmHeap.gcval);
-
             /* Mark the names tuple */
             retval = heap_gcMarkObj((pPmObj_t)((pPmCo_t)pobj)->co_names);
             PM_RETURN_IF_ERROR(retval);
@@ -693,8 +875,6 @@ heap_gcMarkObj(pPmObj_t pobj)
         case OBJ_TYPE_MOD:
         case OBJ_TYPE_FXN:
             /* Module and Func objs are implemented via the PmFunc_t */
-            /* Mark the func obj head */
-            OBJ_SET_GCVAL(pobj, pmHeap.gcval);
 
             /* Mark the code obj */
             retval = heap_gcMarkObj((pPmObj_t)((pPmFunc_t)pobj)->f_co);
@@ -722,9 +902,6 @@ heap_gcMarkObj(pPmObj_t pobj)
 
 #ifdef HAVE_CLASSES
         case OBJ_TYPE_CLI:
-            /* Mark the obj head */
-            OBJ_SET_GCVAL(pobj, pmHeap.gcval);
-
             /* Mark the class */
             retval = heap_gcMarkObj((pPmObj_t)((pPmInstance_t)pobj)->cli_class);
             PM_RETURN_IF_ERROR(retval);
@@ -734,9 +911,6 @@ heap_gcMarkObj(pPmObj_t pobj)
             break;
 
         case OBJ_TYPE_MTH:
-            /* Mark the obj head */
-            OBJ_SET_GCVAL(pobj, pmHeap.gcval);
-
             /* Mark the instance */
             retval = heap_gcMarkObj((pPmObj_t)((pPmMethod_t)pobj)->m_instance);
             PM_RETURN_IF_ERROR(retval);
@@ -750,9 +924,6 @@ heap_gcMarkObj(pPmObj_t pobj)
             break;
 
         case OBJ_TYPE_CLO:
-            /* Mark the obj head */
-            OBJ_SET_GCVAL(pobj, pmHeap.gcval);
-
             /* Mark the attrs dict */
             retval = heap_gcMarkObj((pPmObj_t)((pPmClass_t)pobj)->cl_attrs);
             PM_RETURN_IF_ERROR(retval);
@@ -775,9 +946,6 @@ heap_gcMarkObj(pPmObj_t pobj)
         {
             pPmObj_t *ppobj2 = C_NULL;
 
-            /* Mark the frame obj head */
-            OBJ_SET_GCVAL(pobj, pmHeap.gcval);
-
             /* Mark the previous frame, if this isn't a generator's frame */
             /* Issue #129: Fix iterator losing its object */
             if ((((pPmFrame_t)pobj)->fo_func->f_co->co_flags & CO_GENERATOR) == 0)
@@ -815,17 +983,11 @@ heap_gcMarkObj(pPmObj_t pobj)
         }
 
         case OBJ_TYPE_BLK:
-            /* Mark the block obj head */
-            OBJ_SET_GCVAL(pobj, pmHeap.gcval);
-
             /* Mark the next block in the stack */
             retval = heap_gcMarkObj((pPmObj_t)((pPmBlock_t)pobj)->next);
             break;
 
         case OBJ_TYPE_SGL:
-            /* Mark the seglist obj head */
-            OBJ_SET_GCVAL(pobj, pmHeap.gcval);
-
             /* Mark the seglist's segments */
             n = ((pSeglist_t)pobj)->sl_length;
             pobj = (pPmObj_t)((pSeglist_t)pobj)->sl_rootseg;
@@ -855,29 +1017,16 @@ heap_gcMarkObj(pPmObj_t pobj)
             break;
 
         case OBJ_TYPE_SQI:
-            /* Mark the sequence iterator obj head */
-            OBJ_SET_GCVAL(pobj, pmHeap.gcval);
-
             /* Mark the sequence */
             retval = heap_gcMarkObj(((pPmSeqIter_t)pobj)->si_sequence);
             break;
 
         case OBJ_TYPE_THR:
-            /* Mark the thread obj head */
-            OBJ_SET_GCVAL(pobj, pmHeap.gcval);
-
             /* Mark the current frame */
             retval = heap_gcMarkObj((pPmObj_t)((pPmThread_t)pobj)->pframe);
             break;
 
         case OBJ_TYPE_NFM:
-            /*
-             * Mark the obj desc.  This doesn't really do much since the
-             * native frame is declared static (not from the heap), but this
-             * is here in case that ever changes
-             */
-            OBJ_SET_GCVAL(pobj, pmHeap.gcval);
-
             /* Mark the native frame's remaining fields if active */
             if (gVmGlobal.nativeframe.nf_active)
             {
@@ -907,14 +1056,9 @@ heap_gcMarkObj(pPmObj_t pobj)
 
 #ifdef HAVE_BYTEARRAY
         case OBJ_TYPE_BYA:
-            OBJ_SET_GCVAL(pobj, pmHeap.gcval);
-
+            /* Mark the bytes container */
             retval = heap_gcMarkObj((pPmObj_t)((pPmBytearray_t)pobj)->val);
             break;
-
-        case OBJ_TYPE_BYS:
-            OBJ_SET_GCVAL(pobj, pmHeap.gcval);
-            break;
 #endif /* HAVE_BYTEARRAY */
 
         default:
@@ -926,18 +1070,56 @@ heap_gcMarkObj(pPmObj_t pobj)
 }
 
 
+
+
+/* Scans gray objects until none are left or the budget (if >= 0) runs out */
+static PmReturn_t
+heap_gcDrain(int16_t budget)
+{
+    PmReturn_t retval = PM_RET_OK;
+
+    while ((pmHeap.gray_index > 0) && (budget != 0))
+    {
+        retval = heap_gcScanObj(pmHeap.gray[--pmHeap.gray_index]);
+        PM_RETURN_IF_ERROR(retval);
+
+        if (budget > 0)
+        {
+            budget--;
+        }
+    }
+    return retval;
+}
+
+
+/* Removes a chunk that is being freed from the gray stack */
+static void
+heap_gcForget(pPmObj_t pobj)
+{
+    uint8_t i;
+
+    for (i = 0; i < pmHeap.gray_index; i++)
+    {
+        if (pmHeap.gray[i] == pobj)
+        {
+            pmHeap.gray[i] = pmHeap.gray[--pmHeap.gray_index];
+            return;
+        }
+    }
+}
+
+
 /*
  * Marks the root objects so they won't be collected during the sweep phase.
- * Recursively marks all objects reachable from the roots.
+ * The temporary roots are left to heap_gcMarkTempRoots().
  */
 static PmReturn_t
 heap_gcMarkRoots(void)
 {
     PmReturn_t retval;
-    uint8_t i;
-
-    /* Toggle the GC marking value so it differs from the last run */
-    pmHeap.gcval ^= 1;
+    pPmObj_t pthread;
+    pPmFrame_t pframe;
+    int16_t i;
 
     /* Mark the constant objects */
     retval = heap_gcMarkObj(PM_NONE);
@@ -967,13 +1149,92 @@ heap_gcMarkRoots(void)
     retval = heap_gcMarkObj((pPmObj_t)gVmGlobal.threadList);
     PM_RETURN_IF_ERROR(retval);
 
-    /* Mark the temporary roots */
+    /*
+     * Mark each thread's frame stack.  A running generator's frame does not
+     * mark the frame that called it, so its callers are only found this way.
+     */
+    for (i = 0; i < gVmGlobal.threadList->length; i++)
+    {
+        retval = list_getItem((pPmObj_t)gVmGlobal.threadList, i, &pthread);
+        PM_RETURN_IF_ERROR(retval);
+
+        for (pframe = ((pPmThread_t)pthread)->pframe; pframe != C_NULL;
+             pframe = pframe->fo_back)
+        {
+            if (pframe == (pPmFrame_t)&gVmGlobal.nativeframe)
+            {
+                pframe = gVmGlobal.nativeframe.nf_back;
+                if (pframe == C_NULL)
+                {
+                    break;
+                }
+            }
+            retval = heap_gcMarkObj((pPmObj_t)pframe);
+            PM_RETURN_IF_ERROR(retval);
+        }
+    }
+    return retval;
+}
+
+
+/*
+ * Marks the temporary roots.  These hold objects that are still being built,
+ * so an incremental mark leaves them alone until it finishes; otherwise an
+ * object could be scanned before its fields are filled in.
+ */
+static PmReturn_t
+heap_gcMarkTempRoots(void)
+{
+    PmReturn_t retval = PM_RET_OK;
+    uint8_t i;
+
     for (i = 0; i < pmHeap.temp_root_index; i++)
     {
         retval = heap_gcMarkObj(pmHeap.temp_roots[i]);
         PM_RETURN_IF_ERROR(retval);
     }
+    return retval;
+}
+
+
+/*
+ * Scans every thread's frames again.  The interpreter changes frames (and
+ * the native frame) without a write barrier, so the incremental mark may
+ * have missed objects they got since they were first scanned.
+ */
+static PmReturn_t
+heap_gcRescanThreads(void)
+{
+    PmReturn_t retval;
+    pPmObj_t pthread;
+    pPmFrame_t pframe;
+    int16_t i;
+
+    retval = heap_gcScanObj((pPmObj_t)&gVmGlobal.nativeframe);
+    PM_RETURN_IF_ERROR(retval);
+
+    for (i = 0; i < gVmGlobal.threadList->length; i++)
+    {
+        retval = list_getItem((pPmObj_t)gVmGlobal.threadList, i, &pthread);
+        PM_RETURN_IF_ERROR(retval);
 
+        for (pframe = ((pPmThread_t)pthread)->pframe; pframe != C_NULL;
+             pframe = pframe->fo_back)
+        {
+            if (pframe == (pPmFrame_t)&gVmGlobal.nativeframe)
+            {
+                pframe = gVmGlobal.nativeframe.nf_back;
+                if (pframe == C_NULL)
+                {
+                    break;
+                }
+            }
+            retval = heap_gcMarkObj((pPmObj_t)pframe);
+            PM_RETURN_IF_ERROR(retval);
+            retval = heap_gcScanObj((pPmObj_t)pframe);
+            PM_RETURN_IF_ERROR(retval);
+        }
+    }
     return retval;
 }
 
@@ -1129,11 +1390,82 @@ heap_gcSweep(void)
 }
 
 
+/* Starts a collection: marks the roots with a new mark value */
+static PmReturn_t
+heap_gcStart(void)
+{
+    /* Toggle the GC marking value so it differs from the last run */
+    pmHeap.gcval ^= 1;
+    pmHeap.gcstate = HEAP_GC_MARK;
+
+    return heap_gcMarkRoots();
+}
+
+
+/*
+ * Abandons an incremental mark in progress.  Marks every live object with
+ * the current value so that the next toggle leaves them all unmarked.
+ */
+static void
+heap_gcResetMarks(void)
+{
+    pPmObj_t pobj;
+
+    for (pobj = (pPmObj_t)pmHeap.base;
+         (uint8_t *)pobj < &pmHeap.base[PM_HEAP_SIZE];
+         pobj = (pPmObj_t)((uint8_t *)pobj + OBJ_GET_SIZE(pobj)))
+    {
+        if (!OBJ_GET_FREE(pobj))
+        {
+            OBJ_SET_GCVAL(pobj, pmHeap.gcval);
+        }
+    }
+    OBJ_SET_GCVAL(&gVmGlobal.nativeframe, pmHeap.gcval);
+
+    pmHeap.gray_index = 0;
+    pmHeap.gcstate = HEAP_GC_IDLE;
+}
+
+
+/* Sweeps the marked heap and ends the collection */
+static PmReturn_t
+heap_gcEnd(void)
+{
+    PmReturn_t retval;
+
+    retval = heap_gcSweep();
+
+    /* Cached lookups may refer to dicts or code that were just freed */
+    interp_flushNameCache();
+
+    pmHeap.gcstate = HEAP_GC_IDLE;
+    return retval;
+}
+
+
+/* Records the pause of a completed collection that began at time start */
+static void
+heap_gcDone(uint32_t start)
+{
+    uint32_t pause = (uint32_t)PM_PLAT_GET_USECS() - start;
+
+    pmHeap.gcstats.cycles++;
+    pmHeap.gcstats.lastpause = pause;
+    if (pause > pmHeap.gcstats.maxpause)
+    {
+        pmHeap.gcstats.maxpause = pause;
+    }
+
+    PM_PLAT_GC_DONE(&pmHeap.gcstats);
+}
+
+
 /* Runs the mark-sweep garbage collector */
 PmReturn_t
 heap_gcRun(void)
 {
     PmReturn_t retval;
+    uint32_t start;
 
     /* #239: Fix GC when 2+ unlinked allocs occur */
     /* This assertion fails when there are too many objects on the temporary
@@ -1144,13 +1476,141 @@ heap_gcRun(void)
     C_DEBUG_PRINT(VERBOSITY_LOW, "heap_gcRun()\n");
     /*heap_dump();*/
 
-    retval = heap_gcMarkRoots();
+    start = (uint32_t)PM_PLAT_GET_USECS();
+
+    /*
+     * This may run in the middle of building objects, where the write
+     * barriers do not hold, so redo any incremental mark from scratch
+     */
+    if (pmHeap.gcstate != HEAP_GC_IDLE)
+    {
+        heap_gcResetMarks();
+    }
+
+    retval = heap_gcStart();
+    PM_RETURN_IF_ERROR(retval);
+    retval = heap_gcMarkTempRoots();
+    PM_RETURN_IF_ERROR(retval);
+    retval = heap_gcDrain(-1);
     PM_RETURN_IF_ERROR(retval);
 
-    retval = heap_gcSweep();
+    retval = heap_gcEnd();
     /*heap_dump();*/
+
+    pmHeap.gcstats.full++;
+    heap_gcDone(start);
+    return retval;
+}
+
+
+#if PM_GC_STEP_BUDGET > 0
+/*
+ * Does one slice of an incremental collection; called after allocations.
+ * Starts a collection when the heap runs low, else scans up to
+ * PM_GC_STEP_BUDGET gray objects.  Once nothing is left to scan, asks the
+ * interpreter to come back to its loop top, where heap_gcPoll() sweeps.
+ */
+static PmReturn_t
+heap_gcStep(void)
+{
+    PmReturn_t retval;
+    uint32_t start;
+
+    if (pmHeap.gcstate == HEAP_GC_MARK)
+    {
+        start = (uint32_t)PM_PLAT_GET_USECS();
+        retval = heap_gcDrain(PM_GC_STEP_BUDGET);
+    }
+    else if ((pmHeap.gcstate == HEAP_GC_IDLE)
+             && (pmHeap.avail < PM_GC_START_THRESHOLD))
+    {
+        start = (uint32_t)PM_PLAT_GET_USECS();
+        retval = heap_gcStart();
+    }
+    else
+    {
+        return PM_RET_OK;
+    }
+    PM_RETURN_IF_ERROR(retval);
+
+    if (pmHeap.gray_index == 0)
+    {
+        pmHeap.gcstate = HEAP_GC_FINISH;
+        interp_setRescheduleFlag((uint8_t)1);
+    }
+
+    start = (uint32_t)PM_PLAT_GET_USECS() - start;
+    if (start > pmHeap.gcstats.maxstep)
+    {
+        pmHeap.gcstats.maxstep = start;
+    }
     return retval;
 }
+#endif /* PM_GC_STEP_BUDGET */
+
+
+/* Finishes an incremental collection whose mark phase is done */
+PmReturn_t
+heap_gcPoll(void)
+{
+    PmReturn_t retval;
+    uint32_t start;
+
+    if (pmHeap.gcstate != HEAP_GC_FINISH)
+    {
+        return PM_RET_OK;
+    }
+
+    start = (uint32_t)PM_PLAT_GET_USECS();
+
+    /* Catch up with the changes made without a write barrier */
+    retval = heap_gcMarkRoots();
+    PM_RETURN_IF_ERROR(retval);
+    retval = heap_gcMarkTempRoots();
+    PM_RETURN_IF_ERROR(retval);
+    retval = heap_gcRescanThreads();
+    PM_RETURN_IF_ERROR(retval);
+    retval = heap_gcDrain(-1);
+    PM_RETURN_IF_ERROR(retval);
+
+    retval = heap_gcEnd();
+    heap_gcDone(start);
+    return retval;
+}
+
+
+/* Marks an object stored into another while a mark is in progress */
+PmReturn_t
+heap_gcWriteBarrier(pPmObj_t pobj)
+{
+    if (pmHeap.gcstate == HEAP_GC_IDLE)
+    {
+        return PM_RET_OK;
+    }
+    return heap_gcMarkObj(pobj);
+}
+
+
+/* Scans a marked object again while a mark is in progress */
+PmReturn_t
+heap_gcRescan(pPmObj_t pobj)
+{
+    /* An unmarked object is scanned anyway once the mark reaches it */
+    if ((pmHeap.gcstate == HEAP_GC_IDLE)
+        || (OBJ_GET_GCVAL(pobj) != pmHeap.gcval))
+    {
+        return PM_RET_OK;
+    }
+    return heap_gcScanObj(pobj);
+}
+
+
+/* Returns the collection statistics */
+pPmGcStats_t
+heap_gcGetStats(void)
+{
+    return &pmHeap.gcstats;
+}
 
 
 /* Enables or disables automatic garbage collection */
@@ -1182,5 +1642,7 @@ void heap_gcPopTempRoot(uint8_t objid)
 
 void heap_gcPushTempRoot(pPmObj_t pobj, uint8_t *r_objid) {}
 void heap_gcPopTempRoot(uint8_t objid) {}
+PmReturn_t heap_gcWriteBarrier(pPmObj_t pobj) { return PM_RET_OK; }
+PmReturn_t heap_gcRescan(pPmObj_t pobj) { return PM_RET_OK; }
 
 #endif /* HAVE_GC */
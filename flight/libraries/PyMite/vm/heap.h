@@ -31,6 +31,20 @@
  */
 #define HEAP_GC_NF_THRESHOLD (512)
 
+/**
+ * The number of objects the incremental GC scans after each allocation.
+ * Zero disables the incremental GC; the heap is then only collected
+ * all at once when it runs out of memory.
+ */
+#ifndef PM_GC_STEP_BUDGET
+#define PM_GC_STEP_BUDGET (16)
+#endif
+
+/** The threshold of heap.avail under which an incremental GC starts */
+#ifndef PM_GC_START_THRESHOLD
+#define PM_GC_START_THRESHOLD (PM_HEAP_SIZE / 4)
+#endif
+
 
 #ifdef __DEBUG__
 #define DEBUG_PRINT_HEAP_AVAIL(s) \
@@ -41,6 +55,30 @@
 #endif
 
 
+/**
+ * Garbage collector statistics.
+ * Times are in microseconds, as given by PM_PLAT_GET_USECS().
+ */
+typedef struct PmGcStats_s
+{
+    /** Number of collections completed */
+    uint32_t cycles;
+
+    /** Number of those that were run all at once by heap_gcRun() */
+    uint32_t full;
+
+    /** The pause of the last collection (its sweep if incremental) */
+    uint32_t lastpause;
+
+    /** The longest pause of any collection */
+    uint32_t maxpause;
+
+    /** The longest incremental mark step */
+    uint32_t maxstep;
+} PmGcStats_t,
+ *pPmGcStats_t;
+
+
 /**
  * Initializes the heap for use.
  *
@@ -91,8 +129,39 @@ PmReturn_t heap_gcRun(void);
  */
 PmReturn_t heap_gcSetAuto(uint8_t auto_gc);
 
+/**
+ * Sweeps the heap if an incremental collection has finished marking.
+ * Must only be called where every live object is reachable from the roots,
+ * such as the top of the interpreter loop.
+ *
+ * @return  Return code
+ */
+PmReturn_t heap_gcPoll(void);
+
+/** @return  Pointer to the garbage collector statistics */
+pPmGcStats_t heap_gcGetStats(void);
+
 #endif /* HAVE_GC */
 
+/**
+ * Tells an incremental collection in progress that a reference to pobj was
+ * stored into an object that may already be scanned.  Must be called when
+ * changing a reference in an existing object, except in frames and threads.
+ *
+ * @param   pobj The object that is now referenced
+ * @return  Return code
+ */
+PmReturn_t heap_gcWriteBarrier(pPmObj_t pobj);
+
+/**
+ * Scans again the references of an object that was changed without a write
+ * barrier, such as a generator's frame when it yields.
+ *
+ * @param   pobj The changed object
+ * @return  Return code
+ */
+PmReturn_t heap_gcRescan(pPmObj_t pobj);
+
 /**
  * Pushes an object onto the temporary roots stack if there is room
  * to protect the objects from a potential garbage collection
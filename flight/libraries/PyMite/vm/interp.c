@@ -28,6 +28,38 @@
 #include "pm.h"
 
 
+/** Name lookup cache for LOAD_GLOBAL and LOAD_ATTR, indexed by address */
+static PmNameCache_t interp_nameCache[PM_NAMECACHE_SIZE];
+
+/** Gets the cache entry for the instruction ending at ip */
+#define NAMECACHE_ENTRY(ip) \
+    (&interp_nameCache[(((uintptr_t)(ip)) ^ ((uintptr_t)(ip) >> 5)) \
+                       & (PM_NAMECACHE_SIZE - 1)])
+
+#ifdef PM_COMPUTED_GOTO
+/** Bytecode handler label; the switch case stays for the portable build */
+#define PM_TARGET(bc) case bc: op_##bc
+#define PM_TARGET_DEFAULT default: op_default
+
+/**
+ * Ends a bytecode handler: unless a thread switch is pending, fetches the
+ * next bytecode and jumps directly to its handler.
+ * Must be used as a statement on its own (it expands to several).
+ */
+#define PM_DISPATCH() \
+    if (gVmGlobal.reschedule) \
+    { \
+        continue; \
+    } \
+    bc = mem_getByte(PM_FP->fo_memspace, &PM_IP); \
+    goto *interp_dispatchTable[bc]
+#else
+#define PM_TARGET(bc) case bc
+#define PM_TARGET_DEFAULT default
+#define PM_DISPATCH() continue
+#endif /* PM_COMPUTED_GOTO */
+
+
 PmReturn_t
 interpret(const uint8_t returnOnNoThreads)
 {
@@ -39,6 +71,146 @@ interpret(const uint8_t returnOnNoThreads)
     int8_t t8 = 0;
     uint8_t bc;
     uint8_t objid, objid2;
+    pPmNameCache_t pcache;
+
+#ifdef PM_COMPUTED_GOTO
+    /* Handler address for each bytecode; unimplemented ones raise */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Woverride-init"
+    static void *const interp_dispatchTable[256] = {
+        [0 ... 255] = &&op_default,
+        [POP_TOP] = &&op_POP_TOP,
+        [ROT_TWO] = &&op_ROT_TWO,
+        [ROT_THREE] = &&op_ROT_THREE,
+        [DUP_TOP] = &&op_DUP_TOP,
+        [ROT_FOUR] = &&op_ROT_FOUR,
+        [NOP] = &&op_NOP,
+        [UNARY_POSITIVE] = &&op_UNARY_POSITIVE,
+        [UNARY_NEGATIVE] = &&op_UNARY_NEGATIVE,
+        [UNARY_NOT] = &&op_UNARY_NOT,
+#ifdef HAVE_BACKTICK
+        [UNARY_CONVERT] = &&op_UNARY_CONVERT,
+#endif /* HAVE_BACKTICK */
+        [UNARY_INVERT] = &&op_UNARY_INVERT,
+        [LIST_APPEND] = &&op_LIST_APPEND,
+        [BINARY_POWER] = &&op_BINARY_POWER,
+        [INPLACE_POWER] = &&op_INPLACE_POWER,
+        [GET_ITER] = &&op_GET_ITER,
+        [BINARY_MULTIPLY] = &&op_BINARY_MULTIPLY,
+        [INPLACE_MULTIPLY] = &&op_INPLACE_MULTIPLY,
+        [BINARY_DIVIDE] = &&op_BINARY_DIVIDE,
+        [INPLACE_DIVIDE] = &&op_INPLACE_DIVIDE,
+        [BINARY_FLOOR_DIVIDE] = &&op_BINARY_FLOOR_DIVIDE,
+        [INPLACE_FLOOR_DIVIDE] = &&op_INPLACE_FLOOR_DIVIDE,
+        [BINARY_MODULO] = &&op_BINARY_MODULO,
+        [INPLACE_MODULO] = &&op_INPLACE_MODULO,
+        [STORE_MAP] = &&op_STORE_MAP,
+        [BINARY_ADD] = &&op_BINARY_ADD,
+        [INPLACE_ADD] = &&op_INPLACE_ADD,
+        [BINARY_SUBTRACT] = &&op_BINARY_SUBTRACT,
+        [INPLACE_SUBTRACT] = &&op_INPLACE_SUBTRACT,
+        [BINARY_SUBSCR] = &&op_BINARY_SUBSCR,
+#ifdef HAVE_FLOAT
+        [BINARY_TRUE_DIVIDE] = &&op_BINARY_TRUE_DIVIDE,
+        [INPLACE_TRUE_DIVIDE] = &&op_INPLACE_TRUE_DIVIDE,
+#endif /* HAVE_FLOAT */
+        [SLICE_0] = &&op_SLICE_0,
+        [STORE_SUBSCR] = &&op_STORE_SUBSCR,
+#ifdef HAVE_DEL
+        [DELETE_SUBSCR] = &&op_DELETE_SUBSCR,
+#endif /* HAVE_DEL */
+        [BINARY_LSHIFT] = &&op_BINARY_LSHIFT,
+        [INPLACE_LSHIFT] = &&op_INPLACE_LSHIFT,
+        [BINARY_RSHIFT] = &&op_BINARY_RSHIFT,
+        [INPLACE_RSHIFT] = &&op_INPLACE_RSHIFT,
+        [BINARY_AND] = &&op_BINARY_AND,
+        [INPLACE_AND] = &&op_INPLACE_AND,
+        [BINARY_XOR] = &&op_BINARY_XOR,
+        [INPLACE_XOR] = &&op_INPLACE_XOR,
+        [BINARY_OR] = &&op_BINARY_OR,
+        [INPLACE_OR] = &&op_INPLACE_OR,
+#ifdef HAVE_PRINT
+        [PRINT_EXPR] = &&op_PRINT_EXPR,
+        [PRINT_ITEM] = &&op_PRINT_ITEM,
+        [PRINT_NEWLINE] = &&op_PRINT_NEWLINE,
+#endif /* HAVE_PRINT */
+        [BREAK_LOOP] = &&op_BREAK_LOOP,
+        [LOAD_LOCALS] = &&op_LOAD_LOCALS,
+        [RETURN_VALUE] = &&op_RETURN_VALUE,
+#ifdef HAVE_IMPORTS
+        [IMPORT_STAR] = &&op_IMPORT_STAR,
+#endif /* HAVE_IMPORTS */
+#ifdef HAVE_GENERATORS
+        [YIELD_VALUE] = &&op_YIELD_VALUE,
+#endif /* HAVE_GENERATORS */
+        [POP_BLOCK] = &&op_POP_BLOCK,
+#ifdef HAVE_CLASSES
+        [BUILD_CLASS] = &&op_BUILD_CLASS,
+#endif /* HAVE_CLASSES */
+        [STORE_NAME] = &&op_STORE_NAME,
+#ifdef HAVE_DEL
+        [DELETE_NAME] = &&op_DELETE_NAME,
+#endif /* HAVE_DEL */
+        [UNPACK_SEQUENCE] = &&op_UNPACK_SEQUENCE,
+        [FOR_ITER] = &&op_FOR_ITER,
+        [STORE_ATTR] = &&op_STORE_ATTR,
+#ifdef HAVE_DEL
+        [DELETE_ATTR] = &&op_DELETE_ATTR,
+#endif /* HAVE_DEL */
+        [STORE_GLOBAL] = &&op_STORE_GLOBAL,
+#ifdef HAVE_DEL
+        [DELETE_GLOBAL] = &&op_DELETE_GLOBAL,
+#endif /* HAVE_DEL */
+        [DUP_TOPX] = &&op_DUP_TOPX,
+        [LOAD_CONST] = &&op_LOAD_CONST,
+        [LOAD_NAME] = &&op_LOAD_NAME,
+        [BUILD_TUPLE] = &&op_BUILD_TUPLE,
+        [BUILD_LIST] = &&op_BUILD_LIST,
+        [BUILD_MAP] = &&op_BUILD_MAP,
+        [LOAD_ATTR] = &&op_LOAD_ATTR,
+        [COMPARE_OP] = &&op_COMPARE_OP,
+        [IMPORT_NAME] = &&op_IMPORT_NAME,
+#ifdef HAVE_IMPORTS
+        [IMPORT_FROM] = &&op_IMPORT_FROM,
+#endif /* HAVE_IMPORTS */
+        [JUMP_FORWARD] = &&op_JUMP_FORWARD,
+        [JUMP_IF_FALSE] = &&op_JUMP_IF_FALSE,
+        [JUMP_IF_TRUE] = &&op_JUMP_IF_TRUE,
+        [JUMP_ABSOLUTE] = &&op_JUMP_ABSOLUTE,
+        [CONTINUE_LOOP] = &&op_CONTINUE_LOOP,
+        [LOAD_GLOBAL] = &&op_LOAD_GLOBAL,
+        [SETUP_LOOP] = &&op_SETUP_LOOP,
+        [LOAD_FAST] = &&op_LOAD_FAST,
+        [STORE_FAST] = &&op_STORE_FAST,
+#ifdef HAVE_DEL
+        [DELETE_FAST] = &&op_DELETE_FAST,
+#endif /* HAVE_DEL */
+#ifdef HAVE_SUPERINSTRUCTIONS
+        [LOAD_FAST_LOAD_FAST] = &&op_LOAD_FAST_LOAD_FAST,
+        [LOAD_FAST_LOAD_CONST] = &&op_LOAD_FAST_LOAD_CONST,
+        [STORE_FAST_LOAD_FAST] = &&op_STORE_FAST_LOAD_FAST,
+        [LOAD_FAST_LOAD_CONST_BINARY_ADD] =
+            &&op_LOAD_FAST_LOAD_CONST_BINARY_ADD,
+        [LOAD_FAST_LOAD_CONST_BINARY_SUBTRACT] =
+            &&op_LOAD_FAST_LOAD_CONST_BINARY_SUBTRACT,
+        [LOAD_FAST_LOAD_FAST_COMPARE_OP] = &&op_LOAD_FAST_LOAD_FAST_COMPARE_OP,
+        [LOAD_FAST_LOAD_CONST_COMPARE_OP] =
+            &&op_LOAD_FAST_LOAD_CONST_COMPARE_OP,
+#endif /* HAVE_SUPERINSTRUCTIONS */
+#ifdef HAVE_ASSERT
+        [RAISE_VARARGS] = &&op_RAISE_VARARGS,
+#endif /* HAVE_ASSERT */
+        [CALL_FUNCTION] = &&op_CALL_FUNCTION,
+        [MAKE_FUNCTION] = &&op_MAKE_FUNCTION,
+#ifdef HAVE_CLOSURES
+        [MAKE_CLOSURE] = &&op_MAKE_CLOSURE,
+        [LOAD_CLOSURE] = &&op_LOAD_CLOSURE,
+        [LOAD_DEREF] = &&op_LOAD_DEREF,
+        [STORE_DEREF] = &&op_STORE_DEREF,
+#endif /* HAVE_CLOSURES */
+    };
+#pragma GCC diagnostic pop
+#endif /* PM_COMPUTED_GOTO */
 
     /* Activate a thread the first time */
     retval = interp_reschedule();
@@ -67,48 +239,57 @@ interpret(const uint8_t returnOnNoThreads)
         /* Reschedule threads if flag is true? */
         if (gVmGlobal.reschedule)
         {
+#ifdef HAVE_GC
+            /* Sweep if the incremental GC is done marking (it set the flag) */
+            retval = heap_gcPoll();
+            PM_BREAK_IF_ERROR(retval);
+#endif /* HAVE_GC */
+
             retval = interp_reschedule();
             PM_BREAK_IF_ERROR(retval);
         }
 
         /* Get byte; the func post-incrs PM_IP */
         bc = mem_getByte(PM_FP->fo_memspace, &PM_IP);
+#ifdef PM_COMPUTED_GOTO
+        goto *interp_dispatchTable[bc];
+#endif /* PM_COMPUTED_GOTO */
         switch (bc)
         {
-            case POP_TOP:
+            PM_TARGET(POP_TOP):
                 pobj1 = PM_POP();
-                continue;
+                PM_DISPATCH();
 
-            case ROT_TWO:
+            PM_TARGET(ROT_TWO):
                 pobj1 = TOS;
                 TOS = TOS1;
                 TOS1 = pobj1;
-                continue;
+                PM_DISPATCH();
 
-            case ROT_THREE:
+            PM_TARGET(ROT_THREE):
                 pobj1 = TOS;
                 TOS = TOS1;
                 TOS1 = TOS2;
                 TOS2 = pobj1;
-                continue;
+                PM_DISPATCH();
 
-            case DUP_TOP:
+            PM_TARGET(DUP_TOP):
                 pobj1 = TOS;
                 PM_PUSH(pobj1);
-                continue;
+                PM_DISPATCH();
 
-            case ROT_FOUR:
+            PM_TARGET(ROT_FOUR):
                 pobj1 = TOS;
                 TOS = TOS1;
                 TOS1 = TOS2;
                 TOS2 = TOS3;
                 TOS3 = pobj1;
-                continue;
+                PM_DISPATCH();
 
-            case NOP:
-                continue;
+            PM_TARGET(NOP):
+                PM_DISPATCH();
 
-            case UNARY_POSITIVE:
+            PM_TARGET(UNARY_POSITIVE):
                 /* Raise TypeError if TOS is not an int */
                 if ((OBJ_GET_TYPE(TOS) != OBJ_TYPE_INT)
 #ifdef HAVE_FLOAT
@@ -121,9 +302,9 @@ interpret(const uint8_t returnOnNoThreads)
                 }
 
                 /* When TOS is an int, this is a no-op */
-                continue;
+                PM_DISPATCH();
 
-            case UNARY_NEGATIVE:
+            PM_TARGET(UNARY_NEGATIVE):
 #ifdef HAVE_FLOAT
                 if (OBJ_GET_TYPE(TOS) == OBJ_TYPE_FLT)
                 {
@@ -136,9 +317,9 @@ interpret(const uint8_t returnOnNoThreads)
                 }
                 PM_BREAK_IF_ERROR(retval);
                 TOS = pobj2;
-                continue;
+                PM_DISPATCH();
 
-            case UNARY_NOT:
+            PM_TARGET(UNARY_NOT):
                 pobj1 = PM_POP();
                 if (obj_isFalse(pobj1))
                 {
@@ -148,18 +329,18 @@ interpret(const uint8_t returnOnNoThreads)
                 {
                     PM_PUSH(PM_FALSE);
                 }
-                continue;
+                PM_DISPATCH();
 
 #ifdef HAVE_BACKTICK
             /* #244 Add support for the backtick operation (UNARY_CONVERT) */
-            case UNARY_CONVERT:
+            PM_TARGET(UNARY_CONVERT):
                 retval = obj_repr(TOS, &pobj3);
                 PM_BREAK_IF_ERROR(retval);
                 TOS = pobj3;
-                continue;
+                PM_DISPATCH();
 #endif /* HAVE_BACKTICK */
 
-            case UNARY_INVERT:
+            PM_TARGET(UNARY_INVERT):
                 /* Raise TypeError if it's not an int */
                 if (OBJ_GET_TYPE(TOS) != OBJ_TYPE_INT)
                 {
@@ -171,16 +352,16 @@ interpret(const uint8_t returnOnNoThreads)
                 retval = int_bitInvert(TOS, &pobj2);
                 PM_BREAK_IF_ERROR(retval);
                 TOS = pobj2;
-                continue;
+                PM_DISPATCH();
 
-            case LIST_APPEND:
+            PM_TARGET(LIST_APPEND):
                 /* list_append will raise a TypeError if TOS1 is not a list */
                 retval = list_append(TOS1, TOS);
                 PM_SP -= 2;
-                continue;
+                PM_DISPATCH();
 
-            case BINARY_POWER:
-            case INPLACE_POWER:
+            PM_TARGET(BINARY_POWER):
+            PM_TARGET(INPLACE_POWER):
 
 #ifdef HAVE_FLOAT
                 if ((OBJ_GET_TYPE(TOS) == OBJ_TYPE_FLT)
@@ -191,7 +372,7 @@ interpret(const uint8_t returnOnNoThreads)
                     PM_BREAK_IF_ERROR(retval);
                     PM_SP--;
                     TOS = pobj3;
-                    continue;
+                    PM_DISPATCH();
                 }
 #endif /* HAVE_FLOAT */
 
@@ -202,9 +383,9 @@ interpret(const uint8_t returnOnNoThreads)
                 /* Set return value */
                 PM_SP--;
                 TOS = pobj3;
-                continue;
+                PM_DISPATCH();
 
-            case GET_ITER:
+            PM_TARGET(GET_ITER):
 #ifdef HAVE_GENERATORS
                 /* Raise TypeError if TOS is an instance, but not iterable */
                 if (OBJ_GET_TYPE(TOS) == OBJ_TYPE_CLI)
@@ -226,10 +407,10 @@ interpret(const uint8_t returnOnNoThreads)
                     /* Put sequence-iterator on top of stack */
                     TOS = pobj1;
                 }
-                continue;
+                PM_DISPATCH();
 
-            case BINARY_MULTIPLY:
-            case INPLACE_MULTIPLY:
+            PM_TARGET(BINARY_MULTIPLY):
+            PM_TARGET(INPLACE_MULTIPLY):
                 /* If both objs are ints, perform the op */
                 if ((OBJ_GET_TYPE(TOS) == OBJ_TYPE_INT)
                     && (OBJ_GET_TYPE(TOS1) == OBJ_TYPE_INT))
@@ -239,7 +420,7 @@ interpret(const uint8_t returnOnNoThreads)
                     PM_BREAK_IF_ERROR(retval);
                     PM_SP--;
                     TOS = pobj3;
-                    continue;
+                    PM_DISPATCH();
                 }
 
 #ifdef HAVE_FLOAT
@@ -250,7 +431,7 @@ interpret(const uint8_t returnOnNoThreads)
                     PM_BREAK_IF_ERROR(retval);
                     PM_SP--;
                     TOS = pobj3;
-                    continue;
+                    PM_DISPATCH();
                 }
 #endif /* HAVE_FLOAT */
 
@@ -269,7 +450,7 @@ interpret(const uint8_t returnOnNoThreads)
                     PM_BREAK_IF_ERROR(retval);
                     PM_SP--;
                     TOS = pobj3;
-                    continue;
+                    PM_DISPATCH();
                 }
 
                 /* If it's a tuple replication operation */
@@ -286,7 +467,7 @@ interpret(const uint8_t returnOnNoThreads)
                     PM_BREAK_IF_ERROR(retval);
                     PM_SP--;
                     TOS = pobj3;
-                    continue;
+                    PM_DISPATCH();
                 }
 
                 /* If it's a string replication operation */
@@ -306,7 +487,7 @@ interpret(const uint8_t returnOnNoThreads)
                     PM_BREAK_IF_ERROR(retval);
                     PM_SP--;
                     TOS = pobj3;
-                    continue;
+                    PM_DISPATCH();
                 }
 #endif /* HAVE_REPLICATION */
 
@@ -314,10 +495,10 @@ interpret(const uint8_t returnOnNoThreads)
                 PM_RAISE(retval, PM_RET_EX_TYPE);
                 break;
 
-            case BINARY_DIVIDE:
-            case INPLACE_DIVIDE:
-            case BINARY_FLOOR_DIVIDE:
-            case INPLACE_FLOOR_DIVIDE:
+            PM_TARGET(BINARY_DIVIDE):
+            PM_TARGET(INPLACE_DIVIDE):
+            PM_TARGET(BINARY_FLOOR_DIVIDE):
+            PM_TARGET(INPLACE_FLOOR_DIVIDE):
 
 #ifdef HAVE_FLOAT
                 if ((OBJ_GET_TYPE(TOS) == OBJ_TYPE_FLT)
@@ -327,7 +508,7 @@ interpret(const uint8_t returnOnNoThreads)
                     PM_BREAK_IF_ERROR(retval);
                     PM_SP--;
                     TOS = pobj3;
-                    continue;
+                    PM_DISPATCH();
                 }
 #endif /* HAVE_FLOAT */
 
@@ -352,10 +533,10 @@ interpret(const uint8_t returnOnNoThreads)
                 PM_BREAK_IF_ERROR(retval);
                 PM_SP--;
                 TOS = pobj3;
-                continue;
+                PM_DISPATCH();
 
-            case BINARY_MODULO:
-            case INPLACE_MODULO:
+            PM_TARGET(BINARY_MODULO):
+            PM_TARGET(INPLACE_MODULO):
 
 #ifdef HAVE_STRING_FORMAT
                 /* If it's a string, perform string format */
@@ -365,7 +546,7 @@ interpret(const uint8_t returnOnNoThreads)
                     PM_BREAK_IF_ERROR(retval);
                     PM_SP--;
                     TOS = pobj3;
-                    continue;
+                    PM_DISPATCH();
                 }
 #endif /* HAVE_STRING_FORMAT */
 
@@ -377,7 +558,7 @@ interpret(const uint8_t returnOnNoThreads)
                     PM_BREAK_IF_ERROR(retval);
                     PM_SP--;
                     TOS = pobj3;
-                    continue;
+                    PM_DISPATCH();
                 }
 #endif /* HAVE_FLOAT */
 
@@ -402,18 +583,18 @@ interpret(const uint8_t returnOnNoThreads)
                 PM_BREAK_IF_ERROR(retval);
                 PM_SP--;
                 TOS = pobj3;
-                continue;
+                PM_DISPATCH();
 
-            case STORE_MAP:
+            PM_TARGET(STORE_MAP):
                 /* #213: Add support for Python 2.6 bytecodes */
                 C_ASSERT(OBJ_GET_TYPE(TOS2) == OBJ_TYPE_DIC);
                 retval = dict_setItem(TOS2, TOS, TOS1);
                 PM_BREAK_IF_ERROR(retval);
                 PM_SP -= 2;
-                continue;
+                PM_DISPATCH();
 
-            case BINARY_ADD:
-            case INPLACE_ADD:
+            PM_TARGET(BINARY_ADD):
+            PM_TARGET(INPLACE_ADD):
 
 #ifdef HAVE_FLOAT
                 if ((OBJ_GET_TYPE(TOS) == OBJ_TYPE_FLT)
@@ -423,7 +604,7 @@ interpret(const uint8_t returnOnNoThreads)
                     PM_BREAK_IF_ERROR(retval);
                     PM_SP--;
                     TOS = pobj3;
-                    continue;
+                    PM_DISPATCH();
                 }
 #endif /* HAVE_FLOAT */
 
@@ -436,7 +617,7 @@ interpret(const uint8_t returnOnNoThreads)
                     PM_BREAK_IF_ERROR(retval);
                     PM_SP--;
                     TOS = pobj3;
-                    continue;
+                    PM_DISPATCH();
                 }
 
                 /* #242: If both objs are strings, perform concatenation */
@@ -449,15 +630,15 @@ interpret(const uint8_t returnOnNoThreads)
                     PM_BREAK_IF_ERROR(retval);
                     PM_SP--;
                     TOS = pobj3;
-                    continue;
+                    PM_DISPATCH();
                 }
 
                 /* Otherwise raise a TypeError */
                 PM_RAISE(retval, PM_RET_EX_TYPE);
                 break;
 
-            case BINARY_SUBTRACT:
-            case INPLACE_SUBTRACT:
+            PM_TARGET(BINARY_SUBTRACT):
+            PM_TARGET(INPLACE_SUBTRACT):
 
 #ifdef HAVE_FLOAT
                 if ((OBJ_GET_TYPE(TOS) == OBJ_TYPE_FLT)
@@ -467,7 +648,7 @@ interpret(const uint8_t returnOnNoThreads)
                     PM_BREAK_IF_ERROR(retval);
                     PM_SP--;
                     TOS = pobj3;
-                    continue;
+                    PM_DISPATCH();
                 }
 #endif /* HAVE_FLOAT */
 
@@ -480,14 +661,14 @@ interpret(const uint8_t returnOnNoThreads)
                     PM_BREAK_IF_ERROR(retval);
                     PM_SP--;
                     TOS = pobj3;
-                    continue;
+                    PM_DISPATCH();
                 }
 
                 /* Otherwise raise a TypeError */
                 PM_RAISE(retval, PM_RET_EX_TYPE);
                 break;
 
-            case BINARY_SUBSCR:
+            PM_TARGET(BINARY_SUBSCR):
                 /* Implements TOS = TOS1[TOS]. */
 
                 if (OBJ_GET_TYPE(TOS1) == OBJ_TYPE_DIC)
@@ -526,22 +707,22 @@ interpret(const uint8_t returnOnNoThreads)
                 PM_BREAK_IF_ERROR(retval);
                 PM_SP--;
                 TOS = pobj3;
-                continue;
+                PM_DISPATCH();
 
 #ifdef HAVE_FLOAT
             /* #213: Add support for Python 2.6 bytecodes */
-            case BINARY_TRUE_DIVIDE:
-            case INPLACE_TRUE_DIVIDE:
+            PM_TARGET(BINARY_TRUE_DIVIDE):
+            PM_TARGET(INPLACE_TRUE_DIVIDE):
 
                 /* Perform division; float_op() checks for types and zero-div */
                 retval = float_op(TOS1, TOS, &pobj3, '/');
                 PM_BREAK_IF_ERROR(retval);
                 PM_SP--;
                 TOS = pobj3;
-                continue;
+                PM_DISPATCH();
 #endif /* HAVE_FLOAT */
 
-            case SLICE_0:
+            PM_TARGET(SLICE_0):
                 /* Implements TOS = TOS[:], push a copy of the sequence */
 
                 /* Create a copy if it is a list */
@@ -562,9 +743,9 @@ interpret(const uint8_t returnOnNoThreads)
                     PM_RAISE(retval, PM_RET_EX_TYPE);
                     break;
                 }
-                continue;
+                PM_DISPATCH();
 
-            case STORE_SUBSCR:
+            PM_TARGET(STORE_SUBSCR):
                 /* Implements TOS1[TOS] = TOS2 */
 
                 /* If it's a list */
@@ -584,7 +765,7 @@ interpret(const uint8_t returnOnNoThreads)
                                           TOS2);
                     PM_BREAK_IF_ERROR(retval);
                     PM_SP -= 3;
-                    continue;
+                    PM_DISPATCH();
                 }
 
                 /* If it's a dict */
@@ -594,7 +775,7 @@ interpret(const uint8_t returnOnNoThreads)
                     retval = dict_setItem(TOS1, TOS, TOS2);
                     PM_BREAK_IF_ERROR(retval);
                     PM_SP -= 3;
-                    continue;
+                    PM_DISPATCH();
                 }
 
 #ifdef HAVE_BYTEARRAY
@@ -627,7 +808,7 @@ interpret(const uint8_t returnOnNoThreads)
                                                TOS2);
                     PM_BREAK_IF_ERROR(retval);
                     PM_SP -= 3;
-                    continue;
+                    PM_DISPATCH();
                 }
 #endif /* HAVE_BYTEARRAY */
 
@@ -636,7 +817,7 @@ interpret(const uint8_t returnOnNoThreads)
                 break;
 
 #ifdef HAVE_DEL
-            case DELETE_SUBSCR:
+            PM_TARGET(DELETE_SUBSCR):
 
                 if ((OBJ_GET_TYPE(TOS1) == OBJ_TYPE_LST)
                     && (OBJ_GET_TYPE(TOS) == OBJ_TYPE_INT))
@@ -659,11 +840,11 @@ interpret(const uint8_t returnOnNoThreads)
 
                 PM_BREAK_IF_ERROR(retval);
                 PM_SP -= 2;
-                continue;
+                PM_DISPATCH();
 #endif /* HAVE_DEL */
 
-            case BINARY_LSHIFT:
-            case INPLACE_LSHIFT:
+            PM_TARGET(BINARY_LSHIFT):
+            PM_TARGET(INPLACE_LSHIFT):
                 /* If both objs are ints, perform the op */
                 if ((OBJ_GET_TYPE(TOS) == OBJ_TYPE_INT)
                     && (OBJ_GET_TYPE(TOS1) == OBJ_TYPE_INT))
@@ -673,15 +854,15 @@ interpret(const uint8_t returnOnNoThreads)
                     PM_BREAK_IF_ERROR(retval);
                     PM_SP--;
                     TOS = pobj3;
-                    continue;
+                    PM_DISPATCH();
                 }
 
                 /* Otherwise raise a TypeError */
                 PM_RAISE(retval, PM_RET_EX_TYPE);
                 break;
 
-            case BINARY_RSHIFT:
-            case INPLACE_RSHIFT:
+            PM_TARGET(BINARY_RSHIFT):
+            PM_TARGET(INPLACE_RSHIFT):
                 /* If both objs are ints, perform the op */
                 if ((OBJ_GET_TYPE(TOS) == OBJ_TYPE_INT)
                     && (OBJ_GET_TYPE(TOS1) == OBJ_TYPE_INT))
@@ -691,15 +872,15 @@ interpret(const uint8_t returnOnNoThreads)
                     PM_BREAK_IF_ERROR(retval);
                     PM_SP--;
                     TOS = pobj3;
-                    continue;
+                    PM_DISPATCH();
                 }
 
                 /* Otherwise raise a TypeError */
                 PM_RAISE(retval, PM_RET_EX_TYPE);
                 break;
 
-            case BINARY_AND:
-            case INPLACE_AND:
+            PM_TARGET(BINARY_AND):
+            PM_TARGET(INPLACE_AND):
                 /* If both objs are ints, perform the op */
                 if ((OBJ_GET_TYPE(TOS) == OBJ_TYPE_INT)
                     && (OBJ_GET_TYPE(TOS1) == OBJ_TYPE_INT))
@@ -709,15 +890,15 @@ interpret(const uint8_t returnOnNoThreads)
                     PM_BREAK_IF_ERROR(retval);
                     PM_SP--;
                     TOS = pobj3;
-                    continue;
+                    PM_DISPATCH();
                 }
 
                 /* Otherwise raise a TypeError */
                 PM_RAISE(retval, PM_RET_EX_TYPE);
                 break;
 
-            case BINARY_XOR:
-            case INPLACE_XOR:
+            PM_TARGET(BINARY_XOR):
+            PM_TARGET(INPLACE_XOR):
                 /* If both objs are ints, perform the op */
                 if ((OBJ_GET_TYPE(TOS) == OBJ_TYPE_INT)
                     && (OBJ_GET_TYPE(TOS1) == OBJ_TYPE_INT))
@@ -727,15 +908,15 @@ interpret(const uint8_t returnOnNoThreads)
                     PM_BREAK_IF_ERROR(retval);
                     PM_SP--;
                     TOS = pobj3;
-                    continue;
+                    PM_DISPATCH();
                 }
 
                 /* Otherwise raise a TypeError */
                 PM_RAISE(retval, PM_RET_EX_TYPE);
                 break;
 
-            case BINARY_OR:
-            case INPLACE_OR:
+            PM_TARGET(BINARY_OR):
+            PM_TARGET(INPLACE_OR):
                 /* If both objs are ints, perform the op */
                 if ((OBJ_GET_TYPE(TOS) == OBJ_TYPE_INT)
                     && (OBJ_GET_TYPE(TOS1) == OBJ_TYPE_INT))
@@ -745,7 +926,7 @@ interpret(const uint8_t returnOnNoThreads)
                     PM_BREAK_IF_ERROR(retval);
                     PM_SP--;
                     TOS = pobj3;
-                    continue;
+                    PM_DISPATCH();
                 }
 
                 /* Otherwise raise a TypeError */
@@ -753,11 +934,11 @@ interpret(const uint8_t returnOnNoThreads)
                 break;
 
 #ifdef HAVE_PRINT
-            case PRINT_EXPR:
+            PM_TARGET(PRINT_EXPR):
                 /* Print interactive expression */
                 /* Fallthrough */
 
-            case PRINT_ITEM:
+            PM_TARGET(PRINT_ITEM):
                 if (gVmGlobal.needSoftSpace && (bc == PRINT_ITEM))
                 {
                     retval = plat_putByte(' ');
@@ -771,11 +952,11 @@ interpret(const uint8_t returnOnNoThreads)
                 PM_SP--;
                 if (bc != PRINT_EXPR)
                 {
-                    continue;
+                    PM_DISPATCH();
                 }
                 /* If PRINT_EXPR, Fallthrough to print a newline */
 
-            case PRINT_NEWLINE:
+            PM_TARGET(PRINT_NEWLINE):
                 gVmGlobal.needSoftSpace = C_FALSE;
                 if (gVmGlobal.somethingPrinted)
                 {
@@ -783,10 +964,10 @@ interpret(const uint8_t returnOnNoThreads)
                     gVmGlobal.somethingPrinted = C_FALSE;
                 }
                 PM_BREAK_IF_ERROR(retval);
-                continue;
+                PM_DISPATCH();
 #endif /* HAVE_PRINT */
 
-            case BREAK_LOOP:
+            PM_TARGET(BREAK_LOOP):
             {
                 pPmBlock_t pb1 = PM_FP->fo_blockstack;
 
@@ -816,15 +997,15 @@ interpret(const uint8_t returnOnNoThreads)
                 retval = heap_freeChunk((pPmObj_t)pb1);
                 PM_BREAK_IF_ERROR(retval);
             }
-                continue;
+                PM_DISPATCH();
 
-            case LOAD_LOCALS:
+            PM_TARGET(LOAD_LOCALS):
                 /* Pushes local attrs dict of current frame */
                 /* WARNING: does not copy fo_locals to attrs */
                 PM_PUSH((pPmObj_t)PM_FP->fo_attrs);
-                continue;
+                PM_DISPATCH();
 
-            case RETURN_VALUE:
+            PM_TARGET(RETURN_VALUE):
                 /* Get expiring frame's TOS */
                 pobj2 = PM_POP();
 
@@ -860,6 +1041,10 @@ interpret(const uint8_t returnOnNoThreads)
                 /* If returning function was a generator */
                 if (((pPmFrame_t)pobj1)->fo_func->f_co->co_flags & CO_GENERATOR)
                 {
+                    /* Its frame stays reachable from the generator */
+                    retval = heap_gcRescan(pobj1);
+                    PM_BREAK_IF_ERROR(retval);
+
                     /* Raise a StopIteration exception */
                     PM_RAISE(retval, PM_RET_EX_STOP);
                     break;
@@ -894,10 +1079,10 @@ interpret(const uint8_t returnOnNoThreads)
 
                 /* Deallocate expired frame */
                 PM_BREAK_IF_ERROR(heap_freeChunk(pobj1));
-                continue;
+                PM_DISPATCH();
 
 #ifdef HAVE_IMPORTS
-            case IMPORT_STAR:
+            PM_TARGET(IMPORT_STAR):
                 /* #102: Implement the remaining IMPORT_ bytecodes */
                 /* Expect a module on the top of the stack */
                 C_ASSERT(OBJ_GET_TYPE(TOS) == OBJ_TYPE_MOD);
@@ -907,11 +1092,11 @@ interpret(const uint8_t returnOnNoThreads)
                                      (pPmObj_t)((pPmFunc_t)TOS)->f_attrs);
                 PM_BREAK_IF_ERROR(retval);
                 PM_SP--;
-                continue;
+                PM_DISPATCH();
 #endif /* HAVE_IMPORTS */
 
 #ifdef HAVE_GENERATORS
-            case YIELD_VALUE:
+            PM_TARGET(YIELD_VALUE):
                 /* #207: Add support for the yield keyword */
                 /* Get expiring frame's TOS */
                 pobj1 = PM_POP();
@@ -924,15 +1109,19 @@ interpret(const uint8_t returnOnNoThreads)
                     break;
                 }
 
+                /* The GC does not see a frame change once it leaves the thread */
+                retval = heap_gcRescan((pPmObj_t)PM_FP);
+                PM_BREAK_IF_ERROR(retval);
+
                 /* Return to previous frame */
                 PM_FP = PM_FP->fo_back;
 
                 /* Push yield value onto caller's TOS */
                 PM_PUSH(pobj1);
-                continue;
+                PM_DISPATCH();
 #endif /* HAVE_GENERATORS */
 
-            case POP_BLOCK:
+            PM_TARGET(POP_BLOCK):
                 /* Get ptr to top block */
                 pobj1 = (pPmObj_t)PM_FP->fo_blockstack;
 
@@ -947,16 +1136,16 @@ interpret(const uint8_t returnOnNoThreads)
                 PM_IP = ((pPmBlock_t)pobj1)->b_handler;
 
                 PM_BREAK_IF_ERROR(heap_freeChunk(pobj1));
-                continue;
+                PM_DISPATCH();
 
 #ifdef HAVE_CLASSES
-            case BUILD_CLASS:
+            PM_TARGET(BUILD_CLASS):
                 /* Create and push new class */
                 retval = class_new(TOS, TOS1, TOS2, &pobj2);
                 PM_BREAK_IF_ERROR(retval);
                 PM_SP -= 2;
                 TOS = pobj2;
-                continue;
+                PM_DISPATCH();
 #endif /* HAVE_CLASSES */
 
 
@@ -965,7 +1154,7 @@ interpret(const uint8_t returnOnNoThreads)
              * that needs to be swallowed using GET_ARG().
              **************************************************/
 
-            case STORE_NAME:
+            PM_TARGET(STORE_NAME):
                 /* Get name index */
                 t16 = GET_ARG();
 
@@ -976,10 +1165,10 @@ interpret(const uint8_t returnOnNoThreads)
                 retval = dict_setItem((pPmObj_t)PM_FP->fo_attrs, pobj2, TOS);
                 PM_BREAK_IF_ERROR(retval);
                 PM_SP--;
-                continue;
+                PM_DISPATCH();
 
 #ifdef HAVE_DEL
-            case DELETE_NAME:
+            PM_TARGET(DELETE_NAME):
                 /* Get name index */
                 t16 = GET_ARG();
 
@@ -989,10 +1178,10 @@ interpret(const uint8_t returnOnNoThreads)
                 /* Remove key,val pair from current frame's attrs dict */
                 retval = dict_delItem((pPmObj_t)PM_FP->fo_attrs, pobj2);
                 PM_BREAK_IF_ERROR(retval);
-                continue;
+                PM_DISPATCH();
 #endif /* HAVE_DEL */
 
-            case UNPACK_SEQUENCE:
+            PM_TARGET(UNPACK_SEQUENCE):
                 /* Get ptr to sequence */
                 pobj1 = PM_POP();
 
@@ -1038,9 +1227,9 @@ interpret(const uint8_t returnOnNoThreads)
 
                 /* Test again outside the for loop */
                 PM_BREAK_IF_ERROR(retval);
-                continue;
+                PM_DISPATCH();
 
-            case FOR_ITER:
+            PM_TARGET(FOR_ITER):
                 t16 = GET_ARG();
 
 #ifdef HAVE_GENERATORS
@@ -1073,15 +1262,15 @@ interpret(const uint8_t returnOnNoThreads)
                     PM_SP--;
                     retval = PM_RET_OK;
                     PM_IP += t16;
-                    continue;
+                    PM_DISPATCH();
                 }
                 PM_BREAK_IF_ERROR(retval);
 
                 /* Push the next item onto the stack */
                 PM_PUSH(pobj2);
-                continue;
+                PM_DISPATCH();
 
-            case STORE_ATTR:
+            PM_TARGET(STORE_ATTR):
                 /* TOS.name = TOS1 */
                 /* Get names index */
                 t16 = GET_ARG();
@@ -1129,10 +1318,10 @@ interpret(const uint8_t returnOnNoThreads)
                 retval = dict_setItem(pobj2, pobj3, TOS1);
                 PM_BREAK_IF_ERROR(retval);
                 PM_SP -= 2;
-                continue;
+                PM_DISPATCH();
 
 #ifdef HAVE_DEL
-            case DELETE_ATTR:
+            PM_TARGET(DELETE_ATTR):
                 /* del TOS.name */
                 /* Get names index */
                 t16 = GET_ARG();
@@ -1187,10 +1376,10 @@ interpret(const uint8_t returnOnNoThreads)
 
                 PM_BREAK_IF_ERROR(retval);
                 PM_SP--;
-                continue;
+                PM_DISPATCH();
 #endif /* HAVE_DEL */
 
-            case STORE_GLOBAL:
+            PM_TARGET(STORE_GLOBAL):
                 /* Get name index */
                 t16 = GET_ARG();
 
@@ -1201,10 +1390,10 @@ interpret(const uint8_t returnOnNoThreads)
                 retval = dict_setItem((pPmObj_t)PM_FP->fo_globals, pobj2, TOS);
                 PM_BREAK_IF_ERROR(retval);
                 PM_SP--;
-                continue;
+                PM_DISPATCH();
 
 #ifdef HAVE_DEL
-            case DELETE_GLOBAL:
+            PM_TARGET(DELETE_GLOBAL):
                 /* Get name index */
                 t16 = GET_ARG();
 
@@ -1214,10 +1403,10 @@ interpret(const uint8_t returnOnNoThreads)
                 /* Remove key,val from globals */
                 retval = dict_delItem((pPmObj_t)PM_FP->fo_globals, pobj2);
                 PM_BREAK_IF_ERROR(retval);
-                continue;
+                PM_DISPATCH();
 #endif /* HAVE_DEL */
 
-            case DUP_TOPX:
+            PM_TARGET(DUP_TOPX):
                 t16 = GET_ARG();
                 C_ASSERT(t16 <= 3);
 
@@ -1230,17 +1419,17 @@ interpret(const uint8_t returnOnNoThreads)
                     PM_PUSH(pobj2);
                 if (t16 >= 1)
                     PM_PUSH(pobj1);
-                continue;
+                PM_DISPATCH();
 
-            case LOAD_CONST:
+            PM_TARGET(LOAD_CONST):
                 /* Get const's index in CO */
                 t16 = GET_ARG();
 
                 /* Push const on stack */
                 PM_PUSH(PM_FP->fo_func->f_co->co_consts->val[t16]);
-                continue;
+                PM_DISPATCH();
 
-            case LOAD_NAME:
+            PM_TARGET(LOAD_NAME):
                 /* Get name index */
                 t16 = GET_ARG();
 
@@ -1270,9 +1459,9 @@ interpret(const uint8_t returnOnNoThreads)
                 }
                 PM_BREAK_IF_ERROR(retval);
                 PM_PUSH(pobj2);
-                continue;
+                PM_DISPATCH();
 
-            case BUILD_TUPLE:
+            PM_TARGET(BUILD_TUPLE):
                 /* Get num items */
                 t16 = GET_ARG();
                 retval = tuple_new(t16, &pobj1);
@@ -1284,9 +1473,9 @@ interpret(const uint8_t returnOnNoThreads)
                     ((pPmTuple_t)pobj1)->val[t16] = PM_POP();
                 }
                 PM_PUSH(pobj1);
-                continue;
+                PM_DISPATCH();
 
-            case BUILD_LIST:
+            PM_TARGET(BUILD_LIST):
                 t16 = GET_ARG();
                 retval = list_new(&pobj1);
                 PM_BREAK_IF_ERROR(retval);
@@ -1304,17 +1493,17 @@ interpret(const uint8_t returnOnNoThreads)
 
                 /* push list onto stack */
                 PM_PUSH(pobj1);
-                continue;
+                PM_DISPATCH();
 
-            case BUILD_MAP:
+            PM_TARGET(BUILD_MAP):
                 /* Argument is ignored */
                 t16 = GET_ARG();
                 retval = dict_new(&pobj1);
                 PM_BREAK_IF_ERROR(retval);
                 PM_PUSH(pobj1);
-                continue;
+                PM_DISPATCH();
 
-            case LOAD_ATTR:
+            PM_TARGET(LOAD_ATTR):
                 /* Implements TOS.attr */
                 t16 = GET_ARG();
 
@@ -1354,31 +1543,52 @@ interpret(const uint8_t returnOnNoThreads)
                     break;
                 }
 
-                /* Get name */
-                pobj2 = PM_FP->fo_func->f_co->co_names->val[t16];
+                /* Reuse the previous lookup if the attrs are unchanged */
+                pcache = NAMECACHE_ENTRY(PM_IP);
+                if ((pcache->ip == PM_IP)
+                    && (pcache->pdict == (pPmDict_t)pobj1)
+                    && (pcache->version == ((pPmDict_t)pobj1)->version))
+                {
+                    pobj3 = pcache->pobj;
+                }
+                else
+                {
+                    /* Get name */
+                    pobj2 = PM_FP->fo_func->f_co->co_names->val[t16];
+
+                    /* Get attr with given name */
+                    retval = dict_getItem(pobj1, pobj2, &pobj3);
 
-                /* Get attr with given name */
-                retval = dict_getItem(pobj1, pobj2, &pobj3);
+                    /* Remember attrs found directly in the object's dict */
+                    if (retval == PM_RET_OK)
+                    {
+                        pcache->ip = PM_IP;
+                        pcache->pdict = (pPmDict_t)pobj1;
+                        pcache->version = ((pPmDict_t)pobj1)->version;
+                        pcache->pdict2 = C_NULL;
+                        pcache->pobj = pobj3;
+                    }
 
 #ifdef HAVE_CLASSES
-                /*
-                 * If attr is not found and object is a class or instance,
-                 * try to get the attribute from the class attrs or parent(s)
-                 */
-                if ((retval == PM_RET_EX_KEY) &&
-                    ((OBJ_GET_TYPE(TOS) == OBJ_TYPE_CLO)
-                        || (OBJ_GET_TYPE(TOS) == OBJ_TYPE_CLI)))
-                {
-                    retval = class_getAttr(TOS, pobj2, &pobj3);
-                }
+                    /*
+                     * If attr is not found and object is a class or instance,
+                     * try to get the attribute from the class attrs or parent(s)
+                     */
+                    if ((retval == PM_RET_EX_KEY) &&
+                        ((OBJ_GET_TYPE(TOS) == OBJ_TYPE_CLO)
+                            || (OBJ_GET_TYPE(TOS) == OBJ_TYPE_CLI)))
+                    {
+                        retval = class_getAttr(TOS, pobj2, &pobj3);
+                    }
 #endif /* HAVE_CLASSES */
 
-                /* Raise an AttributeError if key is not found */
-                if (retval == PM_RET_EX_KEY)
-                {
-                    PM_RAISE(retval, PM_RET_EX_ATTR);
+                    /* Raise an AttributeError if key is not found */
+                    if (retval == PM_RET_EX_KEY)
+                    {
+                        PM_RAISE(retval, PM_RET_EX_ATTR);
+                    }
+                    PM_BREAK_IF_ERROR(retval);
                 }
-                PM_BREAK_IF_ERROR(retval);
 
 #ifdef HAVE_CLASSES
                 /* If obj is an instance and attr is a func, create method */
@@ -1393,9 +1603,9 @@ interpret(const uint8_t returnOnNoThreads)
 
                 /* Put attr on the stack */
                 TOS = pobj3;
-                continue;
+                PM_DISPATCH();
 
-            case COMPARE_OP:
+            PM_TARGET(COMPARE_OP):
                 retval = PM_RET_OK;
                 t16 = GET_ARG();
 
@@ -1406,7 +1616,7 @@ interpret(const uint8_t returnOnNoThreads)
                     retval = float_compare(TOS1, TOS, &pobj3, (PmCompare_t)t16);
                     PM_SP--;
                     TOS = pobj3;
-                    continue;
+                    PM_DISPATCH();
                 }
 #endif /* HAVE_FLOAT */
 
@@ -1494,9 +1704,9 @@ interpret(const uint8_t returnOnNoThreads)
                 }
                 PM_SP--;
                 TOS = pobj3;
-                continue;
+                PM_DISPATCH();
 
-            case IMPORT_NAME:
+            PM_TARGET(IMPORT_NAME):
                 /* Get name index */
                 t16 = GET_ARG();
 
@@ -1517,7 +1727,7 @@ interpret(const uint8_t returnOnNoThreads)
                     && (OBJ_GET_TYPE(pobj2) == OBJ_TYPE_MOD))
                 {
                     TOS = pobj2;
-                    continue;
+                    PM_DISPATCH();
                 }
 
                 /* Load module from image */
@@ -1544,10 +1754,10 @@ interpret(const uint8_t returnOnNoThreads)
 
                 /* Set new frame */
                 PM_FP = (pPmFrame_t)pobj3;
-                continue;
+                PM_DISPATCH();
 
 #ifdef HAVE_IMPORTS
-            case IMPORT_FROM:
+            PM_TARGET(IMPORT_FROM):
                 /* #102: Implement the remaining IMPORT_ bytecodes */
                 /* Expect the module on the top of the stack */
                 C_ASSERT(OBJ_GET_TYPE(TOS) == OBJ_TYPE_MOD);
@@ -1564,43 +1774,58 @@ interpret(const uint8_t returnOnNoThreads)
 
                 /* Push the object onto the top of the stack */
                 PM_PUSH(pobj3);
-                continue;
+                PM_DISPATCH();
 #endif /* HAVE_IMPORTS */
 
-            case JUMP_FORWARD:
+            PM_TARGET(JUMP_FORWARD):
                 t16 = GET_ARG();
                 PM_IP += t16;
-                continue;
+                PM_DISPATCH();
 
-            case JUMP_IF_FALSE:
+            PM_TARGET(JUMP_IF_FALSE):
                 t16 = GET_ARG();
                 if (obj_isFalse(TOS))
                 {
                     PM_IP += t16;
                 }
-                continue;
+                PM_DISPATCH();
 
-            case JUMP_IF_TRUE:
+            PM_TARGET(JUMP_IF_TRUE):
                 t16 = GET_ARG();
                 if (!obj_isFalse(TOS))
                 {
                     PM_IP += t16;
                 }
-                continue;
+                PM_DISPATCH();
 
-            case JUMP_ABSOLUTE:
-            case CONTINUE_LOOP:
+            PM_TARGET(JUMP_ABSOLUTE):
+            PM_TARGET(CONTINUE_LOOP):
                 /* Get target offset (bytes) */
                 t16 = GET_ARG();
 
                 /* Jump to base_ip + arg */
                 PM_IP = PM_FP->fo_func->f_co->co_codeaddr + t16;
-                continue;
+                PM_DISPATCH();
 
-            case LOAD_GLOBAL:
+            PM_TARGET(LOAD_GLOBAL):
                 /* Get name */
                 t16 = GET_ARG();
+
+                /* Reuse the previous lookup if globals (and builtins) are unchanged */
+                pcache = NAMECACHE_ENTRY(PM_IP);
+                if ((pcache->ip == PM_IP)
+                    && (pcache->pdict == PM_FP->fo_globals)
+                    && (pcache->version == PM_FP->fo_globals->version)
+                    && ((pcache->pdict2 == C_NULL)
+                        || (pcache->version2 == pcache->pdict2->version)))
+                {
+                    PM_PUSH(pcache->pobj);
+                    PM_DISPATCH();
+                }
+
                 pobj1 = PM_FP->fo_func->f_co->co_names->val[t16];
+                pcache->ip = C_NULL;
+                pcache->pdict2 = C_NULL;
 
                 /* Try globals first */
                 retval = dict_getItem((pPmObj_t)PM_FP->fo_globals,
@@ -1617,12 +1842,21 @@ interpret(const uint8_t returnOnNoThreads)
                         PM_RAISE(retval, PM_RET_EX_NAME);
                         break;
                     }
+                    pcache->pdict2 = gVmGlobal.builtins;
+                    pcache->version2 = gVmGlobal.builtins->version;
                 }
                 PM_BREAK_IF_ERROR(retval);
+
+                /* Remember where the name was found */
+                pcache->ip = PM_IP;
+                pcache->pdict = PM_FP->fo_globals;
+                pcache->version = PM_FP->fo_globals->version;
+                pcache->pobj = pobj2;
+
                 PM_PUSH(pobj2);
-                continue;
+                PM_DISPATCH();
 
-            case SETUP_LOOP:
+            PM_TARGET(SETUP_LOOP):
             {
                 uint8_t *pchunk;
 
@@ -1645,28 +1879,124 @@ interpret(const uint8_t returnOnNoThreads)
                 /* Insert block into blockstack */
                 ((pPmBlock_t)pobj1)->next = PM_FP->fo_blockstack;
                 PM_FP->fo_blockstack = (pPmBlock_t)pobj1;
-                continue;
+                PM_DISPATCH();
             }
 
-            case LOAD_FAST:
+            PM_TARGET(LOAD_FAST):
                 t16 = GET_ARG();
                 PM_PUSH(PM_FP->fo_locals[t16]);
-                continue;
+                PM_DISPATCH();
 
-            case STORE_FAST:
+            PM_TARGET(STORE_FAST):
                 t16 = GET_ARG();
                 PM_FP->fo_locals[t16] = PM_POP();
-                continue;
+                PM_DISPATCH();
 
 #ifdef HAVE_DEL
-            case DELETE_FAST:
+            PM_TARGET(DELETE_FAST):
                 t16 = GET_ARG();
                 PM_FP->fo_locals[t16] = PM_NONE;
-                continue;
+                PM_DISPATCH();
 #endif /* HAVE_DEL */
 
+#ifdef HAVE_SUPERINSTRUCTIONS
+            PM_TARGET(LOAD_FAST_LOAD_FAST):
+                t16 = GET_ARG();
+                PM_PUSH(PM_FP->fo_locals[t16]);
+                SKIP_BCODE();
+                t16 = GET_ARG();
+                PM_PUSH(PM_FP->fo_locals[t16]);
+                PM_DISPATCH();
+
+            PM_TARGET(LOAD_FAST_LOAD_CONST):
+                t16 = GET_ARG();
+                PM_PUSH(PM_FP->fo_locals[t16]);
+                SKIP_BCODE();
+                t16 = GET_ARG();
+                PM_PUSH(PM_FP->fo_func->f_co->co_consts->val[t16]);
+                PM_DISPATCH();
+
+            PM_TARGET(STORE_FAST_LOAD_FAST):
+                t16 = GET_ARG();
+                PM_FP->fo_locals[t16] = PM_POP();
+                SKIP_BCODE();
+                t16 = GET_ARG();
+                PM_PUSH(PM_FP->fo_locals[t16]);
+                PM_DISPATCH();
+
+            PM_TARGET(LOAD_FAST_LOAD_CONST_BINARY_ADD):
+            PM_TARGET(LOAD_FAST_LOAD_CONST_BINARY_SUBTRACT):
+                t16 = GET_ARG();
+                pobj1 = PM_FP->fo_locals[t16];
+                SKIP_BCODE();
+                t16 = GET_ARG();
+                pobj2 = PM_FP->fo_func->f_co->co_consts->val[t16];
+
+                /* Do the int op here, leave other types to the original op */
+                if ((OBJ_GET_TYPE(pobj1) == OBJ_TYPE_INT)
+                    && (OBJ_GET_TYPE(pobj2) == OBJ_TYPE_INT))
+                {
+                    retval = int_new(
+                        (bc == LOAD_FAST_LOAD_CONST_BINARY_ADD)
+                        ? ((pPmInt_t)pobj1)->val + ((pPmInt_t)pobj2)->val
+                        : ((pPmInt_t)pobj1)->val - ((pPmInt_t)pobj2)->val,
+                        &pobj3);
+                    PM_BREAK_IF_ERROR(retval);
+                    SKIP_BCODE();
+                    PM_PUSH(pobj3);
+                    PM_DISPATCH();
+                }
+                PM_PUSH(pobj1);
+                PM_PUSH(pobj2);
+                PM_DISPATCH();
+
+            PM_TARGET(LOAD_FAST_LOAD_FAST_COMPARE_OP):
+            PM_TARGET(LOAD_FAST_LOAD_CONST_COMPARE_OP):
+                t16 = GET_ARG();
+                pobj1 = PM_FP->fo_locals[t16];
+                SKIP_BCODE();
+                t16 = GET_ARG();
+                pobj2 = (bc == LOAD_FAST_LOAD_FAST_COMPARE_OP)
+                        ? PM_FP->fo_locals[t16]
+                        : PM_FP->fo_func->f_co->co_consts->val[t16];
+
+                /* Compare ints here, leave other types to COMPARE_OP */
+                if ((OBJ_GET_TYPE(pobj1) == OBJ_TYPE_INT)
+                    && (OBJ_GET_TYPE(pobj2) == OBJ_TYPE_INT))
+                {
+                    int32_t a = ((pPmInt_t)pobj1)->val;
+                    int32_t b = ((pPmInt_t)pobj2)->val;
+
+                    SKIP_BCODE();
+                    t16 = GET_ARG();
+                    switch (t16)
+                    {
+                        /* *INDENT-OFF* */
+                        case COMP_LT: t8 = (int8_t)(a <  b); break;
+                        case COMP_LE: t8 = (int8_t)(a <= b); break;
+                        case COMP_EQ: t8 = (int8_t)(a == b); break;
+                        case COMP_NE: t8 = (int8_t)(a != b); break;
+                        case COMP_GT: t8 = (int8_t)(a >  b); break;
+                        case COMP_GE: t8 = (int8_t)(a >= b); break;
+                        default: t8 = -1; break;
+                        /* *INDENT-ON* */
+                    }
+                    if (t8 >= 0)
+                    {
+                        PM_PUSH((t8) ? PM_TRUE : PM_FALSE);
+                        PM_DISPATCH();
+                    }
+
+                    /* Rewind to the COMPARE_OP bytecode */
+                    PM_IP -= 3;
+                }
+                PM_PUSH(pobj1);
+                PM_PUSH(pobj2);
+                PM_DISPATCH();
+#endif /* HAVE_SUPERINSTRUCTIONS */
+
 #ifdef HAVE_ASSERT
-            case RAISE_VARARGS:
+            PM_TARGET(RAISE_VARARGS):
                 t16 = GET_ARG();
 
                 /* Only supports taking 1 arg for now */
@@ -1708,7 +2038,7 @@ interpret(const uint8_t returnOnNoThreads)
                 break;
 #endif /* HAVE_ASSERT */
 
-            case CALL_FUNCTION:
+            PM_TARGET(CALL_FUNCTION):
                 /* Get num args */
                 t16 = GET_ARG();
 
@@ -1807,7 +2137,7 @@ interpret(const uint8_t returnOnNoThreads)
 
                         /* Otherwise, continue with instance */
                         heap_gcPopTempRoot(objid);
-                        continue;
+                        PM_DISPATCH();
                     }
                     else if (retval != PM_RET_OK)
                     {
@@ -2065,9 +2395,9 @@ CALL_FUNC_FOR_ITER:
 CALL_FUNC_CLEANUP:
                 heap_gcPopTempRoot(objid);
                 PM_BREAK_IF_ERROR(retval);
-                continue;
+                PM_DISPATCH();
 
-            case MAKE_FUNCTION:
+            PM_TARGET(MAKE_FUNCTION):
                 /* Get num default args to fxn */
                 t16 = GET_ARG();
 
@@ -2110,10 +2440,10 @@ CALL_FUNC_CLEANUP:
 
                 /* Push func obj */
                 PM_PUSH(pobj2);
-                continue;
+                PM_DISPATCH();
 
 #ifdef HAVE_CLOSURES
-            case MAKE_CLOSURE:
+            PM_TARGET(MAKE_CLOSURE):
                 /* Get number of default args */
                 t16 = GET_ARG();
                 retval = func_new(TOS, (pPmObj_t)PM_FP->fo_globals, &pobj2);
@@ -2140,10 +2470,10 @@ CALL_FUNC_CLEANUP:
 
                 /* Push new func with closure */
                 PM_PUSH(pobj2);
-                continue;
+                PM_DISPATCH();
 
-            case LOAD_CLOSURE:
-            case LOAD_DEREF:
+            PM_TARGET(LOAD_CLOSURE):
+            PM_TARGET(LOAD_DEREF):
                 /* Loads the i'th cell of free variable storage onto TOS */
                 t16 = GET_ARG();
                 pobj1 = PM_FP->fo_locals[PM_FP->fo_func->f_co->co_nlocals + t16];
@@ -2153,17 +2483,17 @@ CALL_FUNC_CLEANUP:
                     break;
                 }
                 PM_PUSH(pobj1);
-                continue;
+                PM_DISPATCH();
 
-            case STORE_DEREF:
+            PM_TARGET(STORE_DEREF):
                 /* Stores TOS into the i'th cell of free variable storage */
                 t16 = GET_ARG();
                 PM_FP->fo_locals[PM_FP->fo_func->f_co->co_nlocals + t16] = PM_POP();
-                continue;
+                PM_DISPATCH();
 #endif /* HAVE_CLOSURES */
 
 
-            default:
+            PM_TARGET_DEFAULT:
                 /* SystemError, unknown or unimplemented opcode */
                 PM_RAISE(retval, PM_RET_EX_SYS);
                 break;
@@ -2296,3 +2626,15 @@ interp_setRescheduleFlag(uint8_t boolean)
 {
     gVmGlobal.reschedule = boolean;
 }
+
+
+void
+interp_flushNameCache(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < PM_NAMECACHE_SIZE; i++)
+    {
+        interp_nameCache[i].ip = C_NULL;
+    }
+}
@@ -55,6 +55,17 @@
 #define PM_PUSH(pobj)   (*(PM_SP++) = (pobj))
 /** gets the argument (S16) from the instruction stream */
 #define GET_ARG()       mem_getWord(PM_FP->fo_memspace, &PM_IP)
+/** skips the bytecode of a fused instruction in the instruction stream */
+#define SKIP_BCODE()    (PM_IP++)
+
+/**
+ * Use threaded dispatch (GCC labels as values) in interpret() so every
+ * bytecode handler jumps straight to the handler of the next bytecode.
+ * Define PM_PLAT_NO_COMPUTED_GOTO in plat.h to force the switch dispatch.
+ */
+#if defined(__GNUC__) && !defined(PM_PLAT_NO_COMPUTED_GOTO)
+#define PM_COMPUTED_GOTO
+#endif
 
 /** pushes an obj in the only stack slot of the native frame */
 #define NATIVE_SET_TOS(pobj) (gVmGlobal.nativeframe.nf_stack = \
@@ -275,13 +286,58 @@ typedef enum PmBcode_e
     UNUSED_E4, UNUSED_E5, UNUSED_E6, UNUSED_E7,
     UNUSED_E8, UNUSED_E9, UNUSED_EA, UNUSED_EB,
     UNUSED_EC, UNUSED_ED, UNUSED_EE, UNUSED_EF,
-    UNUSED_F0, UNUSED_F1, UNUSED_F2, UNUSED_F3,
-    UNUSED_F4, UNUSED_F5, UNUSED_F6, UNUSED_F7,
+
+    /*
+     * Superinstructions, written over the first bytecode of a common
+     * sequence by pmImgCreator.py.  The arguments and bytecodes of the
+     * following instructions stay in place, so jump offsets are unchanged
+     * and a fused op can always fall back to executing the original ones.
+     */
+    LOAD_FAST_LOAD_FAST = 0xF0,
+    LOAD_FAST_LOAD_CONST,
+    STORE_FAST_LOAD_FAST,
+    LOAD_FAST_LOAD_CONST_BINARY_ADD,
+    LOAD_FAST_LOAD_CONST_BINARY_SUBTRACT,
+    LOAD_FAST_LOAD_FAST_COMPARE_OP,
+    LOAD_FAST_LOAD_CONST_COMPARE_OP,
+    UNUSED_F7,
     UNUSED_F8, UNUSED_F9, UNUSED_FA, UNUSED_FB,
     UNUSED_FC, UNUSED_FD, UNUSED_FE, UNUSED_FF
 } PmBcode_t, *pPmBcode_t;
 
 
+/** Number of entries in the name lookup cache (must be a power of two) */
+#ifndef PM_NAMECACHE_SIZE
+#define PM_NAMECACHE_SIZE 16
+#endif
+
+
+/**
+ * Name lookup cache entry
+ *
+ * Remembers the result of the dict lookup done by the LOAD_GLOBAL or
+ * LOAD_ATTR instruction that ends at ip.  The entry stays valid while the
+ * dict the name was found in (and, for globals found in the builtins, the
+ * globals dict that did not have it) keep the recorded versions.
+ */
+typedef struct PmNameCache_s
+{
+    /** Address following the instruction that did the lookup */
+    uint8_t const *ip;
+    /** First dict searched (globals or attrs) */
+    pPmDict_t pdict;
+    /** Second dict searched (builtins) or C_NULL */
+    pPmDict_t pdict2;
+    /** Version of pdict at the time of the lookup */
+    uint16_t version;
+    /** Version of pdict2 at the time of the lookup */
+    uint16_t version2;
+    /** The object that was found */
+    pPmObj_t pobj;
+} PmNameCache_t,
+ *pPmNameCache_t;
+
+
 /**
  * Interprets the available threads. Does not return.
  *
@@ -320,4 +376,11 @@ PmReturn_t interp_addThread(pPmFunc_t pfunc);
  */
 void interp_setRescheduleFlag(uint8_t boolean);
 
+/**
+ * Invalidates all name lookup cache entries.
+ * Must be called when objects are freed (a dict or code image at a
+ * cached address could be replaced by a new one) or a dict version wraps.
+ */
+void interp_flushNameCache(void);
+
 #endif /* __INTERP_H__ */
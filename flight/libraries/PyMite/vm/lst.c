@@ -49,6 +49,8 @@ list_append(pPmObj_t plist, pPmObj_t pobj)
     {
         retval = seglist_new(&((pPmList_t)plist)->val);
         PM_RETURN_IF_ERROR(retval);
+        retval = heap_gcWriteBarrier((pPmObj_t)((pPmList_t)plist)->val);
+        PM_RETURN_IF_ERROR(retval);
     }
 
     /* Append object to list */
@@ -132,6 +134,8 @@ list_insert(pPmObj_t plist, int16_t index, pPmObj_t pobj)
     {
         retval = seglist_new(&((pPmList_t)plist)->val);
         PM_RETURN_IF_ERROR(retval);
+        retval = heap_gcWriteBarrier((pPmObj_t)((pPmList_t)plist)->val);
+        PM_RETURN_IF_ERROR(retval);
     }
 
     /* Insert the item in the container */
@@ -72,6 +72,7 @@ pm_run(uint8_t const *modstr)
     pPmObj_t pmod;
     pPmObj_t pstring;
     uint8_t const *pmodstr = modstr;
+    uint8_t objid;
 
     /* Import module from global struct */
     retval = string_new(&pmodstr, &pstring);
@@ -79,8 +80,10 @@ pm_run(uint8_t const *modstr)
     retval = mod_import(pstring, &pmod);
     PM_RETURN_IF_ERROR(retval);
 
-    /* Load builtins into thread */
+    /* Load builtins into thread; this runs the GC if it interprets them */
+    heap_gcPushTempRoot(pmod, &objid);
     retval = global_setBuiltins((pPmFunc_t)pmod);
+    heap_gcPopTempRoot(objid);
     PM_RETURN_IF_ERROR(retval);
 
     /* Interpret the module's bcode */
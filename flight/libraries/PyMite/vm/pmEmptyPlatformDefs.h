@@ -35,4 +35,22 @@
 #define PM_PLAT_HEAP_ATTR
 #endif
 
+/**
+ * Define a platform-specific free running microsecond counter.
+ * The GC uses it to time its pauses (see PmGcStats_t in heap.h).
+ * If not defined, all pauses read as zero.
+ */
+#if !defined(PM_PLAT_GET_USECS) || defined(__DOXYGEN__)
+#define PM_PLAT_GET_USECS() 0
+#endif
+
+/**
+ * Define a platform-specific hook that is called with a pointer to the
+ * GC statistics after each garbage collection.
+ * If not defined, make it empty.
+ */
+#if !defined(PM_PLAT_GC_DONE) || defined(__DOXYGEN__)
+#define PM_PLAT_GC_DONE(pstats)
+#endif
+
 #endif /* __PM_EMPTY_PLATFORM_DEFS_H__ */
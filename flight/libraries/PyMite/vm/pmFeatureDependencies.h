@@ -150,6 +150,15 @@
  * When defined, the code to support debug information in exception reports
  * is included in the build.
  * Issue #103 Add debug info to exception reports
+ *
+ *
+ * HAVE_SUPERINSTRUCTIONS
+ * ----------------------
+ *
+ * When defined, pmImgCreator.py fuses common bytecode sequences (e.g.
+ * LOAD_FAST LOAD_CONST BINARY_ADD) into single superinstructions and the
+ * interpreter includes the handlers for them.  The images and the VM must
+ * be built with the same setting.
  */
 
 /* Check for dependencies */
@@ -207,6 +207,9 @@ seglist_insertItem(pSeglist_t pseglist, pPmObj_t pobj, int16_t index)
 
         /* Either way, this is now the last segment */
         pseglist->sl_lastseg = pseg;
+
+        retval = heap_gcWriteBarrier((pPmObj_t)pseg);
+        PM_RETURN_IF_ERROR(retval);
     }
 
     /* Walk out to the segment for insertion */
@@ -237,7 +240,7 @@ seglist_insertItem(pSeglist_t pseglist, pPmObj_t pobj, int16_t index)
         }
     }
     pseglist->sl_length++;
-    return retval;
+    return heap_gcWriteBarrier(pobj);
 }
 
 
@@ -276,7 +279,7 @@ seglist_setItem(pSeglist_t pseglist, pPmObj_t pobj, int16_t index)
 
     /* Set item in this seg at the index */
     pseg->s_val[index % SEGLIST_OBJS_PER_SEG] = pobj;
-    return PM_RET_OK;
+    return heap_gcWriteBarrier(pobj);
 }
 
 
@@ -50,6 +50,8 @@
 
 #include "WorldMagModel.h"
 #include "WMMInternal.h"
+#include "callbackinfo.h"
+#include <mathmisc.h>
 
 #define MALLOC(x) pios_malloc(x)
 #define FREE(x)   vPortFree(x)
@@ -152,8 +154,8 @@ static const float CoeffFile[91][6] = {
     { 12.0f, 12.0f, 0.0f,      0.9f,     0.1f,   0.0f   }
 };
 
-static WMMtype_Ellipsoid *Ellip = NULL;
-static WMMtype_MagneticModel *MagneticModel = NULL;
+static WMMtype_Ellipsoid Ellip;
+static WMMtype_MagneticModel MagneticModel;
 static float decimal_date;
 
 /**************************************************************************************
@@ -171,29 +173,23 @@ int WMM_Initialize()
 // Sets default values for WMM subroutines.
 // UPDATES : Ellip and MagneticModel
 {
-    if (!Ellip) {
-        return -1; // invalid pointer
-    }
-    if (!MagneticModel) {
-        return -2; // invalid pointer
-    }
     // Sets WGS-84 parameters
-    Ellip->a     = 6378.137f;   // semi-major axis of the ellipsoid in km
-    Ellip->b     = 6356.7523142f;       // semi-minor axis of the ellipsoid in km
-    Ellip->fla   = 1.0f / 298.257223563f;     // flattening
-    Ellip->eps   = sqrt(1 - (Ellip->b * Ellip->b) / (Ellip->a * Ellip->a));   // first eccentricity
-    Ellip->epssq = (Ellip->eps * Ellip->eps); // first eccentricity squared
-    Ellip->re    = 6371.2f;    // Earth's radius in km
+    Ellip.a     = 6378.137f;   // semi-major axis of the ellipsoid in km
+    Ellip.b     = 6356.7523142f;       // semi-minor axis of the ellipsoid in km
+    Ellip.fla   = 1.0f / 298.257223563f;     // flattening
+    Ellip.eps   = sqrt(1 - (Ellip.b * Ellip.b) / (Ellip.a * Ellip.a));   // first eccentricity
+    Ellip.epssq = (Ellip.eps * Ellip.eps); // first eccentricity squared
+    Ellip.re    = 6371.2f;    // Earth's radius in km
 
     // Sets Magnetic Model parameters
-    MagneticModel->nMax = WMM_MAX_MODEL_DEGREES;
-    MagneticModel->nMaxSecVar = WMM_MAX_SECULAR_VARIATION_MODEL_DEGREES;
-    MagneticModel->SecularVariationUsed = 0;
+    MagneticModel.nMax = WMM_MAX_MODEL_DEGREES;
+    MagneticModel.nMaxSecVar = WMM_MAX_SECULAR_VARIATION_MODEL_DEGREES;
+    MagneticModel.SecularVariationUsed = 0;
 
     // Really, Really needs to be read from a file - out of date in 2015 at latest
-    MagneticModel->EditionDate = 0.0f; /* OP change. Originally 5.7863328170559505e-307, truncates to 0.0f */
-    MagneticModel->epoch = 2010.0f;
-    sprintf(MagneticModel->ModelName, "WMM-2010");
+    MagneticModel.EditionDate = 0.0f; /* OP change. Originally 5.7863328170559505e-307, truncates to 0.0f */
+    MagneticModel.epoch = 2010.0f;
+    sprintf(MagneticModel.ModelName, "WMM-2010");
 
     return 0; // OK
 }
@@ -223,21 +219,11 @@ int WMM_GetMagVector(float Lat, float Lon, float AltEllipsoid, uint16_t Month, u
     // ***********
     // allocated required memory
 
-// Ellip = NULL;
-// MagneticModel = NULL;
-
-// MagneticModel = NULL;
-// CoordGeodetic = NULL;
-// GeoMagneticElements = NULL;
-
-    Ellip = (WMMtype_Ellipsoid *)MALLOC(sizeof(WMMtype_Ellipsoid));
-    MagneticModel = (WMMtype_MagneticModel *)MALLOC(sizeof(WMMtype_MagneticModel));
-
     WMMtype_CoordSpherical *CoordSpherical = (WMMtype_CoordSpherical *)MALLOC(sizeof(WMMtype_CoordSpherical));
     WMMtype_CoordGeodetic *CoordGeodetic   = (WMMtype_CoordGeodetic *)MALLOC(sizeof(WMMtype_CoordGeodetic));
     WMMtype_GeoMagneticElements *GeoMagneticElements = (WMMtype_GeoMagneticElements *)MALLOC(sizeof(WMMtype_GeoMagneticElements));
 
-    if (!Ellip || !MagneticModel || !CoordSpherical || !CoordGeodetic || !GeoMagneticElements) {
+    if (!CoordSpherical || !CoordGeodetic || !GeoMagneticElements) {
         returned = -5; // error
     }
     // ***********
@@ -271,9 +257,9 @@ int WMM_GetMagVector(float Lat, float Lon, float AltEllipsoid, uint16_t Month, u
         if (WMM_Geomag(CoordSpherical, CoordGeodetic, GeoMagneticElements) < 0) {
             returned = -9; // error
         } else { // set the returned values
-            B[0] = GeoMagneticElements->X;
-            B[1] = GeoMagneticElements->Y;
-            B[2] = GeoMagneticElements->Z;
+            B[0] = GeoMagneticElements->X * 1e-2f;
+            B[1] = GeoMagneticElements->Y * 1e-2f;
+            B[2] = GeoMagneticElements->Z * 1e-2f;
         }
     }
 
@@ -292,23 +278,348 @@ int WMM_GetMagVector(float Lat, float Lon, float AltEllipsoid, uint16_t Month, u
         FREE(CoordSpherical);
     }
 
-    if (MagneticModel) {
-        FREE(MagneticModel);
-        MagneticModel = NULL;
+    return returned;
+}
+
+/**************************************************************************************
+*   Cached evaluator - for callers that need the field along a flight path
+*
+*	WMM_CacheInitialize(5000.0f); // once, radius of the linearization in m
+*
+*	WMM_GetMagVectorCached(Lat, Lon, Alt, Month, Day, Year, B);
+*	Same arguments and units as WMM_GetMagVector. The date adjusted coefficients are
+*	computed once per date and the field is linearized around a reference point.
+*	Inside the radius B is taken from that linearization, which is a handful of
+*	multiplies. Once the vehicle is past half the radius (or the date changes) a new
+*	reference point is evaluated by a low priority callback, one spherical harmonic
+*	expansion per run, so the caller never waits for the full model.
+**************************************************************************************/
+
+#define WMM_CACHE_STACK_SIZE    640
+#define WMM_CACHE_EARTH_RADIUS  6378137.0f // m, only used to map NED offsets to LLA
+#define WMM_CACHE_MIN_RADIUS    100.0f     // m, below this float LLA can not resolve the offsets
+#define WMM_CACHE_MAX_LATITUDE  89.9f      // keeps the summation away from the pole singularity
+
+// Steps of a refresh, one per callback run
+typedef enum {
+    WMM_CACHE_STEP_COEFFS = 0, // take the request, recompute the coefficients if the date changed
+    WMM_CACHE_STEP_CENTER, // field at the new reference point
+    WMM_CACHE_STEP_NORTH, // field offset north by the radius
+    WMM_CACHE_STEP_EAST, // field offset east by the radius
+    WMM_CACHE_STEP_DOWN, // field offset down by the radius
+    WMM_CACHE_STEP_PUBLISH // build the linearization and hand it to the readers
+} WMMtype_CacheStep;
+
+typedef struct {
+    // Owned by the callback
+    float TimedCoeffG[NUMTERMS]; // date adjusted Gauss coefficients
+    float TimedCoeffH[NUMTERMS];
+    float schmidtQuasiNorm[NUMPCUP];
+    float coeffDate;
+    WMMtype_LegendreFunction LegendreFunction;
+    WMMtype_SphericalHarmonicVariables SphVariables;
+    WMMtype_CacheStep step;
+    float workLLA[3];
+    float workDate;
+    float workRadius;
+    float workB[4][3]; // center, north, east, down
+
+    // Shared with the readers, protected by lock
+    xSemaphoreHandle lock;
+    bool  refreshing;
+    float requestLLA[3];
+    float requestDate;
+    float radius;
+    bool  valid;
+    float refLLA[3];
+    float refDate;
+    float refB[3];
+    float refGradient[3][3]; // dB[i] / dNED[j] per m
+
+    DelayedCallbackInfo *callback;
+} WMMtype_Cache;
+
+static WMMtype_Cache *Cache = NULL;
+
+static void WMM_CacheCallback();
+
+int WMM_CacheInitialize(float radius)
+{
+    if (Cache) {
+        WMM_CacheSetRadius(radius);
+        return 0; // already running
+    }
+
+    WMMtype_Cache *cache = (WMMtype_Cache *)MALLOC(sizeof(WMMtype_Cache));
+    if (!cache) {
+        return -1; // memory allocation error
+    }
+    memset(cache, 0, sizeof(WMMtype_Cache));
+
+    cache->lock = xSemaphoreCreateMutex();
+    if (!cache->lock) {
+        FREE(cache);
+        return -2; // error
+    }
+
+    WMM_Initialize();
+    WMM_SchmidtQuasiNorm(cache->schmidtQuasiNorm, MagneticModel.nMax);
+    cache->coeffDate = -1.0f; // forces the first refresh to compute the coefficients
+    cache->radius    = (radius > WMM_CACHE_MIN_RADIUS) ? radius : WMM_CACHE_MIN_RADIUS;
+
+    cache->callback  = PIOS_CALLBACKSCHEDULER_Create(&WMM_CacheCallback, CALLBACK_PRIORITY_LOW, CALLBACK_TASK_AUXILIARY, CALLBACKINFO_RUNNING_WORLDMAGMODEL, WMM_CACHE_STACK_SIZE);
+    if (!cache->callback) {
+        vQueueDelete(cache->lock);
+        FREE(cache);
+        return -3; // error
+    }
+
+    Cache = cache;
+
+    return 0; // OK
+}
+
+void WMM_CacheSetRadius(float radius)
+{
+    if (!Cache) {
+        return;
+    }
+
+    xSemaphoreTake(Cache->lock, portMAX_DELAY);
+    Cache->radius = (radius > WMM_CACHE_MIN_RADIUS) ? radius : WMM_CACHE_MIN_RADIUS;
+    xSemaphoreGive(Cache->lock);
+}
+
+static void WMM_CacheOffset(const float refLLA[3], float Lat, float Lon, float AltEllipsoid, float offset[3])
+// NED offset in m of a position from the reference point, flat earth is plenty at these distances
+{
+    float dLon = Lon - refLLA[1];
+
+    if (dLon > 180.0f) {
+        dLon -= 360.0f;
+    } else if (dLon < -180.0f) {
+        dLon += 360.0f;
+    }
+
+    offset[0] = DEG2RAD(Lat - refLLA[0]) * WMM_CACHE_EARTH_RADIUS;
+    offset[1] = DEG2RAD(dLon) * WMM_CACHE_EARTH_RADIUS * cosf(DEG2RAD(refLLA[0]));
+    offset[2] = refLLA[2] - AltEllipsoid;
+}
+
+int WMM_GetMagVectorCached(float Lat, float Lon, float AltEllipsoid, uint16_t Month, uint16_t Day, uint16_t Year, float B[3])
+{
+    // return '0' if B comes from a linearization around a point within the radius
+    // return '1' if B had to be extrapolated beyond the radius, a refresh is underway
+    // return < 0 if error, or if no reference point has been computed yet
+
+    float date;
+    float offset[3];
+    float distanceSq = 0.0f;
+    bool dispatch    = false;
+    int returned;
+
+    if (Lat < -90.0f) {
+        return -1; // error
+    }
+    if (Lat > 90.0f) {
+        return -2; // error
+    }
+    if (Lon < -180.0f) {
+        return -3; // error
+    }
+    if (Lon > 180.0f) {
+        return -4; // error
+    }
+    if (!Cache) {
+        return -5; // WMM_CacheInitialize() not called
+    }
+    if (WMM_DecimalYear(Month, Day, Year, &date) < 0) {
+        return -8; // error
+    }
+
+    xSemaphoreTake(Cache->lock, portMAX_DELAY);
+
+    if (Cache->valid) {
+        WMM_CacheOffset(Cache->refLLA, Lat, Lon, AltEllipsoid, offset);
+        distanceSq = offset[0] * offset[0] + offset[1] * offset[1] + offset[2] * offset[2];
+
+        for (uint8_t i = 0; i < 3; i++) {
+            B[i] = Cache->refB[i]
+                   + Cache->refGradient[i][0] * offset[0]
+                   + Cache->refGradient[i][1] * offset[1]
+                   + Cache->refGradient[i][2] * offset[2];
+        }
+        returned = (distanceSq > Cache->radius * Cache->radius) ? 1 : 0;
+    } else {
+        returned = -10; // no reference point yet
     }
 
-    if (Ellip) {
-        FREE(Ellip);
-        Ellip = NULL;
+    // Start moving the reference point before the vehicle leaves the radius
+    if (!Cache->refreshing &&
+        (!Cache->valid || date != Cache->refDate || 4.0f * distanceSq > Cache->radius * Cache->radius)) {
+        Cache->requestLLA[0] = Lat;
+        Cache->requestLLA[1] = Lon;
+        Cache->requestLLA[2] = AltEllipsoid;
+        Cache->requestDate   = date;
+        Cache->refreshing    = true;
+        dispatch = true;
     }
 
-    B[0] = GeoMagneticElements->X * 1e-2f;
-    B[1] = GeoMagneticElements->Y * 1e-2f;
-    B[2] = GeoMagneticElements->Z * 1e-2f;
+    xSemaphoreGive(Cache->lock);
+
+    if (dispatch) {
+        PIOS_CALLBACKSCHEDULER_Dispatch(Cache->callback);
+    }
 
     return returned;
 }
 
+static void WMM_CacheUpdateCoefficients(float date)
+// Date adjusted coefficients, the equivalent of WMM_get_main_field_coeff_g/h for every index
+{
+    float dt = date - MagneticModel.epoch;
+
+    for (uint16_t index = 0; index < NUMTERMS; index++) {
+        Cache->TimedCoeffG[index] = CoeffFile[index][2];
+        Cache->TimedCoeffH[index] = CoeffFile[index][3];
+        if (index >= 1 && index <= WMM_SECULAR_VARIATION_TERMS) {
+            Cache->TimedCoeffG[index] += dt * CoeffFile[index][4];
+            Cache->TimedCoeffH[index] += dt * CoeffFile[index][5];
+        }
+    }
+    Cache->coeffDate = date;
+}
+
+static void WMM_CacheEvaluate(float Lat, float Lon, float AltEllipsoid, float B[3])
+// One spherical harmonic expansion with the cached coefficients, same as WMM_Summation
+// but without the secular variation and without any allocation
+{
+    WMMtype_CoordGeodetic CoordGeodetic;
+    WMMtype_CoordSpherical CoordSpherical;
+    WMMtype_MagneticResults MagneticResultsSph;
+    WMMtype_MagneticResults MagneticResultsGeo;
+    WMMtype_LegendreFunction *LegendreFunction = &Cache->LegendreFunction;
+    WMMtype_SphericalHarmonicVariables *SphVariables = &Cache->SphVariables;
+    uint16_t m, n, index;
+    float cos_phi;
+
+    CoordGeodetic.lambda = Lon;
+    CoordGeodetic.phi    = boundf(Lat, -WMM_CACHE_MAX_LATITUDE, WMM_CACHE_MAX_LATITUDE);
+    CoordGeodetic.HeightAboveEllipsoid = AltEllipsoid / 1000.0f; // convert to km
+
+    WMM_GeodeticToSpherical(&CoordGeodetic, &CoordSpherical);
+    WMM_ComputeSphericalHarmonicVariables(&CoordSpherical, MagneticModel.nMax, SphVariables);
+    WMM_PcupLowGauss(LegendreFunction->Pcup, LegendreFunction->dPcup, sinf(DEG2RAD(CoordSpherical.phig)), MagneticModel.nMax);
+    WMM_PcupToSchmidt(LegendreFunction->Pcup, LegendreFunction->dPcup, Cache->schmidtQuasiNorm, MagneticModel.nMax);
+
+    MagneticResultsSph.Bz = 0.0f;
+    MagneticResultsSph.By = 0.0f;
+    MagneticResultsSph.Bx = 0.0f;
+
+    for (n = 1; n <= MagneticModel.nMax; n++) {
+        float gcos, gsin;
+        for (m = 0; m <= n; m++) {
+            index = (n * (n + 1) / 2 + m);
+            gcos  = Cache->TimedCoeffG[index] * SphVariables->cos_mlambda[m] + Cache->TimedCoeffH[index] * SphVariables->sin_mlambda[m];
+            gsin  = Cache->TimedCoeffG[index] * SphVariables->sin_mlambda[m] - Cache->TimedCoeffH[index] * SphVariables->cos_mlambda[m];
+
+            MagneticResultsSph.Bz -= SphVariables->RelativeRadiusPower[n] * gcos * (float)(n + 1) * LegendreFunction->Pcup[index];
+            MagneticResultsSph.By += SphVariables->RelativeRadiusPower[n] * gsin * (float)(m) * LegendreFunction->Pcup[index];
+            MagneticResultsSph.Bx -= SphVariables->RelativeRadiusPower[n] * gcos * LegendreFunction->dPcup[index];
+        }
+    }
+
+    cos_phi = cosf(DEG2RAD(CoordSpherical.phig));
+    MagneticResultsSph.By = MagneticResultsSph.By / cos_phi;
+
+    WMM_RotateMagneticVector(&CoordSpherical, &CoordGeodetic, &MagneticResultsSph, &MagneticResultsGeo);
+
+    // same scaling as WMM_GetMagVector
+    B[0] = MagneticResultsGeo.Bx * 1e-2f;
+    B[1] = MagneticResultsGeo.By * 1e-2f;
+    B[2] = MagneticResultsGeo.Bz * 1e-2f;
+}
+
+static void WMM_CacheCallback()
+{
+    float *lla = Cache->workLLA;
+    float h    = Cache->workRadius;
+
+    switch (Cache->step) {
+    case WMM_CACHE_STEP_COEFFS:
+        xSemaphoreTake(Cache->lock, portMAX_DELAY);
+        if (!Cache->refreshing) {
+            xSemaphoreGive(Cache->lock);
+            return; // nothing to do, stay idle
+        }
+        memcpy(Cache->workLLA, Cache->requestLLA, sizeof(Cache->workLLA));
+        Cache->workDate   = Cache->requestDate;
+        Cache->workRadius = Cache->radius;
+        xSemaphoreGive(Cache->lock);
+
+        if (Cache->workDate != Cache->coeffDate) {
+            WMM_CacheUpdateCoefficients(Cache->workDate);
+        }
+        Cache->step = WMM_CACHE_STEP_CENTER;
+        break;
+
+    case WMM_CACHE_STEP_CENTER:
+        WMM_CacheEvaluate(lla[0], lla[1], lla[2], Cache->workB[0]);
+        Cache->step = WMM_CACHE_STEP_NORTH;
+        break;
+
+    case WMM_CACHE_STEP_NORTH:
+        // step south instead near the north pole, the gradient then simply has the other sign
+        if (lla[0] + RAD2DEG(h / WMM_CACHE_EARTH_RADIUS) <= WMM_CACHE_MAX_LATITUDE) {
+            WMM_CacheEvaluate(lla[0] + RAD2DEG(h / WMM_CACHE_EARTH_RADIUS), lla[1], lla[2], Cache->workB[1]);
+        } else {
+            WMM_CacheEvaluate(lla[0] - RAD2DEG(h / WMM_CACHE_EARTH_RADIUS), lla[1], lla[2], Cache->workB[1]);
+            Cache->workRadius = -h;
+        }
+        Cache->step = WMM_CACHE_STEP_EAST;
+        break;
+
+    case WMM_CACHE_STEP_EAST:
+    {
+        float lon = lla[1] + RAD2DEG(fabsf(h) / (WMM_CACHE_EARTH_RADIUS * cosf(DEG2RAD(boundf(lla[0], -WMM_CACHE_MAX_LATITUDE, WMM_CACHE_MAX_LATITUDE)))));
+        if (lon > 180.0f) {
+            lon -= 360.0f;
+        }
+        WMM_CacheEvaluate(lla[0], lon, lla[2], Cache->workB[2]);
+        Cache->step = WMM_CACHE_STEP_DOWN;
+        break;
+    }
+
+    case WMM_CACHE_STEP_DOWN:
+        WMM_CacheEvaluate(lla[0], lla[1], lla[2] - fabsf(h), Cache->workB[3]);
+        Cache->step = WMM_CACHE_STEP_PUBLISH;
+        break;
+
+    case WMM_CACHE_STEP_PUBLISH:
+        xSemaphoreTake(Cache->lock, portMAX_DELAY);
+        for (uint8_t i = 0; i < 3; i++) {
+            Cache->refLLA[i] = lla[i];
+            Cache->refB[i]   = Cache->workB[0][i];
+            Cache->refGradient[i][0] = (Cache->workB[1][i] - Cache->workB[0][i]) / h;
+            Cache->refGradient[i][1] = (Cache->workB[2][i] - Cache->workB[0][i]) / fabsf(h);
+            Cache->refGradient[i][2] = (Cache->workB[3][i] - Cache->workB[0][i]) / fabsf(h);
+        }
+        Cache->refDate    = Cache->workDate;
+        Cache->valid      = true;
+        Cache->refreshing = false;
+        xSemaphoreGive(Cache->lock);
+        Cache->step = WMM_CACHE_STEP_COEFFS;
+        return; // readers request the next refresh
+
+    default:
+        Cache->step = WMM_CACHE_STEP_COEFFS;
+        break;
+    }
+
+    // give way to the other low priority callbacks before the next step
+    PIOS_CALLBACKSCHEDULER_Dispatch(Cache->callback);
+}
+
 int WMM_Geomag(WMMtype_CoordSpherical *CoordSpherical, WMMtype_CoordGeodetic *CoordGeodetic, WMMtype_GeoMagneticElements *GeoMagneticElements)
 /*
    The main subroutine that calls a sequence of WMM sub-functions to calculate the magnetic field elements for a single point.
@@ -353,13 +664,13 @@ int WMM_Geomag(WMMtype_CoordSpherical *CoordSpherical, WMMtype_CoordGeodetic *Co
     // ********
 
     if (returned >= 0) { // Compute Spherical Harmonic variables
-        if (WMM_ComputeSphericalHarmonicVariables(CoordSpherical, MagneticModel->nMax, SphVariables) < 0) {
+        if (WMM_ComputeSphericalHarmonicVariables(CoordSpherical, MagneticModel.nMax, SphVariables) < 0) {
             returned = -2; // error
         }
     }
 
     if (returned >= 0) { // Compute ALF
-        if (WMM_AssociatedLegendreFunction(CoordSpherical, MagneticModel->nMax, LegendreFunction) < 0) {
+        if (WMM_AssociatedLegendreFunction(CoordSpherical, MagneticModel.nMax, LegendreFunction) < 0) {
             returned = -3; // error
         }
     }
@@ -449,9 +760,9 @@ int WMM_ComputeSphericalHarmonicVariables(WMMtype_CoordSpherical *CoordSpherical
     /* for n = 0 ... model_order, compute (Radius of Earth / Spherica radius r)^(n+2)
        for n  1..nMax-1 (this is much faster than calling pow MAX_N+1 times).      */
 
-    SphVariables->RelativeRadiusPower[0] = (Ellip->re / CoordSpherical->r) * (Ellip->re / CoordSpherical->r);
+    SphVariables->RelativeRadiusPower[0] = (Ellip.re / CoordSpherical->r) * (Ellip.re / CoordSpherical->r);
     for (n = 1; n <= nMax; n++) {
-        SphVariables->RelativeRadiusPower[n] = SphVariables->RelativeRadiusPower[n - 1] * (Ellip->re / CoordSpherical->r);
+        SphVariables->RelativeRadiusPower[n] = SphVariables->RelativeRadiusPower[n - 1] * (Ellip.re / CoordSpherical->r);
     }
 
     /*
@@ -536,7 +847,7 @@ int WMM_Summation(WMMtype_LegendreFunction *LegendreFunction,
     MagneticResults->By = 0.0f;
     MagneticResults->Bx = 0.0f;
 
-    for (n = 1; n <= MagneticModel->nMax; n++) {
+    for (n = 1; n <= MagneticModel.nMax; n++) {
         for (m = 0; m <= n; m++) {
             index = (n * (n + 1) / 2 + m);
 
@@ -607,13 +918,13 @@ int WMM_SecVarSummation(WMMtype_LegendreFunction *LegendreFunction,
     uint16_t m, n, index;
     float cos_phi;
 
-    MagneticModel->SecularVariationUsed = TRUE;
+    MagneticModel.SecularVariationUsed = TRUE;
 
     MagneticResults->Bz = 0.0f;
     MagneticResults->By = 0.0f;
     MagneticResults->Bx = 0.0f;
 
-    for (n = 1; n <= MagneticModel->nMaxSecVar; n++) {
+    for (n = 1; n <= MagneticModel.nMaxSecVar; n++) {
         for (m = 0; m <= n; m++) {
             index = (n * (n + 1) / 2 + m);
 
@@ -964,15 +1275,27 @@ int WMM_PcupLow(float *Pcup, float *dPcup, float x, uint16_t nMax)
    the Associated Legendre Functions.
  */
 {
-    uint16_t n, m, index, index1, index2;
-    float k, z;
-
     float *schmidtQuasiNorm = (float *)MALLOC(sizeof(float) * NUMPCUP);
 
     if (!schmidtQuasiNorm) { // memory allocation error
         return -1;
     }
 
+    WMM_PcupLowGauss(Pcup, dPcup, x, nMax);
+    WMM_SchmidtQuasiNorm(schmidtQuasiNorm, nMax);
+    WMM_PcupToSchmidt(Pcup, dPcup, schmidtQuasiNorm, nMax);
+
+    FREE(schmidtQuasiNorm);
+
+    return 0; // OK
+}
+
+void WMM_PcupLowGauss(float *Pcup, float *dPcup, float x, uint16_t nMax)
+// Gauss-normalized associated Legendre functions, see WMM_PcupLow
+{
+    uint16_t n, m, index, index1, index2;
+    float k, z;
+
     Pcup[0]  = 1.0f;
     dPcup[0] = 0.0f;
 
@@ -1006,6 +1329,13 @@ int WMM_PcupLow(float *Pcup, float *dPcup, float x, uint16_t nMax)
             }
         }
     }
+}
+
+void WMM_SchmidtQuasiNorm(float *schmidtQuasiNorm, uint16_t nMax)
+// Ratios between the Gauss and Schmidt normalisations, these only depend on nMax
+{
+    uint16_t n, m, index, index1;
+
 /*Compute the ration between the Gauss-normalized associated Legendre
    functions and the Schmidt quasi-normalized version. This is equivalent to
    sqrt((m==0?1:2)*(n-m)!/(n+m!))*(2n-1)!!/(n-m)!  */
@@ -1023,6 +1353,12 @@ int WMM_PcupLow(float *Pcup, float *dPcup, float x, uint16_t nMax)
             schmidtQuasiNorm[index] = schmidtQuasiNorm[index1] * sqrtf((float)((n - m + 1) * (m == 1 ? 2 : 1)) / (float)(n + m));
         }
     }
+}
+
+void WMM_PcupToSchmidt(float *Pcup, float *dPcup, const float *schmidtQuasiNorm, uint16_t nMax)
+// Rescales the output of WMM_PcupLowGauss using a table from WMM_SchmidtQuasiNorm
+{
+    uint16_t n, m, index;
 
 /* Converts the  Gauss-normalized associated Legendre
           functions to the Schmidt quasi-normalized version using pre-computed
@@ -1037,10 +1373,6 @@ int WMM_PcupLow(float *Pcup, float *dPcup, float x, uint16_t nMax)
                insted of co-latitude */
         }
     }
-
-    FREE(schmidtQuasiNorm);
-
-    return 0; // OK
 }
 
 int WMM_SummationSpecial(WMMtype_SphericalHarmonicVariables *
@@ -1073,7 +1405,7 @@ int WMM_SummationSpecial(WMMtype_SphericalHarmonicVariables *
     MagneticResults->By = 0.0f;
     sin_phi = sinf(DEG2RAD(CoordSpherical->phig));
 
-    for (n = 1; n <= MagneticModel->nMax; n++) {
+    for (n = 1; n <= MagneticModel.nMax; n++) {
         /*Compute the ration between the Gauss-normalized associated Legendre
            functions and the Schmidt quasi-normalized version. This is equivalent to
            sqrt((m==0?1:2)*(n-m)!/(n+m!))*(2n-1)!!/(n-m)!  */
@@ -1135,7 +1467,7 @@ int WMM_SecVarSummationSpecial(WMMtype_SphericalHarmonicVariables *
     MagneticResults->By = 0.0f;
     sin_phi = sinf(DEG2RAD(CoordSpherical->phig));
 
-    for (n = 1; n <= MagneticModel->nMaxSecVar; n++) {
+    for (n = 1; n <= MagneticModel.nMaxSecVar; n++) {
         index = (n * (n + 1) / 2 + 1);
         schmidtQuasiNorm2 = schmidtQuasiNorm1 * (float)(2 * n - 1) / (float)n;
         schmidtQuasiNorm3 = schmidtQuasiNorm2 * sqrtf((float)(n * 2) / (float)(n + 1));
@@ -1173,25 +1505,10 @@ float WMM_get_main_field_coeff_g(uint16_t index)
         return 0;
     }
 
-    uint16_t n, m, sum_index, a, b;
-
     float coeff = CoeffFile[index][2];
 
-    a = MagneticModel->nMaxSecVar;
-    b = (a * (a + 1) / 2 + a);
-    for (n = 1; n <= MagneticModel->nMax; n++) {
-        for (m = 0; m <= n; m++) {
-            sum_index = (n * (n + 1) / 2 + m);
-
-            /* Hacky for now, will solve for which conditions need summing analytically */
-            if (sum_index != index) {
-                continue;
-            }
-
-            if (index <= b) {
-                coeff += (decimal_date - MagneticModel->epoch) * WMM_get_secular_var_coeff_g(sum_index);
-            }
-        }
+    if (index >= 1 && index <= WMM_SECULAR_VARIATION_TERMS) {
+        coeff += (decimal_date - MagneticModel.epoch) * WMM_get_secular_var_coeff_g(index);
     }
 
     return coeff;
@@ -1203,24 +1520,10 @@ float WMM_get_main_field_coeff_h(uint16_t index)
         return 0;
     }
 
-    uint16_t n, m, sum_index, a, b;
     float coeff = CoeffFile[index][3];
 
-    a = MagneticModel->nMaxSecVar;
-    b = (a * (a + 1) / 2 + a);
-    for (n = 1; n <= MagneticModel->nMax; n++) {
-        for (m = 0; m <= n; m++) {
-            sum_index = (n * (n + 1) / 2 + m);
-
-            /* Hacky for now, will solve for which conditions need summing analytically */
-            if (sum_index != index) {
-                continue;
-            }
-
-            if (index <= b) {
-                coeff += (decimal_date - MagneticModel->epoch) * WMM_get_secular_var_coeff_h(sum_index);
-            }
-        }
+    if (index >= 1 && index <= WMM_SECULAR_VARIATION_TERMS) {
+        coeff += (decimal_date - MagneticModel.epoch) * WMM_get_secular_var_coeff_h(index);
     }
 
     return coeff;
@@ -1246,6 +1549,12 @@ float WMM_get_secular_var_coeff_h(uint16_t index)
 
 int WMM_DateToYear(uint16_t month, uint16_t day, uint16_t year)
 // Converts a given calendar date into a decimal year
+{
+    return WMM_DecimalYear(month, day, year, &decimal_date);
+}
+
+int WMM_DecimalYear(uint16_t month, uint16_t day, uint16_t year, float *DecimalYear)
+// Converts a given calendar date into a decimal year without touching decimal_date
 {
     uint16_t temp     = 0;      // Total number of days
     uint16_t MonthDays[13] = { 0, 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
@@ -1271,7 +1580,7 @@ int WMM_DateToYear(uint16_t month, uint16_t day, uint16_t year)
     }
     temp += day;
 
-    decimal_date = year + (temp - 1) / (365.0f + ExtraDay);
+    *DecimalYear = year + (temp - 1) / (365.0f + ExtraDay);
 
     return 0; // OK
 }
@@ -1288,12 +1597,12 @@ int WMM_GeodeticToSpherical(WMMtype_CoordGeodetic *CoordGeodetic, WMMtype_CoordS
     SinLat = sinf(DEG2RAD(CoordGeodetic->phi));
 
     // compute the local radius of curvature on the WGS-84 reference ellipsoid
-    rc     = Ellip->a / sqrtf(1.0f - Ellip->epssq * SinLat * SinLat);
+    rc     = Ellip.a / sqrtf(1.0f - Ellip.epssq * SinLat * SinLat);
 
     // compute ECEF Cartesian coordinates of specified point (for longitude=0)
 
     xp = (rc + CoordGeodetic->HeightAboveEllipsoid) * CosLat;
-    zp = (rc * (1.0f - Ellip->epssq) + CoordGeodetic->HeightAboveEllipsoid) * SinLat;
+    zp = (rc * (1.0f - Ellip.epssq) + CoordGeodetic->HeightAboveEllipsoid) * SinLat;
 
     // compute spherical radius and angle lambda and phi of specified point
 
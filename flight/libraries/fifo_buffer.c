@@ -168,6 +168,21 @@ uint16_t fifoBuf_getDataPeek(t_fifo_buffer *buf, void *data, uint16_t len)
     return i; // return number of bytes copied
 }
 
+uint16_t fifoBuf_getDataSpan(t_fifo_buffer *buf, uint8_t * *data)
+{ // get a pointer to the contiguous data at the read position without removing it
+    uint16_t rd = buf->rd;
+    uint16_t wr = buf->wr;
+    uint16_t buf_size = buf->buf_size;
+
+    *data = buf->buf_ptr + rd;
+
+    if (wr < rd) {
+        return buf_size - rd; // data wraps, return the part up to the end of the buffer
+    }
+
+    return wr - rd; // return number of contiguous bytes
+}
+
 uint16_t fifoBuf_getData(t_fifo_buffer *buf, void *data, uint16_t len)
 { // get data from our rx buffer
     uint16_t rd        = buf->rd;
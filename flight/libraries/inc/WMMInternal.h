@@ -36,6 +36,7 @@
 #define NUMTERMS                                91             // ((WMM_MAX_MODEL_DEGREES+1)*(WMM_MAX_MODEL_DEGREES+2)/2);
 #define NUMPCUP                                 92              // NUMTERMS +1
 #define NUMPCUPS                                13             // WMM_MAX_MODEL_DEGREES +1
+#define WMM_SECULAR_VARIATION_TERMS             90             // last index with secular variation: n*(n+1)/2+n for n = WMM_MAX_SECULAR_VARIATION_MODEL_DEGREES
 
 // internal structure definitions
 typedef struct {
@@ -119,6 +120,7 @@ typedef struct {
 void WMM_Set_Coeff_Array();
 int WMM_GeodeticToSpherical(WMMtype_CoordGeodetic *CoordGeodetic, WMMtype_CoordSpherical *CoordSpherical);
 int WMM_DateToYear(uint16_t month, uint16_t day, uint16_t year);
+int WMM_DecimalYear(uint16_t month, uint16_t day, uint16_t year, float *DecimalYear);
 int WMM_Geomag(WMMtype_CoordSpherical *CoordSpherical,
                WMMtype_CoordGeodetic *CoordGeodetic, WMMtype_GeoMagneticElements *GeoMagneticElements);
 
@@ -132,6 +134,9 @@ int WMM_ComputeSphericalHarmonicVariables(WMMtype_CoordSpherical *
                                           CoordSpherical, uint16_t nMax, WMMtype_SphericalHarmonicVariables *SphVariables);
 
 int WMM_PcupLow(float *Pcup, float *dPcup, float x, uint16_t nMax);
+void WMM_PcupLowGauss(float *Pcup, float *dPcup, float x, uint16_t nMax);
+void WMM_SchmidtQuasiNorm(float *schmidtQuasiNorm, uint16_t nMax);
+void WMM_PcupToSchmidt(float *Pcup, float *dPcup, const float *schmidtQuasiNorm, uint16_t nMax);
 
 int WMM_PcupHigh(float *Pcup, float *dPcup, float x, uint16_t nMax);
 
@@ -31,4 +31,9 @@
 int WMM_Initialize();
 int WMM_GetMagVector(float Lat, float Lon, float AltEllipsoid, uint16_t Month, uint16_t Day, uint16_t Year, float B[3]);
 
+// Cached evaluator, linearized around a reference point that a low priority callback keeps up to date
+int WMM_CacheInitialize(float radius);
+void WMM_CacheSetRadius(float radius);
+int WMM_GetMagVectorCached(float Lat, float Lon, float AltEllipsoid, uint16_t Month, uint16_t Day, uint16_t Year, float B[3]);
+
 #endif /* WORLDMAGMODEL_H_ */
@@ -51,6 +51,7 @@ int16_t fifoBuf_getBytePeek(t_fifo_buffer *buf);
 int16_t fifoBuf_getByte(t_fifo_buffer *buf);
 
 uint16_t fifoBuf_getDataPeek(t_fifo_buffer *buf, void *data, uint16_t len);
+uint16_t fifoBuf_getDataSpan(t_fifo_buffer *buf, uint8_t * *data);
 uint16_t fifoBuf_getData(t_fifo_buffer *buf, void *data, uint16_t len);
 
 uint16_t fifoBuf_putByte(t_fifo_buffer *buf, const uint8_t b);
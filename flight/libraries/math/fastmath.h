@@ -0,0 +1,310 @@
+/**
+ ******************************************************************************
+ * @addtogroup OpenPilot Math Utilities
+ * @{
+ * @addtogroup Reuseable math functions
+ * @{
+ *
+ * @file       fastmath.h
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2014.
+ * @brief      Table free polynomial sin/cos/atan2/asin/acos/sqrt/invsqrt
+ *
+ *             Every function comes in two accuracy tiers, the libm function is
+ *             the third:
+ *
+ *             fast_xxx_coarse()  guidance, mixing, anything that ends up in whole
+ *                                degrees or percent. Cheapest.
+ *             fast_xxx()         estimator and attitude math, within a few float
+ *                                ulp of libm.
+ *
+ *             Maximum absolute errors, measured against double precision libm
+ *             over the whole argument range by flight/tests/math:
+ *
+ *                                coarse      fine
+ *             sin, cos           1.1e-5      2.0e-7      |x| <= 1e4 rad
+ *             atan2              8.2e-5      3.5e-7      rad
+ *             asin, acos         3.9e-5      4.0e-7      rad, argument clamped to [-1, 1]
+ *             invsqrt            1.8e-3      1.2e-7      relative
+ *
+ *             sqrt has no tiers, it is the VSQRT instruction on the F4 and sqrtf()
+ *             elsewhere. Angles are in radians, use DEG2RAD() for degrees.
+ *             Replaces the 1 degree resolution table of sin_lookup.c (error up to
+ *             8.7e-3).
+ *
+ * @see        The GNU Public License (GPL) Version 3
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef FASTMATH_H
+#define FASTMATH_H
+
+#include <math.h>
+#include <stdint.h>
+
+#define FAST_PI        3.14159265358979f
+#define FAST_PI_2      1.57079632679490f
+#define FAST_2_PI      0.63661977236758f // 2 / pi
+// pi/2 split in two parts for the range reduction. FAST_PI_2_HI has only 8
+// significant bits, so k * FAST_PI_2_HI is exact for every quadrant count k < 2^16
+#define FAST_PI_2_HI   1.5703125f
+#define FAST_PI_2_LO   4.838267948966e-4f
+
+#if defined(__ARM_FP) && (__ARM_FP & 0x4)
+#define FAST_SQRTF(x) __builtin_sqrtf(x)
+#else
+#define FAST_SQRTF(x) sqrtf(x)
+#endif
+
+/**
+ * sin and cos
+ */
+
+// reduces x to r in [-pi/4, pi/4], returns the quadrant of x
+static inline int32_t fast_reduce_quadrant(float x, float *r)
+{
+    // float to int conversion truncates, round to nearest by hand instead of rintf()
+    const int32_t k = (int32_t)(x * FAST_2_PI + (x >= 0.0f ? 0.5f : -0.5f));
+    const float kf  = (float)k;
+
+    *r = (x - kf * FAST_PI_2_HI) - kf * FAST_PI_2_LO;
+    return k;
+}
+
+// minimax polynomials on [-pi/4, pi/4]
+static inline float fast_sin_poly_coarse(float r)
+{
+    const float r2 = r * r;
+
+    return r * (9.999949974e-01f + r2 * (-1.666016187e-01f + r2 * 8.121556063e-03f));
+}
+
+static inline float fast_cos_poly_coarse(float r)
+{
+    const float r2 = r * r;
+
+    return 9.999900346e-01f + r2 * (-4.997081340e-01f + r2 * 4.039852268e-02f);
+}
+
+static inline float fast_sin_poly(float r)
+{
+    const float r2 = r * r;
+
+    return r * (9.999999862e-01f + r2 * (-1.666663675e-01f + r2 * (8.331584583e-03f + r2 * -1.946211448e-04f)));
+}
+
+static inline float fast_cos_poly(float r)
+{
+    const float r2 = r * r;
+
+    return 9.999999724e-01f + r2 * (-4.999985669e-01f + r2 * (4.165502671e-02f + r2 * -1.358590622e-03f));
+}
+
+// picks sin/cos of the reduced angle by quadrant
+static inline void fast_sincos_quadrant(int32_t k, float s, float c, float *sin_out, float *cos_out)
+{
+    switch (k & 3) {
+    case 0:
+        *sin_out = s;
+        *cos_out = c;
+        break;
+    case 1:
+        *sin_out = c;
+        *cos_out = -s;
+        break;
+    case 2:
+        *sin_out = -s;
+        *cos_out = -c;
+        break;
+    default:
+        *sin_out = -c;
+        *cos_out = s;
+        break;
+    }
+}
+
+static inline void fast_sincosf_coarse(float x, float *s, float *c)
+{
+    float r;
+    const int32_t k = fast_reduce_quadrant(x, &r);
+
+    fast_sincos_quadrant(k, fast_sin_poly_coarse(r), fast_cos_poly_coarse(r), s, c);
+}
+
+static inline void fast_sincosf(float x, float *s, float *c)
+{
+    float r;
+    const int32_t k = fast_reduce_quadrant(x, &r);
+
+    fast_sincos_quadrant(k, fast_sin_poly(r), fast_cos_poly(r), s, c);
+}
+
+static inline float fast_sinf_coarse(float x)
+{
+    float r;
+    const int32_t k = fast_reduce_quadrant(x, &r);
+    const float v   = (k & 1) ? fast_cos_poly_coarse(r) : fast_sin_poly_coarse(r);
+
+    return (k & 2) ? -v : v;
+}
+
+static inline float fast_cosf_coarse(float x)
+{
+    float r;
+    const int32_t k = fast_reduce_quadrant(x, &r);
+    const float v   = (k & 1) ? fast_sin_poly_coarse(r) : fast_cos_poly_coarse(r);
+
+    return ((k + 1) & 2) ? -v : v;
+}
+
+static inline float fast_sinf(float x)
+{
+    float r;
+    const int32_t k = fast_reduce_quadrant(x, &r);
+    const float v   = (k & 1) ? fast_cos_poly(r) : fast_sin_poly(r);
+
+    return (k & 2) ? -v : v;
+}
+
+static inline float fast_cosf(float x)
+{
+    float r;
+    const int32_t k = fast_reduce_quadrant(x, &r);
+    const float v   = (k & 1) ? fast_sin_poly(r) : fast_cos_poly(r);
+
+    return ((k + 1) & 2) ? -v : v;
+}
+
+/**
+ * atan2
+ */
+
+// minimax polynomials of atan(t) / t in t^2, t in [-1, 1]
+static inline float fast_atan_poly_coarse(float t)
+{
+    const float t2 = t * t;
+
+    return t * (9.992136399e-01f + t2 * (-3.211734844e-01f + t2 * (1.462613403e-01f + t2 * -3.898465692e-02f)));
+}
+
+static inline float fast_atan_poly(float t)
+{
+    const float t2 = t * t;
+
+    return t * (9.999993354e-01f + t2 * (-3.332986009e-01f + t2 * (1.994655792e-01f + t2 * (-1.390859159e-01f
+                                                                                          + t2 * (9.642102108e-02f + t2 * (-5.591105156e-02f + t2 * (2.186209023e-02f + t2 * -4.054331516e-03f)))))));
+}
+
+// folds atan(min/max) of the first octant out to all four quadrants
+static inline float fast_atan2_octant(float y, float x, float a, int swapped)
+{
+    if (swapped) {
+        a = FAST_PI_2 - a;
+    }
+    if (x < 0.0f) {
+        a = FAST_PI - a;
+    }
+    return (y < 0.0f) ? -a : a;
+}
+
+static inline float fast_atan2f_coarse(float y, float x)
+{
+    const float ax = fabsf(x), ay = fabsf(y);
+    const int swapped = ay > ax;
+    const float mx    = swapped ? ay : ax;
+
+    if (mx == 0.0f) {
+        return fast_atan2_octant(y, x, 0.0f, 0);
+    }
+    return fast_atan2_octant(y, x, fast_atan_poly_coarse((swapped ? ax : ay) / mx), swapped);
+}
+
+static inline float fast_atan2f(float y, float x)
+{
+    const float ax = fabsf(x), ay = fabsf(y);
+    const int swapped = ay > ax;
+    const float mx    = swapped ? ay : ax;
+
+    if (mx == 0.0f) {
+        return fast_atan2_octant(y, x, 0.0f, 0);
+    }
+    return fast_atan2_octant(y, x, fast_atan_poly((swapped ? ax : ay) / mx), swapped);
+}
+
+/**
+ * asin and acos, acos(x) = sqrt(1 - x) * P(x) on [0, 1]. Arguments outside
+ * [-1, 1] are clamped instead of returning NaN, rounding in a rotation matrix
+ * element must not turn an attitude into NaN.
+ */
+static inline float fast_acosf_coarse(float x)
+{
+    const float ax = (fabsf(x) < 1.0f) ? fabsf(x) : 1.0f;
+    const float a  = FAST_SQRTF(1.0f - ax) * (1.570758336e+00f + ax * (-2.128749960e-01f + ax * (7.689669013e-02f + ax * -2.089144994e-02f)));
+
+    return (x < 0.0f) ? FAST_PI - a : a;
+}
+
+static inline float fast_acosf(float x)
+{
+    const float ax = (fabsf(x) < 1.0f) ? fabsf(x) : 1.0f;
+    const float a  = FAST_SQRTF(1.0f - ax) * (1.570796314e+00f + ax * (-2.145998922e-01f + ax * (8.899925915e-02f + ax * (-5.031274330e-02f
+                                                                                                                             + ax * (3.133533469e-02f + ax * (-1.780875984e-02f + ax * (7.245266785e-03f + ax * -1.441423002e-03f)))))));
+
+    return (x < 0.0f) ? FAST_PI - a : a;
+}
+
+static inline float fast_asinf_coarse(float x)
+{
+    const float a = FAST_PI_2 - fast_acosf_coarse(fabsf(x));
+
+    return (x < 0.0f) ? -a : a;
+}
+
+static inline float fast_asinf(float x)
+{
+    const float a = FAST_PI_2 - fast_acosf(fabsf(x));
+
+    return (x < 0.0f) ? -a : a;
+}
+
+/**
+ * sqrt and 1/sqrt
+ */
+static inline float fast_sqrtf(float x)
+{
+    return FAST_SQRTF(x);
+}
+
+// bit trick start value and one Newton step, x > 0
+static inline float fast_invsqrtf_coarse(float x)
+{
+    union {
+        float    f;
+        uint32_t i;
+    } v = { x };
+
+    v.i = 0x5f375a86u - (v.i >> 1);
+    return v.f * (1.5f - 0.5f * x * v.f * v.f);
+}
+
+// hardware square root and a division beat two more Newton steps on the F4
+static inline float fast_invsqrtf(float x)
+{
+    return 1.0f / FAST_SQRTF(x);
+}
+
+#endif /* FASTMATH_H */
@@ -0,0 +1,260 @@
+/**
+ ******************************************************************************
+ * @addtogroup OpenPilot Math Utilities
+ * @{
+ * @addtogroup Reuseable math functions
+ * @{
+ *
+ * @file       math3d.h
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2014.
+ * @brief      Inline 3-axis vector, rotation matrix and quaternion kernels
+ *
+ *             Drop-in replacements for the hot helpers of CoordinateConversions.c
+ *             (quat_mult, rot_mult, Quaternion2R, RPY2Quaternion, ...) that the
+ *             compiler can inline into the estimator and control loops, plus batched
+ *             variants that rotate a whole array of samples with one matrix.
+ *             Same conventions as CoordinateConversions: q = [q0 q1 q2 q3] with q0
+ *             the scalar part, R is the earth to body matrix Rbe, first index is row.
+ *
+ * @see        The GNU Public License (GPL) Version 3
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef MATH3D_H
+#define MATH3D_H
+
+#include <math.h>
+#include <stdint.h>
+#include "fastmath.h"
+
+// The Cortex-M4 FPU (fpv4-sp-d16) has a fused multiply-accumulate and a hardware
+// square root. The builtins map straight onto VFMA.F32 / VSQRT.F32 there and skip
+// the errno handling of sqrtf(). Everywhere else (simposix, unit tests) the plain
+// C expressions are used.
+#if defined(__ARM_FEATURE_FMA) && defined(__ARM_FP) && (__ARM_FP & 0x4)
+#define M3D_FMA(a, b, c) __builtin_fmaf((a), (b), (c))
+#else
+#define M3D_FMA(a, b, c) ((a) * (b) + (c))
+#endif
+
+#define M3D_SQRTF(x)     FAST_SQRTF(x)
+
+// a[0]*b[0] + a[1]*b[1] + a[2]*b[2]
+#define M3D_DOT3(a0, a1, a2, b0, b1, b2) M3D_FMA((a2), (b2), M3D_FMA((a1), (b1), (a0) * (b0)))
+
+/**
+ * Vector helpers
+ */
+static inline float m3d_vec_dot(const float a[3], const float b[3])
+{
+    return M3D_DOT3(a[0], a[1], a[2], b[0], b[1], b[2]);
+}
+
+static inline void m3d_vec_cross(const float a[3], const float b[3], float out[3])
+{
+    const float x = a[1] * b[2] - a[2] * b[1];
+    const float y = a[2] * b[0] - a[0] * b[2];
+    const float z = a[0] * b[1] - a[1] * b[0];
+
+    out[0] = x;
+    out[1] = y;
+    out[2] = z;
+}
+
+static inline float m3d_vec_length(const float v[3])
+{
+    return M3D_SQRTF(m3d_vec_dot(v, v));
+}
+
+// scales v to unit length and returns its previous length, leaves a zero vector alone
+static inline float m3d_vec_normalize(float v[3])
+{
+    const float len = m3d_vec_length(v);
+
+    if (len > 1e-30f) {
+        const float inv = 1.0f / len;
+        v[0] *= inv;
+        v[1] *= inv;
+        v[2] *= inv;
+    }
+    return len;
+}
+
+/**
+ * Quaternion helpers
+ */
+
+// qout = q1 * q2, same as quat_mult(). qout may alias q1 or q2.
+static inline void m3d_quat_mult(const float q1[4], const float q2[4], float qout[4])
+{
+    const float w = q1[0] * q2[0] - q1[1] * q2[1] - q1[2] * q2[2] - q1[3] * q2[3];
+    const float x = q1[0] * q2[1] + q1[1] * q2[0] + q1[2] * q2[3] - q1[3] * q2[2];
+    const float y = q1[0] * q2[2] - q1[1] * q2[3] + q1[2] * q2[0] + q1[3] * q2[1];
+    const float z = q1[0] * q2[3] + q1[1] * q2[2] - q1[2] * q2[1] + q1[3] * q2[0];
+
+    qout[0] = w;
+    qout[1] = x;
+    qout[2] = y;
+    qout[3] = z;
+}
+
+static inline void m3d_quat_normalize(float q[4])
+{
+    const float len = M3D_SQRTF(M3D_FMA(q[3], q[3], M3D_DOT3(q[0], q[1], q[2], q[0], q[1], q[2])));
+
+    if (len > 1e-30f) {
+        const float inv = 1.0f / len;
+        q[0] *= inv;
+        q[1] *= inv;
+        q[2] *= inv;
+        q[3] *= inv;
+    }
+}
+
+// Rbe from q, same as Quaternion2R()
+static inline void m3d_quat2R(const float q[4], float Rbe[3][3])
+{
+    const float q0s = q[0] * q[0], q1s = q[1] * q[1], q2s = q[2] * q[2], q3s = q[3] * q[3];
+
+    Rbe[0][0] = q0s + q1s - q2s - q3s;
+    Rbe[0][1] = 2.0f * (q[1] * q[2] + q[0] * q[3]);
+    Rbe[0][2] = 2.0f * (q[1] * q[3] - q[0] * q[2]);
+    Rbe[1][0] = 2.0f * (q[1] * q[2] - q[0] * q[3]);
+    Rbe[1][1] = q0s - q1s + q2s - q3s;
+    Rbe[1][2] = 2.0f * (q[2] * q[3] + q[0] * q[1]);
+    Rbe[2][0] = 2.0f * (q[1] * q[3] + q[0] * q[2]);
+    Rbe[2][1] = 2.0f * (q[2] * q[3] - q[0] * q[1]);
+    Rbe[2][2] = q0s - q1s - q2s + q3s;
+}
+
+// q from roll, pitch, yaw in degrees, same as RPY2Quaternion()
+static inline void m3d_rpy2quat(const float rpy[3], float q[4])
+{
+    const float deg2rad_2 = (float)(M_PI / 360.0);
+    const float phi   = rpy[0] * deg2rad_2;
+    const float theta = rpy[1] * deg2rad_2;
+    const float psi   = rpy[2] * deg2rad_2;
+    float cphi, sphi, ctheta, stheta, cpsi, spsi;
+
+    fast_sincosf(phi, &sphi, &cphi);
+    fast_sincosf(theta, &stheta, &ctheta);
+    fast_sincosf(psi, &spsi, &cpsi);
+
+    const float cc    = cphi * ctheta, ss = sphi * stheta;
+    const float sc    = sphi * ctheta, cs = cphi * stheta;
+
+    q[0] = M3D_FMA(ss, spsi, cc * cpsi);
+    q[1] = sc * cpsi - cs * spsi;
+    q[2] = M3D_FMA(sc, spsi, cs * cpsi);
+    q[3] = cc * spsi - ss * cpsi;
+
+    if (q[0] < 0.0f) { // q0 always positive for uniqueness
+        q[0] = -q[0];
+        q[1] = -q[1];
+        q[2] = -q[2];
+        q[3] = -q[3];
+    }
+}
+
+/**
+ * Rotations
+ */
+
+// out = R * v, same as rot_mult(). out may alias v.
+static inline void m3d_rot_mult(float R[3][3], const float v[3], float out[3])
+{
+    const float x = M3D_DOT3(R[0][0], R[0][1], R[0][2], v[0], v[1], v[2]);
+    const float y = M3D_DOT3(R[1][0], R[1][1], R[1][2], v[0], v[1], v[2]);
+    const float z = M3D_DOT3(R[2][0], R[2][1], R[2][2], v[0], v[1], v[2]);
+
+    out[0] = x;
+    out[1] = y;
+    out[2] = z;
+}
+
+// out = R' * v, i.e. body to earth with Rbe. out may alias v.
+static inline void m3d_rot_mult_transpose(float R[3][3], const float v[3], float out[3])
+{
+    const float x = M3D_DOT3(R[0][0], R[1][0], R[2][0], v[0], v[1], v[2]);
+    const float y = M3D_DOT3(R[0][1], R[1][1], R[2][1], v[0], v[1], v[2]);
+    const float z = M3D_DOT3(R[0][2], R[1][2], R[2][2], v[0], v[1], v[2]);
+
+    out[0] = x;
+    out[1] = y;
+    out[2] = z;
+}
+
+// out = Rbe(q) * v without building the matrix, cheaper for a single vector.
+// out may alias v.
+static inline void m3d_quat_rotate(const float q[4], const float v[3], float out[3])
+{
+    // Rbe rotates by the conjugate of q: t = 2 (v x qv), out = v + q0 t - qv x t
+    const float tx = 2.0f * (v[1] * q[3] - v[2] * q[2]);
+    const float ty = 2.0f * (v[2] * q[1] - v[0] * q[3]);
+    const float tz = 2.0f * (v[0] * q[2] - v[1] * q[1]);
+
+    const float x  = M3D_FMA(q[0], tx, v[0]) - (q[2] * tz - q[3] * ty);
+    const float y  = M3D_FMA(q[0], ty, v[1]) - (q[3] * tx - q[1] * tz);
+    const float z  = M3D_FMA(q[0], tz, v[2]) - (q[1] * ty - q[2] * tx);
+
+    out[0] = x;
+    out[1] = y;
+    out[2] = z;
+}
+
+/**
+ * Batched rotations, for sensor FIFOs and oversampled buffers.
+ * in and out may be the same array.
+ */
+static inline void m3d_rot_mult_batch(float R[3][3], float in[][3], float out[][3], uint16_t count)
+{
+    // keep the matrix in registers instead of reloading it through R for every sample
+    const float r00 = R[0][0], r01 = R[0][1], r02 = R[0][2];
+    const float r10 = R[1][0], r11 = R[1][1], r12 = R[1][2];
+    const float r20 = R[2][0], r21 = R[2][1], r22 = R[2][2];
+
+    for (uint16_t i = 0; i < count; i++) {
+        const float vx = in[i][0], vy = in[i][1], vz = in[i][2];
+        out[i][0] = M3D_DOT3(r00, r01, r02, vx, vy, vz);
+        out[i][1] = M3D_DOT3(r10, r11, r12, vx, vy, vz);
+        out[i][2] = M3D_DOT3(r20, r21, r22, vx, vy, vz);
+    }
+}
+
+static inline void m3d_rot_mult_transpose_batch(float R[3][3], float in[][3], float out[][3], uint16_t count)
+{
+    float Rt[3][3] = {
+        { R[0][0], R[1][0], R[2][0] },
+        { R[0][1], R[1][1], R[2][1] },
+        { R[0][2], R[1][2], R[2][2] }
+    };
+
+    m3d_rot_mult_batch(Rt, in, out, count);
+}
+
+// Rotates count vectors by Rbe(q). Building the matrix once costs about as much as
+// two m3d_quat_rotate() calls, so this wins from three samples on.
+static inline void m3d_quat_rotate_batch(const float q[4], float in[][3], float out[][3], uint16_t count)
+{
+    float Rbe[3][3];
+
+    m3d_quat2R(q, Rbe);
+    m3d_rot_mult_batch(Rbe, in, out, count);
+}
+
+#endif /* MATH3D_H */
@@ -166,13 +166,27 @@ void pid2_configure(struct pid2 *pid, float kp, float ki, float kd, float Tf, fl
     pid->va   = va;
     pid->vb   = vb;
     pid->kp   = kp;
+    pid->ki   = ki;
+    pid->kd   = kd;
+    pid->kt   = kt;
+    pid->Tf   = Tf;
     pid->beta = beta; // setpoint weight on proportional term
 
-    pid->bi   = ki * dT;
-    pid->br   = kt * dT / vb;
+    pid2_set_dT(pid, dT);
+}
+
+/**
+ * Change the time increment of a configured pid2, the controller state is kept
+ * @param[out] pid The PID2 structure to update
+ * @param[in] dT delta time increment
+ */
+void pid2_set_dT(struct pid2 *pid, float dT)
+{
+    pid->bi = pid->ki * dT;
+    pid->br = pid->kt * dT / pid->vb;
 
-    pid->ad   = Tf / (Tf + dT);
-    pid->bd   = kd / (Tf + dT);
+    pid->ad = pid->Tf / (pid->Tf + dT);
+    pid->bd = pid->kd / (pid->Tf + dT);
 }
 
 /**
@@ -50,6 +50,10 @@ struct pid2 {
     float   va;
     float   vb;
     float   kp;
+    float   ki;
+    float   kd;
+    float   kt;
+    float   Tf;
     float   bi;
     float   ad;
     float   bd;
@@ -77,6 +81,7 @@ void pid_configure_derivative(float cutoff, float gamma);
 
 // Methods for use with pid2 structure
 void pid2_configure(struct pid2 *pid, float kp, float ki, float kd, float Tf, float kt, float dT, float beta, float u0, float va, float vb);
+void pid2_set_dT(struct pid2 *pid, float dT);
 void pid2_transfer(struct pid2 *pid, float u0);
 float pid2_apply(struct pid2 *pid, const float r, const float y, float ulow, float uhigh);
 
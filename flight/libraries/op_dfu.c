@@ -67,6 +67,34 @@ uint32_t downSizeOfLastPacket = 0;
 uint32_t downPacketTotal = 0;
 uint32_t downPacketCurrent    = 0;
 DFUTransfer downType = 0;
+
+#if defined(PIOS_INCLUDE_DFU_STREAM)
+// Stream upload vars
+typedef enum {
+    STREAM_TOKEN,
+    STREAM_LITERAL,
+    STREAM_MATCH,
+    STREAM_COMMAND,
+    STREAM_END,
+    STREAM_ERROR
+} StreamState;
+
+static struct {
+    StreamState state;
+    uint32_t    count; // literal bytes left / match length
+    uint8_t     need; // argument bytes left
+    uint32_t    arg;
+    uint32_t    base; // flash address of output offset 0
+    uint32_t    size; // output limit
+    uint32_t    pos; // output offset
+    uint32_t    word; // output word being assembled
+    uint32_t    sectorStart; // sector of the last word written
+    uint32_t    sectorEnd;
+    bool        sectorErased;
+} stream;
+uint8_t StreamTransfer = 0;
+uint32_t ErasedSectors = 0; // bit n: sector n of the firmware area was erased since EnterDFU
+#endif /* PIOS_INCLUDE_DFU_STREAM */
 /* Extern variables ----------------------------------------------------------*/
 extern DFUStates DeviceState;
 extern uint8_t JumpToApp;
@@ -79,6 +107,11 @@ bool flash_read(uint8_t *buffer, uint32_t adr, DFUProgType type);
 /* Private functions ---------------------------------------------------------*/
 void sendData(uint8_t *buf, uint16_t size);
 uint32_t CalcFirmCRC(void);
+#if defined(PIOS_INCLUDE_DFU_STREAM)
+static bool streamStart(DFUTransfer type, uint32_t eraseMask);
+static void streamByte(uint8_t byte);
+static void sectorCRCs(uint32_t first);
+#endif
 
 void DataDownload(__attribute__((unused)) DownloadAction action)
 {
@@ -162,6 +195,9 @@ void processComand(uint8_t *xReceive_Buffer)
                 OPDfuIni(true);
             }
             DeviceState = DFUidle;
+#if defined(PIOS_INCLUDE_DFU_STREAM)
+            ErasedSectors = 0;
+#endif
             currentProgrammingDestination = devicesTable[Data0].programmingType;
             currentDeviceCanRead  = devicesTable[Data0].readWriteFlags & 0x01;
             currentDeviceCanWrite = devicesTable[Data0].readWriteFlags >> 1
@@ -193,9 +229,23 @@ void processComand(uint8_t *xReceive_Buffer)
                 Next_Packet      = 1;
                 Expected_CRC     = unpack_uint32(&xReceive_Buffer[DATA + 2]);
                 SizeOfLastPacket = Data1;
+#if defined(PIOS_INCLUDE_DFU_STREAM)
+                StreamTransfer   = (unpack_uint32(&xReceive_Buffer[DATA + 6]) == DFU_UPLOAD_STREAM_MAGIC)
+                                   && (currentProgrammingDestination == Self_flash);
 
+                if (StreamTransfer) {
+                    // the stream is bounds checked while it is decoded, the
+                    // sectors it writes are erased here, before any data
+                    if (streamStart(TransferType, unpack_uint32(&xReceive_Buffer[DATA + 10]))) {
+                        DeviceState = uploading;
+                    } else {
+                        DeviceState = Last_operation_failed;
+                        Aditionals  = (uint32_t)Command;
+                    }
+                } else
+#endif
                 if (isBiggerThanAvailable(TransferType, (SizeOfTransfer - 1)
-                                          * 14 * 4 + SizeOfLastPacket * 4) == true) {
+                                                 * 14 * 4 + SizeOfLastPacket * 4) == true) {
                     DeviceState = outsideDevCapabilities;
                     Aditionals  = (uint32_t)Command;
                 } else {
@@ -204,6 +254,9 @@ void processComand(uint8_t *xReceive_Buffer)
                         switch (currentProgrammingDestination) {
                         case Self_flash:
                             result = PIOS_BL_HELPER_FLASH_Start();
+#if defined(PIOS_INCLUDE_DFU_STREAM)
+                            ErasedSectors = 0xFFFFFFFF;
+#endif
                             break;
                         case Remote_flash_via_spi:
                             result = false;
@@ -233,6 +286,16 @@ void processComand(uint8_t *xReceive_Buffer)
                     uint32_t aux;;
                     switch (currentProgrammingDestination) {
                     case Self_flash:
+#if defined(PIOS_INCLUDE_DFU_STREAM)
+                        if (StreamTransfer) {
+                            // host order bytes, see DFUObject::CopyWords()
+                            for (uint8_t x = 0; x < numberOfWords * 4; ++x) {
+                                streamByte(xReceive_Buffer[DATA + (x & ~3) + 3 - (x & 3)]);
+                            }
+                            result = (stream.state != STREAM_ERROR) ? 1 : 0;
+                            break;
+                        }
+#endif
                         for (uint8_t x = 0; x < numberOfWords; ++x) {
                             offset = 4 * x;
                             Data   = unpack_uint32(&xReceive_Buffer[DATA + offset]);
@@ -297,6 +360,9 @@ void processComand(uint8_t *xReceive_Buffer)
             pack_uint32(devicesTable[Data0 - 1].FW_Crc, &Buffer[10]);
             Buffer[14] = devicesTable[Data0 - 1].devID >> 8;
             Buffer[15] = devicesTable[Data0 - 1].devID;
+#if defined(PIOS_INCLUDE_DFU_STREAM)
+            Buffer[16] = (devicesTable[Data0 - 1].programmingType == Self_flash) ? DFU_FEATURE_STREAM : 0;
+#endif
         }
         sendData(Buffer + 1, 63);
         break;
@@ -325,6 +391,12 @@ void processComand(uint8_t *xReceive_Buffer)
         if (DeviceState == uploading) {
             if (Next_Packet - 1 == SizeOfTransfer) {
                 Next_Packet = 0;
+#if defined(PIOS_INCLUDE_DFU_STREAM)
+                if (StreamTransfer && (stream.state != STREAM_END)) {
+                    DeviceState = Last_operation_failed;
+                    Aditionals  = (uint32_t)Command;
+                } else
+#endif
                 if ((TransferType != FW) || (Expected_CRC == CalcFirmCRC())) {
                     DeviceState = Last_operation_Success;
                 } else {
@@ -379,12 +451,246 @@ void processComand(uint8_t *xReceive_Buffer)
     case Status_Rep:
 
         break;
+#if defined(PIOS_INCLUDE_DFU_STREAM)
+    case Req_SectorCRCs:
+        sectorCRCs(Count);
+        break;
+#endif
     }
     if (EchoReqFlag == 1) {
         echoBuffer[1] = echoBuffer[1] | EchoAnsFlag;
         sendData(echoBuffer + 1, 63);
     }
 }
+
+#if defined(PIOS_INCLUDE_DFU_STREAM)
+/**
+ * Stream uploads. The packets of a stream transfer carry a byte stream of
+ * tokens that is decoded into flash from the base of the transfer:
+ *
+ *   0x00 - 0x7F  literal, token + 1 bytes follow
+ *   0x80 - 0xFE  match, token - 0x80 + 3 bytes copied from a 16 bit big
+ *                endian distance back in the output
+ *   0xFF         command, a 32 bit big endian argument follows: the output
+ *                offset to continue at (word aligned, forward only), or
+ *                0xFFFFFFFF for the end of the stream
+ *
+ * Matches are read back from flash, which holds everything below the output
+ * position: what this transfer wrote and the sectors it skipped, which the
+ * host only skips when their CRC matches the new image.
+ *
+ * The Upload start packet carries a mask of the sectors to erase, numbered
+ * like the Rep_SectorCRCs entries. They are erased before the transfer
+ * starts, the same place the full upload erases the bank, and writes to a
+ * sector not erased since EnterDFU fail the transfer.
+ */
+static bool streamStart(DFUTransfer type, uint32_t eraseMask)
+{
+    const uint32_t end = currentDevice.startOfUserCode + currentDevice.sizeOfCode + currentDevice.sizeOfDescription;
+    uint32_t address   = currentDevice.startOfUserCode;
+
+    memset(&stream, 0, sizeof(stream));
+    stream.state = STREAM_TOKEN;
+    stream.base  = baseOfAdressType(type);
+    switch (type) {
+    case FW:
+        stream.size = currentDevice.sizeOfCode;
+        break;
+    case Descript:
+        stream.size = currentDevice.sizeOfDescription;
+        break;
+    default:
+        stream.state = STREAM_ERROR;
+        return false;
+    }
+
+    for (uint8_t index = 0; (index < 32) && (address < end); index++) {
+        uint32_t sector_start;
+        uint32_t sector_size;
+        if (!PIOS_BL_HELPER_FLASH_GetSector(address, &sector_start, &sector_size)) {
+            return false;
+        }
+        if (eraseMask & (1u << index)) {
+            // never erase below the transfer, the description can share its
+            // sector with the end of the firmware
+            if ((sector_start < stream.base) || !PIOS_BL_HELPER_FLASH_Erase_Sector(sector_start)) {
+                return false;
+            }
+            ErasedSectors |= 1u << index;
+            eraseMask     &= ~(1u << index);
+        }
+        address = sector_start + sector_size;
+    }
+
+    // bits past the end of the area
+    return eraseMask == 0;
+}
+
+static bool streamFlushWord(void)
+{
+    const uint32_t address = stream.base + stream.pos - 4;
+
+    if ((address < stream.sectorStart) || (address >= stream.sectorEnd)) {
+        uint32_t sector_start = currentDevice.startOfUserCode;
+        uint32_t sector_size  = 0;
+        uint8_t index = 0;
+        while (PIOS_BL_HELPER_FLASH_GetSector(sector_start + sector_size, &sector_start, &sector_size)
+               && (sector_start + sector_size <= address)) {
+            index++;
+        }
+        if ((sector_size == 0) || (address < sector_start) || (address >= sector_start + sector_size)) {
+            return false;
+        }
+        stream.sectorStart  = sector_start;
+        stream.sectorEnd    = sector_start + sector_size;
+        stream.sectorErased = (index < 32) && (ErasedSectors & (1u << index));
+    }
+    if (!stream.sectorErased) {
+        return false;
+    }
+    if (stream.word == 0xFFFFFFFF) {
+        return true; // erased flash reads like this already
+    }
+    for (int retry = 0; retry < MAX_WRI_RETRYS; ++retry) {
+        if (FLASH_ProgramWord(address, stream.word) == FLASH_COMPLETE) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool streamPutByte(uint8_t byte)
+{
+    if (stream.pos >= stream.size) {
+        return false;
+    }
+    stream.word |= (uint32_t)byte << (8 * (stream.pos & 3));
+    stream.pos++;
+    if ((stream.pos & 3) == 0) {
+        bool ok = streamFlushWord();
+        stream.word = 0;
+        return ok;
+    }
+    return true;
+}
+
+static uint8_t streamGetByte(uint32_t offset)
+{
+    // the word being assembled is not in flash yet
+    if (offset >= (stream.pos & ~3)) {
+        return stream.word >> (8 * (offset & 3));
+    }
+    return *PIOS_BL_HELPER_FLASH_If_Read(stream.base + offset);
+}
+
+static void streamByte(uint8_t byte)
+{
+    bool ok = true;
+
+    switch (stream.state) {
+    case STREAM_TOKEN:
+        if (byte < 0x80) {
+            stream.count = byte + 1;
+            stream.state = STREAM_LITERAL;
+        } else if (byte < 0xFF) {
+            stream.count = byte - 0x80 + 3;
+            stream.need  = 2;
+            stream.arg   = 0;
+            stream.state = STREAM_MATCH;
+        } else {
+            stream.need  = 4;
+            stream.arg   = 0;
+            stream.state = STREAM_COMMAND;
+        }
+        break;
+    case STREAM_LITERAL:
+        ok = streamPutByte(byte);
+        if (--stream.count == 0) {
+            stream.state = STREAM_TOKEN;
+        }
+        break;
+    case STREAM_MATCH:
+        stream.arg = (stream.arg << 8) | byte;
+        if (--stream.need == 0) {
+            if ((stream.arg == 0) || (stream.arg > stream.pos)) {
+                ok = false;
+                break;
+            }
+            const uint32_t from = stream.pos - stream.arg;
+            for (uint32_t i = 0; (i < stream.count) && ok; i++) {
+                ok = streamPutByte(streamGetByte(from + i));
+            }
+            stream.state = STREAM_TOKEN;
+        }
+        break;
+    case STREAM_COMMAND:
+        stream.arg = (stream.arg << 8) | byte;
+        if (--stream.need == 0) {
+            if (stream.arg == 0xFFFFFFFF) {
+                // a partial word would never be written
+                ok = ((stream.pos & 3) == 0);
+                stream.state = STREAM_END;
+            } else if ((stream.pos & 3) || (stream.arg & 3)
+                       || (stream.arg < stream.pos) || (stream.arg > stream.size)) {
+                ok = false;
+            } else {
+                stream.pos   = stream.arg;
+                stream.state = STREAM_TOKEN;
+            }
+        }
+        break;
+    default:
+        // padding after the end, or an error that Op_END reports
+        break;
+    }
+    if (!ok) {
+        stream.state = STREAM_ERROR;
+    }
+}
+
+/**
+ * Reports offset, size and CRC of the flash sectors of the firmware and
+ * description area, DFU_SECTOR_CRCS_PER_PACKET sectors from first on
+ */
+static void sectorCRCs(uint32_t first)
+{
+    const uint32_t start = currentDevice.startOfUserCode;
+    const uint32_t end   = start + currentDevice.sizeOfCode + currentDevice.sizeOfDescription;
+    uint32_t address     = start;
+    uint32_t index = 0;
+    uint8_t count  = 0;
+
+    memset(Buffer, 0, sizeof(Buffer));
+    Buffer[0] = 0x01;
+    Buffer[1] = Rep_SectorCRCs;
+    pack_uint32(first, &Buffer[2]);
+    while ((DeviceState == DFUidle) && (currentProgrammingDestination == Self_flash) && (address < end)) {
+        uint32_t sector_start;
+        uint32_t sector_size;
+        if (!PIOS_BL_HELPER_FLASH_GetSector(address, &sector_start, &sector_size)) {
+            break;
+        }
+        // clip to the area, the firmware base is sector aligned
+        uint32_t size = sector_start + sector_size - address;
+        if (size > end - address) {
+            size = end - address;
+        }
+        if ((index >= first) && (count < DFU_SECTOR_CRCS_PER_PACKET)) {
+            uint8_t *entry = &Buffer[8 + 12 * count];
+            pack_uint32(address - start, entry);
+            pack_uint32(size, entry + 4);
+            pack_uint32(PIOS_BL_HELPER_CRC_Block_Calc(address, size), entry + 8);
+            count++;
+        }
+        address += size;
+        index++;
+    }
+    Buffer[6] = count;
+    Buffer[7] = index;
+    sendData(Buffer + 1, 63);
+}
+#endif /* PIOS_INCLUDE_DFU_STREAM */
+
 void OPDfuIni(uint8_t discover)
 {
     const struct pios_board_info *bdinfo = &pios_board_info_blob;
@@ -36,7 +36,7 @@ extern "C" {
 #include <math.h>
 #include <pid.h>
 #include <CoordinateConversions.h>
-#include <sin_lookup.h>
+#include <fastmath.h>
 #include <pathdesired.h>
 #include <paths.h>
 #include "plans.h"
@@ -125,6 +125,13 @@ void PIDControlDown::UpdateParameters(float kp, float ki, float kd, float beta,
     mVelocityMax = velocityMax;
 }
 
+// Update the loop period, e.g. with the measured one, without resetting the controller
+void PIDControlDown::UpdateDeltaTime(float dT)
+{
+    pid2_set_dT(&PID, dT);
+    deltaTime = dT;
+}
+
 
 void PIDControlDown::UpdatePositionalParameters(float kp)
 {
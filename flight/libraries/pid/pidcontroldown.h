@@ -49,6 +49,7 @@ public:
         return mActive;
     }
     void UpdateParameters(float kp, float ki, float kd, float beta, float dT, float velocityMax);
+    void UpdateDeltaTime(float dT);
     void UpdateNeutralThrust(float neutral);
     void UpdateVelocitySetpoint(float setpoint);
     void RateLimit(float *spDesired, float *spCurrent, float rateLimit);
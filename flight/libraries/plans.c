@@ -42,7 +42,7 @@
 #include <vtolpathfollowersettings.h>
 #include <stabilizationbank.h>
 #include <stabilizationdesired.h>
-#include <sin_lookup.h>
+#include <fastmath.h>
 #include <statusvtolautotakeoff.h>
 
 #define UPDATE_EXPECTED 0.02f
@@ -484,15 +484,17 @@ static void getVector(float controlVector[4], vario_type type)
         PositionStateGet(&positionState);
         TakeOffLocationData takeoffLocation;
         TakeOffLocationGet(&takeoffLocation);
-        angle = RAD2DEG(atan2f(positionState.East - takeoffLocation.East, positionState.North - takeoffLocation.North));
+        angle = RAD2DEG(fast_atan2f_coarse(positionState.East - takeoffLocation.East, positionState.North - takeoffLocation.North));
     }
     break;
     }
     // rotate horizontally by angle
     {
+        float sine_angle, cos_angle;
+        fast_sincosf_coarse(DEG2RAD(angle), &sine_angle, &cos_angle);
         float rotated[2] = {
-            controlVector[0] * cos_lookup_deg(angle) - controlVector[1] * sin_lookup_deg(angle),
-            controlVector[0] * sin_lookup_deg(angle) + controlVector[1] * cos_lookup_deg(angle)
+            controlVector[0] * cos_angle - controlVector[1] * sine_angle,
+            controlVector[0] * sine_angle + controlVector[1] * cos_angle
         };
         controlVector[0] = rotated[0];
         controlVector[1] = rotated[1];
@@ -631,8 +633,8 @@ void plan_run_VelocityRoam()
         float angle;
         AttitudeStateYawGet(&angle);
         angle = DEG2RAD(angle);
-        float cos_angle  = cosf(angle);
-        float sine_angle = sinf(angle);
+        float cos_angle, sine_angle;
+        fast_sincosf_coarse(angle, &sine_angle, &cos_angle);
         float rotated[2] = {
             -cmd.Pitch * cos_angle - cmd.Roll * sine_angle,
             -cmd.Pitch * sine_angle + cmd.Roll * cos_angle
@@ -723,10 +725,8 @@ void plan_setup_AutoCruise()
     // the velocity is not relevant, as it will be reset by the run function even during first call
     float angle;
     AttitudeStateYawGet(&angle);
-    float vector[2] = {
-        cos_lookup_deg(angle),
-        sin_lookup_deg(angle)
-    };
+    float vector[2];
+    fast_sincosf_coarse(DEG2RAD(angle), &vector[1], &vector[0]);
     hold_position[0]             = positionState.North;
     hold_position[1]             = positionState.East;
     hold_position[2]             = positionState.Down;
@@ -795,13 +795,15 @@ void plan_run_AutoCruise()
 
     // new angle is equal to old angle plus offset depending on yaw input and time
     // (controlVector is normalized with a deadband, change is zero within deadband)
-    float angle = RAD2DEG(atan2f(vector[1], vector[0]));
+    float angle = RAD2DEG(fast_atan2f_coarse(vector[1], vector[0]));
     float dT    = PIOS_DELTATIME_GetAverageSeconds(&actimeval);
     angle    += 10.0f * controlVector[2] * dT; // TODO magic value could eventually end up in a to be created settings
 
     // resulting movement vector is scaled by velocity demand in controlvector[3] [0.0-1.0]
-    vector[0] = cosf(DEG2RAD(angle)) * offset.Horizontal * controlVector[3];
-    vector[1] = sinf(DEG2RAD(angle)) * offset.Horizontal * controlVector[3];
+    float cos_angle, sine_angle;
+    fast_sincosf_coarse(DEG2RAD(angle), &sine_angle, &cos_angle);
+    vector[0] = cos_angle * offset.Horizontal * controlVector[3];
+    vector[1] = sine_angle * offset.Horizontal * controlVector[3];
     vector[2] = -controlVector[1] * offset.Vertical * controlVector[3];
 
     pathDesired.End.North   = hold_position[0] + vector[0];
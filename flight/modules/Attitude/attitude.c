@@ -69,6 +69,7 @@
 #include "CoordinateConversions.h"
 #include <pios_notify.h>
 #include <mathmisc.h>
+#include <math3d.h>
 #include <pios_constants.h>
 #include <pios_instrumentation_helper.h>
 
@@ -78,7 +79,7 @@ PERF_DEFINE_COUNTER(counterPeriod);
 PERF_DEFINE_COUNTER(counterAtt);
 // Counters:
 // - 0xA7710001 sensor fetch duration
-// - 0xA7710002 updateAttitude execution time
+// - 0xA7710002 sensor to attitude execution time (sample read, publish and updateAttitude)
 // - 0xA7710003 Attitude loop rate(period)
 // - 0xA7710004 number of accel samples read for each loop (cc only).
 
@@ -115,9 +116,11 @@ static void AttitudeTask(void *parameters);
 static float gyro_correct_int[3] = { 0, 0, 0 };
 static xQueueHandle gyro_queue;
 
-static int32_t updateSensors(AccelStateData *, GyroStateData *);
-static int32_t updateSensorsCC3D(AccelStateData *accelStateData, GyroStateData *gyrosData);
-static void updateAttitude(AccelStateData *, GyroStateData *);
+static int32_t updateSensors(float accels[3], float gyros[3]);
+static int32_t updateSensorsCC3D(float accels[3], float gyros[3]);
+static int32_t getSimulatedSensors(float accels[3], float gyros[3]);
+static void publishSensors(const float accels[3], const float gyros[3]);
+static void updateAttitude(float accels[3], float gyros[3]);
 static void settingsUpdatedCb(UAVObjEvent *objEv);
 
 static float accelKi     = 0;
@@ -135,6 +138,11 @@ static int8_t rotate = 0;
 static bool zero_during_arming = false;
 static bool bias_correct_gyro  = true;
 
+// Samples stay in locals from read to quaternion update, AccelState is
+// only written every n-th cycle (0 = never)
+static uint8_t accel_publish_decimation = 1;
+static uint8_t accel_publish_count = 0;
+
 // static float gyros_passed[3];
 
 // temp coefficient to calculate gyro bias
@@ -316,14 +324,14 @@ static void AttitudeTask(__attribute__((unused)) void *parameters)
 #ifdef PIOS_INCLUDE_WDG
         PIOS_WDG_UpdateFlag(PIOS_WDG_ATTITUDE);
 #endif
-        AccelStateData accelState;
-        GyroStateData gyros;
+        float accels[3];
+        float gyros[3];
         int32_t retval = 0;
 
         if (cc3d) {
-            retval = updateSensorsCC3D(&accelState, &gyros);
+            retval = updateSensorsCC3D(accels, gyros);
         } else {
-            retval = updateSensors(&accelState, &gyros);
+            retval = updateSensors(accels, gyros);
         }
 
         // Only update attitude when sensor data is good
@@ -332,10 +340,9 @@ static void AttitudeTask(__attribute__((unused)) void *parameters)
         } else {
             // Do not update attitude data in simulation mode
             if (!AttitudeStateReadOnly()) {
-                PERF_TIMED_SECTION_START(counterAtt);
-                updateAttitude(&accelState, &gyros);
-                PERF_TIMED_SECTION_END(counterAtt);
+                updateAttitude(accels, gyros);
             }
+            PERF_TIMED_SECTION_END(counterAtt);
             PERF_MEASURE_PERIOD(counterPeriod);
             AlarmsClear(SYSTEMALARMS_ALARM_ATTITUDE);
         }
@@ -345,10 +352,11 @@ static void AttitudeTask(__attribute__((unused)) void *parameters)
 
 /**
  * Get an update from the sensors
- * @param[in] attitudeRaw Populate the UAVO instead of saving right here
+ * @param[out] accels bias corrected accels, in the board frame
+ * @param[out] gyros bias corrected gyros, in the board frame
  * @return 0 if successfull, -1 if not
  */
-static int32_t updateSensors(AccelStateData *accelState, GyroStateData *gyros)
+static int32_t updateSensors(float accels[3], float gyros[3])
 {
     struct pios_adxl345_data accel_data;
     float gyro[4];
@@ -361,7 +369,7 @@ static int32_t updateSensors(AccelStateData *accelState, GyroStateData *gyros)
 
     // Do not read raw sensor data in simulation mode
     if (GyroStateReadOnly() || AccelStateReadOnly()) {
-        return 0;
+        return getSimulatedSensors(accels, gyros);
     }
 
     // No accel data available
@@ -370,10 +378,11 @@ static int32_t updateSensors(AccelStateData *accelState, GyroStateData *gyros)
         return -1;
     }
     PERF_TIMED_SECTION_START(counterUpd);
+    PERF_TIMED_SECTION_START(counterAtt);
     // First sample is temperature
-    gyros->x = -(gyro[1] - STD_CC_ANALOG_GYRO_NEUTRAL) * gyro_scale.X;
-    gyros->y = (gyro[2] - STD_CC_ANALOG_GYRO_NEUTRAL) * gyro_scale.Y;
-    gyros->z = -(gyro[3] - STD_CC_ANALOG_GYRO_NEUTRAL) * gyro_scale.Z;
+    gyros[0] = -(gyro[1] - STD_CC_ANALOG_GYRO_NEUTRAL) * gyro_scale.X;
+    gyros[1] = (gyro[2] - STD_CC_ANALOG_GYRO_NEUTRAL) * gyro_scale.Y;
+    gyros[2] = -(gyro[3] - STD_CC_ANALOG_GYRO_NEUTRAL) * gyro_scale.Z;
 
     int32_t x = 0;
     int32_t y = 0;
@@ -395,25 +404,14 @@ static int32_t updateSensors(AccelStateData *accelState, GyroStateData *gyros)
         } while ((i < 32) && (samples_remaining > 0));
     }
     PERF_TRACK_VALUE(counterAccelSamples, i);
-    float accel[3] = { accel_scale.X * (float)x / i,
-                       accel_scale.Y * (float)y / i,
-                       accel_scale.Z * (float)z / i };
+    accels[0] = accel_scale.X * (float)x / i;
+    accels[1] = accel_scale.Y * (float)y / i;
+    accels[2] = accel_scale.Z * (float)z / i;
 
     if (rotate) {
         // TODO: rotate sensors too so stabilization is well behaved
-        float vec_out[3];
-        rot_mult(R, accel, vec_out);
-        accelState->x = vec_out[0];
-        accelState->y = vec_out[1];
-        accelState->z = vec_out[2];
-        rot_mult(R, &gyros->x, vec_out);
-        gyros->x = vec_out[0];
-        gyros->y = vec_out[1];
-        gyros->z = vec_out[2];
-    } else {
-        accelState->x = accel[0];
-        accelState->y = accel[1];
-        accelState->z = accel[2];
+        m3d_rot_mult(R, accels, accels);
+        m3d_rot_mult(R, gyros, gyros);
     }
 
     if (trim_requested) {
@@ -427,51 +425,52 @@ static int32_t updateSensors(AccelStateData *accelState, GyroStateData *gyros)
             if ((armed == FLIGHTSTATUS_ARMED_ARMED) && (throttle > 0.0f)) {
                 trim_samples++;
                 // Store the digitally scaled version since that is what we use for bias
-                trim_accels[0] += accelState->x;
-                trim_accels[1] += accelState->y;
-                trim_accels[2] += accelState->z;
+                trim_accels[0] += accels[0];
+                trim_accels[1] += accels[1];
+                trim_accels[2] += accels[2];
             }
         }
     }
 
     // Scale accels and correct bias
-    accelState->x -= accel_bias.X;
-    accelState->y -= accel_bias.Y;
-    accelState->z -= accel_bias.Z;
+    accels[0] -= accel_bias.X;
+    accels[1] -= accel_bias.Y;
+    accels[2] -= accel_bias.Z;
 
     if (bias_correct_gyro) {
         // Applying integral component here so it can be seen on the gyros and correct bias
-        gyros->x += gyro_correct_int[0];
-        gyros->y += gyro_correct_int[1];
-        gyros->z += gyro_correct_int[2];
+        gyros[0] += gyro_correct_int[0];
+        gyros[1] += gyro_correct_int[1];
+        gyros[2] += gyro_correct_int[2];
     }
 
     // Force the roll & pitch gyro rates to average to zero during initialisation
-    gyro_correct_int[0] += -gyros->x * rollPitchBiasRate;
-    gyro_correct_int[1] += -gyros->y * rollPitchBiasRate;
+    gyro_correct_int[0] += -gyros[0] * rollPitchBiasRate;
+    gyro_correct_int[1] += -gyros[1] * rollPitchBiasRate;
 
     // Because most crafts wont get enough information from gravity to zero yaw gyro, we try
     // and make it average zero (weakly)
-    gyro_correct_int[2] += -gyros->z * yawBiasRate;
+    gyro_correct_int[2] += -gyros[2] * yawBiasRate;
     PERF_TIMED_SECTION_END(counterUpd);
 
-    GyroStateSet(gyros);
-    AccelStateSet(accelState);
+    publishSensors(accels, gyros);
 
     return 0;
 }
 
 /**
  * Get an update from the sensors
- * @param[in] attitudeRaw Populate the UAVO instead of saving right here
+ * @param[out] accels bias corrected accels, in the board frame
+ * @param[out] gyros bias corrected gyros, in the board frame
  * @return 0 if successfull, -1 if not
  */
-static int32_t updateSensorsCC3D(AccelStateData *accelStateData, GyroStateData *gyrosData)
+static int32_t updateSensorsCC3D(float accels[3], float gyros[3])
 {
-    float accels[3] = { 0 };
-    float gyros[3]  = { 0 };
     float temp = 0;
-    uint8_t count   = 0;
+    uint8_t count = 0;
+
+    accels[0] = accels[1] = accels[2] = 0.0f;
+    gyros[0]  = gyros[1] = gyros[2] = 0.0f;
 
 #if defined(PIOS_INCLUDE_MPU6000)
 
@@ -499,10 +498,11 @@ static int32_t updateSensorsCC3D(AccelStateData *accelStateData, GyroStateData *
     }
     // Do not read raw sensor data in simulation mode
     if (GyroStateReadOnly() || AccelStateReadOnly()) {
-        return 0;
+        return getSimulatedSensors(accels, gyros);
     }
     float invcount = 1.0f / count;
     PERF_TIMED_SECTION_START(counterUpd);
+    PERF_TIMED_SECTION_START(counterAtt);
     gyros[0]  *= gyro_scale.X * invcount;
     gyros[1]  *= gyro_scale.Y * invcount;
     gyros[2]  *= gyro_scale.Z * invcount;
@@ -551,46 +551,82 @@ static int32_t updateSensorsCC3D(AccelStateData *accelStateData, GyroStateData *
 
     if (rotate) {
         // TODO: rotate sensors too so stabilization is well behaved
-        float vec_out[3];
-        rot_mult(R, accels, vec_out);
-        accels[0] = vec_out[0];
-        accels[1] = vec_out[1];
-        accels[2] = vec_out[2];
-        rot_mult(R, gyros, vec_out);
-        gyros[0]  = vec_out[0];
-        gyros[1]  = vec_out[1];
-        gyros[2]  = vec_out[2];
+        m3d_rot_mult(R, accels, accels);
+        m3d_rot_mult(R, gyros, gyros);
     }
 
-    accelStateData->x = accels[0] - accel_bias.X;
-    accelStateData->y = accels[1] - accel_bias.Y;
-    accelStateData->z = accels[2] - accel_bias.Z;
-
-    gyrosData->x = gyros[0];
-    gyrosData->y = gyros[1];
-    gyrosData->z = gyros[2];
+    accels[0] -= accel_bias.X;
+    accels[1] -= accel_bias.Y;
+    accels[2] -= accel_bias.Z;
 
     if (bias_correct_gyro) {
         // Applying integral component here so it can be seen on the gyros and correct bias
-        gyrosData->x += gyro_correct_int[0];
-        gyrosData->y += gyro_correct_int[1];
-        gyrosData->z += gyro_correct_int[2];
+        gyros[0] += gyro_correct_int[0];
+        gyros[1] += gyro_correct_int[1];
+        gyros[2] += gyro_correct_int[2];
     }
 
     // Force the roll & pitch gyro rates to average to zero during initialisation
-    gyro_correct_int[0] += -gyrosData->x * rollPitchBiasRate;
-    gyro_correct_int[1] += -gyrosData->y * rollPitchBiasRate;
+    gyro_correct_int[0] += -gyros[0] * rollPitchBiasRate;
+    gyro_correct_int[1] += -gyros[1] * rollPitchBiasRate;
 
     // Because most crafts wont get enough information from gravity to zero yaw gyro, we try
     // and make it average zero (weakly)
-    gyro_correct_int[2] += -gyrosData->z * yawBiasRate;
+    gyro_correct_int[2] += -gyros[2] * yawBiasRate;
     PERF_TIMED_SECTION_END(counterUpd);
-    GyroStateSet(gyrosData);
-    AccelStateSet(accelStateData);
+
+    publishSensors(accels, gyros);
+
+    return 0;
+}
+
+/**
+ * In simulation mode AccelState/GyroState are written from outside, use those
+ */
+static int32_t getSimulatedSensors(float accels[3], float gyros[3])
+{
+    AccelStateData accelState;
+    GyroStateData gyroState;
+
+    // the task loop ends this section after the attitude update
+    PERF_TIMED_SECTION_START(counterAtt);
+    AccelStateGet(&accelState);
+    GyroStateGet(&gyroState);
+
+    accels[0] = accelState.x;
+    accels[1] = accelState.y;
+    accels[2] = accelState.z;
+    gyros[0]  = gyroState.x;
+    gyros[1]  = gyroState.y;
+    gyros[2]  = gyroState.z;
 
     return 0;
 }
 
+/**
+ * Write the sensor objects, AccelState decimated by AttitudeSettings.AccelStateDecimation.
+ * Stabilization runs from GyroState updates and its rate groups expect one per
+ * sensor cycle, so GyroState is written every cycle before the attitude update.
+ */
+static void publishSensors(const float accels[3], const float gyros[3])
+{
+    GyroStateData gyroState;
+
+    gyroState.x = gyros[0];
+    gyroState.y = gyros[1];
+    gyroState.z = gyros[2];
+    GyroStateSet(&gyroState);
+
+    if (accel_publish_decimation && ++accel_publish_count >= accel_publish_decimation) {
+        AccelStateData accelState;
+        accelState.x = accels[0];
+        accelState.y = accels[1];
+        accelState.z = accels[2];
+        AccelStateSet(&accelState);
+        accel_publish_count = 0;
+    }
+}
+
 static inline void apply_accel_filter(const float *raw, float *filtered)
 {
     if (accel_filter_enabled) {
@@ -604,13 +640,9 @@ static inline void apply_accel_filter(const float *raw, float *filtered)
     }
 }
 
-__attribute__((optimize("O3"))) static void updateAttitude(AccelStateData *accelStateData, GyroStateData *gyrosData)
+__attribute__((optimize("O3"))) static void updateAttitude(float accels[3], float gyros[3])
 {
-    float dT      = PIOS_DELTATIME_GetAverageSeconds(&dtconfig);
-
-    // Bad practice to assume structure order, but saves memory
-    float *gyros  = &gyrosData->x;
-    float *accels = &accelStateData->x;
+    float dT = PIOS_DELTATIME_GetAverageSeconds(&dtconfig);
 
     float grot[3];
     float accel_err[3];
@@ -625,10 +657,10 @@ __attribute__((optimize("O3"))) static void updateAttitude(AccelStateData *accel
 
     apply_accel_filter(grot, grot_filtered);
 
-    CrossProduct((const float *)accels_filtered, (const float *)grot_filtered, accel_err);
+    m3d_vec_cross(accels_filtered, grot_filtered, accel_err);
 
     // Account for accel magnitude
-    float inv_accel_mag = fast_invsqrtf(accels_filtered[0] * accels_filtered[0] + accels_filtered[1] * accels_filtered[1] + accels_filtered[2] * accels_filtered[2]);
+    float inv_accel_mag = fast_invsqrtf_coarse(accels_filtered[0] * accels_filtered[0] + accels_filtered[1] * accels_filtered[1] + accels_filtered[2] * accels_filtered[2]);
     if (inv_accel_mag > 1e3f) {
         return;
     }
@@ -637,7 +669,7 @@ __attribute__((optimize("O3"))) static void updateAttitude(AccelStateData *accel
     float inv_grot_mag;
 
     if (accel_filter_enabled) {
-        inv_grot_mag = fast_invsqrtf(grot_filtered[0] * grot_filtered[0] + grot_filtered[1] * grot_filtered[1] + grot_filtered[2] * grot_filtered[2]);
+        inv_grot_mag = fast_invsqrtf_coarse(grot_filtered[0] * grot_filtered[0] + grot_filtered[1] * grot_filtered[1] + grot_filtered[2] * grot_filtered[2]);
     } else {
         inv_grot_mag = 1.0f;
     }
@@ -686,7 +718,7 @@ __attribute__((optimize("O3"))) static void updateAttitude(AccelStateData *accel
     }
 
     // Renomalize
-    float inv_qmag = fast_invsqrtf(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+    float inv_qmag = fast_invsqrtf_coarse(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
 
     // If quaternion has become inappropriately short or is nan reinit.
     // THIS SHOULD NEVER ACTUALLY HAPPEN
@@ -702,8 +734,8 @@ __attribute__((optimize("O3"))) static void updateAttitude(AccelStateData *accel
         q[3] = q[3] * inv_qmag;
     }
 
+    // Every field is written below, no need to fetch the old state first
     AttitudeStateData attitudeState;
-    AttitudeStateGet(&attitudeState);
 
     quat_copy(q, &attitudeState.q1);
 
@@ -735,6 +767,8 @@ static void settingsUpdatedCb(__attribute__((unused)) UAVObjEvent *objEv)
         accel_filter_enabled = true;
     }
 
+    accel_publish_decimation = attitudeSettings.AccelStateDecimation;
+
     zero_during_arming = attitudeSettings.ZeroDuringArming == ATTITUDESETTINGS_ZERODURINGARMING_TRUE;
     bias_correct_gyro  = attitudeSettings.BiasCorrectGyro == ATTITUDESETTINGS_BIASCORRECTGYRO_TRUE;
 
@@ -129,6 +129,12 @@ static void AutotuneTask(__attribute__((unused)) void *parameters)
 
     portTickType lastUpdateTime = xTaskGetTickCount();
 
+    // Settings rarely change, so keep copies and refresh them only on update
+    StabilizationSettingsData stabSettings;
+    uint32_t stabSettingsGen  = 0;
+    RelayTuningSettingsData relaySettings;
+    uint32_t relaySettingsGen = 0;
+
     while (1) {
         PIOS_WDG_UpdateFlag(PIOS_WDG_AUTOTUNE);
         // TODO:
@@ -153,17 +159,12 @@ static void AutotuneTask(__attribute__((unused)) void *parameters)
         StabilizationDesiredData stabDesired;
         StabilizationDesiredGet(&stabDesired);
 
-        StabilizationSettingsData stabSettings;
-        StabilizationSettingsGet(&stabSettings);
-
-        ManualControlSettingsData manualSettings;
-        ManualControlSettingsGet(&manualSettings);
+        StabilizationSettingsGetIfChanged(&stabSettings, &stabSettingsGen);
 
         ManualControlCommandData manualControl;
         ManualControlCommandGet(&manualControl);
 
-        RelayTuningSettingsData relaySettings;
-        RelayTuningSettingsGet(&relaySettings);
+        RelayTuningSettingsGetIfChanged(&relaySettings, &relaySettingsGen);
 
         bool rate = relaySettings.Mode == RELAYTUNINGSETTINGS_MODE_RATE;
 
@@ -110,6 +110,12 @@ static void flightPlanTask(__attribute__((unused)) void *parameters)
     status.ErrorType    = FLIGHTPLANSTATUS_ERRORTYPE_NONE;
     status.Debug[0]     = 0.0;
     status.Debug[1]     = 0.0;
+    status.GCCycles     = 0;
+    status.GCFullCycles = 0;
+    status.GCLastPause  = 0;
+    status.GCMaxPause   = 0;
+    status.GCMaxStep    = 0;
+    status.HeapFree     = 0;
     FlightPlanStatusSet(&status);
 
     // Main thread loop
@@ -236,6 +242,12 @@ static void objectUpdatedCb(UAVObjEvent *ev)
                 statusData.ErrorType    = FLIGHTPLANSTATUS_ERRORTYPE_NONE;
                 statusData.Debug[0]     = 0.0;
                 statusData.Debug[1]     = 0.0;
+                statusData.GCCycles     = 0;
+                statusData.GCFullCycles = 0;
+                statusData.GCLastPause  = 0;
+                statusData.GCMaxPause   = 0;
+                statusData.GCMaxStep    = 0;
+                statusData.HeapFree     = 0;
                 FlightPlanStatusSet(&statusData);
             }
         }
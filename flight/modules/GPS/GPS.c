@@ -60,6 +60,7 @@ PERF_DEFINE_COUNTER(counterParse);
 // Private functions
 
 static void gpsTask(__attribute__((unused)) void *parameters);
+static void gpsRxNotify(uint32_t context, bool *need_yield);
 static void updateHwSettings(__attribute__((unused)) UAVObjEvent *ev);
 
 #ifdef PIOS_GPS_SETS_HOMELOCATION
@@ -83,15 +84,17 @@ void updateGpsSettings(__attribute__((unused)) UAVObjEvent *ev);
 // the new location with Set = true.
 #define GPS_HOMELOCATION_SET_DELAY 5000
 
+// housekeeping period (autoconfig, timeouts) while no data is received
 #define GPS_LOOP_DELAY_MS          6
+#define GPS_IDLE_LOOP_DELAY_MS     50
+// wake up the parser before the rx buffer runs full during long bursts
+#define GPS_RX_NOTIFY_THRESHOLD    64
 
 #ifdef PIOS_GPS_SETS_HOMELOCATION
 // Unfortunately need a good size stack for the WMM calculation
         #define STACK_SIZE_BYTES   1024
 #else
 #if defined(PIOS_GPS_MINIMAL)
-        #define GPS_READ_BUFFER    32
-
 #ifdef PIOS_INCLUDE_GPS_NMEA_PARSER
         #define STACK_SIZE_BYTES   580 // NMEA
 #else
@@ -102,10 +105,6 @@ void updateGpsSettings(__attribute__((unused)) UAVObjEvent *ev);
 #endif // PIOS_GPS_MINIMAL
 #endif // PIOS_GPS_SETS_HOMELOCATION
 
-#ifndef GPS_READ_BUFFER
-#define GPS_READ_BUFFER            128
-#endif
-
 #define TASK_PRIORITY              (tskIDLE_PRIORITY + 1)
 
 // ****************
@@ -117,6 +116,7 @@ static GPSSettingsData gpsSettings;
 static bool gpsEnabled = false;
 
 static xTaskHandle gpsTaskHandle;
+static xSemaphoreHandle gpsRxSem;
 
 static char *gps_rx_buffer;
 
@@ -137,6 +137,7 @@ static struct GPS_RX_STATS gpsRxStats;
 int32_t GPSStart(void)
 {
     if (gpsEnabled) {
+        vSemaphoreCreateBinary(gpsRxSem);
         // Start gps task
         xTaskCreate(gpsTask, "GPS", STACK_SIZE_BYTES / 4, NULL, TASK_PRIORITY, &gpsTaskHandle);
         PIOS_TASK_MONITOR_RegisterTask(TASKINFO_RUNNING_GPS, gpsTaskHandle);
@@ -242,13 +243,10 @@ MODULE_INITCALL(GPSInitialize, GPSStart);
 
 static void gpsTask(__attribute__((unused)) void *parameters)
 {
-    // 57600 baud = 5760 bytes per second
-    // PIOS serial buffers appear to be 32 bytes long
-    // that is a maximum of 5760/32 = 180 buffers per second
-    // that is 1/180 = 0.005555556 seconds per packet
-    // we must never wait more than 5ms since packet was last drained or it may overflow
-    // 100ms is way slow too, considering we do everything possible to make the sensor data as contemporary as possible
-    portTickType xDelay = 5 / portTICK_RATE_MS;
+    // The serial driver wakes us once per received burst (idle line or buffer
+    // half full), so the parser runs on whole messages instead of polling the
+    // port every few ms. Without data the loop still runs periodically to
+    // drive autoconfig and the timeout handling.
     uint32_t timeNowMs  = xTaskGetTickCount() * portTICK_RATE_MS;
 
 #ifdef PIOS_GPS_SETS_HOMELOCATION
@@ -265,15 +263,17 @@ static void gpsTask(__attribute__((unused)) void *parameters)
     updateGpsSettings(0);
 #endif
 
-    TickType_t xLastWakeTime;
-    xLastWakeTime = xTaskGetTickCount();
     PERF_INIT_COUNTER(counterBytesIn, 0x97510001);
     PERF_INIT_COUNTER(counterRate, 0x97510002);
     PERF_INIT_COUNTER(counterParse, 0x97510003);
-    uint8_t c[GPS_READ_BUFFER];
+    if (gpsPort) {
+        PIOS_COM_RegisterRxNotify(gpsPort, gpsRxNotify, 0, GPS_RX_NOTIFY_THRESHOLD);
+    }
 
     // Loop forever
     while (1) {
+        portTickType xDelay = GPS_IDLE_LOOP_DELAY_MS / portTICK_RATE_MS;
+
         if (gpsPort) {
 #if defined(PIOS_INCLUDE_GPS_UBX_PARSER) && !defined(PIOS_GPS_MINIMAL)
             // do autoconfig stuff for UBX GPS's
@@ -309,12 +309,17 @@ static void gpsTask(__attribute__((unused)) void *parameters)
                 GPSPositionSensorAutoConfigStatusSet(&gpspositionsensor.AutoConfigStatus);
                 lastStatus = gpspositionsensor.AutoConfigStatus;
             }
+            if (gpspositionsensor.AutoConfigStatus == GPSPOSITIONSENSOR_AUTOCONFIGSTATUS_RUNNING) {
+                // autoconfig is waiting for replies, keep it running at the full rate
+                xDelay = GPS_LOOP_DELAY_MS / portTICK_RATE_MS;
+            }
 #endif /* if defined(PIOS_INCLUDE_GPS_UBX_PARSER) && !defined(PIOS_GPS_MINIMAL) */
 
+            uint8_t *span;
             uint16_t cnt;
-            // This blocks the task until there is something on the buffer (or 100ms? passes)
-            cnt = PIOS_COM_ReceiveBuffer(gpsPort, c, GPS_READ_BUFFER, xDelay);
-            if (cnt > 0) {
+            // Parse everything received so far straight from the rx buffer,
+            // the second pass picks up the data wrapped around the buffer end
+            while ((cnt = PIOS_COM_ReceiveSpan(gpsPort, &span)) > 0) {
                 PERF_TIMED_SECTION_START(counterParse);
                 PERF_TRACK_VALUE(counterBytesIn, cnt);
                 PERF_MEASURE_PERIOD(counterRate);
@@ -322,18 +327,19 @@ static void gpsTask(__attribute__((unused)) void *parameters)
                 switch (gpsSettings.DataProtocol) {
 #if defined(PIOS_INCLUDE_GPS_NMEA_PARSER)
                 case GPSSETTINGS_DATAPROTOCOL_NMEA:
-                    res = parse_nmea_stream(c, cnt, gps_rx_buffer, &gpspositionsensor, &gpsRxStats);
+                    res = parse_nmea_stream(span, cnt, gps_rx_buffer, &gpspositionsensor, &gpsRxStats);
                     break;
 #endif
 #if defined(PIOS_INCLUDE_GPS_UBX_PARSER)
                 case GPSSETTINGS_DATAPROTOCOL_UBX:
-                    res = parse_ubx_stream(c, cnt, gps_rx_buffer, &gpspositionsensor, &gpsRxStats);
+                    res = parse_ubx_stream(span, cnt, gps_rx_buffer, &gpspositionsensor, &gpsRxStats);
                     break;
 #endif
                 default:
                     res = NO_PARSER; // this should not happen
                     break;
                 }
+                PIOS_COM_ReceiveSpanDone(gpsPort, cnt);
                 PERF_TIMED_SECTION_END(counterParse);
 
                 if (res == PARSER_COMPLETE) {
@@ -384,10 +390,22 @@ static void gpsTask(__attribute__((unused)) void *parameters)
                 }
             }
         } // if (gpsPort)
-        vTaskDelayUntil(&xLastWakeTime, GPS_LOOP_DELAY_MS / portTICK_RATE_MS);
+        // This blocks the task until a burst has been received (or xDelay passes)
+        xSemaphoreTake(gpsRxSem, xDelay);
     } // while (1)
 }
 
+/**
+ * Called by the COM layer in interrupt context once a burst has been received
+ */
+static void gpsRxNotify(__attribute__((unused)) uint32_t context, bool *need_yield)
+{
+    signed portBASE_TYPE xHigherPriorityTaskWoken = pdFALSE;
+
+    xSemaphoreGiveFromISR(gpsRxSem, &xHigherPriorityTaskWoken);
+    *need_yield = (xHigherPriorityTaskWoken != pdFALSE);
+}
+
 #ifdef PIOS_GPS_SETS_HOMELOCATION
 /*
  * Estimate the acceleration due to gravity for a particular location in LLA
@@ -105,7 +105,7 @@ static const struct nmea_parser nmea_parsers[] = {
 #endif // PIOS_GPS_MINIMAL
 };
 
-int parse_nmea_stream(uint8_t *rx, uint8_t len, char *gps_rx_buffer, GPSPositionSensorData *GpsData, struct GPS_RX_STATS *gpsRxStats)
+int parse_nmea_stream(uint8_t *rx, uint16_t len, char *gps_rx_buffer, GPSPositionSensorData *GpsData, struct GPS_RX_STATS *gpsRxStats)
 {
     int ret = PARSER_INCOMPLETE;
     static uint8_t rx_count = 0;
@@ -31,7 +31,7 @@ extern "C" {
 #include <math.h>
 #include <pid.h>
 #include <CoordinateConversions.h>
-#include <sin_lookup.h>
+#include <fastmath.h>
 #include <pathdesired.h>
 #include <paths.h>
 #include "plans.h"
@@ -289,8 +289,7 @@ uint8_t FixedWingFlyController::updateFixedDesiredAttitude()
     // reasonable error that measured airspeed is actually the airspeed
     // component in forward pointing direction
     // airspeedVector is normalized
-    airspeedVector[0]     = cos_lookup_deg(attitudeState.Yaw);
-    airspeedVector[1]     = sin_lookup_deg(attitudeState.Yaw);
+    fast_sincosf_coarse(DEG2RAD(attitudeState.Yaw), &airspeedVector[1], &airspeedVector[0]);
 
     // current ground speed projected in forward direction
     groundspeedProjection = velocityState.North * airspeedVector[0] + velocityState.East * airspeedVector[1];
@@ -440,7 +439,7 @@ uint8_t FixedWingFlyController::updateFixedDesiredAttitude()
     /**
      * Compute desired roll command
      */
-    courseError = RAD2DEG(atan2f(courseComponent[1], courseComponent[0])) - attitudeState.Yaw;
+    courseError = RAD2DEG(fast_atan2f_coarse(courseComponent[1], courseComponent[0])) - attitudeState.Yaw;
 
     if (courseError < -180.0f) {
         courseError += 360.0f;
@@ -604,8 +603,7 @@ void FixedWingFlyController::AirspeedStateUpdatedCb(__attribute__((unused)) UAVO
     float airspeedVector[2];
     float yaw;
     AttitudeStateYawGet(&yaw);
-    airspeedVector[0] = cos_lookup_deg(yaw);
-    airspeedVector[1] = sin_lookup_deg(yaw);
+    fast_sincosf_coarse(DEG2RAD(yaw), &airspeedVector[1], &airspeedVector[0]);
     // vector projection of groundspeed on airspeed vector to handle both forward and backwards movement
     float groundspeedProjection = velocityState.North * airspeedVector[0] + velocityState.East * airspeedVector[1];
 
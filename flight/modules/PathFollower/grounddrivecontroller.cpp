@@ -32,7 +32,7 @@ extern "C" {
 #include <math.h>
 #include <pid.h>
 #include <CoordinateConversions.h>
-#include <sin_lookup.h>
+#include <fastmath.h>
 #include <pathdesired.h>
 #include <paths.h>
 #include "plans.h"
@@ -234,8 +234,8 @@ uint8_t GroundDriveController::updateGroundDesiredAttitude()
 
     // Get current vehicle orientation
     float angle_radians  = DEG2RAD(attitudeState.Yaw); // (+-pi)
-    float cos_angle      = cosf(angle_radians);
-    float sine_angle     = sinf(angle_radians);
+    float cos_angle, sine_angle;
+    fast_sincosf_coarse(angle_radians, &sine_angle, &cos_angle);
 
     float courseCommand  = 0.0f;
     float speedCommand   = 0.0f;
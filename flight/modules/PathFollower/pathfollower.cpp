@@ -52,7 +52,7 @@ extern "C" {
 #include <math.h>
 #include <pid.h>
 #include <CoordinateConversions.h>
-#include <sin_lookup.h>
+#include <fastmath.h>
 #include <pathdesired.h>
 #include <paths.h>
 #include "plans.h"
@@ -36,7 +36,7 @@ extern "C" {
 #include <math.h>
 #include <pid.h>
 #include <CoordinateConversions.h>
-#include <sin_lookup.h>
+#include <fastmath.h>
 #include <pathdesired.h>
 #include <paths.h>
 #include "plans.h"
@@ -37,7 +37,7 @@ extern "C" {
 #include <pid.h>
 #include <alarms.h>
 #include <CoordinateConversions.h>
-#include <sin_lookup.h>
+#include <fastmath.h>
 #include <pathdesired.h>
 #include <paths.h>
 #include "plans.h"
@@ -280,8 +280,8 @@ int8_t VtolBrakeController::UpdateStabilizationDesired(void)
     controlNE.GetNECommand(&northCommand, &eastCommand);
 
     float angle_radians = DEG2RAD(attitudeState.Yaw);
-    float cos_angle     = cosf(angle_radians);
-    float sine_angle    = sinf(angle_radians);
+    float cos_angle, sine_angle;
+    fast_sincosf_coarse(angle_radians, &sine_angle, &cos_angle);
     float maxPitch = vtolPathFollowerSettings->BrakeMaxPitch;
     stabDesired.StabilizationMode.Pitch = STABILIZATIONDESIRED_STABILIZATIONMODE_ATTITUDE;
     stabDesired.Pitch = boundf(-northCommand * cos_angle - eastCommand * sine_angle, -maxPitch, maxPitch); // this should be in the controller
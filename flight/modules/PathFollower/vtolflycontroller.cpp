@@ -31,7 +31,7 @@ extern "C" {
 #include <math.h>
 #include <pid.h>
 #include <CoordinateConversions.h>
-#include <sin_lookup.h>
+#include <fastmath.h>
 #include <pathdesired.h>
 #include <paths.h>
 #include "plans.h"
@@ -231,8 +231,8 @@ int8_t VtolFlyController::UpdateStabilizationDesired(bool yaw_attitude, float ya
     controlNE.GetNECommand(&northCommand, &eastCommand);
 
     float angle_radians = DEG2RAD(attitudeState.Yaw);
-    float cos_angle     = cosf(angle_radians);
-    float sine_angle    = sinf(angle_radians);
+    float cos_angle, sine_angle;
+    fast_sincosf_coarse(angle_radians, &sine_angle, &cos_angle);
     float maxPitch = vtolPathFollowerSettings->MaxRollPitch;
     stabDesired.StabilizationMode.Pitch = STABILIZATIONDESIRED_STABILIZATIONMODE_ATTITUDE;
     stabDesired.Pitch = boundf(-northCommand * cos_angle - eastCommand * sine_angle, -maxPitch, maxPitch); // this should be in the controller
@@ -314,7 +314,7 @@ void VtolFlyController::UpdateDesiredAttitudeEmergencyFallback()
     ManualControlCommandData manualControlData;
     ManualControlCommandGet(&manualControlData);
 
-    courseError = RAD2DEG(atan2f(velocityDesired.East, velocityDesired.North) - atan2f(velocityState.East, velocityState.North));
+    courseError = RAD2DEG(fast_atan2f_coarse(velocityDesired.East, velocityDesired.North) - fast_atan2f_coarse(velocityState.East, velocityState.North));
 
     if (courseError < -180.0f) {
         courseError += 360.0f;
@@ -473,7 +473,7 @@ float VtolFlyController::updateTailInBearing()
     TakeOffLocationData t;
     TakeOffLocationGet(&t);
     // atan2f always returns in between + and - 180 degrees
-    return RAD2DEG(atan2f(p.East - t.East, p.North - t.North));
+    return RAD2DEG(fast_atan2f_coarse(p.East - t.East, p.North - t.North));
 }
 
 
@@ -486,7 +486,7 @@ float VtolFlyController::updateCourseBearing()
 
     VelocityStateGet(&v);
     // atan2f always returns in between + and - 180 degrees
-    return RAD2DEG(atan2f(v.East, v.North));
+    return RAD2DEG(fast_atan2f_coarse(v.East, v.North));
 }
 
 
@@ -507,7 +507,7 @@ float VtolFlyController::updatePathBearing()
     path_progress(pathDesired, cur, &progress, true);
 
     // atan2f always returns in between + and - 180 degrees
-    return RAD2DEG(atan2f(progress.path_vector[1], progress.path_vector[0]));
+    return RAD2DEG(fast_atan2f_coarse(progress.path_vector[1], progress.path_vector[0]));
 }
 
 
@@ -532,9 +532,9 @@ float VtolFlyController::updatePOIBearing()
     dLoc[2] = positionState.Down - poi.Down;
 
     if (dLoc[1] < 0) {
-        yaw = RAD2DEG(atan2f(dLoc[1], dLoc[0])) + 180.0f;
+        yaw = RAD2DEG(fast_atan2f_coarse(dLoc[1], dLoc[0])) + 180.0f;
     } else {
-        yaw = RAD2DEG(atan2f(dLoc[1], dLoc[0])) - 180.0f;
+        yaw = RAD2DEG(fast_atan2f_coarse(dLoc[1], dLoc[0])) - 180.0f;
     }
     ManualControlCommandData manualControlData;
     ManualControlCommandGet(&manualControlData);
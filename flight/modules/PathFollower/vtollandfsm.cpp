@@ -33,7 +33,7 @@ extern "C" {
 #include <pid.h>
 #include <alarms.h>
 #include <CoordinateConversions.h>
-#include <sin_lookup.h>
+#include <fastmath.h>
 #include <pathdesired.h>
 #include <paths.h>
 #include "plans.h"
@@ -32,7 +32,7 @@ extern "C" {
 #include <pid.h>
 #include <alarms.h>
 #include <CoordinateConversions.h>
-#include <sin_lookup.h>
+#include <fastmath.h>
 #include <pathdesired.h>
 #include <paths.h>
 #include "plans.h"
@@ -171,8 +171,8 @@ int8_t VtolVelocityController::UpdateStabilizationDesired(__attribute__((unused)
     controlNE.GetNECommand(&northCommand, &eastCommand);
 
     float angle_radians = DEG2RAD(attitudeState.Yaw);
-    float cos_angle     = cosf(angle_radians);
-    float sine_angle    = sinf(angle_radians);
+    float cos_angle, sine_angle;
+    fast_sincosf_coarse(angle_radians, &sine_angle, &cos_angle);
     float maxPitch = vtolPathFollowerSettings->VelocityRoamMaxRollPitch;
     stabDesired.StabilizationMode.Pitch = STABILIZATIONDESIRED_STABILIZATIONMODE_ATTITUDE;
     stabDesired.Pitch = boundf(-northCommand * cos_angle - eastCommand * sine_angle, -maxPitch, maxPitch);
@@ -40,6 +40,7 @@ extern "C" {
 #include <positionstate.h>
 #include <vtolselftuningstats.h>
 #include <stabilization.h>
+#include <rategroups.h>
 }
 
 #include <pidcontroldown.h>
@@ -49,7 +50,7 @@ extern "C" {
 
 #ifdef REVOLUTION
 
-#define UPDATE_EXPECTED   (1.0f / PIOS_SENSOR_RATE)
+#define UPDATE_EXPECTED   (1.0f / NAVLOOP_RATE)
 #define UPDATE_MIN        1.0e-6f
 #define UPDATE_MAX        1.0f
 #define UPDATE_ALPHA      1.0e-2f
@@ -65,12 +66,13 @@ static PIDControlDown controlDown;
 static AltitudeHoldSettingsData altitudeHoldSettings;
 static ThrustModeType thrustMode;
 static float thrustDemand = 0.0f;
+static PiOSDeltatimeConfig timeval;
 
 
 // Private functions
 static void SettingsUpdatedCb(UAVObjEvent *ev);
 static void altitudeHoldTask(void);
-static void VelocityStateUpdatedCb(UAVObjEvent *ev);
+static void altitudeHoldCb(void);
 
 /**
  * Setup mode and setpoint
@@ -181,9 +183,13 @@ static void altitudeHoldTask(void)
     AltitudeHoldStatusSet(&altitudeHoldStatus);
 }
 
-static void VelocityStateUpdatedCb(__attribute__((unused)) UAVObjEvent *ev)
+static void altitudeHoldCb(void)
 {
-    PIOS_CALLBACKSCHEDULER_Dispatch(altitudeHoldCBInfo);
+    stabilizationRateGroupBegin(RATEGROUP_NAV);
+    // the measured period, releases can be skipped or late under load
+    controlDown.UpdateDeltaTime(PIOS_DELTATIME_GetAverageSeconds(&timeval));
+    altitudeHoldTask();
+    stabilizationRateGroupEnd(RATEGROUP_NAV);
 }
 
 /**
@@ -201,8 +207,10 @@ void stabilizationAltitudeloopInit()
     VtolSelfTuningStatsConnectCallback(&SettingsUpdatedCb);
     SettingsUpdatedCb(NULL);
 
-    altitudeHoldCBInfo = PIOS_CALLBACKSCHEDULER_Create(&altitudeHoldTask, CALLBACK_PRIORITY, CBTASK_PRIORITY, CALLBACKINFO_RUNNING_ALTITUDEHOLD, STACK_SIZE_BYTES);
-    VelocityStateConnectCallback(&VelocityStateUpdatedCb);
+    PIOS_DELTATIME_Init(&timeval, UPDATE_EXPECTED, UPDATE_MIN, UPDATE_MAX, UPDATE_ALPHA);
+    altitudeHoldCBInfo = PIOS_CALLBACKSCHEDULER_Create(&altitudeHoldCb, CALLBACK_PRIORITY, CBTASK_PRIORITY, CALLBACKINFO_RUNNING_ALTITUDEHOLD, STACK_SIZE_BYTES);
+    // released by the gyro sample clock at NAVLOOP_RATE instead of every VelocityState update
+    stabilizationRateGroupAttach(RATEGROUP_NAV, RATEGROUP_CLOCK_GYRO, altitudeHoldCBInfo, NAVLOOP_RATE, 0);
 }
 
 
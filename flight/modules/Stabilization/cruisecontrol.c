@@ -33,7 +33,7 @@
 #include <openpilot.h>
 #include <stabilization.h>
 #include <attitudestate.h>
-#include <sin_lookup.h>
+#include <fastmath.h>
 
 static float cruisecontrol_factor = 1.0f;
 
@@ -73,7 +73,7 @@ static float CruiseControlAngleToFactor(float angle)
         factor = stabSettings.settings.CruiseControlMaxPowerFactor;
     } else {
         // the simple bank angle boost calculation that Cruise Control revolves around
-        factor = 1.0f / fabsf(cos_lookup_deg(angle));
+        factor = 1.0f / fabsf(fast_cosf_coarse(DEG2RAD(angle)));
         // factor in the power trim, no effect at 1.0, linear effect increases with factor
         factor = (factor - 1.0f) * stabSettings.cruiseControl.power_trim + 1.0f;
         // limit to user specified max power multiplier
@@ -137,8 +137,8 @@ void cruisecontrol_compute_factor(AttitudeStateData *attitude, float thrustDeman
 
         // spherical right triangle
         // 0.0 <= angle <= 180.0
-        angle_unmodified = angle = RAD2DEG(acosf(cos_lookup_deg(attitude->Roll)
-                                                 * cos_lookup_deg(attitude->Pitch)));
+        angle_unmodified = angle = RAD2DEG(fast_acosf_coarse(fast_cosf_coarse(DEG2RAD(attitude->Roll))
+                                                             * fast_cosf_coarse(DEG2RAD(attitude->Pitch))));
 
         // Calculate rate as a combined (roll and pitch) bank angle
         // change; in degrees per second.  Rate is calculated over the
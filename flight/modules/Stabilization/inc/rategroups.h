@@ -0,0 +1,76 @@
+/**
+ ******************************************************************************
+ * @addtogroup OpenPilotModules OpenPilot Modules
+ * @{
+ * @addtogroup StabilizationModule Stabilization Module
+ * @brief Rate groups for the stabilization loops
+ * @note This file implements the release of the inner, outer and navigation
+ * loops from the gyro and attitude sample clocks
+ * @{
+ *
+ * @file       rategroups.h
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2014.
+ * @brief      Attitude stabilization module.
+ *
+ * @see        The GNU Public License (GPL) Version 3
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef RATEGROUPS_H
+#define RATEGROUPS_H
+
+#include <openpilot.h>
+
+typedef enum {
+    RATEGROUP_INNER = 0,
+    RATEGROUP_OUTER,
+    RATEGROUP_NAV,
+    RATEGROUP_NUMELEM
+} RateGroupId;
+
+// sample clocks that release the groups
+typedef enum {
+    RATEGROUP_CLOCK_GYRO = 0, // GyroState updates
+    RATEGROUP_CLOCK_ATTITUDE, // AttitudeState updates
+    RATEGROUP_CLOCK_NUMELEM
+} RateGroupClock;
+
+typedef struct {
+    uint32_t releases; // times the group was released by the sample clock
+    uint32_t skipped;  // releases that found the previous one still waiting to run
+    uint32_t overruns; // runs that finished after their deadline
+    uint32_t latency;  // [us] release to start of the last run
+    uint32_t latency_max;
+    uint32_t exectime; // [us] start to end of the last run
+    uint32_t exectime_max;
+} RateGroupStats;
+
+void stabilizationRateGroupsInit(float gyroRate, float attitudeRate);
+void stabilizationRateGroupAttach(RateGroupId group, RateGroupClock clock, DelayedCallbackInfo *callback, float rate, uint32_t deadline_us);
+void stabilizationRateGroupsTick(RateGroupClock clock);
+void stabilizationRateGroupBegin(RateGroupId group);
+void stabilizationRateGroupEnd(RateGroupId group);
+bool stabilizationRateGroupsOverrun();
+void stabilizationRateGroupGetStats(RateGroupId group, RateGroupStats *stats);
+
+#endif /* RATEGROUPS_H */
+
+/**
+ * @}
+ * @}
+ */
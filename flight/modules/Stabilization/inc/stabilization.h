@@ -78,9 +78,14 @@ extern StabilizationData stabSettings;
 // must be same as eventdispatcher to avoid needing additional mutexes
 #define CBTASK_PRIORITY     CALLBACK_TASK_FLIGHTCONTROL
 
-// outer loop only executes every 4th uavobject update to save CPU
+// outer loop only executes every 4th gyro update to save CPU
 #define OUTERLOOP_SKIPCOUNT 4
 
+// rate groups released by the gyro sample clock, see rategroups.c
+// the inner loop runs with every gyro update
+#define OUTERLOOP_RATE      (PIOS_SENSOR_RATE / OUTERLOOP_SKIPCOUNT)
+#define NAVLOOP_RATE        100.0f
+
 #endif // STABILIZATION_H
 
 /**
@@ -33,7 +33,7 @@
 
 #include <openpilot.h>
 #include <pid.h>
-#include <sin_lookup.h>
+#include <fastmath.h>
 #include <callbackinfo.h>
 #include <ratedesired.h>
 #include <actuatordesired.h>
@@ -50,6 +50,7 @@
 #include <virtualflybar.h>
 #include <cruisecontrol.h>
 #include <sanitycheck.h>
+#include <rategroups.h>
 // Private constants
 
 #define CALLBACK_PRIORITY CALLBACK_PRIORITY_CRITICAL
@@ -92,6 +93,7 @@ void stabilizationInnerloopInit()
     PIOS_DELTATIME_Init(&timeval, UPDATE_EXPECTED, UPDATE_MIN, UPDATE_MAX, UPDATE_ALPHA);
 
     callbackHandle = PIOS_CALLBACKSCHEDULER_Create(&stabilizationInnerloopTask, CALLBACK_PRIORITY, CBTASK_PRIORITY, CALLBACKINFO_RUNNING_STABILIZATION1, STACK_SIZE_BYTES);
+    stabilizationRateGroupAttach(RATEGROUP_INNER, RATEGROUP_CLOCK_GYRO, callbackHandle, PIOS_SENSOR_RATE, 0);
     GyroStateConnectCallback(GyroStateUpdatedCb);
 
     // schedule dead calls every FAILSAFE_TIMEOUT_MS to have the watchdog cleared
@@ -182,6 +184,8 @@ static pid_scaler create_pid_scaler(int axis)
  */
 static void stabilizationInnerloopTask()
 {
+    stabilizationRateGroupBegin(RATEGROUP_INNER);
+
     // watchdog and error handling
     {
 #ifdef PIOS_INCLUDE_WDG
@@ -215,6 +219,10 @@ static void stabilizationInnerloopTask()
             // critical if we missed 3 gyro updates
             crit = true;
         }
+        if (stabilizationRateGroupsOverrun()) {
+            // warning if any loop missed its deadline
+            warn = true;
+        }
         stabSettings.monitor.gyroupdates = 0;
 
         if (crit) {
@@ -347,8 +355,8 @@ static void stabilizationInnerloopTask()
     if (allowPiroComp && stabSettings.stabBank.EnablePiroComp == STABILIZATIONBANK_ENABLEPIROCOMP_TRUE && stabSettings.innerPids[0].iLim > 1e-3f && stabSettings.innerPids[1].iLim > 1e-3f) {
         // attempted piro compensation - rotate pitch and yaw integrals (experimental)
         float angleYaw = DEG2RAD(gyro_filtered[2] * dT);
-        float sinYaw   = sinf(angleYaw);
-        float cosYaw   = cosf(angleYaw);
+        float sinYaw, cosYaw;
+        fast_sincosf(angleYaw, &sinYaw, &cosYaw);
         float rollAcc  = stabSettings.innerPids[0].iAccumulator / stabSettings.innerPids[0].iLim;
         float pitchAcc = stabSettings.innerPids[1].iAccumulator / stabSettings.innerPids[1].iLim;
         stabSettings.innerPids[0].iAccumulator = stabSettings.innerPids[0].iLim * (cosYaw * rollAcc + sinYaw * pitchAcc);
@@ -369,6 +377,7 @@ static void stabilizationInnerloopTask()
         }
     }
     PIOS_CALLBACKSCHEDULER_Schedule(callbackHandle, FAILSAFE_TIMEOUT_MS, CALLBACK_UPDATEMODE_LATER);
+    stabilizationRateGroupEnd(RATEGROUP_INNER);
 }
 
 
@@ -382,7 +391,8 @@ static void GyroStateUpdatedCb(__attribute__((unused)) UAVObjEvent *ev)
     gyro_filtered[1] = gyro_filtered[1] * stabSettings.gyro_alpha + gyroState.y * (1 - stabSettings.gyro_alpha);
     gyro_filtered[2] = gyro_filtered[2] * stabSettings.gyro_alpha + gyroState.z * (1 - stabSettings.gyro_alpha);
 
-    PIOS_CALLBACKSCHEDULER_Dispatch(callbackHandle);
+    // releases this inner loop and, every n-th sample, the navigation loop
+    stabilizationRateGroupsTick(RATEGROUP_CLOCK_GYRO);
     stabSettings.monitor.gyroupdates++;
 }
 
@@ -47,19 +47,19 @@
 #include <cruisecontrol.h>
 #include <altitudeloop.h>
 #include <CoordinateConversions.h>
+#include <rategroups.h>
 
 // Private constants
 
 #define CALLBACK_PRIORITY CALLBACK_PRIORITY_REGULAR
 
-#define UPDATE_EXPECTED   (1.0f / PIOS_SENSOR_RATE)
+#define UPDATE_EXPECTED   (1.0f / OUTERLOOP_RATE)
 #define UPDATE_MIN        1.0e-6f
 #define UPDATE_MAX        1.0f
 #define UPDATE_ALPHA      1.0e-2f
 
 // Private variables
 static DelayedCallbackInfo *callbackHandle;
-static AttitudeStateData attitude;
 
 static uint8_t previous_mode[AXES] = { 255, 255, 255, 255 };
 static PiOSDeltatimeConfig timeval;
@@ -80,14 +80,14 @@ void stabilizationOuterloopInit()
     PIOS_DELTATIME_Init(&timeval, UPDATE_EXPECTED, UPDATE_MIN, UPDATE_MAX, UPDATE_ALPHA);
 
     callbackHandle = PIOS_CALLBACKSCHEDULER_Create(&stabilizationOuterloopTask, CALLBACK_PRIORITY, CBTASK_PRIORITY, CALLBACKINFO_RUNNING_STABILIZATION0, STACK_SIZE_BYTES);
+    // released on every OUTERLOOP_SKIPCOUNT-th AttitudeState update, so it runs on fresh attitude
+    stabilizationRateGroupAttach(RATEGROUP_OUTER, RATEGROUP_CLOCK_ATTITUDE, callbackHandle, OUTERLOOP_RATE, 0);
     AttitudeStateConnectCallback(AttitudeStateUpdatedCb);
 }
 
 
 /**
- * WARNING! This callback executes with critical flight control priority every
- * time a gyroscope update happens do NOT put any time consuming calculations
- * in this loop unless they really have to execute with every gyro update
+ * Released by the AttitudeState clock at OUTERLOOP_RATE
  */
 static void stabilizationOuterloopTask()
 {
@@ -96,6 +96,7 @@ static void stabilizationOuterloopTask()
     StabilizationDesiredData stabilizationDesired;
     StabilizationStatusOuterLoopData enabled;
 
+    stabilizationRateGroupBegin(RATEGROUP_OUTER);
     AttitudeStateGet(&attitudeState);
     StabilizationDesiredGet(&stabilizationDesired);
     RateDesiredGet(&rateDesired);
@@ -331,19 +332,13 @@ static void stabilizationOuterloopTask()
 // update cruisecontrol based on attitude
     cruisecontrol_compute_factor(&attitudeState, rateDesired.Thrust);
     stabSettings.monitor.rateupdates = 0;
+    stabilizationRateGroupEnd(RATEGROUP_OUTER);
 }
 
 
 static void AttitudeStateUpdatedCb(__attribute__((unused)) UAVObjEvent *ev)
 {
-    // to reduce CPU utilization, outer loop is not executed on every state update
-    static uint8_t cpusaver = 0;
-
-    if ((cpusaver++ % OUTERLOOP_SKIPCOUNT) == 0) {
-        // this does not need mutex protection as both eventdispatcher and stabi run in same callback task!
-        AttitudeStateGet(&attitude);
-        PIOS_CALLBACKSCHEDULER_Dispatch(callbackHandle);
-    }
+    stabilizationRateGroupsTick(RATEGROUP_CLOCK_ATTITUDE);
 }
 
 /**
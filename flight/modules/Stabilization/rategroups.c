@@ -0,0 +1,216 @@
+/**
+ ******************************************************************************
+ * @addtogroup OpenPilotModules OpenPilot Modules
+ * @{
+ * @addtogroup StabilizationModule Stabilization Module
+ * @brief Rate groups for the stabilization loops
+ * @note Groups are released by a sample clock, every GyroState or AttitudeState
+ * update is one tick of its clock. Each group owns a 0.32 fixed point phase
+ * accumulator that advances by rate / clock rate per tick and releases the
+ * group's callback when it wraps. The groups therefore stay phase locked to
+ * their input without drift, and a rate that is not an integer fraction of the
+ * clock rate is spread evenly.
+ * The inner loop is released on every gyro tick and the navigation loop on the
+ * same ticks as an inner loop run. The outer loop is released by the attitude
+ * clock, so it always sees a freshly published attitude. The lower priority
+ * callbacks share the callback task with the inner loop and run in the gap
+ * after it.
+ * @{
+ *
+ * @file       rategroups.c
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2014.
+ * @brief      Attitude stabilization module.
+ *
+ * @see        The GNU Public License (GPL) Version 3
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include <openpilot.h>
+#include <rategroups.h>
+
+#define PIOS_INSTRUMENT_MODULE
+#include <pios_instrumentation_helper.h>
+
+// perf counters 0x5AB100g1 (latency) and 0x5AB100g2 (execution time) for group g
+#define RATEGROUP_PERF_ID(group, n) (0x5AB10000 + ((uint32_t)(group) << 4) + (n))
+
+// Private types
+typedef struct {
+    DelayedCallbackInfo *callback;
+    RateGroupClock clock;
+    uint32_t step;        // rate / clock rate in 0.32 fixed point, 0 = every tick
+    uint32_t phase;
+    uint32_t deadline;    // [us] from release
+    uint32_t releaseTime; // raw PIOS_DELAY time of the pending release
+    bool     pending;     // released, not yet started
+    bool     running;     // started from a release, not yet ended
+    bool     overrun;     // overrun since the last stabilizationRateGroupsOverrun()
+    RateGroupStats stats;
+} RateGroup;
+
+// Private variables
+static RateGroup groups[RATEGROUP_NUMELEM];
+static float clockRate[RATEGROUP_CLOCK_NUMELEM];
+
+PERF_DEFINE_COUNTER(counterLatency[RATEGROUP_NUMELEM]);
+PERF_DEFINE_COUNTER(counterExec[RATEGROUP_NUMELEM]);
+
+/**
+ * Set up the rate groups, call before any group is attached
+ * @param[in] gyroRate nominal rate of GyroState updates [Hz]
+ * @param[in] attitudeRate nominal rate of AttitudeState updates [Hz]
+ */
+void stabilizationRateGroupsInit(float gyroRate, float attitudeRate)
+{
+    memset(groups, 0, sizeof(groups));
+    clockRate[RATEGROUP_CLOCK_GYRO]     = gyroRate;
+    clockRate[RATEGROUP_CLOCK_ATTITUDE] = attitudeRate;
+    for (uint8_t t = 0; t < RATEGROUP_NUMELEM; t++) {
+        PERF_INIT_COUNTER(counterLatency[t], RATEGROUP_PERF_ID(t, 1));
+        PERF_INIT_COUNTER(counterExec[t], RATEGROUP_PERF_ID(t, 2));
+    }
+}
+
+/**
+ * Let a sample clock release a callback
+ * @param[in] group the group to attach to
+ * @param[in] clock the sample clock that releases the group
+ * @param[in] callback released by the group, it must call stabilizationRateGroupBegin()/End()
+ * @param[in] rate release rate [Hz], at most the clock rate
+ * @param[in] deadline_us latest completion after the release, 0 for one period of the group
+ */
+void stabilizationRateGroupAttach(RateGroupId group, RateGroupClock clock, DelayedCallbackInfo *callback, float rate, uint32_t deadline_us)
+{
+    PIOS_Assert(group < RATEGROUP_NUMELEM && clock < RATEGROUP_CLOCK_NUMELEM && rate > 0.0f);
+    RateGroup *g = &groups[group];
+
+    const float tickRate = clockRate[clock];
+    float ratio  = rate / tickRate;
+    g->callback  = callback;
+    g->clock     = clock;
+    // 2^32 does not fit, a ratio of 1 (or more) is marked by step 0 instead
+    g->step      = (ratio < 1.0f) ? (uint32_t)(ratio * 4294967296.0f) : 0;
+    g->phase     = 0;
+    g->deadline  = deadline_us ? deadline_us : (uint32_t)(1e6f / ((ratio < 1.0f) ? rate : tickRate));
+}
+
+/**
+ * One tick of a sample clock. Called from the GyroState and AttitudeState
+ * callbacks, which run in the same callback task as the loops, so the group
+ * state needs no locking.
+ * @param[in] clock the sample clock that ticked
+ */
+void stabilizationRateGroupsTick(RateGroupClock clock)
+{
+    const uint32_t now = PIOS_DELAY_GetRaw();
+
+    for (uint8_t t = 0; t < RATEGROUP_NUMELEM; t++) {
+        RateGroup *g = &groups[t];
+        if (!g->callback || g->clock != clock) {
+            continue;
+        }
+        if (g->step) {
+            const uint32_t old = g->phase;
+            g->phase += g->step;
+            if (g->phase >= old) {
+                continue;
+            }
+        }
+        g->stats.releases++;
+        if (g->pending) {
+            // the previous release never got to run, keep its timestamp so the
+            // latency shows the full delay
+            g->stats.skipped++;
+        } else {
+            g->releaseTime = now;
+            g->pending     = true;
+        }
+        PIOS_CALLBACKSCHEDULER_Dispatch(g->callback);
+    }
+}
+
+/**
+ * Mark the start of a group's callback. Runs that were not released by the
+ * sample clock (failsafe calls) are not accounted.
+ */
+void stabilizationRateGroupBegin(RateGroupId group)
+{
+    RateGroup *g = &groups[group];
+
+    if (!g->pending) {
+        g->running = false;
+        return;
+    }
+    g->pending = false;
+    g->running = true;
+    g->stats.latency = PIOS_DELAY_DiffuS(g->releaseTime);
+    if (g->stats.latency > g->stats.latency_max) {
+        g->stats.latency_max = g->stats.latency;
+    }
+    PERF_TRACK_VALUE(counterLatency[group], g->stats.latency);
+    PERF_TIMED_SECTION_START(counterExec[group]);
+}
+
+/**
+ * Mark the end of a group's callback, checks the deadline
+ */
+void stabilizationRateGroupEnd(RateGroupId group)
+{
+    RateGroup *g = &groups[group];
+
+    if (!g->running) {
+        return;
+    }
+    g->running = false;
+    PERF_TIMED_SECTION_END(counterExec[group]);
+
+    const uint32_t total = PIOS_DELAY_DiffuS(g->releaseTime);
+    g->stats.exectime = total - g->stats.latency;
+    if (g->stats.exectime > g->stats.exectime_max) {
+        g->stats.exectime_max = g->stats.exectime;
+    }
+    if (total > g->deadline) {
+        g->stats.overruns++;
+        g->overrun = true;
+    }
+}
+
+/**
+ * @returns true if any group overran its deadline since the last call
+ */
+bool stabilizationRateGroupsOverrun()
+{
+    bool overrun = false;
+
+    for (uint8_t t = 0; t < RATEGROUP_NUMELEM; t++) {
+        overrun |= groups[t].overrun;
+        groups[t].overrun = false;
+    }
+    return overrun;
+}
+
+void stabilizationRateGroupGetStats(RateGroupId group, RateGroupStats *stats)
+{
+    PIOS_Assert(group < RATEGROUP_NUMELEM);
+    *stats = groups[group].stats;
+}
+
+/**
+ * @}
+ * @}
+ */
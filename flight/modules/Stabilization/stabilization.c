@@ -44,11 +44,12 @@
 #include <stabilizationsettingsbank2.h>
 #include <stabilizationsettingsbank3.h>
 #include <ratedesired.h>
-#include <sin_lookup.h>
+#include <fastmath.h>
 #include <stabilization.h>
 #include <innerloop.h>
 #include <outerloop.h>
 #include <altitudeloop.h>
+#include <rategroups.h>
 
 
 // Public variables
@@ -102,8 +103,8 @@ int32_t StabilizationInitialize()
     StabilizationSettingsBank3Initialize();
     RateDesiredInitialize();
     ManualControlCommandInitialize(); // only used for PID bank selection based on flight mode switch
-    sin_lookup_initalize();
 
+    stabilizationRateGroupsInit(PIOS_SENSOR_RATE, PIOS_SENSOR_RATE);
     stabilizationOuterloopInit();
     stabilizationInnerloopInit();
 #ifdef REVOLUTION
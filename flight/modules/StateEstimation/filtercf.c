@@ -171,6 +171,13 @@ static filterResult filter(stateFilter *self, stateEstimation *state)
 
     filterResult result = FILTERRESULT_OK;
 
+    if (IS_SET(state->updated, SENSORUPDATES_Be)) {
+        // local earth field from the mag filter, replaces the one at home
+        this->homeLocation.Be[0] = state->Be[0];
+        this->homeLocation.Be[1] = state->Be[1];
+        this->homeLocation.Be[2] = state->Be[2];
+    }
+
     if (IS_SET(state->updated, SENSORUPDATES_mag)) {
         this->magUpdated    = 1;
         this->currentMag[0] = state->mag[0];
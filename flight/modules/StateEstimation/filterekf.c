@@ -202,6 +202,13 @@ static filterResult filter(stateFilter *self, stateEstimation *state)
     float dT;
     uint16_t sensors = 0;
 
+    if (IS_SET(state->updated, SENSORUPDATES_Be)) {
+        // local earth field from the mag filter, replaces the one at home
+        this->homeLocation.Be[0] = state->Be[0];
+        this->homeLocation.Be[1] = state->Be[1];
+        this->homeLocation.Be[2] = state->Be[2];
+    }
+
     this->work.updated |= state->updated;
 
     // check magnetometer alarm, discard any magnetometer readings if not OK
@@ -37,12 +37,16 @@
 #include <systemalarms.h>
 #include <homelocation.h>
 #include <auxmagsettings.h>
+#include <gpspositionsensor.h>
+#include <gpstime.h>
 #include <CoordinateConversions.h>
+#include <WorldMagModel.h>
 #include <mathmisc.h>
 
 // Private constants
 //
-#define STACK_REQUIRED 256
+#define STACK_REQUIRED   256
+#define WMM_CACHE_RADIUS 5000.0f // m, the earth field is linearized over this distance
 
 // Private types
 struct data {
@@ -55,6 +59,9 @@ struct data {
     float   magBe;
     float   invMagBe;
     float   magBias[3];
+    bool    homeLocationSet;
+    bool    wmmCacheTried;
+    bool    wmmCacheRunning;
 };
 
 // Private variables
@@ -66,13 +73,18 @@ static filterResult filter(stateFilter *self, stateEstimation *state);
 static bool checkMagValidity(struct data *this, float error, bool setAlarms);
 static void magOffsetEstimation(struct data *this, float mag[3]);
 static float getMagError(struct data *this, float mag[3]);
+static void updateLocalBe(struct data *this, stateEstimation *state);
 
 int32_t filterMagInitialize(stateFilter *handle)
 {
     handle->init      = &init;
     handle->filter    = &filter;
     handle->localdata = pios_malloc(sizeof(struct data));
+    ((struct data *)handle->localdata)->wmmCacheTried   = false;
+    ((struct data *)handle->localdata)->wmmCacheRunning = false;
     HomeLocationInitialize();
+    GPSPositionSensorInitialize();
+    GPSTimeInitialize();
     return STACK_REQUIRED;
 }
 
@@ -83,6 +95,9 @@ static int32_t init(stateFilter *self)
     this->magBias[0]   = this->magBias[1] = this->magBias[2] = 0.0f;
     this->warningcount = this->errorcount = 0;
     HomeLocationBeGet(this->homeLocationBe);
+    uint8_t homeLocationSet;
+    HomeLocationSetGet(&homeLocationSet);
+    this->homeLocationSet = (homeLocationSet == HOMELOCATION_SET_TRUE);
     // magBe holds the magnetic vector length (expected)
     this->magBe    = vector_lengthf(this->homeLocationBe, 3);
     this->invMagBe = 1.0f / this->magBe;
@@ -101,6 +116,10 @@ static filterResult filter(stateFilter *self, stateEstimation *state)
     uint8_t temp_status = MAGSTATUS_INVALID;
     uint8_t magSamples  = 0;
 
+    if (IS_SET(state->updated, SENSORUPDATES_lla)) {
+        updateLocalBe(this, state);
+    }
+
     // Uses the external mag when available
     if ((this->auxMagUsage != AUXMAGSETTINGS_USAGE_ONBOARDONLY) &&
         IS_SET(state->updated, SENSORUPDATES_auxMag)) {
@@ -153,6 +172,54 @@ static filterResult filter(stateFilter *self, stateEstimation *state)
     return FILTERRESULT_OK;
 }
 
+/**
+ * Follow the earth magnetic field along the flight path instead of using the
+ * field at home for the whole flight. A low priority callback keeps the WMM
+ * linearized around a reference point close to the vehicle, so a lookup here
+ * is a few multiply-adds. Until the first reference point is there the home
+ * location field stays in use.
+ */
+static void updateLocalBe(struct data *this, stateEstimation *state)
+{
+    GPSPositionSensorData gps;
+    GPSTimeData time;
+    float Be[3];
+
+    if (!this->homeLocationSet) {
+        return;
+    }
+    GPSPositionSensorGet(&gps);
+    GPSTimeGet(&time);
+    if (gps.Status != GPSPOSITIONSENSOR_STATUS_FIX3D || time.Year < 2000) {
+        return;
+    }
+
+    if (!this->wmmCacheTried) {
+        // started on the first fix only, boards flying without GPS do not pay for it
+        this->wmmCacheTried   = true;
+        this->wmmCacheRunning = (WMM_CacheInitialize(WMM_CACHE_RADIUS) == 0);
+    }
+    if (!this->wmmCacheRunning) {
+        return;
+    }
+
+    if (WMM_GetMagVectorCached(gps.Latitude * 1e-7f, gps.Longitude * 1e-7f, gps.Altitude + gps.GeoidSeparation,
+                               time.Month, time.Day, time.Year, Be) < 0) {
+        return;
+    }
+
+    this->homeLocationBe[0] = Be[0];
+    this->homeLocationBe[1] = Be[1];
+    this->homeLocationBe[2] = Be[2];
+    this->magBe    = vector_lengthf(Be, 3);
+    this->invMagBe = 1.0f / this->magBe;
+
+    state->Be[0]   = Be[0];
+    state->Be[1]   = Be[1];
+    state->Be[2]   = Be[2];
+    state->updated |= SENSORUPDATES_Be;
+}
+
 /**
  * check validity of magnetometers
  */
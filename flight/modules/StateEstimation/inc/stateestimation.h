@@ -55,6 +55,7 @@ typedef enum {
         SENSORUPDATES_airspeed = 1 << 6,
         SENSORUPDATES_baro     = 1 << 7,
         SENSORUPDATES_lla      = 1 << 8,
+        SENSORUPDATES_Be       = 1 << 11,
 } sensorUpdates;
 
 #define MAGSTATUS_OK      1
@@ -72,6 +73,7 @@ typedef struct {
     float   auxMag[3];
     uint8_t magStatus;
     float   boardMag[3];
+    float   Be[3]; // earth magnetic field at the current position
     sensorUpdates updated;
 } stateEstimation;
 
@@ -635,6 +635,10 @@ static void updateSystemAlarms()
         sysStats.ObjectManagerQueueID    = objStats.lastQueueErrorID;
         SystemStatsSet(&sysStats);
     }
+
+    // instance data copied out of the object manager, cleared with the other counters above
+    uint32_t copyRate = (uint32_t)((float)objStats.bytesCopied * 1000.0f / SYSTEM_UPDATE_PERIOD_MS);
+    SystemStatsObjectManagerCopyRateSet(&copyRate);
 }
 
 /**
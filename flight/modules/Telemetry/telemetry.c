@@ -94,6 +94,7 @@
 #define MAX_RETRIES               2
 #define STATS_UPDATE_PERIOD_MS    4000
 #define CONNECTION_TIMEOUT_MS     8000
+#define DELTA_REFERENCE_BYTES     1024
 
 // Private types
 typedef struct {
@@ -124,6 +125,9 @@ static int32_t transmitRadioData(uint8_t *data, int32_t length);
 static void registerRadioObject(UAVObjHandle obj);
 static uint32_t radioPort();
 static uint32_t radio_port;
+static bool radioDeltaEncoding;
+static uint32_t radioDeltaPort;
+static void updateRadioDeltaEncoding();
 
 
 // Telemetry stats
@@ -300,6 +304,12 @@ int32_t TelemetryInitialize(void)
     // Initialise UAVTalk
     radioChannel.uavTalkCon = UAVTalkInitialize(&transmitRadioData);
 
+    // Send only the changed bytes of large objects over the radio if the GCS supports it
+    HwSettingsTelemetryDeltaEncodingOptions deltaEncoding;
+    HwSettingsTelemetryDeltaEncodingGet(&deltaEncoding);
+    radioDeltaEncoding = (deltaEncoding == HWSETTINGS_TELEMETRYDELTAENCODING_ENABLED);
+    radioDeltaPort     = 0;
+
     return 0;
 }
 
@@ -469,6 +479,10 @@ static void processObjEvent(
     int32_t retries;
     int32_t success;
 
+    if (channel == &radioChannel && radioDeltaEncoding) {
+        updateRadioDeltaEncoding();
+    }
+
     if (ev->obj == 0) {
         updateTelemetryStats();
     } else if (ev->obj == GCSTelemetryStatsHandle()) {
@@ -665,6 +679,21 @@ static uint32_t radioPort()
 }
 
 
+/**
+ * Enable delta encoding on the radio channel while it uses the radio port.
+ * USB has plenty of bandwidth, deltas would only cost CPU there.
+ */
+static void updateRadioDeltaEncoding()
+{
+    uint32_t port = radioPort();
+
+    if (port != radioDeltaPort) {
+        radioDeltaPort = port;
+        UAVTalkSetDeltaEncoding(radioChannel.uavTalkCon, (port && port == radio_port) ? DELTA_REFERENCE_BYTES : 0);
+    }
+}
+
+
 /**
  * Transmit data buffer to the modem or USB port.
  * \param[in] data Data buffer to send
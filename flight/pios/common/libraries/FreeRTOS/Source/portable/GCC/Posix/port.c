@@ -158,6 +158,8 @@ static volatile portBASE_TYPE xInterruptsEnabled = pdFALSE;
 static volatile portBASE_TYPE xSchedulerNesting = 0;
 static volatile portBASE_TYPE xPendYield = pdFALSE;
 static volatile portLONG lIndexOfLastAddedTask = 0;
+static volatile portBASE_TYPE xVirtualTime = pdFALSE;
+static portBASE_TYPE ( * volatile pxVirtualTimeGate )( TickType_t xTickCount ) = NULL;
 /*-----------------------------------------------------------*/
 
 /*
@@ -172,6 +174,9 @@ static xThreadState* prvGetThreadHandleByThread( pthread_t hThread );
 static portLONG prvGetFreeThreadState( void );
 static void prvDeleteThread( void *xThreadId );
 static void prvPortYield();
+static portBASE_TYPE prvAllTasksBlocked( void );
+static void prvRunVirtualTime( void );
+static void prvPreemptRunningTask( portBASE_TYPE xIncrementTick );
 /*-----------------------------------------------------------*/
 
 /*
@@ -291,6 +296,10 @@ portBASE_TYPE xPortStartScheduler( void )
 	/* Start the first task. This gives up the RunningThreadMutex*/
 	vPortStartFirstTask();
 
+	if ( pdTRUE == xVirtualTime ) {
+		prvRunVirtualTime();
+	}
+
 	/**
 	 * Main scheduling loop. Call the tick handler every
 	 * portTICK_RATE_MICROSECONDS
@@ -346,6 +355,109 @@ portBASE_TYPE xPortStartScheduler( void )
 }
 /*-----------------------------------------------------------*/
 
+/**
+ * Switch the scheduler to virtual time. Instead of following the wall
+ * clock, the tick is advanced as soon as every task is blocked, so
+ * simulated time runs as fast as the host can execute the firmware and
+ * scheduling depends only on the workload. Must be called before
+ * vTaskStartScheduler().
+ */
+portBASE_TYPE xPortSetVirtualTime( portBASE_TYPE xEnable )
+{
+#if ( INCLUDE_xTaskGetIdleTaskHandle == 1 )
+	if ( pdTRUE == xSchedulerStarted ) {
+		return pdFAIL;
+	}
+	xVirtualTime = xEnable ? pdTRUE : pdFALSE;
+	return pdPASS;
+#else
+	( void ) xEnable;
+	return pdFAIL;
+#endif
+}
+/*-----------------------------------------------------------*/
+
+portBASE_TYPE xPortIsVirtualTime( void )
+{
+	return xVirtualTime;
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * Hold the virtual clock. The gate is asked before every tick, it returns
+ * pdTRUE to let the tick happen. While it returns pdFALSE the clock stands
+ * still, but the scheduler keeps switching between the ready tasks of idle
+ * priority, so a receiver polling at that priority still gets its data in
+ * and wakes whoever waits for it. The gate is called from the scheduler
+ * thread, it must not call into FreeRTOS and must not block, the scheduler
+ * calls it again right away.
+ */
+void vPortSetVirtualTimeGate( portBASE_TYPE ( *pxGate )( TickType_t xTickCount ) )
+{
+	pxVirtualTimeGate = pxGate;
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * Current virtual time in microseconds, derived from the tick count.
+ */
+unsigned long ulPortGetVirtualTimeUS( void )
+{
+	return ( unsigned long ) xTaskGetTickCount() * portTICK_RATE_MICROSECONDS;
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * true if the idle task holds the CPU, which means every other task is
+ * waiting for a delay, queue or semaphore
+ */
+static portBASE_TYPE prvAllTasksBlocked( void )
+{
+#if ( INCLUDE_xTaskGetIdleTaskHandle == 1 )
+	portBASE_TYPE xBlocked;
+
+	PORT_LOCK( xGuardMutex );
+	xBlocked = ( xInterruptsEnabled == pdTRUE )
+		&& ( xTaskGetCurrentTaskHandle() == xTaskGetIdleTaskHandle() )
+		&& ( prvGetThreadHandle( xTaskGetCurrentTaskHandle() )->threadStatus == THREAD_RUNNING );
+	PORT_UNLOCK( xGuardMutex );
+	return xBlocked;
+#else
+	return pdFALSE;
+#endif
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * Virtual time scheduling loop. The tick is only advanced when the idle
+ * task was seen running twice in a row with a yield in between, so a task
+ * that was just woken up (or is handing over to another task) gets to run
+ * to completion before time moves on. Input from outside (UDP, serial) is
+ * not synchronised with this unless a gate holds the clock until it
+ * arrived, see vPortSetVirtualTimeGate().
+ */
+static void prvRunVirtualTime( void )
+{
+	while ( pdTRUE != xSchedulerEnd )
+	{
+		if ( pdTRUE == prvAllTasksBlocked() ) {
+			sched_yield();
+			if ( pdTRUE == prvAllTasksBlocked() ) {
+				if ( ( NULL == pxVirtualTimeGate ) || ( pdTRUE == pxVirtualTimeGate( xTaskGetTickCount() ) ) ) {
+					vPortSystemTickHandler();
+				} else {
+					/* the clock is held, let the tasks sharing the idle priority (the polling UDP receiver) run at the current tick */
+					xPendYield = pdFALSE;
+					prvPreemptRunningTask( pdFALSE );
+				}
+				continue;
+			}
+		}
+		sched_yield();
+	}
+}
+/*-----------------------------------------------------------*/
+
 /**
  * quickly clean up all running threads, without asking them first
  */
@@ -585,6 +697,16 @@ void vPortClearInterruptMask( portBASE_TYPE xMask )
  * the tick handler is just an ordinary function, called by the supervisor thread periodically
  */
 void vPortSystemTickHandler()
+{
+	prvPreemptRunningTask( pdTRUE );
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * stop the running task, optionally advance the tick, and switch to the
+ * highest priority ready task
+ */
+static void prvPreemptRunningTask( portBASE_TYPE xIncrementTick )
 {
 	/**
 	 * the problem with the tick handler is, that it runs outside of the schedulers domain - worse,
@@ -646,7 +768,9 @@ void vPortSystemTickHandler()
 	/**
 	 * call tick handler
 	 */
-	xTaskIncrementTick();
+	if ( pdTRUE == xIncrementTick ) {
+		xTaskIncrementTick();
+	}
 
 	
 #if ( configUSE_PREEMPTION == 1 )
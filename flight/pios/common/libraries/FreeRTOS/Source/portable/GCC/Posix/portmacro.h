@@ -158,6 +158,12 @@ extern void vPortForciblyEndThread( void *pxTaskToDelete );
 extern void vPortAddTaskHandle( void *pxTaskHandle );
 #define traceTASK_CREATE( pxNewTCB )			vPortAddTaskHandle( pxNewTCB )
 
+/* Virtual time: advance the tick whenever all tasks are blocked instead of following the wall clock. */
+extern portBASE_TYPE xPortSetVirtualTime( portBASE_TYPE xEnable );
+extern portBASE_TYPE xPortIsVirtualTime( void );
+extern void vPortSetVirtualTimeGate( portBASE_TYPE ( *pxGate )( TickType_t xTickCount ) );
+extern unsigned long ulPortGetVirtualTimeUS( void );
+
 /* Posix Signal definitions that can be changed or read as appropriate. */
 #define SIG_SUSPEND					SIGUSR1
 
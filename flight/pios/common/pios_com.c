@@ -59,6 +59,10 @@ struct pios_com_dev {
 
     t_fifo_buffer rx;
     t_fifo_buffer tx;
+
+    pios_com_callback_rx_notify rx_notify_cb;
+    uint32_t rx_notify_context;
+    uint16_t rx_notify_threshold;
 };
 
 static bool PIOS_COM_validate(struct pios_com_dev *com_dev)
@@ -217,7 +221,15 @@ static uint16_t PIOS_COM_RxInCallback(uint32_t context, uint8_t *buf, uint16_t b
     PIOS_Assert(valid);
     PIOS_Assert(com_dev->has_rx);
     uint16_t bytes_into_fifo;
-    if (buf_len == 1) {
+    if (buf_len == 0) {
+        /* Lower layer reports the line went idle (only if requested via rx_idle_notify) */
+        bytes_into_fifo = 0;
+        if (com_dev->rx_notify_cb && fifoBuf_getUsed(&com_dev->rx) > 0) {
+            (com_dev->rx_notify_cb)(com_dev->rx_notify_context, need_yield);
+        } else {
+            *need_yield = false;
+        }
+    } else if (buf_len == 1) {
         bytes_into_fifo = fifoBuf_putByte(&com_dev->rx, buf[0]);
     } else {
         bytes_into_fifo = fifoBuf_putData(&com_dev->rx, buf, buf_len);
@@ -225,6 +237,17 @@ static uint16_t PIOS_COM_RxInCallback(uint32_t context, uint8_t *buf, uint16_t b
     if (bytes_into_fifo > 0) {
         /* Data has been added to the buffer */
         PIOS_COM_UnblockRx(com_dev, need_yield);
+
+        /*
+         * Wake the consumer once per burst: when the line goes idle or the buffer
+         * fills up. Without idle detection only the threshold wakes it, the
+         * consumer picks up a shorter tail with its own bounded wait.
+         */
+        if (com_dev->rx_notify_cb && fifoBuf_getUsed(&com_dev->rx) >= com_dev->rx_notify_threshold) {
+            bool notify_need_yield = false;
+            (com_dev->rx_notify_cb)(com_dev->rx_notify_context, &notify_need_yield);
+            *need_yield |= notify_need_yield;
+        }
     }
 
     if (headroom) {
@@ -620,6 +643,98 @@ check_again:
     return bytes_from_fifo;
 }
 
+/**
+ * Register a callback that is invoked from the receive path once per burst of
+ * data instead of once per byte. The callback runs in interrupt context.
+ * The callback is invoked when at least \p threshold bytes are buffered and, if
+ * the driver is able to detect an idle line, when the line goes idle. Without
+ * idle detection the consumer has to wait with a timeout to pick up data below
+ * the threshold.
+ * \param[in] com_id COM port
+ * \param[in] rx_notify_cb Callback function, NULL to unregister
+ * \param[in] context context to pass to the callback function
+ * \param[in] threshold fill level that triggers the callback, clamped to half the rx buffer
+ * \return -1 if port not available
+ * \return 0 on success
+ */
+int32_t PIOS_COM_RegisterRxNotify(uint32_t com_id, pios_com_callback_rx_notify rx_notify_cb, uint32_t context, uint16_t threshold)
+{
+    struct pios_com_dev *com_dev = (struct pios_com_dev *)com_id;
+
+    if (!PIOS_COM_validate(com_dev) || !com_dev->has_rx) {
+        /* Undefined COM port for this board (see pios_board.c) */
+        return -1;
+    }
+
+    uint16_t max_threshold = fifoBuf_getSize(&com_dev->rx) / 2;
+    if (threshold > max_threshold) {
+        threshold = max_threshold;
+    }
+    if (threshold < 1) {
+        threshold = 1;
+    }
+
+    /* Disable notifications while the parameters are changed */
+    com_dev->rx_notify_cb        = NULL;
+    com_dev->rx_notify_context   = context;
+    com_dev->rx_notify_threshold = threshold;
+    com_dev->rx_notify_cb        = rx_notify_cb;
+
+    if (com_dev->driver->rx_idle_notify) {
+        (com_dev->driver->rx_idle_notify)(com_dev->lower_id, rx_notify_cb != NULL);
+    }
+
+    return 0;
+}
+
+/**
+ * Get the contiguous block of received data at the head of the receive buffer
+ * without copying it. The data stays in the buffer until it is released with
+ * PIOS_COM_ReceiveSpanDone(). Call again after releasing to get the part that
+ * wrapped around the end of the buffer.
+ * \param[in] com_id COM port
+ * \param[out] span pointer to the received data
+ * \returns number of bytes available at \p span
+ */
+uint16_t PIOS_COM_ReceiveSpan(uint32_t com_id, uint8_t * *span)
+{
+    PIOS_Assert(span);
+
+    struct pios_com_dev *com_dev = (struct pios_com_dev *)com_id;
+
+    if (!PIOS_COM_validate(com_dev)) {
+        /* Undefined COM port for this board (see pios_board.c) */
+        PIOS_Assert(0);
+    }
+    PIOS_Assert(com_dev->has_rx);
+
+    return fifoBuf_getDataSpan(&com_dev->rx, span);
+}
+
+/**
+ * Release data obtained from PIOS_COM_ReceiveSpan()
+ * \param[in] com_id COM port
+ * \param[in] len number of bytes consumed
+ */
+void PIOS_COM_ReceiveSpanDone(uint32_t com_id, uint16_t len)
+{
+    struct pios_com_dev *com_dev = (struct pios_com_dev *)com_id;
+
+    if (!PIOS_COM_validate(com_dev)) {
+        /* Undefined COM port for this board (see pios_board.c) */
+        PIOS_Assert(0);
+    }
+    PIOS_Assert(com_dev->has_rx);
+
+    fifoBuf_removeData(&com_dev->rx, len);
+
+    if (com_dev->driver->rx_start) {
+        /* Notify the lower layer that there is now room in the rx buffer */
+        (com_dev->driver->rx_start)(com_dev->lower_id,
+                                    fifoBuf_getFree(&com_dev->rx));
+    }
+}
+
 /**
  * Query if a com port is available for use.  That can be
  * used to check a link is established even if the device
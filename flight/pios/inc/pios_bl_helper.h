@@ -39,4 +39,13 @@ extern uint8_t PIOS_BL_HELPER_FLASH_Start();
 extern uint8_t PIOS_BL_HELPER_FLASH_Erase_Bootloader();
 extern void PIOS_BL_HELPER_CRC_Ini();
 
+/* sector level access, implemented for STM32F4xx only (see op_dfu.c stream uploads) */
+#if defined(STM32F4XX)
+extern uint8_t PIOS_BL_HELPER_FLASH_GetSector(uint32_t address, uint32_t *sector_start, uint32_t *sector_size);
+extern uint32_t PIOS_BL_HELPER_CRC_Block_Calc(uint32_t address, uint32_t size);
+#if defined(PIOS_INCLUDE_BL_HELPER_WRITE_SUPPORT)
+extern uint8_t PIOS_BL_HELPER_FLASH_Erase_Sector(uint32_t address);
+#endif
+#endif /* defined(STM32F4XX) */
+
 #endif /* PIOS_BL_HELPER_H */
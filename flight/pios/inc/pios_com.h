@@ -37,6 +37,7 @@
 
 typedef uint16_t (*pios_com_callback)(uint32_t context, uint8_t *buf, uint16_t buf_len, uint16_t *headroom, bool *task_woken);
 typedef void (*pios_com_callback_ctrl_line)(uint32_t context, uint32_t mask, uint32_t state);
+typedef void (*pios_com_callback_rx_notify)(uint32_t context, bool *need_yield);
 
 struct pios_com_driver {
     void (*init)(uint32_t id);
@@ -48,6 +49,7 @@ struct pios_com_driver {
     void (*bind_tx_cb)(uint32_t id, pios_com_callback tx_out_cb, uint32_t context);
     void (*bind_ctrl_line_cb)(uint32_t id, pios_com_callback_ctrl_line ctrl_line_cb, uint32_t context);
     bool (*available)(uint32_t id);
+    void (*rx_idle_notify)(uint32_t id, bool enable);
 };
 
 /* Control line definitions */
@@ -68,6 +70,9 @@ extern int32_t PIOS_COM_SendString(uint32_t com_id, const char *str);
 extern int32_t PIOS_COM_SendFormattedStringNonBlocking(uint32_t com_id, const char *format, ...);
 extern int32_t PIOS_COM_SendFormattedString(uint32_t com_id, const char *format, ...);
 extern uint16_t PIOS_COM_ReceiveBuffer(uint32_t com_id, uint8_t *buf, uint16_t buf_len, uint32_t timeout_ms);
+extern int32_t PIOS_COM_RegisterRxNotify(uint32_t com_id, pios_com_callback_rx_notify rx_notify_cb, uint32_t context, uint16_t threshold);
+extern uint16_t PIOS_COM_ReceiveSpan(uint32_t com_id, uint8_t * *span);
+extern void PIOS_COM_ReceiveSpanDone(uint32_t com_id, uint16_t len);
 extern bool PIOS_COM_Available(uint32_t com_id);
 
 #endif /* PIOS_COM_H */
@@ -0,0 +1,55 @@
+/**
+ ******************************************************************************
+ *
+ * @file       pios_lockstep.h
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2015.
+ * @brief      Holds the virtual clock of the simulation for an external model.
+ * @see        The GNU Public License (GPL) Version 3
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef PIOS_LOCKSTEP_H
+#define PIOS_LOCKSTEP_H
+
+/*
+ * Lockstep protocol, one datagram per message on the local machine, host byte order.
+ * The model (GCS) grants ticks, the firmware runs up to the granted tick, then holds
+ * the clock and reports its outputs. The layout is mirrored in the GCS sitlsimulator.h.
+ */
+#define PIOS_LOCKSTEP_MAGIC       0x4F504C53 /* "OPLS" */
+#define PIOS_LOCKSTEP_NUM_OUTPUTS 4
+
+enum pios_lockstep_type {
+    PIOS_LOCKSTEP_HOLD    = 0, /* firmware -> model: clock held at tick */
+    PIOS_LOCKSTEP_GRANT   = 1, /* model -> firmware: run until tick */
+    PIOS_LOCKSTEP_RELEASE = 2, /* model -> firmware: run freely */
+};
+
+struct pios_lockstep_msg {
+    uint32_t magic;
+    uint32_t type;
+    uint32_t tick;
+    uint32_t tick_us;
+    float    outputs[PIOS_LOCKSTEP_NUM_OUTPUTS];
+};
+
+/* Public Functions */
+extern int32_t PIOS_LOCKSTEP_Init(uint16_t port);
+extern void PIOS_LOCKSTEP_SetOutputs(const float *outputs, uint8_t count);
+
+#endif /* PIOS_LOCKSTEP_H */
@@ -83,6 +83,9 @@ extern void PIOS_LED_Init(void);
 #include <pios_irq.h>
 #include <pios_sdcard.h>
 #include <pios_udp.h>
+#ifdef PIOS_INCLUDE_LOCKSTEP
+#include <pios_lockstep.h>
+#endif
 #include <pios_com.h>
 #include <pios_servo.h>
 #include <pios_wdg.h>
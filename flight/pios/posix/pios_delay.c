@@ -41,6 +41,20 @@
  */
 #include <time.h>
 
+/**
+ * True if the scheduler runs on virtual time (see xPortSetVirtualTime()),
+ * in which case the delay clock follows the tick count instead of the
+ * wall clock.
+ */
+static inline bool PIOS_DELAY_IsVirtualTime(void)
+{
+#if defined(PIOS_INCLUDE_FREERTOS)
+    return xPortIsVirtualTime() == pdTRUE;
+#else
+    return false;
+#endif
+}
+
 int32_t PIOS_DELAY_Init(void)
 {
     // stub
@@ -63,6 +77,11 @@ int32_t PIOS_DELAY_WaituS(uint32_t uS)
 {
     static struct timespec wait, rest;
 
+    /* busy waits take no virtual time */
+    if (PIOS_DELAY_IsVirtualTime()) {
+        return 0;
+    }
+
     wait.tv_sec  = 0;
     wait.tv_nsec = 1000 * uS;
     while (nanosleep(&wait, &rest) != 0) {
@@ -90,6 +109,10 @@ int32_t PIOS_DELAY_WaitmS(uint32_t mS)
     // PIOS_DELAY_WaituS(1000);
     static struct timespec wait, rest;
 
+    if (PIOS_DELAY_IsVirtualTime()) {
+        return 0;
+    }
+
     wait.tv_sec  = mS / 1000;
     wait.tv_nsec = (mS % 1000) * 1000000;
     while (nanosleep(&wait, &rest) != 0) {
@@ -109,6 +132,13 @@ uint32_t PIOS_DELAY_GetuS()
 {
     static struct timespec current;
 
+    if (PIOS_DELAY_IsVirtualTime()) {
+#if defined(PIOS_INCLUDE_FREERTOS)
+        return (uint32_t)ulPortGetVirtualTimeUS();
+#endif
+
+    }
+
     clock_gettime(CLOCK_REALTIME, &current);
     return (current.tv_sec * 1000000) + (current.tv_nsec / 1000);
 }
@@ -0,0 +1,186 @@
+/**
+ ******************************************************************************
+ *
+ * @file       pios_lockstep.c
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2015.
+ * @brief      Holds the virtual clock of the simulation for an external model.
+ * @see        The GNU Public License (GPL) Version 3
+ * @defgroup   PIOS_LOCKSTEP Lockstep Functions
+ * @{
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+
+/* Project Includes */
+#include "pios.h"
+
+#if defined(PIOS_INCLUDE_LOCKSTEP)
+
+#include <pios_lockstep.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <time.h>
+
+/* a hold that was not answered is repeated after this time, in case a datagram got lost */
+#define PIOS_LOCKSTEP_RESEND_NS 1000000000LL
+
+static int lockstep_socket = -1;
+static struct sockaddr_in lockstep_peer;
+static bool lockstep_connected;
+static bool lockstep_released;
+static TickType_t lockstep_granted;
+static bool lockstep_hold_sent;
+static TickType_t lockstep_held;
+static struct timespec lockstep_hold_time;
+
+/* written by a task, read by the gate only while all tasks are blocked */
+static float lockstep_outputs[PIOS_LOCKSTEP_NUM_OUTPUTS];
+
+static portBASE_TYPE PIOS_LOCKSTEP_Gate(TickType_t tick);
+
+/**
+ * Open the lockstep socket and let it gate the virtual clock.
+ * The clock runs freely until the model sends its first grant.
+ * \param[in] port UDP port on the loopback interface
+ * \return < 0 if the socket can't be opened or the scheduler is not on virtual time
+ */
+int32_t PIOS_LOCKSTEP_Init(uint16_t port)
+{
+    struct sockaddr_in server;
+
+    if (xPortIsVirtualTime() != pdTRUE) {
+        return -1;
+    }
+
+    lockstep_socket = socket(PF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (lockstep_socket < 0) {
+        return -2;
+    }
+
+    memset(&server, 0, sizeof(server));
+    server.sin_family      = AF_INET;
+    server.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    server.sin_port = htons(port);
+    if (bind(lockstep_socket, (struct sockaddr *)&server, sizeof(server)) < 0) {
+        close(lockstep_socket);
+        lockstep_socket = -1;
+        return -3;
+    }
+
+    vPortSetVirtualTimeGate(PIOS_LOCKSTEP_Gate);
+
+    printf("lockstep socket %i listening on port %u\n", lockstep_socket, port);
+
+    return 0;
+}
+
+/**
+ * Set the outputs reported to the model with every hold.
+ * \param[in] outputs output values, missing ones are reported as 0
+ * \param[in] count number of values in outputs
+ */
+void PIOS_LOCKSTEP_SetOutputs(const float *outputs, uint8_t count)
+{
+    for (uint8_t i = 0; i < PIOS_LOCKSTEP_NUM_OUTPUTS; i++) {
+        lockstep_outputs[i] = (i < count) ? outputs[i] : 0.0f;
+    }
+}
+
+/**
+ * Drain the socket without blocking, remember who talks to us and what was granted.
+ */
+static void PIOS_LOCKSTEP_Receive()
+{
+    struct pios_lockstep_msg msg;
+    struct sockaddr_in peer;
+    socklen_t peer_len = sizeof(peer);
+
+    while (recvfrom(lockstep_socket, &msg, sizeof(msg), MSG_DONTWAIT, (struct sockaddr *)&peer, &peer_len) == sizeof(msg)) {
+        peer_len = sizeof(peer);
+        if (msg.magic != PIOS_LOCKSTEP_MAGIC) {
+            continue;
+        }
+        switch (msg.type) {
+        case PIOS_LOCKSTEP_GRANT:
+            lockstep_peer      = peer;
+            lockstep_connected = true;
+            lockstep_released  = false;
+            lockstep_granted   = msg.tick;
+            break;
+        case PIOS_LOCKSTEP_RELEASE:
+            lockstep_released  = true;
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+/**
+ * Report the held tick and the current outputs to the model.
+ */
+static void PIOS_LOCKSTEP_SendHold(TickType_t tick)
+{
+    struct pios_lockstep_msg msg;
+
+    msg.magic   = PIOS_LOCKSTEP_MAGIC;
+    msg.type    = PIOS_LOCKSTEP_HOLD;
+    msg.tick    = tick;
+    msg.tick_us = portTICK_RATE_MICROSECONDS;
+    memcpy(msg.outputs, lockstep_outputs, sizeof(msg.outputs));
+
+    sendto(lockstep_socket, &msg, sizeof(msg), 0, (struct sockaddr *)&lockstep_peer, sizeof(lockstep_peer));
+
+    lockstep_hold_sent = true;
+    lockstep_held = tick;
+    clock_gettime(CLOCK_MONOTONIC, &lockstep_hold_time);
+}
+
+/**
+ * Virtual time gate, runs on the scheduler thread and must not call into FreeRTOS.
+ * \param[in] tick the tick count that is about to be advanced
+ * \return pdTRUE to let the tick happen, pdFALSE to hold the clock
+ */
+static portBASE_TYPE PIOS_LOCKSTEP_Gate(TickType_t tick)
+{
+    struct timespec now;
+
+    PIOS_LOCKSTEP_Receive();
+
+    if (!lockstep_connected || lockstep_released) {
+        return pdTRUE;
+    }
+    if ((int32_t)(lockstep_granted - tick) > 0) {
+        return pdTRUE;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if (!lockstep_hold_sent || lockstep_held != tick
+        || (now.tv_sec - lockstep_hold_time.tv_sec) * 1000000000LL + (now.tv_nsec - lockstep_hold_time.tv_nsec) > PIOS_LOCKSTEP_RESEND_NS) {
+        PIOS_LOCKSTEP_SendHold(tick);
+    }
+
+    return pdFALSE;
+}
+
+#endif /* PIOS_INCLUDE_LOCKSTEP */
+
+/**
+ * @}
+ */
@@ -77,6 +77,14 @@ static pios_udp_dev *find_udp_dev_by_id(uint8_t udp)
 void *PIOS_UDP_RxThread(void *udp_dev_n)
 {
     pios_udp_dev *udp_dev = (pios_udp_dev *)udp_dev_n;
+    int flags = 0;
+
+#if defined(PIOS_INCLUDE_FREERTOS)
+    /* a task blocked in recvfrom() looks busy to the virtual clock and would stop it, poll instead */
+    if (xPortIsVirtualTime() == pdTRUE) {
+        flags = MSG_DONTWAIT;
+    }
+#endif /* PIOS_INCLUDE_FREERTOS */
 
     /**
      * com devices never get closed except by application "reboot"
@@ -91,7 +99,7 @@ void *PIOS_UDP_RxThread(void *udp_dev_n)
         if ((received = recvfrom(udp_dev->socket,
                                  &udp_dev->rx_buffer,
                                  PIOS_UDP_RX_BUFFER_SIZE,
-                                 0,
+                                 flags,
                                  (struct sockaddr *)&udp_dev->client,
                                  (socklen_t *)&udp_dev->clientLength)) >= 0) {
             /* copy received data to buffer if possible */
@@ -108,6 +116,11 @@ void *PIOS_UDP_RxThread(void *udp_dev_n)
             }
 #endif /* PIOS_INCLUDE_FREERTOS */
         }
+#if defined(PIOS_INCLUDE_FREERTOS)
+        else if (flags & MSG_DONTWAIT) {
+            taskYIELD();
+        }
+#endif /* PIOS_INCLUDE_FREERTOS */
     }
 }
 
@@ -139,7 +152,9 @@ int32_t PIOS_UDP_Init(uint32_t *udp_id, const struct pios_udp_cfg *cfg)
     /* Create transmit thread for this connection */
 #if defined(PIOS_INCLUDE_FREERTOS)
 // ( pdTASK_CODE pvTaskCode, const portCHAR * const pcName, unsigned portSHORT usStackDepth, void *pvParameters, unsigned portBASE_TYPE uxPriority, xTaskHandle *pvCreatedTask );
-    xTaskCreate((pdTASK_CODE)PIOS_UDP_RxThread, "UDP_Rx_Thread", 1024, (void *)udp_dev, (tskIDLE_PRIORITY + 1), &udp_dev->rxThread);
+    /* in virtual time the receiver polls, it shares the idle priority so the clock can still advance */
+    xTaskCreate((pdTASK_CODE)PIOS_UDP_RxThread, "UDP_Rx_Thread", 1024, (void *)udp_dev,
+                (xPortIsVirtualTime() == pdTRUE) ? tskIDLE_PRIORITY : (tskIDLE_PRIORITY + 1), &udp_dev->rxThread);
 #else
     pthread_create(&udp_dev->rxThread, NULL, PIOS_UDP_RxThread, (void *)udp_dev);
 #endif
@@ -40,13 +40,15 @@ static void PIOS_USART_RegisterRxCallback(uint32_t usart_id, pios_com_callback r
 static void PIOS_USART_RegisterTxCallback(uint32_t usart_id, pios_com_callback tx_out_cb, uint32_t context);
 static void PIOS_USART_TxStart(uint32_t usart_id, uint16_t tx_bytes_avail);
 static void PIOS_USART_RxStart(uint32_t usart_id, uint16_t rx_bytes_avail);
+static void PIOS_USART_RxIdleNotify(uint32_t usart_id, bool enable);
 
 const struct pios_com_driver pios_usart_com_driver = {
-    .set_baud   = PIOS_USART_ChangeBaud,
-    .tx_start   = PIOS_USART_TxStart,
-    .rx_start   = PIOS_USART_RxStart,
-    .bind_tx_cb = PIOS_USART_RegisterTxCallback,
-    .bind_rx_cb = PIOS_USART_RegisterRxCallback,
+    .set_baud       = PIOS_USART_ChangeBaud,
+    .tx_start       = PIOS_USART_TxStart,
+    .rx_start       = PIOS_USART_RxStart,
+    .bind_tx_cb     = PIOS_USART_RegisterTxCallback,
+    .bind_rx_cb     = PIOS_USART_RegisterRxCallback,
+    .rx_idle_notify = PIOS_USART_RxIdleNotify,
 };
 
 enum pios_usart_dev_magic {
@@ -61,6 +63,7 @@ struct pios_usart_dev {
     uint32_t rx_in_context;
     pios_com_callback tx_out_cb;
     uint32_t tx_out_context;
+    bool     rx_idle_notify;
 
     uint32_t rx_dropped;
 };
@@ -213,6 +216,17 @@ static void PIOS_USART_RxStart(uint32_t usart_id, __attribute__((unused)) uint16
 
     USART_ITConfig(usart_dev->cfg->regs, USART_IT_RXNE, ENABLE);
 }
+static void PIOS_USART_RxIdleNotify(uint32_t usart_id, bool enable)
+{
+    struct pios_usart_dev *usart_dev = (struct pios_usart_dev *)usart_id;
+
+    bool valid = PIOS_USART_validate(usart_dev);
+
+    PIOS_Assert(valid);
+
+    usart_dev->rx_idle_notify = enable;
+    USART_ITConfig(usart_dev->cfg->regs, USART_IT_IDLE, enable ? ENABLE : DISABLE);
+}
 static void PIOS_USART_TxStart(uint32_t usart_id, __attribute__((unused)) uint16_t tx_bytes_avail)
 {
     struct pios_usart_dev *usart_dev = (struct pios_usart_dev *)usart_id;
@@ -307,6 +321,16 @@ static void PIOS_USART_generic_irq_handler(uint32_t usart_id)
         }
     }
 
+    /* Check if IDLE flag is set (cleared by the sr/dr read above) */
+    if ((sr & USART_SR_IDLE) && usart_dev->rx_idle_notify) {
+        bool idle_need_yield = false;
+        if (usart_dev->rx_in_cb) {
+            /* Zero length receive signals the idle line to the COM layer */
+            (void)(usart_dev->rx_in_cb)(usart_dev->rx_in_context, NULL, 0, NULL, &idle_need_yield);
+        }
+        rx_need_yield |= idle_need_yield;
+    }
+
     /* Check if TXE flag is set */
     bool tx_need_yield = false;
     if (sr & USART_SR_TXE) {
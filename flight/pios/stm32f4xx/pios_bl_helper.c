@@ -41,17 +41,6 @@ uint8_t *PIOS_BL_HELPER_FLASH_If_Read(uint32_t SectorAddress)
     return (uint8_t *)(SectorAddress);
 }
 
-#if defined(PIOS_INCLUDE_BL_HELPER_WRITE_SUPPORT)
-
-static bool erase_flash(uint32_t startAddress, uint32_t endAddress);
-
-uint8_t PIOS_BL_HELPER_FLASH_Ini()
-{
-    FLASH_Unlock();
-    FLASH_ClearFlag(FLASH_FLAG_EOP | FLASH_FLAG_OPERR | FLASH_FLAG_WRPERR | FLASH_FLAG_PGAERR | FLASH_FLAG_PGPERR | FLASH_FLAG_PGSERR);
-    return 1;
-}
-
 struct device_flash_sector {
     uint32_t start;
     uint32_t size;
@@ -138,6 +127,24 @@ static bool PIOS_BL_HELPER_FLASH_GetSectorInfo(uint32_t address, uint8_t *sector
     return false;
 }
 
+uint8_t PIOS_BL_HELPER_FLASH_GetSector(uint32_t address, uint32_t *sector_start, uint32_t *sector_size)
+{
+    uint8_t sector_number;
+
+    return PIOS_BL_HELPER_FLASH_GetSectorInfo(address, &sector_number, sector_start, sector_size) ? 1 : 0;
+}
+
+#if defined(PIOS_INCLUDE_BL_HELPER_WRITE_SUPPORT)
+
+static bool erase_flash(uint32_t startAddress, uint32_t endAddress);
+
+uint8_t PIOS_BL_HELPER_FLASH_Ini()
+{
+    FLASH_Unlock();
+    FLASH_ClearFlag(FLASH_FLAG_EOP | FLASH_FLAG_OPERR | FLASH_FLAG_WRPERR | FLASH_FLAG_PGAERR | FLASH_FLAG_PGPERR | FLASH_FLAG_PGSERR);
+    return 1;
+}
+
 uint8_t PIOS_BL_HELPER_FLASH_Start()
 {
     const struct pios_board_info *bdinfo = &pios_board_info_blob;
@@ -161,6 +168,23 @@ uint8_t PIOS_BL_HELPER_FLASH_Erase_Bootloader()
     return (success) ? 1 : 0;
 }
 
+/**
+ * Erase the sector (page) that contains address
+ */
+uint8_t PIOS_BL_HELPER_FLASH_Erase_Sector(uint32_t address)
+{
+    uint32_t sector_start;
+    uint32_t sector_size;
+
+    if (!PIOS_BL_HELPER_FLASH_GetSector(address, &sector_start, &sector_size)) {
+        return 0;
+    }
+
+    bool success = erase_flash(sector_start, sector_start + sector_size);
+
+    return (success) ? 1 : 0;
+}
+
 static bool erase_flash(uint32_t startAddress, uint32_t endAddress)
 {
     uint32_t pageAddress = startAddress;
@@ -203,6 +227,18 @@ uint32_t PIOS_BL_HELPER_CRC_Memory_Calc()
     return CRC_GetCRC();
 }
 
+/**
+ * CRC of size bytes (a multiple of 4) at address, same polynomial and start
+ * value as PIOS_BL_HELPER_CRC_Memory_Calc()
+ */
+uint32_t PIOS_BL_HELPER_CRC_Block_Calc(uint32_t address, uint32_t size)
+{
+    PIOS_BL_HELPER_CRC_Ini();
+    CRC_ResetDR();
+    CRC_CalcBlockCRC((uint32_t *)address, size >> 2);
+    return CRC_GetCRC();
+}
+
 void PIOS_BL_HELPER_FLASH_Read_Description(uint8_t *array, uint8_t size)
 {
     const struct pios_board_info *bdinfo = &pios_board_info_blob;
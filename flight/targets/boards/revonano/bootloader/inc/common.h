@@ -70,8 +70,10 @@ typedef enum {
     Download_Req, // 9
     Download, // 10
     Status_Request, // 11
-    Status_Rep
-// 12
+    Status_Rep, // 12
+    Req_SectorCRCs, // 13
+    Rep_SectorCRCs
+// 14
 } DFUCommands;
 
 typedef enum {
@@ -112,4 +114,11 @@ typedef enum {
 #define MAX_DEL_RETRYS 3
 #define MAX_WRI_RETRYS 3
 
+/**************************************************/
+/* OP_DFU differential stream upload              */
+/**************************************************/
+#define DFU_FEATURE_STREAM         0x01 // Rep_Capabilities byte 16, sector CRCs and stream uploads
+#define DFU_UPLOAD_STREAM_MAGIC    0x5354524D // "STRM" in DATA + 6 of the Upload start packet
+#define DFU_SECTOR_CRCS_PER_PACKET 4
+
 #endif /* COMMON_H_ */
@@ -40,5 +40,6 @@
 #define PIOS_INCLUDE_COM_MSG
 #define PIOS_INCLUDE_BL_HELPER
 #define PIOS_INCLUDE_BL_HELPER_WRITE_SUPPORT
+#define PIOS_INCLUDE_DFU_STREAM /* sector CRCs and differential stream uploads, see op_dfu.c */
 
 #endif /* PIOS_CONFIG_H */
@@ -85,6 +85,7 @@
 #define INCLUDE_vTaskDelay                           1
 #define INCLUDE_xTaskGetSchedulerState               1
 #define INCLUDE_xTaskGetCurrentTaskHandle            1
+#define INCLUDE_xTaskGetIdleTaskHandle               1
 #define INCLUDE_uxTaskGetStackHighWaterMark          0
 
 
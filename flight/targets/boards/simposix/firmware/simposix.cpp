@@ -35,6 +35,8 @@ extern "C" {
 #include "inc/openpilot.h"
 #include <systemmod.h>
 #include <uavobjectsinit.h>
+#include <actuatordesired.h>
+#include <flightstatus.h>
 
 /* Task Priorities */
 #define PRIORITY_TASK_HOOKS (tskIDLE_PRIORITY + 3)
@@ -72,6 +74,10 @@ static xTaskHandle initTaskHandle;
 
 /* Function Prototypes */
 static void initTask(void *parameters);
+static void lockstepOutputsUpdated(UAVObjEvent *ev);
+
+/* UDP port of the lockstep socket, 0 if the clock runs freely */
+static uint16_t lockstepPort = 0;
 
 /* Prototype of generated InitModules() function */
 extern void InitModules(void);
@@ -85,11 +91,33 @@ extern void InitModules(void);
  * Start FreeRTOS Scheduler (vTaskStartScheduler)<BR>
  * If something goes wrong, blink LED1 and LED2 every 100ms
  *
+ * Passing --virtual-time runs the scheduler on virtual time: the system
+ * tick advances whenever all tasks are blocked, so the firmware runs as
+ * fast as the host allows with reproducible task interleaving.
+ *
+ * Passing --lockstep <port> in addition lets a simulation model (the GCS
+ * built-in simulator) hold the virtual clock over a loopback UDP socket
+ * until it delivered the sensor data for the current tick.
  */
-int main()
+int main(int argc, char *argv[])
 {
     int result;
 
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--virtual-time")) {
+            result = xPortSetVirtualTime(pdTRUE);
+            PIOS_Assert(result == pdPASS);
+        } else if (!strcmp(argv[i], "--lockstep") && i + 1 < argc) {
+            lockstepPort = atoi(argv[++i]);
+        }
+    }
+
+    if (lockstepPort) {
+        /* needs --virtual-time, a wall clock can't be held */
+        result = PIOS_LOCKSTEP_Init(lockstepPort);
+        PIOS_Assert(result == 0);
+    }
+
     /* NOTE: Do NOT modify the following start-up sequence */
     /* Any new initialization functions should be added in OpenPilotInit() */
 
@@ -130,10 +158,35 @@ void initTask(__attribute__((unused)) void *parameters)
     /* Initialize modules */
     MODULE_INITIALISE_ALL;
 
+    if (lockstepPort) {
+        ActuatorDesiredConnectCallback(lockstepOutputsUpdated);
+        FlightStatusConnectCallback(lockstepOutputsUpdated);
+    }
+
     /* terminate this task */
     vTaskDelete(NULL);
 }
 
+/**
+ * Report roll, pitch, yaw and thrust to the lockstep model, all zero while disarmed.
+ */
+static void lockstepOutputsUpdated(__attribute__((unused)) UAVObjEvent *ev)
+{
+    float outputs[PIOS_LOCKSTEP_NUM_OUTPUTS] = { 0 };
+    uint8_t armed;
+
+    FlightStatusArmedGet(&armed);
+    if (armed == FLIGHTSTATUS_ARMED_ARMED) {
+        ActuatorDesiredData desired;
+        ActuatorDesiredGet(&desired);
+        outputs[0] = desired.Roll;
+        outputs[1] = desired.Pitch;
+        outputs[2] = desired.Yaw;
+        outputs[3] = desired.Thrust;
+    }
+    PIOS_LOCKSTEP_SetOutputs(outputs, PIOS_LOCKSTEP_NUM_OUTPUTS);
+}
+
 /**
  * @}
  * @}
@@ -0,0 +1,154 @@
+/**
+ ******************************************************************************
+ *
+ * @file       benchmark.c
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2014.
+ * @brief      Host timings of the math3d.h kernels and fastmath.h tiers
+ *             against the functions they replace. The accuracy checks live
+ *             in the math unit test.
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "mathmisc.h"
+#include "math3d.h"
+#include "fastmath.h"
+#include "CoordinateConversions.h"
+
+#define BENCH_SAMPLES 10000000
+#define BENCH_BATCH   32
+
+// keeps the compiler from dropping the timed loops
+static volatile float sink;
+
+static uint32_t seed = 42;
+
+// Deterministic pseudo random numbers in [-1, 1)
+static float rnd(void)
+{
+    seed = seed * 1103515245u + 12345u;
+    return (float)((seed >> 8) & 0xffff) / 32768.0f - 1.0f;
+}
+
+static double elapsed_ms(clock_t start)
+{
+    return (double)(clock() - start) / CLOCKS_PER_SEC * 1e3;
+}
+
+static void bench_math3d(void)
+{
+    static float in[BENCH_BATCH][3], out[BENCH_BATCH][3];
+    float rpy[3] = { 180.0f * rnd(), 89.0f * rnd(), 180.0f * rnd() };
+    float q[4], R[3][3], acc = 0.0f;
+    clock_t t;
+
+    RPY2Quaternion(rpy, q);
+    for (int i = 0; i < BENCH_BATCH; i++) {
+        for (int j = 0; j < 3; j++) {
+            in[i][j] = rnd();
+        }
+    }
+
+    t = clock();
+    for (int n = 0; n < BENCH_SAMPLES / BENCH_BATCH; n++) {
+        Quaternion2R(q, R);
+        for (int i = 0; i < BENCH_BATCH; i++) {
+            rot_mult(R, in[i], out[i]);
+        }
+        acc += out[n % BENCH_BATCH][0];
+    }
+    double t_ref = elapsed_ms(t);
+
+    t = clock();
+    for (int n = 0; n < BENCH_SAMPLES / BENCH_BATCH; n++) {
+        m3d_quat_rotate_batch(q, in, out, BENCH_BATCH);
+        acc += out[n % BENCH_BATCH][0];
+    }
+    double t_batch = elapsed_ms(t);
+
+    t = clock();
+    for (int n = 0; n < BENCH_SAMPLES; n++) {
+        float q2[4];
+        quat_mult(q, q, q2);
+        acc += q2[0];
+    }
+    double t_qref = elapsed_ms(t);
+
+    t = clock();
+    for (int n = 0; n < BENCH_SAMPLES; n++) {
+        float q2[4];
+        m3d_quat_mult(q, q, q2);
+        acc += q2[0];
+    }
+    double t_q = elapsed_ms(t);
+
+    sink = acc;
+    printf("rotate %d vectors: rot_mult %.2f ms, m3d_quat_rotate_batch %.2f ms\n", BENCH_SAMPLES, t_ref, t_batch);
+    printf("%d quaternion products: quat_mult %.2f ms, m3d_quat_mult %.2f ms\n", BENCH_SAMPLES, t_qref, t_q);
+}
+
+#define FASTMATH_BENCH(expr, result) \
+    acc = 0.0f; \
+    t   = clock(); \
+    for (int n = 0; n < BENCH_SAMPLES; n++) { \
+        float x = in[n % BENCH_BATCH]; \
+        acc += (expr); \
+    } \
+    result = elapsed_ms(t); \
+    sink   = acc;
+
+static void bench_fastmath(void)
+{
+    static float in[BENCH_BATCH];
+    double t_libm, t_coarse, t_fine;
+    float acc;
+    clock_t t;
+
+    for (int i = 0; i < BENCH_BATCH; i++) {
+        in[i] = 4.0f * (float)i / BENCH_BATCH - 2.0f;
+    }
+
+    FASTMATH_BENCH(sinf(x), t_libm);
+    FASTMATH_BENCH(fast_sinf_coarse(x), t_coarse);
+    FASTMATH_BENCH(fast_sinf(x), t_fine);
+    printf("%d sin: libm %.2f ms, coarse %.2f ms, fine %.2f ms\n", BENCH_SAMPLES, t_libm, t_coarse, t_fine);
+
+    FASTMATH_BENCH(atan2f(x, 0.7f), t_libm);
+    FASTMATH_BENCH(fast_atan2f_coarse(x, 0.7f), t_coarse);
+    FASTMATH_BENCH(fast_atan2f(x, 0.7f), t_fine);
+    printf("%d atan2: libm %.2f ms, coarse %.2f ms, fine %.2f ms\n", BENCH_SAMPLES, t_libm, t_coarse, t_fine);
+
+    FASTMATH_BENCH(asinf(x * 0.5f), t_libm);
+    FASTMATH_BENCH(fast_asinf_coarse(x * 0.5f), t_coarse);
+    FASTMATH_BENCH(fast_asinf(x * 0.5f), t_fine);
+    printf("%d asin: libm %.2f ms, coarse %.2f ms, fine %.2f ms\n", BENCH_SAMPLES, t_libm, t_coarse, t_fine);
+
+    FASTMATH_BENCH(1.0f / sqrtf(x + 3.0f), t_libm);
+    FASTMATH_BENCH(fast_invsqrtf_coarse(x + 3.0f), t_coarse);
+    FASTMATH_BENCH(fast_invsqrtf(x + 3.0f), t_fine);
+    printf("%d invsqrt: libm %.2f ms, coarse %.2f ms, fine %.2f ms\n", BENCH_SAMPLES, t_libm, t_coarse, t_fine);
+}
+
+int main(void)
+{
+    bench_math3d();
+    bench_fastmath();
+    return 0;
+}
@@ -6,6 +6,9 @@
 
 extern "C" {
 #include "mathmisc.h"
+#include "math3d.h"
+#include "fastmath.h"
+#include "CoordinateConversions.h"
 }
 
 #define epsilon 0.00001f
@@ -108,3 +111,236 @@ TEST_F(MathTestRaw, y_on_curve1) {
     EXPECT_NEAR(-0.35f, y_on_curve(1.250f, points, length(points)), epsilon);
     EXPECT_NEAR(-0.50f, y_on_curve(2.000f, points, length(points)), epsilon);
 }
+
+// Compares the inline kernels of math3d.h with the CoordinateConversions functions they replace
+class Math3DTest : public testing::Test {
+protected:
+    // Deterministic pseudo random numbers in [-1, 1)
+    float rnd()
+    {
+        seed = seed * 1103515245u + 12345u;
+        return (float)((seed >> 8) & 0xffff) / 32768.0f - 1.0f;
+    }
+
+    void rndQuat(float q[4])
+    {
+        float rpy[3] = { 180.0f * rnd(), 89.0f * rnd(), 180.0f * rnd() };
+
+        RPY2Quaternion(rpy, q);
+    }
+
+    virtual void SetUp()
+    {
+        seed = 42;
+    }
+
+    uint32_t seed;
+};
+
+#define math3d_epsilon 1e-5f
+#define MATH3D_BATCH   32
+
+TEST_F(Math3DTest, quat_mult) {
+    for (int i = 0; i < 1000; i++) {
+        float q1[4], q2[4], ref[4], out[4];
+        rndQuat(q1);
+        rndQuat(q2);
+        quat_mult(q1, q2, ref);
+        m3d_quat_mult(q1, q2, out);
+        for (int j = 0; j < 4; j++) {
+            EXPECT_NEAR(ref[j], out[j], math3d_epsilon);
+        }
+        // in place
+        m3d_quat_mult(q1, q2, q1);
+        for (int j = 0; j < 4; j++) {
+            EXPECT_NEAR(ref[j], q1[j], math3d_epsilon);
+        }
+    }
+}
+
+TEST_F(Math3DTest, quat2R_rpy2quat) {
+    for (int i = 0; i < 1000; i++) {
+        float rpy[3] = { 180.0f * rnd(), 89.0f * rnd(), 180.0f * rnd() };
+        float qref[4], q[4], Rref[3][3], R[3][3];
+
+        RPY2Quaternion(rpy, qref);
+        m3d_rpy2quat(rpy, q);
+        for (int j = 0; j < 4; j++) {
+            EXPECT_NEAR(qref[j], q[j], math3d_epsilon);
+        }
+
+        Quaternion2R(qref, Rref);
+        m3d_quat2R(qref, R);
+        for (int j = 0; j < 3; j++) {
+            for (int k = 0; k < 3; k++) {
+                EXPECT_NEAR(Rref[j][k], R[j][k], math3d_epsilon);
+            }
+        }
+    }
+}
+
+TEST_F(Math3DTest, rotations) {
+    for (int i = 0; i < 1000; i++) {
+        float q[4], R[3][3];
+        float v[3] = { 10.0f * rnd(), 10.0f * rnd(), 10.0f * rnd() };
+        float ref[3], out[3], back[3];
+
+        rndQuat(q);
+        Quaternion2R(q, R);
+        rot_mult(R, v, ref);
+
+        m3d_rot_mult(R, v, out);
+        for (int j = 0; j < 3; j++) {
+            EXPECT_NEAR(ref[j], out[j], 10.0f * math3d_epsilon);
+        }
+
+        m3d_quat_rotate(q, v, out);
+        for (int j = 0; j < 3; j++) {
+            EXPECT_NEAR(ref[j], out[j], 10.0f * math3d_epsilon);
+        }
+
+        m3d_rot_mult_transpose(R, ref, back);
+        for (int j = 0; j < 3; j++) {
+            EXPECT_NEAR(v[j], back[j], 10.0f * math3d_epsilon);
+        }
+    }
+}
+
+TEST_F(Math3DTest, batch) {
+    float q[4], R[3][3];
+    float in[MATH3D_BATCH][3], out[MATH3D_BATCH][3], back[MATH3D_BATCH][3];
+
+    rndQuat(q);
+    Quaternion2R(q, R);
+    for (int i = 0; i < MATH3D_BATCH; i++) {
+        for (int j = 0; j < 3; j++) {
+            in[i][j] = 10.0f * rnd();
+        }
+    }
+
+    m3d_quat_rotate_batch(q, in, out, MATH3D_BATCH);
+    m3d_rot_mult_transpose_batch(R, out, back, MATH3D_BATCH);
+    for (int i = 0; i < MATH3D_BATCH; i++) {
+        float ref[3];
+        rot_mult(R, in[i], ref);
+        for (int j = 0; j < 3; j++) {
+            EXPECT_NEAR(ref[j], out[i][j], 10.0f * math3d_epsilon);
+            EXPECT_NEAR(in[i][j], back[i][j], 10.0f * math3d_epsilon);
+        }
+    }
+
+    // in place
+    m3d_rot_mult_batch(R, in, in, MATH3D_BATCH);
+    for (int i = 0; i < MATH3D_BATCH; i++) {
+        for (int j = 0; j < 3; j++) {
+            EXPECT_NEAR(out[i][j], in[i][j], 10.0f * math3d_epsilon);
+        }
+    }
+}
+
+TEST_F(Math3DTest, vectors) {
+    for (int i = 0; i < 1000; i++) {
+        float a[3] = { rnd(), rnd(), rnd() };
+        float b[3] = { rnd(), rnd(), rnd() };
+        float ref[3], out[3];
+
+        CrossProduct(a, b, ref);
+        m3d_vec_cross(a, b, out);
+        for (int j = 0; j < 3; j++) {
+            EXPECT_NEAR(ref[j], out[j], math3d_epsilon);
+        }
+        EXPECT_NEAR(VectorMagnitude(a), m3d_vec_length(a), math3d_epsilon);
+        EXPECT_NEAR(0.0f, m3d_vec_dot(out, a), math3d_epsilon);
+
+        float mag = VectorMagnitude(a);
+        EXPECT_NEAR(mag, m3d_vec_normalize(a), math3d_epsilon);
+        EXPECT_NEAR(1.0f, m3d_vec_length(a), math3d_epsilon);
+    }
+
+    float zero[3] = { 0.0f, 0.0f, 0.0f };
+    EXPECT_EQ(0.0f, m3d_vec_normalize(zero));
+    EXPECT_EQ(0.0f, zero[0]);
+}
+
+// Measures the worst case error of the fastmath.h tiers against double precision libm
+// and checks it against the bounds documented in fastmath.h
+class FastMathTest : public testing::Test {};
+
+#define FASTMATH_STEPS 200000
+
+TEST_F(FastMathTest, sincos) {
+    double err_c = 0.0, err_f = 0.0, err_sc = 0.0;
+
+    for (int i = -FASTMATH_STEPS; i <= FASTMATH_STEPS; i++) {
+        // dense around zero, out to 1e4 rad at the ends
+        float x = (float)(i * (double)i * i * (1e4 / ((double)FASTMATH_STEPS * FASTMATH_STEPS * FASTMATH_STEPS)) + i * 1e-4);
+        double s = sin((double)x), c = cos((double)x);
+        float fs, fc;
+
+        err_c = fmax(err_c, fabs(fast_sinf_coarse(x) - s));
+        err_c = fmax(err_c, fabs(fast_cosf_coarse(x) - c));
+        err_f = fmax(err_f, fabs(fast_sinf(x) - s));
+        err_f = fmax(err_f, fabs(fast_cosf(x) - c));
+        fast_sincosf(x, &fs, &fc);
+        err_sc = fmax(err_sc, fmax(fabs(fs - s), fabs(fc - c)));
+    }
+    EXPECT_LT(err_c, 1.1e-5);
+    EXPECT_LT(err_f, 2.0e-7);
+    EXPECT_LT(err_sc, 2.0e-7);
+}
+
+TEST_F(FastMathTest, atan2) {
+    double err_c = 0.0, err_f = 0.0;
+
+    for (int i = 0; i < FASTMATH_STEPS; i++) {
+        double a = 2.0 * M_PI * i / FASTMATH_STEPS - M_PI;
+        // radius over several decades
+        float r  = powf(10.0f, (float)(i % 13) - 6.0f);
+        float y  = r * (float)sin(a), x = r * (float)cos(a);
+        double ref = atan2((double)y, (double)x);
+
+        err_c = fmax(err_c, fabs(fast_atan2f_coarse(y, x) - ref));
+        err_f = fmax(err_f, fabs(fast_atan2f(y, x) - ref));
+    }
+    EXPECT_LT(err_c, 8.2e-5);
+    EXPECT_LT(err_f, 3.5e-7);
+
+    EXPECT_EQ(0.0f, fast_atan2f(0.0f, 0.0f));
+    EXPECT_NEAR(M_PI, fast_atan2f(0.0f, -1.0f), 1e-6);
+    EXPECT_NEAR(M_PI_2, fast_atan2f(1.0f, 0.0f), 1e-6);
+    EXPECT_NEAR(-M_PI_2, fast_atan2f(-1.0f, 0.0f), 1e-6);
+}
+
+TEST_F(FastMathTest, asin_acos) {
+    double err_c = 0.0, err_f = 0.0;
+
+    for (int i = -FASTMATH_STEPS; i <= FASTMATH_STEPS; i++) {
+        float x = (float)i / FASTMATH_STEPS;
+
+        err_c = fmax(err_c, fabs(fast_asinf_coarse(x) - asin((double)x)));
+        err_c = fmax(err_c, fabs(fast_acosf_coarse(x) - acos((double)x)));
+        err_f = fmax(err_f, fabs(fast_asinf(x) - asin((double)x)));
+        err_f = fmax(err_f, fabs(fast_acosf(x) - acos((double)x)));
+    }
+    EXPECT_LT(err_c, 3.9e-5);
+    EXPECT_LT(err_f, 4.0e-7);
+
+    // clamped instead of NaN
+    EXPECT_NEAR(M_PI_2, fast_asinf(1.0001f), 1e-6);
+    EXPECT_NEAR(M_PI, fast_acosf(-1.0001f), 1e-6);
+}
+
+TEST_F(FastMathTest, invsqrt) {
+    double err_c = 0.0, err_f = 0.0;
+
+    for (int i = 1; i <= FASTMATH_STEPS; i++) {
+        float x    = powf(10.0f, 12.0f * i / FASTMATH_STEPS - 6.0f);
+        double ref = 1.0 / sqrt((double)x);
+
+        err_c = fmax(err_c, fabs(fast_invsqrtf_coarse(x) - ref) / ref);
+        err_f = fmax(err_f, fabs(fast_invsqrtf(x) - ref) / ref);
+    }
+    EXPECT_LT(err_c, 1.8e-3);
+    EXPECT_LT(err_f, 1.2e-7);
+    EXPECT_EQ(3.0f, fast_sqrtf(9.0f));
+}
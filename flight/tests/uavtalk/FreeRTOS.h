@@ -0,0 +1,49 @@
+#include <stdlib.h>
+
+/*
+ * The tests are single threaded and the two connections under test are wired
+ * back to back, so a response arrives before the sender waits for it. Mutexes
+ * are no-ops and binary semaphores are plain flags.
+ */
+typedef uint32_t portTickType;
+typedef volatile int *xSemaphoreHandle;
+
+#define pdFALSE                               0
+#define pdTRUE                                1
+#define portMAX_DELAY                         0xffffffff
+#define portTICK_RATE_MS                      1
+
+#define xTaskGetTickCount()                   ((portTickType)0)
+
+static inline xSemaphoreHandle xSemaphoreCreateRecursiveMutex(void)
+{
+    return (xSemaphoreHandle)calloc(1, sizeof(int));
+}
+
+static inline int xSemaphoreTakeRecursive(__attribute__((unused)) xSemaphoreHandle sema, __attribute__((unused)) portTickType ticks)
+{
+    return pdTRUE;
+}
+
+static inline int xSemaphoreGiveRecursive(__attribute__((unused)) xSemaphoreHandle sema)
+{
+    return pdTRUE;
+}
+
+static inline int xSemaphoreTake(xSemaphoreHandle sema, __attribute__((unused)) portTickType ticks)
+{
+    if (!*sema) {
+        return pdFALSE;
+    }
+    *sema = 0;
+    return pdTRUE;
+}
+
+static inline int xSemaphoreGive(xSemaphoreHandle sema)
+{
+    *sema = 1;
+    return pdTRUE;
+}
+
+#define vSemaphoreCreateBinary(sema) \
+    do { (sema) = xSemaphoreCreateRecursiveMutex(); xSemaphoreGive(sema); } while (0)
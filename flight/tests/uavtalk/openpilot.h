@@ -0,0 +1,28 @@
+#ifndef OPENPILOT_H
+#define OPENPILOT_H
+
+#include <stdbool.h>
+
+#include "pios.h"
+
+#define PIOS_Assert(x) \
+    if (!(x)) { while (1) {; } \
+    }
+#define PIOS_DEBUG_Assert(x) PIOS_Assert(x)
+
+/* The part of the UAVObject manager used by UAVTalk, see uavobjectmanager_ut.c */
+typedef void *UAVObjHandle;
+
+#define UAVOBJ_ALL_INSTANCES 0xFFFF
+
+UAVObjHandle UAVObjGetByID(uint32_t id);
+uint32_t UAVObjGetID(UAVObjHandle obj);
+uint32_t UAVObjGetNumBytes(UAVObjHandle obj);
+uint16_t UAVObjGetNumInstances(UAVObjHandle obj);
+bool UAVObjIsSingleInstance(UAVObjHandle obj);
+int32_t UAVObjUnpack(UAVObjHandle obj_handle, uint16_t instId, const uint8_t *dataIn);
+int32_t UAVObjPack(UAVObjHandle obj_handle, uint16_t instId, uint8_t *dataOut);
+
+#include "uavtalk.h"
+
+#endif /* OPENPILOT_H */
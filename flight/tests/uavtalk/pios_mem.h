@@ -1,16 +1,13 @@
 /**
  ******************************************************************************
- * @addtogroup OpenPilot Math Utilities
+ *
+ * @file       pios_mem.h
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2014.
+ * @addtogroup PiOS
  * @{
- * @addtogroup Sine and cosine methods that use a cached lookup table
+ * @addtogroup PiOS
  * @{
- *
- * @file       sin_lookup.h
- * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
- * @brief      Sine lookup table from flash with 1 degree resolution
- *
- * @see        The GNU Public License (GPL) Version 3
- *
+ * @brief PiOS memory allocation API
  *****************************************************************************/
 /*
  * This program is free software; you can redistribute it and/or modify
@@ -27,14 +24,11 @@
  * with this program; if not, write to the Free Software Foundation, Inc.,
  * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
  */
+#ifndef PIOS_MEM_H
+#define PIOS_MEM_H
 
-#ifndef SIN_LOOKUP_H
-#define SIN_LOOKUP_H
-
-int sin_lookup_initalize();
-float sin_lookup_deg(float angle);
-float cos_lookup_deg(float angle);
-float sin_lookup_rad(float angle);
-float cos_lookup_rad(float angle);
+#define pios_fastheapmalloc(size) (malloc(size))
+#define pios_malloc(size)         (malloc(size))
+#define pios_free(p)              (free(p))
 
-#endif
+#endif /* PIOS_MEM_H */
@@ -0,0 +1,57 @@
+/*
+ * A single object UAVObject manager for the UAVTalk tests. Every connection
+ * packs the object from test_obj_data and unpacks it into test_obj_received.
+ */
+
+#include "openpilot.h"
+#include "uavobjectmanager_ut.h"
+
+uint8_t test_obj_data[TEST_OBJ_SIZE];
+uint8_t test_obj_received[TEST_OBJ_SIZE];
+uint32_t test_obj_unpacked;
+
+static int test_obj;
+
+UAVObjHandle UAVObjGetByID(uint32_t id)
+{
+    return (id == TEST_OBJ_ID) ? &test_obj : NULL;
+}
+
+uint32_t UAVObjGetID(__attribute__((unused)) UAVObjHandle obj)
+{
+    return TEST_OBJ_ID;
+}
+
+uint32_t UAVObjGetNumBytes(__attribute__((unused)) UAVObjHandle obj)
+{
+    return TEST_OBJ_SIZE;
+}
+
+uint16_t UAVObjGetNumInstances(__attribute__((unused)) UAVObjHandle obj)
+{
+    return 1;
+}
+
+bool UAVObjIsSingleInstance(__attribute__((unused)) UAVObjHandle obj)
+{
+    return true;
+}
+
+int32_t UAVObjUnpack(__attribute__((unused)) UAVObjHandle obj_handle, uint16_t instId, const uint8_t *dataIn)
+{
+    if (instId != 0) {
+        return -1;
+    }
+    memcpy(test_obj_received, dataIn, TEST_OBJ_SIZE);
+    test_obj_unpacked++;
+    return 0;
+}
+
+int32_t UAVObjPack(__attribute__((unused)) UAVObjHandle obj_handle, uint16_t instId, uint8_t *dataOut)
+{
+    if (instId != 0) {
+        return -1;
+    }
+    memcpy(dataOut, test_obj_data, TEST_OBJ_SIZE);
+    return 0;
+}
@@ -0,0 +1,11 @@
+#ifndef UAVOBJECTMANAGER_UT_H
+#define UAVOBJECTMANAGER_UT_H
+
+#define TEST_OBJ_ID   0x12345678
+#define TEST_OBJ_SIZE 32 // large enough to be sent as delta
+
+extern uint8_t test_obj_data[TEST_OBJ_SIZE];
+extern uint8_t test_obj_received[TEST_OBJ_SIZE];
+extern uint32_t test_obj_unpacked;
+
+#endif /* UAVOBJECTMANAGER_UT_H */
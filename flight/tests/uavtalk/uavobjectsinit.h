@@ -0,0 +1,6 @@
+#ifndef UAVOBJECTSINIT_H
+#define UAVOBJECTSINIT_H
+
+#define UAVOBJECTS_LARGEST 64
+
+#endif /* UAVOBJECTSINIT_H */
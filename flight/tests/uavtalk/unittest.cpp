@@ -0,0 +1,117 @@
+#include "gtest/gtest.h"
+
+#include <stdio.h> /* printf */
+#include <stdlib.h> /* abort */
+#include <string.h> /* memset */
+
+extern "C" {
+#include "openpilot.h"
+#include "uavtalk_priv.h" /* UAVTALK_TYPE_* */
+#include "uavobjectmanager_ut.h"
+}
+
+#define TIMEOUT_MS 100
+
+/*
+ * The ground side (gcs) and the flight side (fc) are wired back to back,
+ * everything one side sends is processed by the other one right away.
+ * Only the flight side sends delta updates.
+ */
+static UAVTalkConnection gcs;
+static UAVTalkConnection fc;
+
+/* Message types sent by the flight side, in order */
+static uint8_t fcTypes[16];
+static uint32_t fcTypeCount;
+
+static int32_t gcsOutput(uint8_t *data, int32_t length)
+{
+    UAVTalkProcessInputStream(fc, data, length);
+    return length;
+}
+
+static int32_t fcOutput(uint8_t *data, int32_t length)
+{
+    if (fcTypeCount < sizeof(fcTypes)) {
+        fcTypes[fcTypeCount++] = data[1];
+    }
+    UAVTalkProcessInputStream(gcs, data, length);
+    return length;
+}
+
+// To use a test fixture, derive a class from testing::Test.
+class UAVTalkDeltaTest : public testing::Test {
+protected:
+    virtual void SetUp()
+    {
+        for (uint32_t i = 0; i < sizeof(test_obj_data); i++) {
+            test_obj_data[i] = i;
+        }
+        memset(test_obj_received, 0, sizeof(test_obj_received));
+        test_obj_unpacked = 0;
+        fcTypeCount = 0;
+
+        gcs = UAVTalkInitialize(&gcsOutput);
+        ASSERT_TRUE(gcs != NULL);
+        fc  = UAVTalkInitialize(&fcOutput);
+        ASSERT_TRUE(fc != NULL);
+        EXPECT_EQ(0, UAVTalkSetDeltaEncoding(fc, 256));
+    }
+
+    virtual void TearDown()
+    {
+        /* The library has no way to release a connection, leak it */
+    }
+
+    /* Send an update from the flight side, returns the type it was sent as */
+    uint8_t sendUpdate()
+    {
+        uint32_t count = fcTypeCount;
+
+        EXPECT_EQ(0, UAVTalkSendObject(fc, UAVObjGetByID(TEST_OBJ_ID), 0, 0, 0));
+        EXPECT_EQ(count + 1, fcTypeCount);
+        /* deltas are decoded by the GCS only, the flight side drops them */
+        if (fcTypes[count] != UAVTALK_TYPE_OBJ_DELTA) {
+            EXPECT_EQ(0, memcmp(test_obj_data, test_obj_received, TEST_OBJ_SIZE));
+        }
+        return fcTypes[count];
+    }
+};
+
+TEST_F(UAVTalkDeltaTest, UpdatesAreSentAsKeyframeThenDelta) {
+    EXPECT_EQ(UAVTALK_TYPE_OBJ_ACK, sendUpdate());
+
+    /* the ground side acked the keyframe */
+    test_obj_data[3] = 0xAA;
+    EXPECT_EQ(UAVTALK_TYPE_OBJ_DELTA, sendUpdate());
+}
+
+TEST_F(UAVTalkDeltaTest, RequestIsAnsweredWithObjectBeforeKeyframe) {
+    uint32_t count = fcTypeCount;
+
+    EXPECT_EQ(0, UAVTalkSendObjectRequest(gcs, UAVObjGetByID(TEST_OBJ_ID), 0, TIMEOUT_MS));
+    ASSERT_EQ(count + 1, fcTypeCount);
+    EXPECT_EQ(UAVTALK_TYPE_OBJ, fcTypes[count]);
+    EXPECT_EQ(1u, test_obj_unpacked);
+    EXPECT_EQ(0, memcmp(test_obj_data, test_obj_received, TEST_OBJ_SIZE));
+}
+
+TEST_F(UAVTalkDeltaTest, RequestIsAnsweredWithObjectWhileSendingDeltas) {
+    EXPECT_EQ(UAVTALK_TYPE_OBJ_ACK, sendUpdate());
+    test_obj_data[3] = 0xAA;
+    EXPECT_EQ(UAVTALK_TYPE_OBJ_DELTA, sendUpdate());
+
+    /* the answer to a request is a full object, never a delta nor a keyframe */
+    test_obj_data[5] = 0xBB;
+    uint32_t count = fcTypeCount;
+    EXPECT_EQ(0, UAVTalkSendObjectRequest(gcs, UAVObjGetByID(TEST_OBJ_ID), 0, TIMEOUT_MS));
+    ASSERT_EQ(count + 1, fcTypeCount);
+    EXPECT_EQ(UAVTALK_TYPE_OBJ, fcTypes[count]);
+    EXPECT_EQ(0, memcmp(test_obj_data, test_obj_received, TEST_OBJ_SIZE));
+
+    /* the request dropped the reference, the next update is a new keyframe */
+    test_obj_data[7] = 0xCC;
+    EXPECT_EQ(UAVTALK_TYPE_OBJ_ACK, sendUpdate());
+    test_obj_data[9] = 0xDD;
+    EXPECT_EQ(UAVTALK_TYPE_OBJ_DELTA, sendUpdate());
+}
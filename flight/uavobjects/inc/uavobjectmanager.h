@@ -180,6 +180,7 @@ typedef struct {
     uint32_t eventCallbackErrors;
     uint32_t lastCallbackErrorID;
     uint32_t lastQueueErrorID;
+    uint32_t bytesCopied; /** Instance data bytes copied out by UAVObjGetInstanceData() */
 } UAVObjStats;
 
 int32_t UAVObjInitialize();
@@ -216,6 +217,8 @@ int32_t UAVObjSetInstanceData(UAVObjHandle obj_handle, uint16_t instId, const vo
 int32_t UAVObjSetInstanceDataField(UAVObjHandle obj_handle, uint16_t instId, const void *dataIn, uint32_t offset, uint32_t size);
 int32_t UAVObjGetInstanceData(UAVObjHandle obj_handle, uint16_t instId, void *dataOut);
 int32_t UAVObjGetInstanceDataField(UAVObjHandle obj_handle, uint16_t instId, void *dataOut, uint32_t offset, uint32_t size);
+uint32_t UAVObjGetGeneration(UAVObjHandle obj_handle);
+bool UAVObjGetInstanceDataIfChanged(UAVObjHandle obj_handle, uint16_t instId, void *dataOut, uint32_t *generation);
 int32_t UAVObjSetMetadata(UAVObjHandle obj_handle, const UAVObjMetadata *dataIn);
 int32_t UAVObjGetMetadata(UAVObjHandle obj_handle, UAVObjMetadata *dataOut);
 uint8_t UAVObjGetMetadataAccess(const UAVObjMetadata *dataOut);
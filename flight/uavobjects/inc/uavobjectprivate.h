@@ -119,6 +119,8 @@ struct UAVOData {
      */
     struct UAVOMeta metaObj;
     uint16_t instance_size;
+    /* Incremented each time the data of any instance may have changed */
+    uint32_t generation;
 } __attribute__((packed, aligned(4)));
 
 /* Augmented type for Single Instance Data UAVO */
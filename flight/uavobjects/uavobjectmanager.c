@@ -103,7 +103,7 @@ int32_t UAVObjInitialize()
  ****************/
 
 /**
- * Get the statistics counters
+ * Get the statistics counters, including bytesCopied since the last UAVObjClearStats()
  * @param[out] statsOut The statistics counters will be copied there
  */
 void UAVObjGetStats(UAVObjStats *statsOut)
@@ -114,7 +114,7 @@ void UAVObjGetStats(UAVObjStats *statsOut)
 }
 
 /**
- * Clear the statistics counters
+ * Clear the statistics counters, bytesCopied included
  */
 void UAVObjClearStats()
 {
@@ -236,6 +236,8 @@ UAVObjHandle UAVObjRegister(uint32_t id,
     /* Fill in the details about this UAVO */
     uavo_data->id = id;
     uavo_data->instance_size = num_bytes;
+    /* Start at 1 so a cached copy with generation 0 is always refreshed */
+    uavo_data->generation    = 1;
     if (isSettings) {
         uavo_data->base.flags.isSettings = true;
         // settings defaults to being sent with priority
@@ -534,6 +536,7 @@ int32_t UAVObjUnpack(UAVObjHandle obj_handle, uint16_t instId, const uint8_t *da
         }
         // Set the data
         memcpy(InstanceData(instEntry), dataIn, obj->instance_size);
+        ++obj->generation;
     }
 
     // Fire event
@@ -924,6 +927,7 @@ int32_t UAVObjSetInstanceData(UAVObjHandle obj_handle, uint16_t instId,
         }
         // Set data
         memcpy(InstanceData(instEntry), dataIn, obj->instance_size);
+        ++obj->generation;
     }
 
     // Fire event
@@ -989,6 +993,7 @@ int32_t UAVObjSetInstanceDataField(UAVObjHandle obj_handle, uint16_t instId, con
 
         // Set data
         memcpy(InstanceData(instEntry) + offset, dataIn, size);
+        ++obj->generation;
     }
 
 
@@ -1025,6 +1030,7 @@ int32_t UAVObjGetInstanceData(UAVObjHandle obj_handle, uint16_t instId,
         }
         // Set data
         memcpy(dataOut, MetaDataPtr((struct UAVOMeta *)obj_handle), MetaNumBytes);
+        stats.bytesCopied += MetaNumBytes;
     } else {
         struct UAVOData *obj;
         InstanceHandle instEntry;
@@ -1039,6 +1045,7 @@ int32_t UAVObjGetInstanceData(UAVObjHandle obj_handle, uint16_t instId,
         }
         // Set data
         memcpy(dataOut, InstanceData(instEntry), obj->instance_size);
+        stats.bytesCopied += obj->instance_size;
     }
 
     rc = 0;
@@ -1048,6 +1055,60 @@ unlock_exit:
     return rc;
 }
 
+/**
+ * Get the update generation of an object. It changes whenever the data of
+ * any of its instances may have changed (set, unpacked or loaded).
+ * \param[in] obj The object handle
+ * \return The generation, or 0 for a metaobject
+ */
+uint32_t UAVObjGetGeneration(UAVObjHandle obj_handle)
+{
+    PIOS_Assert(obj_handle);
+
+    if (UAVObjIsMetaobject(obj_handle)) {
+        return 0;
+    }
+
+    return ((struct UAVOData *)obj_handle)->generation;
+}
+
+/**
+ * Get the data of a specific object instance, but only if the object was
+ * updated since the given generation. Lets a module keep a cached copy of
+ * rarely changing data (e.g. settings) at the cost of a compare per call.
+ * \param[in] obj The object handle
+ * \param[in] instId The object instance ID
+ * \param[out] dataOut The object's data structure, left alone if unchanged
+ * \param[in,out] generation Generation of the cached copy, start with 0
+ * \return true if dataOut was refreshed, false if unchanged or on failure
+ */
+bool UAVObjGetInstanceDataIfChanged(UAVObjHandle obj_handle, uint16_t instId,
+                                    void *dataOut, uint32_t *generation)
+{
+    PIOS_Assert(obj_handle);
+    PIOS_Assert(!UAVObjIsMetaobject(obj_handle));
+
+    struct UAVOData *obj = (struct UAVOData *)obj_handle;
+
+    // Unlocked fast path, a racing update is caught on the next call
+    if (obj->generation == *generation) {
+        return false;
+    }
+
+    // Lock
+    xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+
+    bool changed = false;
+
+    if (UAVObjGetInstanceData(obj_handle, instId, dataOut) == 0) {
+        *generation = obj->generation;
+        changed     = true;
+    }
+
+    xSemaphoreGiveRecursive(mutex);
+    return changed;
+}
+
 /**
  * Get the data of a specific object instance
  * \param[in] obj The object handle
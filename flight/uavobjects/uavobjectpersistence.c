@@ -101,7 +101,12 @@ int32_t UAVObjLoad(UAVObjHandle obj_handle, uint16_t instId)
         }
 
         // Fire event on success
-        if (PIOS_FLASHFS_ObjLoad(pios_uavo_settings_fs_id, UAVObjGetID(obj_handle), instId, InstanceData(instEntry), UAVObjGetNumBytes(obj_handle)) == 0) {
+        int32_t rc = PIOS_FLASHFS_ObjLoad(pios_uavo_settings_fs_id, UAVObjGetID(obj_handle), instId, InstanceData(instEntry), UAVObjGetNumBytes(obj_handle));
+
+        // The data may have been partly overwritten even on failure
+        ++((struct UAVOData *)obj_handle)->generation;
+
+        if (rc == 0) {
             sendEvent((struct UAVOBase *)obj_handle, instId, EV_UNPACKED);
         } else {
             return -1;
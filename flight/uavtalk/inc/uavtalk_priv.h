@@ -60,6 +60,18 @@ typedef struct {
     uint16_t rxPacketLength;
 } UAVTalkInputProcessor;
 
+// Copy of the last keyframe sent for an object instance, the reference of its delta updates.
+// Keyframes are sent acked, deltas are only sent once the receiver acked the keyframe.
+typedef struct UAVTalkDeltaRefStruct {
+    struct UAVTalkDeltaRefStruct *next;
+    uint32_t objId;
+    uint16_t instId;
+    uint16_t length;
+    uint8_t  updatesSinceKeyframe;
+    bool     confirmed;
+    uint8_t  data[];
+} UAVTalkDeltaRef;
+
 typedef struct {
     uint8_t canari;
     UAVTalkOutputStream outStream;
@@ -73,6 +85,10 @@ typedef struct {
     UAVTalkInputProcessor iproc;
     uint8_t      *rxBuffer;
     uint8_t      *txBuffer;
+    // delta encoding, disabled while deltaBuffer is NULL
+    uint8_t      *deltaBuffer;
+    UAVTalkDeltaRef *deltaRefs;
+    uint16_t     deltaBudget;
 } UAVTalkConnectionData;
 
 #define UAVTALK_CANARI          0xCA
@@ -86,9 +102,24 @@ typedef struct {
 #define UAVTALK_TYPE_OBJ_ACK    (UAVTALK_TYPE_VER | 0x02)
 #define UAVTALK_TYPE_ACK        (UAVTALK_TYPE_VER | 0x03)
 #define UAVTALK_TYPE_NACK       (UAVTALK_TYPE_VER | 0x04)
+#define UAVTALK_TYPE_OBJ_DELTA  (UAVTALK_TYPE_VER | 0x05)
 #define UAVTALK_TYPE_OBJ_TS     (UAVTALK_TIMESTAMPED | UAVTALK_TYPE_OBJ)
 #define UAVTALK_TYPE_OBJ_ACK_TS (UAVTALK_TIMESTAMPED | UAVTALK_TYPE_OBJ_ACK)
 
+// Delta updates carry the CRC16 of the complete object followed by the runs of bytes
+// that differ from the last keyframe, each encoded as offset(1), length(1), data(length)
+#define UAVTALK_DELTA_CRC_LENGTH        2
+#define UAVTALK_DELTA_RUN_HEADER_LENGTH 2
+// Smaller objects are always sent in full
+#define UAVTALK_DELTA_MIN_OBJECT_SIZE   16
+// Offsets and run lengths must fit in a byte
+#define UAVTALK_DELTA_MAX_OBJECT_SIZE   255
+// Unchanged bytes between two runs are resent when cheaper than a new run header
+#define UAVTALK_DELTA_MAX_GAP           UAVTALK_DELTA_RUN_HEADER_LENGTH
+// A new keyframe is sent after this many updates, or after this many updates
+// without the ack of the previous keyframe
+#define UAVTALK_DELTA_KEYFRAME_INTERVAL 20
+
 // macros
 #define CHECKCONHANDLE(handle, variable, failcommand) \
     variable = (UAVTalkConnectionData *)handle; \
@@ -49,10 +49,14 @@
 
 // Private functions
 static int32_t objectTransaction(UAVTalkConnectionData *connection, uint8_t type, UAVObjHandle obj, uint16_t instId, int32_t timeout);
-static int32_t sendObject(UAVTalkConnectionData *connection, uint8_t type, uint32_t objId, uint16_t instId, UAVObjHandle obj);
-static int32_t sendSingleObject(UAVTalkConnectionData *connection, uint8_t type, uint32_t objId, uint16_t instId, UAVObjHandle obj);
+static int32_t sendObject(UAVTalkConnectionData *connection, uint8_t type, uint32_t objId, uint16_t instId, UAVObjHandle obj, bool allowDelta);
+static int32_t sendSingleObject(UAVTalkConnectionData *connection, uint8_t type, uint32_t objId, uint16_t instId, UAVObjHandle obj, bool allowDelta);
 static int32_t receiveObject(UAVTalkConnectionData *connection, uint8_t type, uint32_t objId, uint16_t instId, uint8_t *data);
 static void updateAck(UAVTalkConnectionData *connection, uint8_t type, uint32_t objId, uint16_t instId);
+static int32_t deltaEncodeObject(UAVTalkConnectionData *connection, uint8_t *type, uint32_t objId, uint16_t instId, uint8_t *data, int32_t length);
+static int32_t encodeDelta(const uint8_t *reference, const uint8_t *data, int32_t length, uint8_t *out);
+static void confirmDeltaRef(UAVTalkConnectionData *connection, uint32_t objId, uint16_t instId);
+static void resetDeltaRefs(UAVTalkConnectionData *connection, uint32_t objId, uint16_t instId);
 // UavTalk Process FSM functions
 static bool UAVTalkProcess_SYNC(UAVTalkConnectionData *connection, UAVTalkInputProcessor *iproc, uint8_t *rxbuffer, uint8_t length, uint8_t *position);
 static bool UAVTalkProcess_TYPE(UAVTalkConnectionData *connection, UAVTalkInputProcessor *iproc, uint8_t *rxbuffer, uint8_t length, uint8_t *position);
@@ -81,6 +85,9 @@ UAVTalkConnection UAVTalkInitialize(UAVTalkOutputStream outputStream)
     connection->iproc.rxPacketLength = 0;
     connection->iproc.state = UAVTALK_STATE_SYNC;
     connection->outStream   = outputStream;
+    connection->deltaBuffer = NULL;
+    connection->deltaRefs   = NULL;
+    connection->deltaBudget = 0;
     connection->lock = xSemaphoreCreateRecursiveMutex();
     connection->transLock   = xSemaphoreCreateRecursiveMutex();
     // allocate buffers
@@ -123,6 +130,52 @@ int32_t UAVTalkSetOutputStream(UAVTalkConnection connectionHandle, UAVTalkOutput
     return 0;
 }
 
+/**
+ * Enable or disable delta encoding of the object updates sent on a connection.
+ * When enabled, unacked updates of larger objects are sent as the list of bytes
+ * that changed since the last update, with a full update every few packets.
+ * \param[in] connection UAVTalkConnection to be used
+ * \param[in] maxReferenceBytes Memory available for the copies of sent objects, 0 disables delta encoding
+ * \return 0 Success
+ * \return -1 Failure
+ */
+int32_t UAVTalkSetDeltaEncoding(UAVTalkConnection connectionHandle, uint16_t maxReferenceBytes)
+{
+    UAVTalkConnectionData *connection;
+    int32_t ret = 0;
+
+    CHECKCONHANDLE(connectionHandle, connection, return -1);
+
+    // Lock
+    xSemaphoreTakeRecursive(connection->lock, portMAX_DELAY);
+
+    // Drop all reference copies, they are rebuilt from the next updates
+    while (connection->deltaRefs) {
+        UAVTalkDeltaRef *ref = connection->deltaRefs;
+        connection->deltaRefs = ref->next;
+        pios_free(ref);
+    }
+    connection->deltaBudget = maxReferenceBytes;
+
+    if (maxReferenceBytes == 0) {
+        if (connection->deltaBuffer) {
+            pios_free(connection->deltaBuffer);
+            connection->deltaBuffer = NULL;
+        }
+    } else if (!connection->deltaBuffer) {
+        connection->deltaBuffer = pios_malloc(UAVTALK_MAX_PAYLOAD_LENGTH);
+        if (!connection->deltaBuffer) {
+            connection->deltaBudget = 0;
+            ret = -1;
+        }
+    }
+
+    // Release lock
+    xSemaphoreGiveRecursive(connection->lock);
+
+    return ret;
+}
+
 /**
  * Get current output stream
  * \param[in] connection UAVTalkConnection to be used
@@ -325,7 +378,7 @@ static int32_t objectTransaction(UAVTalkConnectionData *connection, uint8_t type
         connection->respType   = (type == UAVTALK_TYPE_OBJ_REQ) ? UAVTALK_TYPE_OBJ : UAVTALK_TYPE_ACK;
         connection->respObjId  = UAVObjGetID(obj);
         connection->respInstId = instId;
-        ret = sendObject(connection, type, UAVObjGetID(obj), instId, obj);
+        ret = sendObject(connection, type, UAVObjGetID(obj), instId, obj, true);
         xSemaphoreGiveRecursive(connection->lock);
         // Wait for response (or timeout) if sending the object succeeded
         respReceived = pdFALSE;
@@ -349,7 +402,7 @@ static int32_t objectTransaction(UAVTalkConnectionData *connection, uint8_t type
         }
     } else if (type == UAVTALK_TYPE_OBJ || type == UAVTALK_TYPE_OBJ_TS) {
         xSemaphoreTakeRecursive(connection->lock, portMAX_DELAY);
-        ret = sendObject(connection, type, UAVObjGetID(obj), instId, obj);
+        ret = sendObject(connection, type, UAVObjGetID(obj), instId, obj, true);
         xSemaphoreGiveRecursive(connection->lock);
     }
     return ret;
@@ -636,7 +689,7 @@ static int32_t receiveObject(UAVTalkConnectionData *connection, uint8_t type, ui
             if (UAVObjUnpack(obj, instId, data) == 0) {
                 UAVT_DEBUGLOG_CPRINTF(objId, "OBJ ACK %X %d", objId, instId);
                 // Object updated or created, transmit ACK
-                sendObject(connection, UAVTALK_TYPE_ACK, objId, instId, NULL);
+                sendObject(connection, UAVTALK_TYPE_ACK, objId, instId, NULL, false);
             } else {
                 ret = -1;
             }
@@ -646,7 +699,7 @@ static int32_t receiveObject(UAVTalkConnectionData *connection, uint8_t type, ui
         if (ret == -1) {
             // failed to update object, transmit NACK
             UAVT_DEBUGLOG_PRINTF("OBJ NACK %X %d", objId, instId);
-            sendObject(connection, UAVTALK_TYPE_NACK, objId, instId, NULL);
+            sendObject(connection, UAVTALK_TYPE_NACK, objId, instId, NULL, false);
         }
         break;
 
@@ -655,15 +708,18 @@ static int32_t receiveObject(UAVTalkConnectionData *connection, uint8_t type, ui
         UAVT_DEBUGLOG_CPRINTF(objId, "REQ %X %d", objId, instId);
         if (obj) {
             // Object found, transmit it
-            // The sent object will ack the object request on the receiver side
-            ret = sendObject(connection, UAVTALK_TYPE_OBJ, objId, instId, obj);
+            // The sent object will ack the object request on the receiver side, so it must
+            // be a plain OBJ: never a delta, nor a keyframe sent as OBJ_ACK. The next
+            // update starts a new keyframe, the receiver resyncs on the request anyway.
+            resetDeltaRefs(connection, objId, instId);
+            ret = sendObject(connection, UAVTALK_TYPE_OBJ, objId, instId, obj, false);
         } else {
             ret = -1;
         }
         if (ret == -1) {
             // failed to send object, transmit NACK
             UAVT_DEBUGLOG_PRINTF("REQ NACK %X %d", objId, instId);
-            sendObject(connection, UAVTALK_TYPE_NACK, objId, instId, NULL);
+            sendObject(connection, UAVTALK_TYPE_NACK, objId, instId, NULL, false);
         }
         break;
 
@@ -683,6 +739,8 @@ static int32_t receiveObject(UAVTalkConnectionData *connection, uint8_t type, ui
         if (obj && (instId != UAVOBJ_ALL_INSTANCES)) {
             // Check if an ACK is pending
             updateAck(connection, type, objId, instId);
+            // Acks of keyframes enable delta updates
+            confirmDeltaRef(connection, objId, instId);
         } else {
             ret = -1;
         }
@@ -726,10 +784,11 @@ static void updateAck(UAVTalkConnectionData *connection, uint8_t type, uint32_t
  * \param[in] objId The object ID
  * \param[in] instId The instance ID or UAVOBJ_ALL_INSTANCES for all instances
  * \param[in] obj Object handle to send (null when type is NACK)
+ * \param[in] allowDelta Whether the update may be sent as delta or keyframe
  * \return 0 Success
  * \return -1 Failure
  */
-static int32_t sendObject(UAVTalkConnectionData *connection, uint8_t type, uint32_t objId, uint16_t instId, UAVObjHandle obj)
+static int32_t sendObject(UAVTalkConnectionData *connection, uint8_t type, uint32_t objId, uint16_t instId, UAVObjHandle obj, bool allowDelta)
 {
     uint32_t numInst;
     uint32_t n;
@@ -751,19 +810,19 @@ static int32_t sendObject(UAVTalkConnectionData *connection, uint8_t type, uint3
             // This allows the receiver to detect when the last object has been received (i.e. when instance 0 is received)
             ret     = 0;
             for (n = 0; n < numInst; ++n) {
-                ret = sendSingleObject(connection, type, objId, numInst - n - 1, obj);
+                ret = sendSingleObject(connection, type, objId, numInst - n - 1, obj, allowDelta);
                 if (ret == -1) {
                     break;
                 }
             }
         } else {
-            ret = sendSingleObject(connection, type, objId, instId, obj);
+            ret = sendSingleObject(connection, type, objId, instId, obj, allowDelta);
         }
     } else if (type == UAVTALK_TYPE_OBJ_REQ) {
-        ret = sendSingleObject(connection, type, objId, instId, obj);
+        ret = sendSingleObject(connection, type, objId, instId, obj, allowDelta);
     } else if (type == UAVTALK_TYPE_ACK || type == UAVTALK_TYPE_NACK) {
         if (instId != UAVOBJ_ALL_INSTANCES) {
-            ret = sendSingleObject(connection, type, objId, instId, obj);
+            ret = sendSingleObject(connection, type, objId, instId, obj, allowDelta);
         }
     }
 
@@ -777,10 +836,11 @@ static int32_t sendObject(UAVTalkConnectionData *connection, uint8_t type, uint3
  * \param[in] objId The object ID
  * \param[in] instId The instance ID (can NOT be UAVOBJ_ALL_INSTANCES, use () instead)
  * \param[in] obj Object handle to send (null when type is NACK)
+ * \param[in] allowDelta Whether the update may be sent as delta or keyframe
  * \return 0 Success
  * \return -1 Failure
  */
-static int32_t sendSingleObject(UAVTalkConnectionData *connection, uint8_t type, uint32_t objId, uint16_t instId, UAVObjHandle obj)
+static int32_t sendSingleObject(UAVTalkConnectionData *connection, uint8_t type, uint32_t objId, uint16_t instId, UAVObjHandle obj, bool allowDelta)
 {
     // IMPORTANT : obj can be null (when type is NACK for example)
 
@@ -832,6 +892,11 @@ static int32_t sendSingleObject(UAVTalkConnectionData *connection, uint8_t type,
             connection->stats.txErrors++;
             return -1;
         }
+        // Send only the changed bytes when possible
+        if (connection->deltaBuffer && allowDelta) {
+            length = deltaEncodeObject(connection, &type, objId, instId, &connection->txBuffer[headerLength], length);
+            connection->txBuffer[1] = type;
+        }
     }
 
     // Store the packet length
@@ -854,6 +919,10 @@ static int32_t sendSingleObject(UAVTalkConnectionData *connection, uint8_t type,
         connection->stats.txErrors++;
         // TODO rc == -1 connection not open, -2 buffer full should retry
         connection->stats.txBytes += (rc > 0) ? rc : 0;
+        // The receiver may have missed this update, the next one must be complete
+        if (connection->deltaBuffer && length > 0) {
+            resetDeltaRefs(connection, objId, instId);
+        }
         return -1;
     }
 
@@ -861,6 +930,175 @@ static int32_t sendSingleObject(UAVTalkConnectionData *connection, uint8_t type,
     return 0;
 }
 
+/**
+ * Replace the packed object by a delta update when allowed and smaller than the full object.
+ * Deltas are computed against the last keyframe, a full update sent acked. They are only
+ * sent once the keyframe was acked, so a lost packet never leaves the receiver with
+ * another reference than the sender.
+ * \param[in] connection UAVTalkConnection to be used
+ * \param[in/out] type Transaction type, changed to UAVTALK_TYPE_OBJ_DELTA when a delta is sent
+ * or to UAVTALK_TYPE_OBJ_ACK when a keyframe is sent
+ * \param[in] objId The object ID
+ * \param[in] instId The instance ID
+ * \param[in/out] data Packed object data, replaced by the delta update
+ * \param[in] length Length of the packed object
+ * \return Length of the data to send
+ */
+static int32_t deltaEncodeObject(UAVTalkConnectionData *connection, uint8_t *type, uint32_t objId, uint16_t instId, uint8_t *data, int32_t length)
+{
+    UAVTalkDeltaRef *ref;
+
+    if (length < UAVTALK_DELTA_MIN_OBJECT_SIZE || length > UAVTALK_DELTA_MAX_OBJECT_SIZE) {
+        return length;
+    }
+
+    for (ref = connection->deltaRefs; ref; ref = ref->next) {
+        if (ref->objId == objId && ref->instId == instId) {
+            break;
+        }
+    }
+
+    if (*type == UAVTALK_TYPE_OBJ_ACK) {
+        // The receiver takes any acked update as its new reference
+        if (ref && ref->length == length) {
+            memcpy(ref->data, data, length);
+            ref->updatesSinceKeyframe = 0;
+            ref->confirmed = false;
+        } else if (ref) {
+            ref->updatesSinceKeyframe = UAVTALK_DELTA_KEYFRAME_INTERVAL;
+            ref->confirmed = false;
+        }
+        return length;
+    }
+
+    // Only plain updates can be sent as delta
+    if (*type != UAVTALK_TYPE_OBJ) {
+        return length;
+    }
+
+    if (!ref) {
+        uint16_t size = sizeof(UAVTalkDeltaRef) + length;
+        if (size > connection->deltaBudget) {
+            return length;
+        }
+        ref = pios_malloc(size);
+        if (!ref) {
+            return length;
+        }
+        connection->deltaBudget -= size;
+        ref->objId     = objId;
+        ref->instId    = instId;
+        ref->length    = length;
+        // first update is always a keyframe
+        ref->updatesSinceKeyframe = UAVTALK_DELTA_KEYFRAME_INTERVAL;
+        ref->confirmed = false;
+        ref->next      = connection->deltaRefs;
+        connection->deltaRefs = ref;
+    }
+
+    if (ref->updatesSinceKeyframe < UAVTALK_DELTA_KEYFRAME_INTERVAL && ref->length == length) {
+        ref->updatesSinceKeyframe++;
+        if (!ref->confirmed) {
+            // Keyframe not acked yet, keep sending full updates
+            return length;
+        }
+        int32_t deltaLength = encodeDelta(ref->data, data, length, connection->deltaBuffer);
+        if (deltaLength >= 0) {
+            memcpy(data, connection->deltaBuffer, deltaLength);
+            *type = UAVTALK_TYPE_OBJ_DELTA;
+            return deltaLength;
+        }
+        // Too much changed since the keyframe, send a new one
+    }
+
+    memcpy(ref->data, data, length);
+    ref->length = length;
+    ref->updatesSinceKeyframe = 0;
+    ref->confirmed = false;
+    *type = UAVTALK_TYPE_OBJ_ACK;
+    return length;
+}
+
+/**
+ * Enable delta updates of an object once the receiver acked its keyframe.
+ * \param[in] connection UAVTalkConnection to be used
+ * \param[in] objId The object ID
+ * \param[in] instId The instance ID
+ */
+static void confirmDeltaRef(UAVTalkConnectionData *connection, uint32_t objId, uint16_t instId)
+{
+    for (UAVTalkDeltaRef *ref = connection->deltaRefs; ref; ref = ref->next) {
+        if (ref->objId == objId && ref->instId == instId) {
+            ref->confirmed = true;
+        }
+    }
+}
+
+/**
+ * Encode the bytes that differ between two copies of an object.
+ * \param[in] reference Data of the last keyframe
+ * \param[in] data Current data
+ * \param[in] length Length of the object
+ * \param[out] out Delta update, CRC16 of the current data followed by the changed runs
+ * \return Length of the delta update
+ * \return -1 if the delta update is not smaller than the object
+ */
+static int32_t encodeDelta(const uint8_t *reference, const uint8_t *data, int32_t length, uint8_t *out)
+{
+    int32_t outLength = 0;
+    int32_t i = 0;
+    uint16_t crc = PIOS_CRC16_updateCRC(0, data, length);
+
+    out[outLength++] = crc & 0xff;
+    out[outLength++] = crc >> 8;
+
+    while (i < length) {
+        if (reference[i] == data[i]) {
+            ++i;
+            continue;
+        }
+
+        int32_t start = i;
+        int32_t end   = ++i;
+
+        // Extend the run across short gaps of unchanged bytes
+        while (i < length && (i - end) <= UAVTALK_DELTA_MAX_GAP) {
+            if (reference[i] != data[i]) {
+                end = i + 1;
+            }
+            ++i;
+        }
+        i = end;
+
+        int32_t runLength = end - start;
+        if (outLength + UAVTALK_DELTA_RUN_HEADER_LENGTH + runLength >= length) {
+            return -1;
+        }
+        out[outLength++] = (uint8_t)start;
+        out[outLength++] = (uint8_t)runLength;
+        memcpy(&out[outLength], &data[start], runLength);
+        outLength += runLength;
+    }
+
+    return outLength;
+}
+
+/**
+ * Force the next update of an object to be sent complete.
+ * \param[in] connection UAVTalkConnection to be used
+ * \param[in] objId The object ID
+ * \param[in] instId The instance ID or UAVOBJ_ALL_INSTANCES for all instances
+ */
+static void resetDeltaRefs(UAVTalkConnectionData *connection, uint32_t objId, uint16_t instId)
+{
+    for (UAVTalkDeltaRef *ref = connection->deltaRefs; ref; ref = ref->next) {
+        if (ref->objId == objId && (instId == UAVOBJ_ALL_INSTANCES || ref->instId == instId)) {
+            ref->updatesSinceKeyframe = UAVTALK_DELTA_KEYFRAME_INTERVAL;
+            ref->confirmed = false;
+        }
+    }
+}
+
 /*
  * Functions that implements the UAVTalk Process FSM. return false to break out of current cycle
  */
@@ -971,6 +1209,10 @@ static bool UAVTalkProcess_INSTID(UAVTalkConnectionData *connection, UAVTalkInpu
     if (iproc->type == UAVTALK_TYPE_OBJ_REQ || iproc->type == UAVTALK_TYPE_ACK || iproc->type == UAVTALK_TYPE_NACK) {
         iproc->length = 0;
         iproc->timestampLength = 0;
+    } else if (iproc->type == UAVTALK_TYPE_OBJ_DELTA) {
+        // Delta updates have a variable length
+        iproc->length = iproc->packet_size - iproc->rxPacketLength;
+        iproc->timestampLength = 0;
     } else {
         iproc->timestampLength = (iproc->type & UAVTALK_TIMESTAMPED) ? 2 : 0;
         if (obj) {
@@ -135,7 +135,9 @@ const char *fixedOptionsC = " [OPTION]... [FILE]...\n"
                             "    -D <key>=<value>    Permanently set a user setting, e.g: -D General/OverrideLanguage=de\n"
                             "    -reset              Reset user settings to factory defaults.\n"
                             "    -config-file <file> Specify alternate factory defaults settings file (used with -reset)\n"
-                            "    -exit-after-config  Exit after manipulating configuration settings\n";
+                            "    -exit-after-config  Exit after manipulating configuration settings\n"
+                            "    -profile            Print plugin loading times\n"
+                            "    -no-parallel-load   Load plugin libraries one at a time\n";
 
 const QLatin1String HELP1_OPTION("-h");
 const QLatin1String HELP2_OPTION("-help");
@@ -149,6 +151,8 @@ const QLatin1String RESET_OPTION("-reset");
 const QLatin1String CONFIG_FILE_OPTION("-config-file");
 const QLatin1String EXIT_AFTER_CONFIG_OPTION("-exit-after-config");
 const QLatin1String LOG_FILE_OPTION("-log");
+const QLatin1String PROFILE_OPTION("-profile");
+const QLatin1String NO_PARALLEL_LOAD_OPTION("-no-parallel-load");
 
 // Helpers for displaying messages. Note that there is no console on Windows.
 void displayHelpText(QString t)
@@ -344,6 +348,8 @@ AppOptions options()
     appOptions.insert(RESET_OPTION, false);
     appOptions.insert(CONFIG_FILE_OPTION, true);
     appOptions.insert(EXIT_AFTER_CONFIG_OPTION, false);
+    appOptions.insert(PROFILE_OPTION, false);
+    appOptions.insert(NO_PARALLEL_LOAD_OPTION, false);
     return appOptions;
 }
 
@@ -590,6 +596,8 @@ int main(int argc, char * *argv)
         return sendArguments(app, pluginManager.arguments()) ? 0 : -1;
     }
 
+    pluginManager.setProfilingEnabled(appOptionValues.contains(PROFILE_OPTION));
+    pluginManager.setParallelLoadingEnabled(!appOptionValues.contains(NO_PARALLEL_LOAD_OPTION));
     pluginManager.loadPlugins();
 
     if (coreplugin->hasError()) {
@@ -238,6 +238,17 @@
     \sa initialize()
  */
 
+/*!
+    \fn bool IPlugin::delayedInitialize()
+    Called after all plugins are running and the event loop has started,
+    in the same 'leaf-to-root' order as extensionsInitialized(). Work that
+    is not needed to show the main window, e.g. preparing things only used
+    once a gadget or dialog is opened, belongs here. Plugins are called one
+    at a time with the event loop running in between, return true if the
+    call did work worth yielding for.
+    \sa extensionsInitialized()
+ */
+
 /*!
     \fn void IPlugin::shutdown()
     Called during a shutdown sequence in the same order as initialization
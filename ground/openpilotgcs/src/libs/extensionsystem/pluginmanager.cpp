@@ -37,6 +37,11 @@
 #include <QtCore/QDir>
 #include <QtCore/QTextStream>
 #include <QtCore/QWriteLocker>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QThreadPool>
+#include <QtCore/QRunnable>
+#include <QtCore/QTimer>
+#include <QtCore/QHash>
 #include <QtDebug>
 #ifdef WITH_TESTS
 #include <QTest>
@@ -46,6 +51,9 @@ typedef QList<ExtensionSystem::PluginSpec *> PluginSpecSet;
 
 enum { debugLeaks = 0 };
 
+// [ms] event loop time between two plugins' delayedInitialize()
+enum { DELAYED_INITIALIZE_INTERVAL = 20 };
+
 /*!
     \namespace ExtensionSystem
     \brief The ExtensionSystem namespace provides classes that belong to the core plugin system.
@@ -423,6 +431,35 @@ void PluginManager::formatPluginVersions(QTextStream &str) const
     }
 }
 
+/*!
+    \fn void PluginManager::setParallelLoadingEnabled(bool enabled)
+    Map the plugin libraries on a thread pool before loadPlugins() creates
+    the plugin instances, plugins that do not depend on each other load
+    concurrently. On by default.
+ */
+void PluginManager::setParallelLoadingEnabled(bool enabled)
+{
+    d->parallelLoading = enabled;
+}
+
+/*!
+    \fn void PluginManager::setProfilingEnabled(bool enabled)
+    Print the time spent loading and initializing each plugin.
+ */
+void PluginManager::setProfilingEnabled(bool enabled)
+{
+    d->profiling = enabled;
+}
+
+void PluginManager::nextDelayedInitialize()
+{
+    if (d->nextDelayedInitialize()) {
+        QTimer::singleShot(DELAYED_INITIALIZE_INTERVAL, this, SLOT(nextDelayedInitialize()));
+    } else {
+        emit initializationDone();
+    }
+}
+
 void PluginManager::startTests()
 {
 #ifdef WITH_TESTS
@@ -494,7 +531,7 @@ PluginSpecPrivate *PluginManagerPrivate::privateSpec(PluginSpec *spec)
     \internal
  */
 PluginManagerPrivate::PluginManagerPrivate(PluginManager *pluginManager)
-    : extension("xml"), q(pluginManager)
+    : extension("xml"), parallelLoading(true), preloadTotal(0), profiling(false), q(pluginManager)
 {}
 
 /*!
@@ -512,6 +549,7 @@ PluginManagerPrivate::~PluginManagerPrivate()
 
 void PluginManagerPrivate::stopAll()
 {
+    delayedInitializeQueue.clear();
     QList<PluginSpec *> queue = loadQueue();
     foreach(PluginSpec * spec, queue) {
         loadPlugin(spec, PluginSpec::Stopped);
@@ -580,7 +618,16 @@ void PluginManagerPrivate::removeObject(QObject *obj)
  */
 void PluginManagerPrivate::loadPlugins()
 {
+    QElapsedTimer timer;
+
+    timer.start();
     QList<PluginSpec *> queue = loadQueue();
+    if (parallelLoading) {
+        QElapsedTimer preloadTimer;
+        preloadTimer.start();
+        preloadLibraries(queue);
+        preloadTotal = preloadTimer.elapsed();
+    }
     foreach(PluginSpec * spec, queue) {
         loadPlugin(spec, PluginSpec::Loaded);
     }
@@ -593,10 +640,111 @@ void PluginManagerPrivate::loadPlugins()
         PluginSpec *plugin = it.previous();
         emit q->pluginAboutToBeLoaded(plugin);
         loadPlugin(plugin, PluginSpec::Running);
+        delayedInitializeQueue.append(plugin);
+    }
+    if (profiling) {
+        profilingReport(queue, timer.elapsed());
     }
     emit q->pluginsChanged();
     q->m_allPluginsLoaded = true;
     emit q->pluginsLoadEnded();
+
+    // runs once the application enters its event loop
+    QTimer::singleShot(0, q, SLOT(nextDelayedInitialize()));
+}
+
+namespace {
+class LibraryPreloader : public QRunnable {
+public:
+    LibraryPreloader(PluginSpecPrivate *spec) : m_spec(spec) {}
+    void run()
+    {
+        m_spec->preloadLibrary();
+    }
+
+private:
+    PluginSpecPrivate *m_spec;
+};
+}
+
+/*!
+    \fn void PluginManagerPrivate::preloadLibraries(const QList<PluginSpec *> &queue)
+    \internal
+    Maps the libraries of the queue on a thread pool, one dependency level at
+    a time. A plugin's level is one more than the deepest of its dependencies,
+    so all libraries a plugin links to are mapped before it. Only the mapping
+    (relocation, static initialization) runs on the pool, the plugin instances
+    are still created on this thread by loadLibrary() and initialize() and
+    extensionsInitialized() run here too. Static initializers of a plugin must
+    therefore not create QObjects, they would live on a pool thread.
+    -no-parallel-load falls back to loading everything on this thread.
+ */
+void PluginManagerPrivate::preloadLibraries(const QList<PluginSpec *> &queue)
+{
+    // the queue lists every plugin after its dependencies
+    QHash<PluginSpec *, int> levels;
+    int maxLevel = 0;
+
+    foreach(PluginSpec * spec, queue) {
+        int level = 0;
+        foreach(PluginSpec * depSpec, spec->dependencySpecs()) {
+            level = qMax(level, levels.value(depSpec) + 1);
+        }
+        levels.insert(spec, level);
+        maxLevel = qMax(maxLevel, level);
+    }
+
+    QThreadPool pool;
+    for (int level = 0; level <= maxLevel; ++level) {
+        foreach(PluginSpec * spec, queue) {
+            if (levels.value(spec) == level && !spec->hasError()) {
+                pool.start(new LibraryPreloader(spec->d));
+            }
+        }
+        pool.waitForDone();
+    }
+}
+
+/*!
+    \fn bool PluginManagerPrivate::nextDelayedInitialize()
+    \internal
+    Runs delayedInitialize() of the queued plugins until one reports it did
+    work, returns false once the queue is empty.
+ */
+bool PluginManagerPrivate::nextDelayedInitialize()
+{
+    while (!delayedInitializeQueue.isEmpty()) {
+        PluginSpec *spec = delayedInitializeQueue.takeFirst();
+        if (spec->d->delayedInitialize()) {
+            if (profiling) {
+                qDebug() << "PluginManager -" << spec->name() << "delayedInitialize took" << spec->d->delayedTime << "ms";
+            }
+            return !delayedInitializeQueue.isEmpty();
+        }
+    }
+    return false;
+}
+
+/*!
+    \fn void PluginManagerPrivate::profilingReport(const QList<PluginSpec *> &queue, qint64 total) const
+    \internal
+ */
+void PluginManagerPrivate::profilingReport(const QList<PluginSpec *> &queue, qint64 total) const
+{
+    qDebug() << "PluginManager - startup [ms]   preload     load     init  extinit";
+    foreach(PluginSpec * spec, queue) {
+        qDebug() << qPrintable(QString("PluginManager - %1 %2 %3 %4 %5")
+                               .arg(spec->name(), -16)
+                               .arg(spec->d->preloadTime, 8)
+                               .arg(spec->d->loadTime, 8)
+                               .arg(spec->d->initializeTime, 8)
+                               .arg(spec->d->extensionsTime, 8));
+    }
+    if (parallelLoading) {
+        // compare with the sum of the preload column for the gain of the pool
+        qDebug() << "PluginManager - preloading took" << preloadTotal << "ms";
+    }
+    qDebug() << "PluginManager - loading" << queue.size() << "plugins took" << total << "ms";
 }
 
 /*!
@@ -667,8 +815,11 @@ void PluginManagerPrivate::loadPlugin(PluginSpec *spec, PluginSpec::State destSt
     if (spec->hasError()) {
         return;
     }
+    QElapsedTimer timer;
+    timer.start();
     if (destState == PluginSpec::Running) {
         spec->d->initializeExtensions();
+        spec->d->extensionsTime = timer.elapsed();
         return;
     } else if (destState == PluginSpec::Deleted) {
         spec->d->kill();
@@ -685,8 +836,10 @@ void PluginManagerPrivate::loadPlugin(PluginSpec *spec, PluginSpec::State destSt
     }
     if (destState == PluginSpec::Loaded) {
         spec->d->loadLibrary();
+        spec->d->loadTime = timer.elapsed();
     } else if (destState == PluginSpec::Initialized) {
         spec->d->initializePlugin();
+        spec->d->initializeTime = timer.elapsed();
     } else if (destState == PluginSpec::Stopped) {
         spec->d->stop();
     }
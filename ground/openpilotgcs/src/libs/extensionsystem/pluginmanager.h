@@ -115,6 +115,10 @@ public:
     bool runningTests() const;
     QString testDataDirectory() const;
 
+    // startup
+    void setParallelLoadingEnabled(bool enabled);
+    void setProfilingEnabled(bool enabled);
+
 signals:
     void objectAdded(QObject *obj);
     void aboutToRemoveObject(QObject *obj);
@@ -122,8 +126,10 @@ signals:
     void pluginAboutToBeLoaded(ExtensionSystem::PluginSpec *pluginSpec);
     void pluginsChanged();
     void pluginsLoadEnded();
+    void initializationDone();
 private slots:
     void startTests();
+    void nextDelayedInitialize();
 
 private:
     Internal::PluginManagerPrivate *d;
@@ -57,6 +57,9 @@ public:
     QList<PluginSpec *> loadQueue();
     void loadPlugin(PluginSpec *spec, PluginSpec::State destState);
     void resolveDependencies();
+    void preloadLibraries(const QList<PluginSpec *> &queue);
+    bool nextDelayedInitialize();
+    void profilingReport(const QList<PluginSpec *> &queue, qint64 total) const;
 
     QList<PluginSpec *> pluginSpecs;
     QList<PluginSpec *> testSpecs;
@@ -66,6 +69,11 @@ public:
 
     QStringList arguments;
 
+    bool parallelLoading;
+    qint64 preloadTotal;
+    bool profiling;
+    QList<PluginSpec *> delayedInitializeQueue;
+
     // Look in argument descriptions of the specs for the option.
     PluginSpec *pluginForOption(const QString &option, bool *requiresArgument) const;
     PluginSpec *pluginByName(const QString &name) const;
@@ -38,6 +38,8 @@
 #include <QtCore/QXmlStreamReader>
 #include <QtCore/QRegExp>
 #include <QtCore/QCoreApplication>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QLibrary>
 #include <QtDebug>
 
 #ifdef Q_OS_LINUX
@@ -384,6 +386,11 @@ PluginSpecPrivate::PluginSpecPrivate(PluginSpec *spec)
     : plugin(0),
     state(PluginSpec::Invalid),
     hasError(false),
+    preloadTime(0),
+    loadTime(0),
+    initializeTime(0),
+    extensionsTime(0),
+    delayedTime(0),
     q(spec)
 {}
 
@@ -770,22 +777,11 @@ bool PluginSpecPrivate::resolveDependencies(const QList<PluginSpec *> &specs)
 }
 
 /*!
-    \fn bool PluginSpecPrivate::loadLibrary()
+    \fn QString PluginSpecPrivate::libraryName() const
     \internal
  */
-bool PluginSpecPrivate::loadLibrary()
+QString PluginSpecPrivate::libraryName() const
 {
-    if (hasError) {
-        return false;
-    }
-    if (state != PluginSpec::Resolved) {
-        if (state == PluginSpec::Loaded) {
-            return true;
-        }
-        errorString = QCoreApplication::translate("PluginSpec", "Loading the library failed because state != Resolved");
-        hasError    = true;
-        return false;
-    }
 #ifdef QT_NO_DEBUG
 
 #ifdef Q_OS_WIN
@@ -808,6 +804,45 @@ bool PluginSpecPrivate::loadLibrary()
 
 #endif
 
+    return libName;
+}
+
+/*!
+    \fn bool PluginSpecPrivate::preloadLibrary()
+    \internal
+    Maps the plugin library without creating the plugin instance, so it
+    can run on a pool thread. loadLibrary() then finds the library loaded
+    and reports any error.
+ */
+bool PluginSpecPrivate::preloadLibrary()
+{
+    QElapsedTimer timer;
+
+    timer.start();
+    QLibrary library(libraryName());
+    bool loaded = library.load();
+    preloadTime = timer.elapsed();
+    return loaded;
+}
+
+/*!
+    \fn bool PluginSpecPrivate::loadLibrary()
+    \internal
+ */
+bool PluginSpecPrivate::loadLibrary()
+{
+    if (hasError) {
+        return false;
+    }
+    if (state != PluginSpec::Resolved) {
+        if (state == PluginSpec::Loaded) {
+            return true;
+        }
+        errorString = QCoreApplication::translate("PluginSpec", "Loading the library failed because state != Resolved");
+        hasError    = true;
+        return false;
+    }
+    QString libName = libraryName();
     PluginLoader loader(libName);
     if (!loader.load()) {
         hasError    = true;
@@ -886,6 +921,22 @@ bool PluginSpecPrivate::initializeExtensions()
     return true;
 }
 
+/*!
+    \fn bool PluginSpecPrivate::delayedInitialize()
+    \internal
+ */
+bool PluginSpecPrivate::delayedInitialize()
+{
+    if (hasError || state != PluginSpec::Running || !plugin) {
+        return false;
+    }
+    QElapsedTimer timer;
+    timer.start();
+    bool didWork = plugin->delayedInitialize();
+    delayedTime = timer.elapsed();
+    return didWork;
+}
+
 /*!
     \fn bool PluginSpecPrivate::stop()
     \internal
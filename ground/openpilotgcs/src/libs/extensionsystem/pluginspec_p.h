@@ -49,9 +49,12 @@ public:
     bool read(const QString &fileName);
     bool provides(const QString &pluginName, const QString &version) const;
     bool resolveDependencies(const QList<PluginSpec *> &specs);
+    QString libraryName() const;
+    bool preloadLibrary();
     bool loadLibrary();
     bool initializePlugin();
     bool initializeExtensions();
+    bool delayedInitialize();
     void stop();
     void kill();
 
@@ -77,6 +80,13 @@ public:
     bool hasError;
     QString errorString;
 
+    // startup profile [ms]
+    qint64 preloadTime;
+    qint64 loadTime;
+    qint64 initializeTime;
+    qint64 extensionsTime;
+    qint64 delayedTime;
+
     static bool isValidVersion(const QString &version);
     static int versionCompare(const QString &version1, const QString &version2);
 
@@ -211,7 +211,7 @@ void ConfigCustomWidget::refreshWidgetsValues(QString frameType)
 
     UAVDataObject *system = dynamic_cast<UAVDataObject *>(getObjectManager()->getObject(QString("SystemSettings")));
     Q_ASSERT(system);
-    QPointer<UAVObjectField> field = system->getField(QString("AirframeType"));
+    UAVObjectField *field = system->getField(QString("AirframeType"));
 
     // Do not allow table edit until AirframeType == Custom
     // First save set AirframeType to 'Custom' and next modify.
@@ -292,7 +292,7 @@ QString ConfigCustomWidget::updateConfigObjectsFromWidgets()
 
     Q_ASSERT(system);
 
-    QPointer<UAVObjectField> field = system->getField(QString("AirframeType"));
+    UAVObjectField *field = system->getField(QString("AirframeType"));
 
     // Do not allow changes until AirframeType == Custom
     // If user want to save custom mixer : first set AirframeType to 'Custom' without changes and next modify.
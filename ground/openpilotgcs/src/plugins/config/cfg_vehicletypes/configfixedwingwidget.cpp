@@ -114,7 +114,7 @@ void ConfigFixedWingWidget::setupUI(QString frameType)
 
     UAVDataObject *system = dynamic_cast<UAVDataObject *>(getObjectManager()->getObject(QString("SystemSettings")));
     Q_ASSERT(system);
-    QPointer<UAVObjectField> field = system->getField(QString("AirframeType"));
+    UAVObjectField *field = system->getField(QString("AirframeType"));
 
     UAVDataObject *mixer = dynamic_cast<UAVDataObject *>(getObjectManager()->getObject(QString("MixerSettings")));
     Q_ASSERT(mixer);
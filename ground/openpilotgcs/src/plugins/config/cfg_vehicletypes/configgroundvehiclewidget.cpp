@@ -108,7 +108,7 @@ void ConfigGroundVehicleWidget::setupUI(QString frameType)
 
     UAVDataObject *system = dynamic_cast<UAVDataObject *>(getObjectManager()->getObject(QString("SystemSettings")));
     Q_ASSERT(system);
-    QPointer<UAVObjectField> frameTypeSaved = system->getField(QString("AirframeType"));
+    UAVObjectField *frameTypeSaved = system->getField(QString("AirframeType"));
 
     m_aircraft->differentialSteeringSlider1->setEnabled(false);
     m_aircraft->differentialSteeringSlider2->setEnabled(false);
@@ -270,7 +270,7 @@ double VehicleConfig::getMixerValue(UAVDataObject *mixer, QString elementName)
 
     double value = 0.0;
 
-    QPointer<UAVObjectField> field = mixer->getField(elementName);
+    UAVObjectField *field = mixer->getField(elementName);
     if (field) {
         value = field->getDouble();
     }
@@ -281,7 +281,7 @@ void VehicleConfig::setMixerValue(UAVDataObject *mixer, QString elementName, dou
 {
     Q_ASSERT(mixer);
 
-    QPointer<UAVObjectField> field = mixer->getField(elementName);
+    UAVObjectField *field = mixer->getField(elementName);
     if (field) {
         field->setDouble(value);
     }
@@ -289,7 +289,7 @@ void VehicleConfig::setMixerValue(UAVDataObject *mixer, QString elementName, dou
 
 void VehicleConfig::setThrottleCurve(UAVDataObject *mixer, MixerThrottleCurveElem curveType, QList<double> curve)
 {
-    QPointer<UAVObjectField> field;
+    UAVObjectField *field = NULL;
 
     switch (curveType) {
     case MIXER_THROTTLECURVE1:
@@ -312,7 +312,7 @@ void VehicleConfig::getThrottleCurve(UAVDataObject *mixer, MixerThrottleCurveEle
     Q_ASSERT(mixer);
     Q_ASSERT(curve);
 
-    QPointer<UAVObjectField> field;
+    UAVObjectField *field = NULL;
 
     switch (curveType) {
     case MIXER_THROTTLECURVE1:
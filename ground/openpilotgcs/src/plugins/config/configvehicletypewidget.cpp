@@ -276,7 +276,7 @@ void ConfigVehicleTypeWidget::updateObjectsFromWidgets()
     UAVDataObject *system = dynamic_cast<UAVDataObject *>(getObjectManager()->getObject(QString("SystemSettings")));
     Q_ASSERT(system);
 
-    QPointer<UAVObjectField> field = system->getField(QString("AirframeType"));
+    UAVObjectField *field = system->getField(QString("AirframeType"));
     if (field) {
         field->setValue(airframeType);
     }
@@ -60,6 +60,12 @@ void CorePlugin::extensionsInitialized()
     m_mainWindow->extensionsInitialized();
 }
 
+bool CorePlugin::delayedInitialize()
+{
+    m_mainWindow->delayedInitialize();
+    return true;
+}
+
 void CorePlugin::remoteArgument(const QString & arg)
 {
     // An empty argument is sent to trigger activation
@@ -45,6 +45,7 @@ public:
 
     virtual bool initialize(const QStringList &arguments, QString *errorMessage = 0);
     virtual void extensionsInitialized();
+    virtual bool delayedInitialize();
     virtual void shutdown();
 
 public slots:
@@ -1100,12 +1100,39 @@ void MainWindow::createWorkspaces(QSettings *qs, bool diffOnly)
 
         pm->addObject(uavGadgetManager);
         m_uavGadgetManagers.append(uavGadgetManager);
-        uavGadgetManager->readSettings(qs);
-        qDebug() << "MainWindow::createWorkspaces - creating workspace" << name << "took" << timer.elapsed() << "ms";
+        // only the workspace showing gets its gadgets now, the others when
+        // they are first shown or by delayedInitialize()
+        uavGadgetManager->readSettings(qs, qs == m_settings);
+        qDebug() << "MainWindow::createWorkspaces - creating workspace" << name
+                 << (uavGadgetManager->isRestorePending() ? "(gadgets deferred)" : "")
+                 << "took" << timer.elapsed() << "ms";
     }
     qDebug() << "MainWindow::createWorkspaces - creating workspaces took" << totalTimer.elapsed() << "ms";
 }
 
+/**
+ * Called once the main window is up: creates the gadgets of the workspaces
+ * that were not shown yet, one workspace per event loop turn.
+ */
+void MainWindow::delayedInitialize()
+{
+    QTimer::singleShot(0, this, SLOT(restoreNextWorkspace()));
+}
+
+void MainWindow::restoreNextWorkspace()
+{
+    foreach(UAVGadgetManager * manager, m_uavGadgetManagers) {
+        if (manager->isRestorePending()) {
+            QElapsedTimer timer;
+            timer.start();
+            manager->restorePendingState();
+            qDebug() << "MainWindow::restoreNextWorkspace - restoring workspace" << manager->name() << "took" << timer.elapsed() << "ms";
+            QTimer::singleShot(0, this, SLOT(restoreNextWorkspace()));
+            return;
+        }
+    }
+}
+
 static const char *settingsGroup  = "MainWindow";
 static const char *geometryKey    = "Geometry";
 static const char *colorKey = "Color";
@@ -84,6 +84,7 @@ public:
 
     bool init(QString *errorMessage);
     void extensionsInitialized();
+    void delayedInitialize();
     void shutdown();
 
     IContext *contextObject(QWidget *widget);
@@ -162,6 +163,7 @@ private slots:
     void showUavGadgetMenus(bool show, bool hasSplitter);
     void applyTabBarSettings(QTabWidget::TabPosition pos, bool movable);
     void showHelp();
+    void restoreNextWorkspace();
 
 private:
     void updateContextObject(IContext *context);
@@ -86,7 +86,8 @@ UAVGadgetManager::UAVGadgetManager(ICore *core, QString name, QIcon icon, int pr
     m_name(name),
     m_icon(icon),
     m_priority(priority),
-    m_widget(new QWidget(parent))
+    m_widget(new QWidget(parent)),
+    m_pendingSettings(0)
 {
     // checking that the mode name is unique gives harmless
     // warnings on the console output
@@ -141,6 +142,7 @@ void UAVGadgetManager::modeChanged(Core::IMode *mode)
         return;
     }
 
+    restorePendingState();
     m_currentGadget->widget()->setFocus();
     showToolbars(toolbarsShown());
 }
@@ -333,6 +335,20 @@ bool UAVGadgetManager::restoreState(QSettings *qSettings)
 
 void UAVGadgetManager::saveSettings(QSettings *qs)
 {
+    // A workspace that was never shown still has its layout only in the
+    // settings it was read from, copy that over
+    QMap<QString, QVariant> pendingState;
+
+    if (m_pendingSettings) {
+        m_pendingSettings->beginGroup("UAVGadgetManager");
+        m_pendingSettings->beginGroup(this->uniqueModeName());
+        foreach(QString key, m_pendingSettings->allKeys()) {
+            pendingState.insert(key, m_pendingSettings->value(key));
+        }
+        m_pendingSettings->endGroup();
+        m_pendingSettings->endGroup();
+    }
+
     qs->beginGroup("UAVGadgetManager");
     qs->beginGroup(this->uniqueModeName());
 
@@ -340,16 +356,29 @@ void UAVGadgetManager::saveSettings(QSettings *qs)
     qs->remove("");
 
     // Do actual saving
-    saveState(qs);
+    if (m_pendingSettings) {
+        QMap<QString, QVariant>::const_iterator it;
+        for (it = pendingState.constBegin(); it != pendingState.constEnd(); ++it) {
+            qs->setValue(it.key(), it.value());
+        }
+    } else {
+        saveState(qs);
+    }
 
     qs->endGroup();
     qs->endGroup();
 }
 
-void UAVGadgetManager::readSettings(QSettings *qs)
+/**
+ * Restores the gadget layout of the workspace. With deferred set and the
+ * workspace not showing, the gadgets are only created once it is first
+ * shown or restorePendingState() is called. qs must then outlive this.
+ */
+void UAVGadgetManager::readSettings(QSettings *qs, bool deferred)
 {
     QString uavGadgetManagerRootKey = "UAVGadgetManager";
 
+    m_pendingSettings = 0;
     if (!qs->childGroups().contains(uavGadgetManagerRootKey)) {
         return;
     }
@@ -361,6 +390,28 @@ void UAVGadgetManager::readSettings(QSettings *qs)
     }
     qs->beginGroup(uniqueModeName());
 
+    if (deferred && ModeManager::instance()->currentMode() != this) {
+        m_pendingSettings = qs;
+    } else {
+        restoreState(qs);
+        showToolbars(m_showToolbars);
+    }
+
+    qs->endGroup();
+    qs->endGroup();
+}
+
+void UAVGadgetManager::restorePendingState()
+{
+    QSettings *qs = m_pendingSettings;
+
+    if (!qs) {
+        return;
+    }
+    m_pendingSettings = 0;
+    qs->beginGroup("UAVGadgetManager");
+    qs->beginGroup(uniqueModeName());
+
     restoreState(qs);
 
     showToolbars(m_showToolbars);
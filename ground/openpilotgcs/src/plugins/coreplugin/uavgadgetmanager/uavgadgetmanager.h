@@ -99,7 +99,12 @@ public:
     bool restoreState(QSettings *qSettings);
 
     void saveSettings(QSettings *qs);
-    void readSettings(QSettings *qs);
+    void readSettings(QSettings *qs, bool deferred = false);
+    bool isRestorePending() const
+    {
+        return m_pendingSettings != 0;
+    }
+    void restorePendingState();
     bool toolbarsShown()
     {
         return m_showToolbars;
@@ -145,6 +150,7 @@ private:
     QByteArray m_uniqueNameBA;
     const char *m_uniqueModeName;
     QWidget *m_widget;
+    QSettings *m_pendingSettings;
 
     friend class Core::Internal::SplitterOrView;
     friend class Core::Internal::UAVGadgetView;
@@ -32,6 +32,7 @@
 #include <QFileDialog>
 #include <QXmlStreamReader>
 #include <QMessageBox>
+#include <QTemporaryDir>
 #include <QDebug>
 
 #include "debuglogcontrol.h"
@@ -39,6 +40,7 @@
 #include "uavtalk/uavtalk.h"
 #include "utils/logfile.h"
 #include "uavdataobject.h"
+#include "uavobjectcolumnlog.h"
 #include <uavobjectutil/uavobjectutilmanager.h>
 
 FlightLogManager::FlightLogManager(QObject *parent) :
@@ -275,8 +277,10 @@ void FlightLogManager::retrieveLogs(int flightToRetrieve)
     setDisableControls(false);
 }
 
-void FlightLogManager::exportToOPL(QString fileName)
+QStringList FlightLogManager::exportToOPL(QString fileName)
 {
+    QStringList fileNames;
+
     // Fix the file name
     fileName.replace(QString(".opl"), QString("%1.opl"));
 
@@ -297,7 +301,8 @@ void FlightLogManager::exportToOPL(QString fileName)
         logFile.useProvidedTimeStamp(true);
 
         // Set the file name to contain flight number
-        logFile.setFileName(fileName.arg(tr("_flight-%1").arg(currentFlight + 1)));
+        fileNames << fileName.arg(tr("_flight-%1").arg(currentFlight + 1));
+        logFile.setFileName(fileNames.last());
         logFile.open(QIODevice::WriteOnly);
         UAVTalk uavTalk(&logFile, m_objectManager);
 
@@ -319,6 +324,31 @@ void FlightLogManager::exportToOPL(QString fileName)
 
         logFile.close();
     }
+    return fileNames;
+}
+
+/**
+ * Columnar export, one .opc file per flight like the .opl export it is converted from
+ */
+void FlightLogManager::exportToColumns(QString fileName)
+{
+    QTemporaryDir tempDir;
+
+    if (!tempDir.isValid()) {
+        return;
+    }
+    QString baseName = QString("export");
+    QStringList logFileNames = exportToOPL(tempDir.path() + "/" + baseName + ".opl");
+
+    fileName.replace(QString(".opc"), QString("%1.opc"));
+    UAVObjectColumnExporter exporter(m_objectManager);
+    foreach(QString logFileName, logFileNames) {
+        // keep the flight suffix of the temporary log
+        QString suffix = QFileInfo(logFileName).completeBaseName().mid(baseName.length());
+        if (!exporter.exportLog(logFileName, fileName.arg(suffix))) {
+            qWarning() << "FlightLogManager - column export failed:" << exporter.errorString();
+        }
+    }
 }
 
 void FlightLogManager::exportToCSV(QString fileName)
@@ -384,11 +414,12 @@ void FlightLogManager::exportLogs()
     QString oplFilter = tr("OpenPilot Log file %1").arg("(*.opl)");
     QString csvFilter = tr("Text file %1").arg("(*.csv)");
     QString xmlFilter = tr("XML file %1").arg("(*.xml)");
+    QString opcFilter = tr("Columnar binary file %1").arg("(*.opc)");
 
     QString selectedFilter = csvFilter;
 
     QString fileName = QFileDialog::getSaveFileName(NULL, tr("Save Log Entries"), QDir::homePath(),
-                                                    QString("%1;;%2;;%3").arg(oplFilter, csvFilter, xmlFilter), &selectedFilter);
+                                                    QString("%1;;%2;;%3;;%4").arg(oplFilter, csvFilter, xmlFilter, opcFilter), &selectedFilter);
     if (!fileName.isEmpty()) {
         if (selectedFilter == oplFilter) {
             if (!fileName.endsWith(".opl")) {
@@ -405,6 +436,11 @@ void FlightLogManager::exportLogs()
                 fileName.append(".xml");
             }
             exportToXML(fileName);
+        } else if (selectedFilter == opcFilter) {
+            if (!fileName.endsWith(".opc")) {
+                fileName.append(".opc");
+            }
+            exportToColumns(fileName);
         }
     }
 
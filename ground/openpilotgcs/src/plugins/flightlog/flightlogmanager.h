@@ -338,9 +338,10 @@ private:
     QList<UAVOLogSettingsWrapper *> m_uavoEntries;
     QHash<QString, UAVOLogSettingsWrapper *> m_uavoEntriesHash;
 
-    void exportToOPL(QString fileName);
+    QStringList exportToOPL(QString fileName);
     void exportToCSV(QString fileName);
     void exportToXML(QString fileName);
+    void exportToColumns(QString fileName);
 
     static const int UAVTALK_TIMEOUT = 4000;
     static const int LOG_SETTINGS_FILE_VERSION = 1;
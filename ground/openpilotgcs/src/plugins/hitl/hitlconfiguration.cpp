@@ -37,6 +37,8 @@ HITLConfiguration::HITLConfiguration(QString classId, QSettings *qSettings, QObj
     settings.manualControlEnabled = true;
     settings.startSim             = false;
     settings.addNoise             = false;
+    settings.lockstep             = false;
+    settings.lockstepBatch        = false;
     settings.hostAddress          = "127.0.0.1";
     settings.remoteAddress        = "127.0.0.1";
     settings.outPort              = 0;
@@ -82,6 +84,8 @@ HITLConfiguration::HITLConfiguration(QString classId, QSettings *qSettings, QObj
         settings.longitude     = qSettings->value("longitude").toString();
         settings.startSim      = qSettings->value("startSim").toBool();
         settings.addNoise      = qSettings->value("noiseCheckBox").toBool();
+        settings.lockstep      = qSettings->value("lockstep").toBool();
+        settings.lockstepBatch = qSettings->value("lockstepBatch").toBool();
 
         settings.gcsReceiverEnabled   = qSettings->value("gcsReceiverEnabled").toBool();
         settings.manualControlEnabled = qSettings->value("manualControlEnabled").toBool();
@@ -138,6 +142,8 @@ void HITLConfiguration::saveConfig(QSettings *qSettings) const
     qSettings->setValue("longitude", settings.longitude);
     qSettings->setValue("addNoise", settings.addNoise);
     qSettings->setValue("startSim", settings.startSim);
+    qSettings->setValue("lockstep", settings.lockstep);
+    qSettings->setValue("lockstepBatch", settings.lockstepBatch);
 
     qSettings->setValue("gcsReceiverEnabled", settings.gcsReceiverEnabled);
     qSettings->setValue("manualControlEnabled", settings.manualControlEnabled);
@@ -82,6 +82,8 @@ QWidget *HITLOptionsPage::createPage(QWidget *parent)
 
     m_optionsPage->startSim->setChecked(config->Settings().startSim);
     m_optionsPage->noiseCheckBox->setChecked(config->Settings().addNoise);
+    m_optionsPage->lockstepCheckBox->setChecked(config->Settings().lockstep);
+    m_optionsPage->lockstepBatchCheckBox->setChecked(config->Settings().lockstepBatch);
 
     m_optionsPage->hostAddress->setText(config->Settings().hostAddress);
     m_optionsPage->remoteAddress->setText(config->Settings().remoteAddress);
@@ -126,6 +128,8 @@ void HITLOptionsPage::apply()
     settings.dataPath             = m_optionsPage->dataPath->path();
     settings.startSim             = m_optionsPage->startSim->isChecked();
     settings.addNoise             = m_optionsPage->noiseCheckBox->isChecked();
+    settings.lockstep             = m_optionsPage->lockstepCheckBox->isChecked();
+    settings.lockstepBatch        = m_optionsPage->lockstepBatchCheckBox->isChecked();
     settings.hostAddress          = m_optionsPage->hostAddress->text();
     settings.remoteAddress        = m_optionsPage->remoteAddress->text();
 
@@ -17,7 +17,8 @@ HEADERS += hitlplugin.h \
     fgsimulator.h \
     il2simulator.h \
     xplanesimulator9.h \
-    xplanesimulator10.h
+    xplanesimulator10.h \
+    sitlsimulator.h
 SOURCES += hitlplugin.cpp \
     hitlwidget.cpp \
     hitloptionspage.cpp \
@@ -30,7 +31,8 @@ SOURCES += hitlplugin.cpp \
     fgsimulator.cpp \
     il2simulator.cpp \
     xplanesimulator9.cpp \
-    xplanesimulator10.cpp
+    xplanesimulator10.cpp \
+    sitlsimulator.cpp
 OTHER_FILES += hitl.pluginspec
 FORMS += hitloptionspage.ui \
     hitlwidget.ui
@@ -64,14 +64,7 @@ Simulator::Simulator(const SimulatorSettings & params) :
     connect(this, SIGNAL(myStart()), this, SLOT(onStart()), Qt::QueuedConnection);
     emit myStart();
 
-    QTime currentTime = QTime::currentTime();
-    gpsPosTime        = currentTime;
-    groundTruthTime   = currentTime;
-    gcsRcvrTime       = currentTime;
-    attRawTime        = currentTime;
-    baroAltTime       = currentTime;
-    battTime = currentTime;
-    airspeedStateTime = currentTime;
+    resetOutputTimers(QTime::currentTime());
 
     // Define standard atmospheric constants
     airParameters.univGasConstant  = 8.31447; // [J/(mol·K)]
@@ -215,9 +208,11 @@ void Simulator::onStart()
     current.i = 0;
 }
 
-void Simulator::receiveUpdate()
+/**
+ * Restart the simulator connection timeout and flag the simulator as connected.
+ */
+void Simulator::simulatorAlive()
 {
-    // Update connection timer and status
     simTimer->setInterval(simTimeout);
     simTimer->stop();
     simTimer->start();
@@ -225,6 +220,26 @@ void Simulator::receiveUpdate()
         simConnectionStatus = true;
         emit simulatorConnected();
     }
+}
+
+/**
+ * Restart the rate limiting of all sensor outputs at the given time.
+ */
+void Simulator::resetOutputTimers(const QTime & start)
+{
+    gpsPosTime        = start;
+    groundTruthTime   = start;
+    gcsRcvrTime       = start;
+    attRawTime        = start;
+    baroAltTime       = start;
+    battTime          = start;
+    airspeedStateTime = start;
+}
+
+void Simulator::receiveUpdate()
+{
+    // Update connection timer and status
+    simulatorAlive();
 
     // Process data
     while (inSocket->hasPendingDatagrams()) {
@@ -336,14 +351,26 @@ void Simulator::setupOutputObject(UAVObject *obj, quint32 updatePeriod)
     mdata = obj->getDefaultMetadata();
 
     UAVObject::SetGcsAccess(mdata, UAVObject::ACCESS_READWRITE);
-    UAVObject::SetGcsTelemetryAcked(mdata, false);
-    UAVObject::SetGcsTelemetryUpdateMode(mdata, UAVObject::UPDATEMODE_PERIODIC);
-    mdata.gcsTelemetryUpdatePeriod = updatePeriod;
+    if (settings.lockstep) {
+        // updateUAVOs() already limits the rate on simulation time, send every sample right away
+        // and have it acknowledged, the autopilot clock is held until it arrived
+        UAVObject::SetGcsTelemetryAcked(mdata, true);
+        UAVObject::SetGcsTelemetryUpdateMode(mdata, UAVObject::UPDATEMODE_ONCHANGE);
+        mdata.gcsTelemetryUpdatePeriod = 0;
+    } else {
+        UAVObject::SetGcsTelemetryAcked(mdata, false);
+        UAVObject::SetGcsTelemetryUpdateMode(mdata, UAVObject::UPDATEMODE_PERIODIC);
+        mdata.gcsTelemetryUpdatePeriod = updatePeriod;
+    }
 
     UAVObject::SetFlightAccess(mdata, UAVObject::ACCESS_READONLY);
     UAVObject::SetFlightTelemetryUpdateMode(mdata, UAVObject::UPDATEMODE_MANUAL);
 
     obj->setMetadata(mdata);
+
+    if (!outputObjects.contains(obj)) {
+        outputObjects.append(obj);
+    }
 }
 
 void Simulator::onAutopilotConnect()
@@ -389,7 +416,7 @@ void Simulator::resetInitialHomePosition()
 
 void Simulator::updateUAVOs(Output2Hardware out)
 {
-    QTime currentTime = QTime::currentTime();
+    QTime currentTime = simulationClock();
 
     Noise noise;
     HitlNoiseGeneration noiseSource;
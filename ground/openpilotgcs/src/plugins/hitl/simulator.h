@@ -122,6 +122,8 @@ typedef struct _CONNECTION {
     int     inPort;
     bool    startSim;
     bool    addNoise;
+    bool    lockstep;      // hold the autopilot clock until the simulation delivered its sensor data
+    bool    lockstepBatch; // in lockstep, run as fast as possible instead of in real time
     QString latitude;
     QString longitude;
 
@@ -303,6 +305,22 @@ private slots:
     virtual void processUpdate(const QByteArray & data) = 0;
 
 protected:
+    void simulatorAlive();
+    void resetOutputTimers(const QTime & start);
+    virtual void setupObjects();
+    void setupOutputObject(UAVObject *obj, quint32 updatePeriod);
+    void setupInputObject(UAVObject *obj, quint32 updatePeriod);
+    void setupWatchedObject(UAVObject *obj, quint32 updatePeriod);
+
+    /**
+     * Clock the sensor output rates in updateUAVOs() are measured against.
+     * Backends that run on simulation time instead of the wall clock override this.
+     */
+    virtual QTime simulationClock() const
+    {
+        return QTime::currentTime();
+    }
+
     static const float GEE;
     static const float FT2M;
     static const float KT2MPS;
@@ -342,6 +360,9 @@ protected:
     FLIGHT_PARAM old;
     QMutex lock;
 
+    // objects set up by setupOutputObject(), the sensor data sent to the autopilot
+    QList<UAVObject *> outputObjects;
+
 private:
     bool once;
     float initN;
@@ -368,10 +389,6 @@ private:
     volatile static bool isStarted;
     static QStringList instances;
     // QList<QScopedPointer<UAVDataObject> > requiredUAVObjects;
-    void setupOutputObject(UAVObject *obj, quint32 updatePeriod);
-    void setupInputObject(UAVObject *obj, quint32 updatePeriod);
-    void setupWatchedObject(UAVObject *obj, quint32 updatePeriod);
-    void setupObjects();
 
     AirParameters airParameters;
 };
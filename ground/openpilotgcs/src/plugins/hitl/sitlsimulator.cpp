@@ -0,0 +1,562 @@
+/**
+ ******************************************************************************
+ *
+ * @file       sitlsimulator.cpp
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2014.
+ * @brief      Built-in rigid body simulator for software in the loop testing
+ * @see        The GNU Public License (GPL) Version 3
+ * @defgroup   hitlplugin
+ * @{
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "sitlsimulator.h"
+#include "systemsettings.h"
+#include "extensionsystem/pluginmanager.h"
+
+// Integration step, larger steps are split up
+static const float MAX_INTEGRATION_STEP = 0.002f;     // [s]
+static const float EARTH_RADIUS = 6378137.0f;         // [m]
+
+// Multirotor model
+static const float MR_MASS = 1.0f;                    // [kg]
+static const float MR_MAX_THRUST   = 2.0f * 9.81f;    // [N], thrust to weight of 2
+static const float MR_DRAG = 0.3f;                    // linear drag [N/(m/s)]
+static const float MR_MAX_ANGULAR_ACCEL[3] = { 40.0f, 40.0f, 10.0f }; // [rad/s^2]
+static const float MR_RATE_DAMPING = 2.0f;            // [1/s]
+
+// Fixed wing model
+static const float FW_MASS = 1.2f;                    // [kg]
+static const float FW_MAX_THRUST = 12.0f;             // [N]
+static const float FW_WING_AREA  = 0.3f;              // [m^2]
+static const float FW_CL0      = 0.3f;
+static const float FW_CL_ALPHA = 4.5f;                // [1/rad]
+static const float FW_CL_MAX   = 1.2f;
+static const float FW_CD0      = 0.04f;
+static const float FW_CD_K     = 0.06f;
+static const float FW_CY_BETA  = 0.6f;                // [1/rad]
+static const float FW_CRUISE_SPEED    = 15.0f;        // [m/s]
+static const float FW_MAX_ANGULAR_ACCEL[3] = { 30.0f, 20.0f, 8.0f }; // [rad/s^2] at cruise speed
+static const float FW_RATE_DAMPING    = 4.0f;         // [1/s] at cruise speed
+static const float FW_PITCH_STIFFNESS = 30.0f;        // [rad/s^2 per rad of angle of attack]
+static const float FW_YAW_STIFFNESS   = 20.0f;        // [rad/s^2 per rad of sideslip]
+static const float FW_START_ALTITUDE  = 100.0f;       // [m]
+
+// Lockstep, grant anyway when the sensor objects are not acknowledged in time
+static const int LOCKSTEP_TIMEOUT = 1000;             // [ms]
+
+SITLSimulator::SITLSimulator(const SimulatorSettings & params) :
+    Simulator(params),
+    vehicle(VEHICLE_MULTIROTOR),
+    simTimeUs(0),
+    consumption(0),
+    lockstepHeld(false),
+    lockstepStepping(false),
+    heldTick(0),
+    grantedTick(0),
+    lockstepTickUs(1000),
+    lockstepTimer(NULL)
+{
+    homeLLA[0] = 0;
+    homeLLA[1] = 0;
+    homeLLA[2] = 0;
+    resetState();
+}
+
+SITLSimulator::~SITLSimulator()
+{
+    if (lockstepTimer) {
+        // let the firmware run on by itself
+        lockstepSend(LOCKSTEP_RELEASE, 0);
+        delete lockstepTimer;
+        lockstepTimer = NULL;
+    }
+}
+
+/**
+ * The model runs in process, only lockstep needs a socket. The firmware lockstep
+ * port is the output port, it answers to the input port.
+ */
+void SITLSimulator::setupUdpPorts(const QString & host, int inPort, int outPort)
+{
+    Q_UNUSED(outPort)
+
+    if (!settings.lockstep) {
+        return;
+    }
+
+    if (inSocket->bind(QHostAddress(host), inPort)) {
+        emit processOutput("Successfully bound to address " + host + " on port " + QString::number(inSocket->localPort()) + "\n");
+    } else {
+        emit processOutput("Cannot bind to address " + host + " on port " + QString::number(inPort) + "\n");
+    }
+
+    lockstepTimer = new QTimer();
+    lockstepTimer->setSingleShot(true);
+    lockstepTimer->setInterval(LOCKSTEP_TIMEOUT);
+    connect(lockstepTimer, SIGNAL(timeout()), this, SLOT(lockstepTimeout()), Qt::DirectConnection);
+}
+
+bool SITLSimulator::setupProcess()
+{
+    QMutexLocker locker(&lock);
+
+    ExtensionSystem::PluginManager *pm = ExtensionSystem::PluginManager::instance();
+    UAVObjectManager *objManager = pm->getObject<UAVObjectManager>();
+    SystemSettings *systemSettings = SystemSettings::GetInstance(objManager);
+
+    switch (systemSettings->getData().AirframeType) {
+    case SystemSettings::AIRFRAMETYPE_FIXEDWING:
+    case SystemSettings::AIRFRAMETYPE_FIXEDWINGELEVON:
+    case SystemSettings::AIRFRAMETYPE_FIXEDWINGVTAIL:
+        vehicle = VEHICLE_FIXEDWING;
+        break;
+    default:
+        vehicle = VEHICLE_MULTIROTOR;
+        break;
+    }
+
+    homeLLA[0] = settings.latitude.toDouble();
+    homeLLA[1] = settings.longitude.toDouble();
+    homeLLA[2] = 0;
+
+    resetState();
+    resetOutputTimers(simulationClock());
+    realTime.start();
+
+    if (lockstepTimer) {
+        // a grant in the past holds the firmware at its next tick
+        lockstepHeld     = false;
+        lockstepStepping = false;
+        pendingOutputs.clear();
+        lockstepSend(LOCKSTEP_GRANT, 0);
+        lockstepTimer->start();
+    }
+
+    emit processOutput(QString("Built-in %1 model started in %2 mode\n")
+                       .arg(vehicle == VEHICLE_FIXEDWING ? "fixed wing" : "multirotor")
+                       .arg(settings.lockstep ? (settings.lockstepBatch ? "lockstep batch" : "lockstep") : "real time"));
+
+    // there is no external process to wait for
+    simulatorAlive();
+
+    return true;
+}
+
+void SITLSimulator::setupObjects()
+{
+    Simulator::setupObjects();
+
+    // the model is driven by ActuatorDesired, also when the autopilot runs its own mixer
+    if (settings.gcsReceiverEnabled) {
+        setupInputObject(actDesired, settings.minOutputPeriod);
+    }
+
+    // lockstep waits for the acknowledgement of every sensor object sent in a step
+    if (settings.lockstep) {
+        foreach(UAVObject * obj, outputObjects) {
+            connect(obj, SIGNAL(objectUpdated(UAVObject *)), this, SLOT(outputUpdated(UAVObject *)), Qt::UniqueConnection);
+            connect(obj, SIGNAL(transactionCompleted(UAVObject *, bool)), this, SLOT(outputCompleted(UAVObject *, bool)), Qt::UniqueConnection);
+        }
+    }
+}
+
+QTime SITLSimulator::simulationClock() const
+{
+    if (settings.lockstep) {
+        return QTime(0, 0).addMSecs(simTimeUs / 1000);
+    }
+    return QTime::currentTime();
+}
+
+/**
+ * Lockstep datagrams from the firmware.
+ */
+void SITLSimulator::processUpdate(const QByteArray & data)
+{
+    LockstepMessage msg;
+
+    if (!lockstepTimer || data.size() != (int)sizeof(msg)) {
+        return;
+    }
+    memcpy(&msg, data.constData(), sizeof(msg));
+    if (msg.magic == LOCKSTEP_MAGIC && msg.type == LOCKSTEP_HOLD) {
+        lockstepHold(msg);
+    }
+}
+
+/**
+ * Real time mode: advance the model by the wall clock time since the last update.
+ */
+void SITLSimulator::transmitUpdate()
+{
+    if (settings.lockstep) {
+        return;
+    }
+
+    float dT = realTime.restart() * 1e-3f;
+    if (dT > 0.2f) {
+        // do not try to catch up after the GCS stalled
+        dT = 0.2f;
+    }
+
+    float controls[4];
+    readControls(controls);
+    step(dT, controls);
+}
+
+/**
+ * Lockstep mode: the firmware holds its clock at msg.tick. Advance the model by
+ * the time since the last hold with the outputs the firmware reported, the next
+ * period is granted once the sensor objects arrived.
+ */
+void SITLSimulator::lockstepHold(const LockstepMessage & msg)
+{
+    if (lockstepStepping) {
+        // the firmware repeats its hold, the acknowledgements are still due
+        return;
+    }
+    if (lockstepHeld && msg.tick == heldTick) {
+        if ((qint32)(grantedTick - heldTick) > 0) {
+            // the grant got lost, a paced grant is still pending otherwise
+            lockstepSend(LOCKSTEP_GRANT, grantedTick);
+        }
+        return;
+    }
+
+    float dT = 0;
+    if (lockstepHeld) {
+        dT = (quint32)(msg.tick - heldTick) * msg.tickUs * 1e-6f;
+    } else {
+        // pace from the first hold on
+        realTime.restart();
+    }
+    lockstepHeld   = true;
+    heldTick       = msg.tick;
+    lockstepTickUs = qMax<quint32>(msg.tickUs, 1);
+
+    float controls[4];
+    for (int i = 0; i < 3; i++) {
+        controls[i] = qBound(-1.0f, msg.outputs[i], 1.0f);
+    }
+    controls[3] = qBound(0.0f, msg.outputs[3], 1.0f);
+
+    lockstepStepping = true;
+    pendingOutputs.clear();
+    lockstepTimer->start();
+    step(dT, controls);
+
+    if (lockstepStepping && pendingOutputs.isEmpty()) {
+        // no sensor was due in this step
+        lockstepStepDone();
+    }
+}
+
+void SITLSimulator::outputUpdated(UAVObject *obj)
+{
+    if (lockstepStepping) {
+        pendingOutputs.insert(obj);
+    }
+}
+
+void SITLSimulator::outputCompleted(UAVObject *obj, bool success)
+{
+    Q_UNUSED(success);
+
+    if (lockstepStepping && pendingOutputs.remove(obj) && pendingOutputs.isEmpty()) {
+        lockstepStepDone();
+    }
+}
+
+/**
+ * The firmware did not answer the first grant or did not acknowledge the sensor objects in time.
+ */
+void SITLSimulator::lockstepTimeout()
+{
+    if (!lockstepHeld) {
+        lockstepSend(LOCKSTEP_GRANT, 0);
+        lockstepTimer->start();
+    } else if (lockstepStepping) {
+        qDebug() << "SITLSimulator: lockstep timeout, granting without" << pendingOutputs.size() << "acknowledgements";
+        pendingOutputs.clear();
+        lockstepStepDone();
+    }
+}
+
+/**
+ * All sensor objects of the step arrived, grant the next period. In batch mode
+ * right away, otherwise once the wall clock caught up with the simulation.
+ */
+void SITLSimulator::lockstepStepDone()
+{
+    lockstepStepping = false;
+    lockstepTimer->stop();
+
+    qint64 ahead = (qint64)(simTimeUs / 1000) - realTime.elapsed();
+    if (settings.lockstepBatch || ahead <= 0) {
+        lockstepGrant();
+    } else {
+        QTimer::singleShot(ahead, this, SLOT(lockstepGrant()));
+    }
+}
+
+void SITLSimulator::lockstepGrant()
+{
+    grantedTick = heldTick + qMax<quint32>(1, settings.minOutputPeriod * 1000 / lockstepTickUs);
+    lockstepSend(LOCKSTEP_GRANT, grantedTick);
+}
+
+/**
+ * Sent through the input socket, so the firmware answers to the port we listen on.
+ */
+void SITLSimulator::lockstepSend(quint32 type, quint32 tick)
+{
+    LockstepMessage msg;
+
+    memset(&msg, 0, sizeof(msg));
+    msg.magic = LOCKSTEP_MAGIC;
+    msg.type  = type;
+    msg.tick  = tick;
+    inSocket->writeDatagram((const char *)&msg, sizeof(msg), QHostAddress(settings.remoteAddress), settings.outPort);
+}
+
+void SITLSimulator::resetState()
+{
+    memset(&state, 0, sizeof(state));
+    state.q[0] = 1;
+    state.accel[2] = -GEE;
+    if (vehicle == VEHICLE_FIXEDWING) {
+        // no runway, start in level flight
+        state.pos[2] = -FW_START_ALTITUDE;
+        state.vel[0] = FW_CRUISE_SPEED;
+    }
+    simTimeUs   = 0;
+    consumption = 0;
+}
+
+/**
+ * Real time mode: roll, pitch, yaw and thrust from the ActuatorDesired telemetry, zero while disarmed.
+ */
+void SITLSimulator::readControls(float controls[4])
+{
+    for (int i = 0; i < 4; i++) {
+        controls[i] = 0;
+    }
+    if (flightStatus->getData().Armed == FlightStatus::ARMED_ARMED) {
+        ActuatorDesired::DataFields actData = actDesired->getData();
+        controls[0] = qBound(-1.0f, actData.Roll, 1.0f);
+        controls[1] = qBound(-1.0f, actData.Pitch, 1.0f);
+        controls[2] = qBound(-1.0f, actData.Yaw, 1.0f);
+        controls[3] = qBound(0.0f, actData.Thrust, 1.0f);
+    }
+}
+
+/**
+ * Advance the model and publish the sensor objects.
+ * \param[in] dT time step [s]
+ * \param[in] controls roll, pitch, yaw in [-1,1] and thrust in [0,1]
+ */
+void SITLSimulator::step(float dT, const float controls[4])
+{
+    if (dT <= 0) {
+        return;
+    }
+
+    int steps = (int)ceilf(dT / MAX_INTEGRATION_STEP);
+    for (int i = 0; i < steps; i++) {
+        integrate(dT / steps, controls);
+    }
+    simTimeUs += (quint64)(dT * 1e6f + 0.5f);
+
+    publish(dT, controls[3]);
+    simulatorAlive();
+}
+
+/**
+ * One explicit Euler step of the rigid body equations.
+ * \param[in] dT time step [s]
+ * \param[in] controls roll, pitch, yaw in [-1,1] and thrust in [0,1]
+ */
+void SITLSimulator::integrate(float dT, const float controls[4])
+{
+    float Rbe[3][3];
+
+    Utils::CoordinateConversions().Quaternion2R(state.q, Rbe);
+
+    float force[3]     = { 0, 0, 0 }; // body frame [N]
+    float rateDot[3];
+    float mass;
+
+    if (vehicle == VEHICLE_MULTIROTOR) {
+        mass     = MR_MASS;
+        force[2] = -controls[3] * MR_MAX_THRUST;
+        // linear drag, rotated into the body frame
+        for (int i = 0; i < 3; i++) {
+            force[i] -= MR_DRAG * (Rbe[i][0] * state.vel[0] + Rbe[i][1] * state.vel[1] + Rbe[i][2] * state.vel[2]);
+        }
+        for (int i = 0; i < 3; i++) {
+            rateDot[i] = controls[i] * MR_MAX_ANGULAR_ACCEL[i] - MR_RATE_DAMPING * state.rate[i];
+        }
+    } else {
+        mass = FW_MASS;
+        float vb[3];
+        for (int i = 0; i < 3; i++) {
+            vb[i] = Rbe[i][0] * state.vel[0] + Rbe[i][1] * state.vel[1] + Rbe[i][2] * state.vel[2];
+        }
+        float airspeed = sqrtf(vb[0] * vb[0] + vb[1] * vb[1] + vb[2] * vb[2]);
+        float alpha    = atan2f(vb[2], vb[0]);
+        float beta     = airspeed > 0.1f ? asinf(vb[1] / airspeed) : 0;
+        float rho      = getAirParameters().groundDensity;
+        float qbar     = 0.5f * rho * airspeed * airspeed;
+        float cl = qBound(-FW_CL_MAX, FW_CL0 + FW_CL_ALPHA * alpha, FW_CL_MAX);
+        float cd = FW_CD0 + FW_CD_K * cl * cl;
+
+        force[0] = controls[3] * FW_MAX_THRUST;
+        if (airspeed > 0.1f) {
+            // lift perpendicular to the airflow in the symmetry plane, drag against it
+            force[0] += qbar * FW_WING_AREA * (cl * sinf(alpha) - cd * vb[0] / airspeed);
+            force[1] += qbar * FW_WING_AREA * (-FW_CY_BETA * beta - cd * vb[1] / airspeed);
+            force[2] += qbar * FW_WING_AREA * (-cl * cosf(alpha) - cd * vb[2] / airspeed);
+        }
+
+        // control authority and damping scale with dynamic pressure
+        float speedRatio = airspeed / FW_CRUISE_SPEED;
+        float authority  = qMin(speedRatio * speedRatio, 2.0f);
+        for (int i = 0; i < 3; i++) {
+            rateDot[i] = authority * controls[i] * FW_MAX_ANGULAR_ACCEL[i] - FW_RATE_DAMPING * speedRatio * state.rate[i];
+        }
+        rateDot[1] -= authority * FW_PITCH_STIFFNESS * alpha;
+        rateDot[2] += authority * FW_YAW_STIFFNESS * beta;
+    }
+
+    // specific force is what the accelerometers measure
+    for (int i = 0; i < 3; i++) {
+        state.accel[i] = force[i] / mass;
+    }
+
+    // acceleration in NED = Rbe' * specific force + gravity
+    float accNED[3];
+    for (int i = 0; i < 3; i++) {
+        accNED[i] = Rbe[0][i] * state.accel[0] + Rbe[1][i] * state.accel[1] + Rbe[2][i] * state.accel[2];
+    }
+    accNED[2] += GEE;
+
+    for (int i = 0; i < 3; i++) {
+        state.vel[i]  += accNED[i] * dT;
+        state.pos[i]  += state.vel[i] * dT;
+        state.rate[i] += rateDot[i] * dT;
+    }
+
+    // ground contact, the vehicle sits still on flat ground
+    if (state.pos[2] >= 0 && state.vel[2] >= 0) {
+        state.pos[2] = 0;
+        for (int i = 0; i < 3; i++) {
+            state.vel[i]   = 0;
+            state.rate[i]  = 0;
+            state.accel[i] = -GEE * Rbe[i][2];
+        }
+        return;
+    }
+
+    // attitude, qdot = 0.5 * q x (0, rate)
+    const float *q = state.q;
+    const float *w = state.rate;
+    float qdot[4];
+    qdot[0] = 0.5f * (-q[1] * w[0] - q[2] * w[1] - q[3] * w[2]);
+    qdot[1] = 0.5f * (q[0] * w[0] - q[3] * w[1] + q[2] * w[2]);
+    qdot[2] = 0.5f * (q[3] * w[0] + q[0] * w[1] - q[1] * w[2]);
+    qdot[3] = 0.5f * (-q[2] * w[0] + q[1] * w[1] + q[0] * w[2]);
+
+    float qmag = 0;
+    for (int i = 0; i < 4; i++) {
+        state.q[i] += qdot[i] * dT;
+        qmag += state.q[i] * state.q[i];
+    }
+    qmag = sqrtf(qmag);
+    for (int i = 0; i < 4; i++) {
+        state.q[i] /= qmag;
+    }
+}
+
+void SITLSimulator::publish(float dT, float thrust)
+{
+    Output2Hardware out;
+
+    memset(&out, 0, sizeof(Output2Hardware));
+
+    float rpy[3];
+    Utils::CoordinateConversions().Quaternion2RPY(state.q, rpy);
+
+    float Rbe[3][3];
+    Utils::CoordinateConversions().Quaternion2R(state.q, Rbe);
+    float vb[3];
+    for (int i = 0; i < 3; i++) {
+        vb[i] = Rbe[i][0] * state.vel[0] + Rbe[i][1] * state.vel[1] + Rbe[i][2] * state.vel[2];
+    }
+
+    // flat earth around home is plenty for the distances flown here
+    double latitude  = homeLLA[0] + RAD2DEG * state.pos[0] / EARTH_RADIUS;
+    double longitude = homeLLA[1] + RAD2DEG * state.pos[1] / (EARTH_RADIUS * cos(DEG2RAD * homeLLA[0]));
+    float altitude   = homeLLA[2] - state.pos[2];
+
+    AirParameters air = getAirParameters();
+    float temperature = air.groundTemp - air.tempLapseRate * altitude;
+    float pressure    = airPressureFromAltitude(altitude, air, GEE);
+    float densityRatio = (pressure / air.seaLevelPress) * (air.groundTemp / temperature);
+    float airspeed    = sqrtf(vb[0] * vb[0] + vb[1] * vb[1] + vb[2] * vb[2]);
+
+    out.latitude      = latitude * 1e7;
+    out.longitude     = longitude * 1e7;
+    out.altitude      = altitude;
+    out.agl           = -state.pos[2];
+    out.heading       = rpy[2];
+    out.groundspeed   = sqrtf(state.vel[0] * state.vel[0] + state.vel[1] * state.vel[1]);
+    out.trueAirspeed  = airspeed;
+    out.calibratedAirspeed = airspeed * sqrtf(densityRatio);
+    out.angleOfAttack = RAD2DEG * atan2f(vb[2], vb[0]);
+    out.angleOfSlip   = airspeed > 0.1f ? RAD2DEG * asinf(vb[1] / airspeed) : 0;
+    out.roll          = rpy[0];
+    out.pitch         = rpy[1];
+    out.pressure      = pressure;
+    out.temperature   = temperature - 273.15f;
+
+    out.velNorth      = state.vel[0];
+    out.velEast       = state.vel[1];
+    out.velDown       = state.vel[2];
+
+    out.dstN          = state.pos[0];
+    out.dstE          = state.pos[1];
+    out.dstD          = state.pos[2];
+
+    out.accX          = state.accel[0];
+    out.accY          = state.accel[1];
+    out.accZ          = state.accel[2];
+
+    out.rollRate      = RAD2DEG * state.rate[0];
+    out.pitchRate     = RAD2DEG * state.rate[1];
+    out.yawRate       = RAD2DEG * state.rate[2];
+    out.delT          = dT;
+
+    // rough 3S battery model
+    out.current       = 0.5f + 20.0f * thrust;
+    consumption      += out.current * dT / 3.6f; // [mAh]
+    out.consumption   = consumption;
+    out.voltage       = 12.6f - 0.02f * out.current;
+
+    updateUAVOs(out);
+}
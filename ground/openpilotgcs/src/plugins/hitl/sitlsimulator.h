@@ -0,0 +1,140 @@
+/**
+ ******************************************************************************
+ *
+ * @file       sitlsimulator.h
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2014.
+ * @brief      Built-in rigid body simulator for software in the loop testing
+ * @see        The GNU Public License (GPL) Version 3
+ * @defgroup   hitlplugin
+ * @{
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef SITLSIMULATOR_H
+#define SITLSIMULATOR_H
+
+#include <QObject>
+#include <QSet>
+#include "simulator.h"
+
+/**
+ * Simple multirotor / fixed wing rigid body model that runs inside the GCS,
+ * so no external flight simulator is needed. The model consumes ActuatorDesired
+ * from the autopilot (usually the simposix firmware) and publishes the sensor
+ * objects through Simulator::updateUAVOs().
+ *
+ * In lockstep mode the simposix firmware (--virtual-time --lockstep <port>)
+ * holds its clock at the end of every output period and reports its outputs
+ * over a loopback socket. The model steps by the held time, waits until the
+ * sensor objects were acknowledged and grants the next period. All sensor
+ * rates are measured on simulation time. In batch mode the next period is
+ * granted right away, so the run is as fast as the CPU allows, otherwise it
+ * is paced to the wall clock. Without lockstep the model follows the wall
+ * clock and reads ActuatorDesired from telemetry.
+ */
+class SITLSimulator : public Simulator {
+    Q_OBJECT
+
+public:
+    SITLSimulator(const SimulatorSettings & params);
+    ~SITLSimulator();
+
+    bool setupProcess();
+    void setupUdpPorts(const QString & host, int inPort, int outPort);
+
+protected:
+    void setupObjects();
+    QTime simulationClock() const;
+
+private slots:
+    void transmitUpdate();
+    void outputUpdated(UAVObject *obj);
+    void outputCompleted(UAVObject *obj, bool success);
+    void lockstepTimeout();
+    void lockstepGrant();
+
+private:
+    enum VehicleType {
+        VEHICLE_MULTIROTOR,
+        VEHICLE_FIXEDWING
+    };
+
+    struct State {
+        float pos[3];   // NED relative to home [m]
+        float vel[3];   // NED [m/s]
+        float q[4];     // attitude, body to NED
+        float rate[3];  // body rates [rad/s]
+        float accel[3]; // specific force in body frame [m/s^2]
+    };
+
+    // datagram exchanged with the firmware, mirrors struct pios_lockstep_msg in flight/pios/inc/pios_lockstep.h
+    enum LockstepType {
+        LOCKSTEP_HOLD    = 0,
+        LOCKSTEP_GRANT   = 1,
+        LOCKSTEP_RELEASE = 2
+    };
+
+    struct LockstepMessage {
+        quint32 magic;
+        quint32 type;
+        quint32 tick;
+        quint32 tickUs;
+        float   outputs[4];
+    };
+
+    static const quint32 LOCKSTEP_MAGIC = 0x4F504C53;
+
+    VehicleType vehicle;
+    State state;
+    double homeLLA[3];
+    quint64 simTimeUs;
+    QTime realTime;
+    float consumption;
+
+    bool lockstepHeld;     // a hold was received, heldTick is valid
+    bool lockstepStepping; // waiting for the sensor objects of the current step
+    quint32 heldTick;
+    quint32 grantedTick;
+    quint32 lockstepTickUs;
+    QSet<UAVObject *> pendingOutputs;
+    QTimer *lockstepTimer;
+
+    void resetState();
+    void readControls(float controls[4]);
+    void step(float dT, const float controls[4]);
+    void lockstepHold(const LockstepMessage & msg);
+    void lockstepStepDone();
+    void lockstepSend(quint32 type, quint32 tick);
+    void integrate(float dT, const float controls[4]);
+    void publish(float dT, float thrust);
+    void processUpdate(const QByteArray & data);
+};
+
+class SITLSimulatorCreator : public SimulatorCreator {
+public:
+    SITLSimulatorCreator(const QString & classId, const QString & description)
+        :  SimulatorCreator(classId, description)
+    {}
+
+    Simulator *createSimulator(const SimulatorSettings & params)
+    {
+        return new SITLSimulator(params);
+    }
+};
+
+#endif // SITLSIMULATOR_H
@@ -42,6 +42,7 @@
 #include <extensionsystem/pluginmanager.h>
 #include <QKeySequence>
 #include "uavobjectmanager.h"
+#include "uavtalk/telemetrymanager.h"
 
 
 LoggingConnection::LoggingConnection(LoggingPlugin *loggingPlugin) :
@@ -381,6 +382,8 @@ void LoggingPlugin::startLogging(QString file)
     if (loggingThread->openFile(file, this)) {
         connect(loggingThread, SIGNAL(finished()), this, SLOT(loggingStopped()));
         state = LOGGING;
+        // The log must get every update, not the rates the gadgets subscribed to
+        ExtensionSystem::PluginManager::instance()->getObject<TelemetryManager>()->holdFlightRates(loggingThread);
         loggingThread->start();
         emit stateChanged("LOGGING");
     } else {
@@ -413,6 +416,7 @@ void LoggingPlugin::loggingStopped()
 
     emit stateChanged("IDLE");
 
+    ExtensionSystem::PluginManager::instance()->getObject<TelemetryManager>()->releaseFlightRates(loggingThread);
     delete loggingThread;
     loggingThread = NULL;
 }
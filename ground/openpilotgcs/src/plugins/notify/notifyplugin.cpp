@@ -77,8 +77,14 @@ void SoundNotifyPlugin::extensionsInitialized()
     ExtensionSystem::PluginManager *pm = ExtensionSystem::PluginManager::instance();
 
     connect(pm, SIGNAL(objectAdded(QObject *)), this, SLOT(onTelemetryManagerAdded(QObject *)));
+}
+
+bool SoundNotifyPlugin::delayedInitialize()
+{
+    // sets up the media player, nothing is played before a connection anyway
     _toRemoveNotifications.clear();
     connectNotifications();
+    return true;
 }
 
 void SoundNotifyPlugin::saveConfig(QSettings *settings, UAVConfigInfo *configInfo)
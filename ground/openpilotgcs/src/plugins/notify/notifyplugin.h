@@ -55,6 +55,7 @@ public:
     ~SoundNotifyPlugin();
 
     void extensionsInitialized();
+    bool delayedInitialize();
     bool initialize(const QStringList & arguments, QString *errorString);
     void readConfig(QSettings *qSettings, Core::UAVConfigInfo *configInfo);
     void saveConfig(QSettings *qSettings, Core::UAVConfigInfo *configInfo);
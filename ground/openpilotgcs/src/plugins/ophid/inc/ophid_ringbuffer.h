@@ -0,0 +1,185 @@
+/**
+ ******************************************************************************
+ *
+ * @file       ophid_ringbuffer.h
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2014.
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup opHIDPlugin HID Plugin
+ * @{
+ * @brief Lock free single producer / single consumer byte ring used between
+ *        the HID read/write threads and the QIODevice side
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef OPHID_RINGBUFFER_H
+#define OPHID_RINGBUFFER_H
+
+#include <QtGlobal>
+#include <QAtomicInt>
+#include <string.h>
+
+/**
+ * Exactly one thread may call the producer functions (writeSpan, commit, write)
+ * and exactly one thread the consumer functions (readSpan, consume, read, clear).
+ * bytesAvailable() and freeSpace() may be called from anywhere, they are exact
+ * for the calling side and a lower bound for the other one.
+ *
+ * head and tail are free running byte counters, the buffer position is the
+ * counter masked with the power of two capacity. Each counter is written by one
+ * side only and published with release / read with acquire semantics, so the
+ * bytes behind it are visible before the counter is.
+ */
+class opHID_RingBuffer {
+public:
+    explicit opHID_RingBuffer(int minCapacity)
+        : m_head(0), m_tail(0)
+    {
+        m_capacity = 1;
+        while (m_capacity < minCapacity) {
+            m_capacity <<= 1;
+        }
+        m_mask   = m_capacity - 1;
+        m_buffer = new char[m_capacity];
+    }
+
+    ~opHID_RingBuffer()
+    {
+        delete[] m_buffer;
+    }
+
+    int capacity() const
+    {
+        return m_capacity;
+    }
+
+    int bytesAvailable() const
+    {
+        return (int)((quint32)m_head.loadAcquire() - (quint32)m_tail.loadAcquire());
+    }
+
+    int freeSpace() const
+    {
+        return m_capacity - bytesAvailable();
+    }
+
+    // producer side
+
+    /** Contiguous free space at the write position, fill it and commit() */
+    int writeSpan(char **span)
+    {
+        const quint32 head = (quint32)m_head.load();
+        const quint32 tail = (quint32)m_tail.loadAcquire();
+        const int free     = m_capacity - (int)(head - tail);
+        const int offset   = (int)(head & m_mask);
+
+        *span = m_buffer + offset;
+        return qMin(free, m_capacity - offset);
+    }
+
+    void commit(int size)
+    {
+        m_head.storeRelease((int)((quint32)m_head.load() + (quint32)size));
+    }
+
+    /** Copy as much of data as fits, returns the bytes copied */
+    int write(const char *data, int size)
+    {
+        int done = 0;
+
+        // at most two spans, up to the end of the buffer and from its start
+        for (int pass = 0; pass < 2 && done < size; pass++) {
+            char *span;
+            const int n = qMin(writeSpan(&span), size - done);
+            if (n <= 0) {
+                break;
+            }
+            memcpy(span, data + done, n);
+            commit(n);
+            done += n;
+        }
+        return done;
+    }
+
+    // consumer side
+
+    /** Contiguous readable bytes at the read position, use them and consume() */
+    int readSpan(const char **span) const
+    {
+        const quint32 tail = (quint32)m_tail.load();
+        const quint32 head = (quint32)m_head.loadAcquire();
+        const int offset   = (int)(tail & m_mask);
+
+        *span = m_buffer + offset;
+        return qMin((int)(head - tail), m_capacity - offset);
+    }
+
+    void consume(int size)
+    {
+        m_tail.storeRelease((int)((quint32)m_tail.load() + (quint32)size));
+    }
+
+    /** Copy up to size bytes out without consuming them, returns the bytes copied */
+    int peek(char *data, int size) const
+    {
+        const quint32 tail = (quint32)m_tail.load();
+        const quint32 head = (quint32)m_head.loadAcquire();
+        const int offset   = (int)(tail & m_mask);
+        const int n     = qMin((int)(head - tail), size);
+        const int first = qMin(n, m_capacity - offset);
+
+        memcpy(data, m_buffer + offset, first);
+        // the rest wrapped around to the start of the buffer
+        memcpy(data + first, m_buffer, n - first);
+        return n;
+    }
+
+    /** Copy up to size bytes out, returns the bytes copied */
+    int read(char *data, int size)
+    {
+        int done = 0;
+
+        for (int pass = 0; pass < 2 && done < size; pass++) {
+            const char *span;
+            const int n = qMin(readSpan(&span), size - done);
+            if (n <= 0) {
+                break;
+            }
+            memcpy(data + done, span, n);
+            consume(n);
+            done += n;
+        }
+        return done;
+    }
+
+    /** Drop everything buffered */
+    void clear()
+    {
+        m_tail.storeRelease(m_head.loadAcquire());
+    }
+
+private:
+    Q_DISABLE_COPY(opHID_RingBuffer)
+
+    char *m_buffer;
+    int m_capacity;
+    int m_mask;
+    QAtomicInt m_head; // bytes ever written, producer owned
+    QAtomicInt m_tail; // bytes ever consumed, consumer owned
+};
+
+#endif // OPHID_RINGBUFFER_H
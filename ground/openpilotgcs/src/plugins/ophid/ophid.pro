@@ -14,6 +14,7 @@ HEADERS += \
     inc/ophid.h \
     inc/ophid_hidapi.h \
     inc/ophid_const.h \
+    inc/ophid_ringbuffer.h \
     inc/ophid_usbmon.h \
     inc/ophid_usbsignal.h \
     hidapi/hidapi.h
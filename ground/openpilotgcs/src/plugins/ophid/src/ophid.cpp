@@ -27,12 +27,13 @@
 
 #include "ophid.h"
 #include "ophid_const.h"
+#include "ophid_ringbuffer.h"
 #include "coreplugin/connectionmanager.h"
 #include <extensionsystem/pluginmanager.h>
 #include <QtGlobal>
 #include <QList>
 #include <QMutexLocker>
-#include <QWaitCondition>
+#include <QSemaphore>
 
 class IConnection;
 
@@ -43,6 +44,10 @@ static const int READ_SIZE     = 64;
 static const int WRITE_TIMEOUT = 1000;
 static const int WRITE_SIZE    = 64;
 
+// ring sizes, the read side holds about 4s of a saturated full speed HID link
+static const int READ_BUFFER_SIZE  = 256 * 1024;
+static const int WRITE_BUFFER_SIZE = 64 * 1024;
+
 
 // *********************************************************************************
 
@@ -69,12 +74,8 @@ public slots:
 protected:
     void run();
 
-    /** QByteArray might not be the most efficient way to implement
-       a circular buffer but it's good enough and very simple */
-    QByteArray m_readBuffer;
-
-    /** A mutex to protect read buffer */
-    QMutex m_readBufMtx;
+    /** Filled by this thread, drained by RawHID::readData() */
+    opHID_RingBuffer m_readBuffer;
 
     RawHID *m_hid;
 
@@ -95,7 +96,7 @@ public:
     RawHIDWriteThread(RawHID *hid);
     virtual ~RawHIDWriteThread();
 
-    /** Add some data to be written without waiting */
+    /** Add some data to be written without waiting, returns the bytes taken */
     int pushDataToWrite(const char *data, int size);
 
     /** Return the number of bytes buffered */
@@ -105,20 +106,17 @@ public slots:
     void terminate()
     {
         m_running = false;
+        m_newDataToWrite.release();
     }
 
 protected:
     void run();
 
-    /** QByteArray might not be the most efficient way to implement
-       a circular buffer but it's good enough and very simple */
-    QByteArray m_writeBuffer;
+    /** Filled by RawHID::writeData(), drained by this thread */
+    opHID_RingBuffer m_writeBuffer;
 
-    /** A mutex to protect read buffer */
-    QMutex m_writeBufMtx;
-
-    /** Synchronize task with data arival */
-    QWaitCondition m_newDataToWrite;
+    /** Wakes the thread when data arrives, released once per push */
+    QSemaphore m_newDataToWrite;
 
     RawHID *m_hid;
 
@@ -131,7 +129,8 @@ protected:
 // *********************************************************************************
 
 RawHIDReadThread::RawHIDReadThread(RawHID *hid)
-    : m_hid(hid),
+    : m_readBuffer(READ_BUFFER_SIZE),
+    m_hid(hid),
     hiddev(&hid->dev),
     hidno(hid->m_deviceNo),
     m_running(true)
@@ -169,10 +168,15 @@ void RawHIDReadThread::run()
         int ret = hiddev->receive(hidno, buffer, READ_SIZE, READ_TIMEOUT);
 
         if (ret > 0) { // read some data
-            QMutexLocker lock(&m_readBufMtx);
             // Note: Preprocess the USB packets in this OS independent code
             // First byte is report ID, second byte is the number of valid bytes
-            m_readBuffer.append(&buffer[2], buffer[1]);
+            int size = qMin((int)(quint8)buffer[1], READ_SIZE - 2);
+            int done = m_readBuffer.write(&buffer[2], size);
+            while (done < size && m_running) {
+                // reader is behind by a full ring, hold off the device instead of dropping data
+                msleep(1);
+                done += m_readBuffer.write(&buffer[2 + done], size - done);
+            }
 
             emit m_hid->readyRead();
         } else if (ret == 0) { // nothing read
@@ -188,27 +192,20 @@ void RawHIDReadThread::run()
 
 int RawHIDReadThread::getReadData(char *data, int size)
 {
-    QMutexLocker lock(&m_readBufMtx);
-
-    size = qMin(size, m_readBuffer.size());
-
-    memcpy(data, m_readBuffer.constData(), size);
-    m_readBuffer.remove(0, size);
-
-    return size;
+    // copies at most two spans, independent of the backlog
+    return m_readBuffer.read(data, size);
 }
 
 qint64 RawHIDReadThread::getBytesAvailable()
 {
-    QMutexLocker lock(&m_readBufMtx);
-
-    return m_readBuffer.size();
+    return m_readBuffer.bytesAvailable();
 }
 
 // *********************************************************************************
 
 RawHIDWriteThread::RawHIDWriteThread(RawHID *hid)
-    : m_hid(hid),
+    : m_writeBuffer(WRITE_BUFFER_SIZE),
+    m_hid(hid),
     hiddev(&hid->dev),
     hidno(hid->m_deviceNo),
     m_running(true)
@@ -216,7 +213,7 @@ RawHIDWriteThread::RawHIDWriteThread(RawHID *hid)
 
 RawHIDWriteThread::~RawHIDWriteThread()
 {
-    m_running = false;
+    terminate();
     // wait for the thread to terminate
     if (wait(10000) == false) {
         qWarning() << "Cannot terminate RawHIDReadThread";
@@ -227,40 +224,26 @@ void RawHIDWriteThread::run()
 {
     while (m_running) {
         char buffer[WRITE_SIZE] = { 0 };
-        int size;
-
-        {
-            QMutexLocker lock(&m_writeBufMtx);
-            size = qMin(WRITE_SIZE - 2, m_writeBuffer.size());
-            while (size <= 0) {
-                // wait on new data to write condition, the timeout
-                // enable the thread to shutdown properly
-                m_newDataToWrite.wait(&m_writeBufMtx, 200);
-                if (!m_running) {
-                    return;
-                }
-
-                size = m_writeBuffer.size();
-            }
 
-            // NOTE: data size is limited to 2 bytes less than the
-            // usb packet size (64 bytes for interrupt) to make room
-            // for the reportID and valid data length
-            size = qMin(WRITE_SIZE - 2, m_writeBuffer.size());
-            memcpy(&buffer[2], m_writeBuffer.constData(), size);
-            buffer[1] = size; // valid data length
-            buffer[0] = 2; // reportID
+        // NOTE: data size is limited to 2 bytes less than the
+        // usb packet size (64 bytes for interrupt) to make room
+        // for the reportID and valid data length
+        int size = m_writeBuffer.peek(&buffer[2], WRITE_SIZE - 2);
+        if (size <= 0) {
+            // wait for new data, terminate() wakes us up as well
+            m_newDataToWrite.acquire();
+            continue;
         }
+        buffer[1] = size; // valid data length
+        buffer[0] = 2; // reportID
 
-        // must hold lock through the send to know how much was sent
         int ret = hiddev->send(hidno, buffer, WRITE_SIZE, WRITE_TIMEOUT);
 
         if (ret > 0) {
             // only remove the size actually written to the device
-            QMutexLocker lock(&m_writeBufMtx);
-            m_writeBuffer.remove(0, size);
+            m_writeBuffer.consume(size);
 
-            emit m_hid->bytesWritten(ret - 2);
+            emit m_hid->bytesWritten(size);
         } else if (ret < 0) { // < 0 => error
             // TODO! make proper error handling, this only quick hack for unplug freeze
             m_running = false;
@@ -273,18 +256,26 @@ void RawHIDWriteThread::run()
 
 int RawHIDWriteThread::pushDataToWrite(const char *data, int size)
 {
-    QMutexLocker lock(&m_writeBufMtx);
+    // Never wait here, the caller is the telemetry thread. Data that fits the
+    // ring is refused as a whole while the ring is too full, so the device
+    // never gets half a packet and the caller sees the backpressure as 0.
+    if (!m_running || (size <= m_writeBuffer.capacity() && m_writeBuffer.freeSpace() < size)) {
+        return 0;
+    }
+
+    int done = m_writeBuffer.write(data, size);
 
-    m_writeBuffer.append(data, size);
-    m_newDataToWrite.wakeOne(); // signal that new data arrived
+    // signal that new data arrived, one pending wake up is enough
+    if (done > 0 && m_newDataToWrite.available() == 0) {
+        m_newDataToWrite.release();
+    }
 
-    return size;
+    return done;
 }
 
 qint64 RawHIDWriteThread::getBytesToWrite()
 {
-    // QMutexLocker lock(&m_writeBufMtx);
-    return m_writeBuffer.size();
+    return m_writeBuffer.bytesAvailable();
 }
 
 // *********************************************************************************
@@ -0,0 +1,11 @@
+QT += testlib
+QT -= gui
+TEMPLATE = app
+CONFIG += console testcase no_testcase_installs
+CONFIG -= app_bundle
+TARGET = tst_ophid_ringbuffer
+
+INCLUDEPATH += ../inc
+
+# Input
+SOURCES += tst_ophid_ringbuffer.cpp
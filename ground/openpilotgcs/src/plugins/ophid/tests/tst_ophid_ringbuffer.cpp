@@ -0,0 +1,247 @@
+/**
+ ******************************************************************************
+ *
+ * @file       tst_ophid_ringbuffer.cpp
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2014.
+ * @brief      Correctness and throughput of the RawHID transport ring buffer
+ * @see        The GNU Public License (GPL) Version 3
+ * @defgroup
+ * @{
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "ophid_ringbuffer.h"
+
+#include <QtCore/QObject>
+#include <QtCore/QThread>
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+#include <QtTest/QtTest>
+
+// HID report layout used by RawHIDReadThread: report id, valid length, payload
+static const int REPORT_SIZE  = 64;
+static const int PAYLOAD_SIZE = REPORT_SIZE - 2;
+static const int STREAM_SIZE  = 4 * 1024 * 1024;
+
+/**
+ * Loopback stand in for opHID_hidapi::receive(), hands out full reports of a
+ * byte stream whose value at position i is (char)i
+ */
+class LoopbackHidDev {
+public:
+    LoopbackHidDev() : m_sent(0) {}
+
+    int receive(char *buffer, int size)
+    {
+        const int n = qMin(STREAM_SIZE - m_sent, PAYLOAD_SIZE);
+
+        Q_ASSERT(size == REPORT_SIZE);
+        if (n <= 0) {
+            return 0;
+        }
+        buffer[0] = 2;
+        buffer[1] = n;
+        for (int i = 0; i < n; i++) {
+            buffer[2 + i] = (char)(m_sent + i);
+        }
+        m_sent += n;
+        return size;
+    }
+
+private:
+    int m_sent;
+};
+
+/** The previous transport, QByteArray::remove() under a mutex */
+class ByteArrayBuffer {
+public:
+    int write(const char *data, int size)
+    {
+        QMutexLocker lock(&m_mutex);
+
+        m_buffer.append(data, size);
+        return size;
+    }
+
+    int read(char *data, int size)
+    {
+        QMutexLocker lock(&m_mutex);
+
+        size = qMin(size, m_buffer.size());
+        memcpy(data, m_buffer.constData(), size);
+        m_buffer.remove(0, size);
+        return size;
+    }
+
+private:
+    QMutex m_mutex;
+    QByteArray m_buffer;
+};
+
+/** Does what RawHIDReadThread::run() does, against the loopback device */
+template<class Buffer>
+class ReadThread : public QThread {
+public:
+    explicit ReadThread(Buffer *buffer) : m_buffer(buffer) {}
+
+protected:
+    void run()
+    {
+        LoopbackHidDev dev;
+        char report[REPORT_SIZE];
+
+        while (dev.receive(report, REPORT_SIZE) > 0) {
+            const int size = (quint8)report[1];
+            int done = 0;
+            while (done < size) {
+                done += m_buffer->write(&report[2 + done], size - done);
+                if (done < size) {
+                    yieldCurrentThread();
+                }
+            }
+        }
+    }
+
+private:
+    Buffer *m_buffer;
+};
+
+/** The UAVTalk parser reads the device one byte at a time, so does this */
+template<class Buffer>
+static bool drainBytewise(Buffer *buffer)
+{
+    ReadThread<Buffer> thread(buffer);
+    bool ok = true;
+    int received = 0;
+
+    thread.start();
+    while (received < STREAM_SIZE) {
+        char c;
+        if (buffer->read(&c, 1) == 1) {
+            ok &= (c == (char)received);
+            received++;
+        } else {
+            QThread::yieldCurrentThread();
+        }
+    }
+    thread.wait();
+    return ok;
+}
+
+class tst_opHID_RingBuffer : public QObject {
+    Q_OBJECT
+
+private slots:
+    void capacity();
+    void wrap();
+    void spans();
+    void loopbackRing();
+    void loopbackByteArray();
+};
+
+void tst_opHID_RingBuffer::capacity()
+{
+    opHID_RingBuffer ring(1000);
+
+    QCOMPARE(ring.capacity(), 1024);
+    QCOMPARE(ring.bytesAvailable(), 0);
+    QCOMPARE(ring.freeSpace(), 1024);
+
+    QByteArray data(2000, 'x');
+    QCOMPARE(ring.write(data.constData(), data.size()), 1024);
+    QCOMPARE(ring.freeSpace(), 0);
+    QCOMPARE(ring.write(data.constData(), 1), 0);
+}
+
+void tst_opHID_RingBuffer::wrap()
+{
+    opHID_RingBuffer ring(16);
+    char in[12], out[12];
+    int next = 0, expect = 0;
+
+    // every write and read after the first straddles the end of the buffer
+    for (int pass = 0; pass < 100; pass++) {
+        for (int i = 0; i < 12; i++) {
+            in[i] = (char)next++;
+        }
+        QCOMPARE(ring.write(in, 12), 12);
+
+        char peeked[12];
+        QCOMPARE(ring.peek(peeked, 12), 12);
+        QCOMPARE(ring.read(out, 12), 12);
+        QCOMPARE(memcmp(peeked, out, 12), 0);
+        for (int i = 0; i < 12; i++) {
+            QCOMPARE(out[i], (char)expect++);
+        }
+        QCOMPARE(ring.bytesAvailable(), 0);
+    }
+}
+
+void tst_opHID_RingBuffer::spans()
+{
+    opHID_RingBuffer ring(16);
+    char tmp[16];
+    char *wspan;
+    const char *rspan;
+
+    ring.write(tmp, 10);
+    ring.read(tmp, 10);
+
+    // the free space is split at the end of the buffer
+    QCOMPARE(ring.writeSpan(&wspan), 6);
+    memset(wspan, 'a', 6);
+    ring.commit(6);
+    QCOMPARE(ring.writeSpan(&wspan), 10);
+    memset(wspan, 'b', 4);
+    ring.commit(4);
+
+    QCOMPARE(ring.readSpan(&rspan), 6);
+    QCOMPARE(rspan[0], 'a');
+    ring.consume(6);
+    QCOMPARE(ring.readSpan(&rspan), 4);
+    QCOMPARE(rspan[0], 'b');
+
+    ring.clear();
+    QCOMPARE(ring.bytesAvailable(), 0);
+}
+
+void tst_opHID_RingBuffer::loopbackRing()
+{
+    opHID_RingBuffer ring(256 * 1024);
+    bool ok = true;
+
+    QBENCHMARK_ONCE {
+        ok = drainBytewise(&ring);
+    }
+    QVERIFY(ok);
+}
+
+void tst_opHID_RingBuffer::loopbackByteArray()
+{
+    ByteArrayBuffer buffer;
+    bool ok = true;
+
+    QBENCHMARK_ONCE {
+        ok = drainBytewise(&buffer);
+    }
+    QVERIFY(ok);
+}
+
+QTEST_MAIN(tst_opHID_RingBuffer)
+
+#include "tst_ophid_ringbuffer.moc"
@@ -53,6 +53,7 @@ void PfdQmlGadget::loadConfiguration(IUAVGadgetConfiguration *config)
     m_widget->setSpeedUnit(m->speedUnit());
     m_widget->setAltitudeFactor(m->altitudeFactor());
     m_widget->setAltitudeUnit(m->altitudeUnit());
+    m_widget->setUpdateInterval(m->updateInterval());
 
     // setting OSGEARTH_CACHE_ONLY seems to work the most reliably
     // between osgEarth versions I tried
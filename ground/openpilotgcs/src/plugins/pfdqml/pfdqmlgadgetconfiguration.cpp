@@ -33,7 +33,8 @@ PfdQmlGadgetConfiguration::PfdQmlGadgetConfiguration(QString classId, QSettings
     m_altitude(0),
     m_cacheOnly(false),
     m_speedFactor(1.0),
-    m_altitudeFactor(1.0)
+    m_altitudeFactor(1.0),
+    m_updateInterval(0)
 {
     m_speedMap[1.0]       = "m/s";
     m_speedMap[3.6]       = "km/h";
@@ -60,6 +61,7 @@ PfdQmlGadgetConfiguration::PfdQmlGadgetConfiguration(QString classId, QSettings
         m_cacheOnly          = qSettings->value("cacheOnly").toBool();
         m_speedFactor        = qSettings->value("speedFactor").toDouble();
         m_altitudeFactor     = qSettings->value("altitudeFactor").toDouble();
+        m_updateInterval     = qSettings->value("updateInterval", 0).toInt();
     }
 }
 
@@ -82,6 +84,7 @@ IUAVGadgetConfiguration *PfdQmlGadgetConfiguration::clone()
     m->m_cacheOnly          = m_cacheOnly;
     m->m_speedFactor        = m_speedFactor;
     m->m_altitudeFactor     = m_altitudeFactor;
+    m->m_updateInterval     = m_updateInterval;
 
     return m;
 }
@@ -107,4 +110,5 @@ void PfdQmlGadgetConfiguration::saveConfig(QSettings *qSettings) const
     qSettings->setValue("cacheOnly", m_cacheOnly);
     qSettings->setValue("speedFactor", m_speedFactor);
     qSettings->setValue("altitudeFactor", m_altitudeFactor);
+    qSettings->setValue("updateInterval", m_updateInterval);
 }
@@ -71,6 +71,10 @@ public:
     {
         m_altitudeFactor = factor;
     }
+    void setUpdateInterval(int ms)
+    {
+        m_updateInterval = ms;
+    }
 
     QString qmlFile() const
     {
@@ -116,6 +120,10 @@ public:
     {
         return m_altitudeFactor;
     }
+    int updateInterval() const
+    {
+        return m_updateInterval;
+    }
 
     QString speedUnit() const
     {
@@ -152,6 +160,7 @@ private:
     bool m_cacheOnly;
     double m_speedFactor;
     double m_altitudeFactor;
+    int m_updateInterval; // [ms] minimum time between UAVObject notifications, 0 for every update
     QMap<double, QString> m_speedMap;
     QMap<double, QString> m_altitudeMap;
 };
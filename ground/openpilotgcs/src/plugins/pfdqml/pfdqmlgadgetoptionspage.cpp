@@ -77,6 +77,8 @@ QWidget *PfdQmlGadgetOptionsPage::createPage(QWidget *parent)
     }
     options_page->altUnitCombo->setCurrentIndex(options_page->altUnitCombo->findData(m_config->altitudeFactor()));
 
+    options_page->updateInterval->setValue(m_config->updateInterval());
+
 #ifndef USE_OSG
     options_page->showTerrain->setChecked(false);
     options_page->showTerrain->setVisible(false);
@@ -111,6 +113,7 @@ void PfdQmlGadgetOptionsPage::apply()
 
     m_config->setSpeedFactor(options_page->speedUnitCombo->itemData(options_page->speedUnitCombo->currentIndex()).toDouble());
     m_config->setAltitudeFactor(options_page->altUnitCombo->itemData(options_page->altUnitCombo->currentIndex()).toDouble());
+    m_config->setUpdateInterval(options_page->updateInterval->value());
 }
 
 void PfdQmlGadgetOptionsPage::finish()
@@ -18,6 +18,8 @@
 #include "extensionsystem/pluginmanager.h"
 #include "uavobjectmanager.h"
 #include "uavobject.h"
+#include "uavdataobject.h"
+#include "uavtalk/telemetrymanager.h"
 #include "flightbatterysettings.h"
 #include "utils/svgimageprovider.h"
 #ifdef USE_OSG
@@ -92,6 +94,9 @@ PfdQmlGadgetWidget::PfdQmlGadgetWidget(QWindow *parent) :
 
         if (object) {
             engine()->rootContext()->setContextProperty(objectName, object);
+            if (UAVDataObject *dataObject = qobject_cast<UAVDataObject *>(object)) {
+                m_exportedObjects.append(dataObject);
+            }
         } else {
             qWarning() << "Failed to load object" << objectName;
         }
@@ -238,3 +243,16 @@ void PfdQmlGadgetWidget::setAltitude(double arg)
         emit altitudeChanged(arg);
     }
 }
+
+// Merge the property notifications of the exported objects, other gadgets
+// asking for a shorter interval win. The flight side is asked for the same
+// interval, the QML bindings get the data so the subscription has no member.
+void PfdQmlGadgetWidget::setUpdateInterval(int ms)
+{
+    TelemetryManager *telMngr = ExtensionSystem::PluginManager::instance()->getObject<TelemetryManager>();
+
+    foreach(UAVDataObject * object, m_exportedObjects) {
+        object->setNotificationInterval(this, ms);
+        telMngr->subscribe(object, this, NULL, qMax(ms, 0));
+    }
+}
@@ -104,6 +104,8 @@ public slots:
 
     void setActualPositionUsed(bool arg);
 
+    void setUpdateInterval(int ms);
+
 signals:
     void earthFileChanged(QString arg);
     void terrainEnabledChanged(bool arg);
@@ -137,6 +139,8 @@ private:
     double m_speedFactor;
     QString m_altitudeUnit;
     double m_altitudeFactor;
+
+    QList<UAVDataObject *> m_exportedObjects;
 };
 
 #endif /* PFDQMLGADGETWIDGET_H_ */
@@ -33,6 +33,12 @@ SUBDIRS += plugin_opHID
 plugin_opHID.subdir = ophid
 plugin_opHID.depends = plugin_coreplugin
 
+# opHID ring buffer test, only built with "qmake CONFIG+=test", runs with "make check"
+CONFIG(test) {
+    SUBDIRS += plugin_opHID_tests
+    plugin_opHID_tests.subdir = ophid/tests
+}
+
 # Serial port connection plugin
 SUBDIRS += plugin_serial
 plugin_serial.subdir = serialconnection
@@ -29,13 +29,117 @@
 #include "plotdata.h"
 #include <math.h>
 #include <QDebug>
+#include <QThreadPool>
+
+// Shortest block the power spectral density is computed on
+#define MIN_FFT_SIZE 16
+
+namespace {
+/**
+ * In place iterative radix-2 FFT, the size must be a power of two
+ */
+void fft(double *re, double *im, int n)
+{
+    // bit reversal permutation
+    for (int i = 1, j = 0; i < n; i++) {
+        int bit = n >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            qSwap(re[i], re[j]);
+            qSwap(im[i], im[j]);
+        }
+    }
+
+    for (int len = 2; len <= n; len <<= 1) {
+        int half     = len / 2;
+        double angle = -2.0 * M_PI / len;
+        double wRe   = cos(angle);
+        double wIm   = sin(angle);
+        for (int i = 0; i < n; i += len) {
+            double uRe = 1.0;
+            double uIm = 0.0;
+            for (int k = 0; k < half; k++) {
+                int a = i + k;
+                int b = a + half;
+                double tRe  = re[b] * uRe - im[b] * uIm;
+                double tIm  = re[b] * uIm + im[b] * uRe;
+                re[b]  = re[a] - tRe;
+                im[b]  = im[a] - tIm;
+                re[a] += tRe;
+                im[a] += tIm;
+                double next = uRe * wRe - uIm * wIm;
+                uIm = uRe * wIm + uIm * wRe;
+                uRe = next;
+            }
+        }
+    }
+}
+}
+
+SpectrumJob::SpectrumJob(const QVector<double> &samples, double sampleRate) :
+    m_samples(samples), m_sampleRate(sampleRate)
+{
+    // deletes itself in the GUI thread once the result is posted
+    setAutoDelete(false);
+}
+
+/**
+ * One sided power spectral density [unit^2/Hz] of a Hann windowed block.
+ * The mean is removed first, the DC bin would dwarf the vibration peaks.
+ */
+void SpectrumJob::run()
+{
+    int n = m_samples.size();
+    const double *samples = m_samples.constData();
+
+    double mean = 0.0;
+
+    for (int i = 0; i < n; i++) {
+        mean += samples[i];
+    }
+    mean /= n;
+
+    QVector<double> re(n);
+    QVector<double> im(n, 0.0);
+    double windowPower = 0.0;
+    for (int i = 0; i < n; i++) {
+        double w = 0.5 - 0.5 * cos(2.0 * M_PI * i / n);
+        re[i] = (samples[i] - mean) * w;
+        windowPower += w * w;
+    }
+
+    fft(re.data(), im.data(), n);
+
+    int bins     = n / 2 + 1;
+    double scale = 1.0 / (m_sampleRate * windowPower);
+    QVector<double> frequencies(bins);
+    QVector<double> density(bins);
+    for (int k = 0; k < bins; k++) {
+        double power = (re.at(k) * re.at(k) + im.at(k) * im.at(k)) * scale;
+        // all bins but DC and Nyquist also carry the negative frequency
+        if (k > 0 && k < n / 2) {
+            power *= 2.0;
+        }
+        frequencies[k] = k * m_sampleRate / n;
+        density[k]     = power;
+    }
+
+    emit finished(frequencies, density);
+    deleteLater();
+}
 
 PlotData::PlotData(UAVObject *object, UAVObjectField *field, int element,
                    int scaleOrderFactor, int meanSamples, QString mathFunction,
                    double plotDataSize, QPen pen, bool antialiased) :
     m_scalePower(scaleOrderFactor), m_meanSamples(meanSamples),
-    m_meanSum(0.0f), m_mathFunction(mathFunction), m_correctionSum(0.0f),
-    m_correctionCount(0), m_plotDataSize(plotDataSize),
+    m_meanSum(0.0f), m_mathFunction(mathFunction), m_mathFunctionType(MathNone),
+    m_correctionSum(0.0f), m_correctionCount(0), m_plotDataSize(plotDataSize),
+    m_historyIndex(0), m_historyCount(0), m_welfordMean(0.0), m_welfordM2(0.0),
+    m_lastValue(0.0), m_lastXValue(0.0), m_hasLastValue(false),
+    m_fftSize(0), m_spectrumSamples(0), m_spectrumBusy(false),
     m_object(object), m_field(field), m_element(element),
     m_plotCurve(NULL), m_isVisible(true), m_pen(pen), m_isEnumPlot(false)
 {
@@ -64,6 +168,32 @@ PlotData::PlotData(UAVObject *object, UAVObjectField *field, int element,
     m_plotCurve->setPen(m_pen);
     m_plotCurve->setSamples(m_xDataEntries, m_yDataEntries);
     m_isEnumPlot = m_field->getType() == UAVObjectField::ENUM;
+
+    // Resolve the math function once instead of comparing strings per sample
+    if (m_mathFunction == "Boxcar average") {
+        m_mathFunctionType = MathBoxcarAverage;
+    } else if (m_mathFunction == "Standard deviation") {
+        m_mathFunctionType = MathStandardDeviation;
+    } else if (m_mathFunction == "Derivative") {
+        m_mathFunctionType = MathDerivative;
+    } else if (m_mathFunction == "Power spectral density") {
+        m_mathFunctionType = MathPowerSpectralDensity;
+    }
+
+    if (m_meanSamples < 1) {
+        m_meanSamples = 1;
+    }
+    if (m_mathFunctionType == MathPowerSpectralDensity) {
+        // The largest power of two that fits the math window
+        m_fftSize = MIN_FFT_SIZE;
+        while (m_fftSize * 2 <= m_meanSamples) {
+            m_fftSize *= 2;
+        }
+        m_yDataHistory.resize(m_fftSize);
+        qRegisterMetaType<QVector<double> >("QVector<double>");
+    } else {
+        m_yDataHistory.resize(m_meanSamples);
+    }
 }
 
 PlotData::~PlotData()
@@ -95,9 +225,7 @@ void PlotData::updatePlotData()
 
 void PlotData::clear()
 {
-    m_meanSum = 0.0f;
-    m_correctionSum   = 0.0f;
-    m_correctionCount = 0;
+    resetMath();
     m_xDataEntries.clear();
     m_yDataEntries.clear();
     while (!m_enumMarkerList.isEmpty()) {
@@ -142,37 +270,148 @@ void PlotData::visibilityChanged(QwtPlotItem *item)
     }
 }
 
-void PlotData::calcMathFunction(double currentValue)
+void PlotData::resetMath()
+{
+    m_meanSum = 0.0f;
+    m_correctionSum   = 0.0f;
+    m_correctionCount = 0;
+    m_historyIndex    = 0;
+    m_historyCount    = 0;
+    m_welfordMean     = 0.0;
+    m_welfordM2       = 0.0;
+    m_hasLastValue    = false;
+    m_spectrumSamples = 0;
+}
+
+/**
+ * Put the new value into the history ring buffer
+ * \return the value it replaced, the oldest one once the buffer is full
+ */
+double PlotData::pushHistory(double currentValue)
+{
+    double oldestValue = m_yDataHistory.at(m_historyIndex);
+
+    m_yDataHistory[m_historyIndex] = currentValue;
+    if (++m_historyIndex >= m_yDataHistory.size()) {
+        m_historyIndex = 0;
+    }
+    if (m_historyCount < m_yDataHistory.size()) {
+        m_historyCount++;
+    }
+    return oldestValue;
+}
+
+void PlotData::calcMathFunction(double currentValue, double xValue)
 {
-    // Put the new value at the back
-    m_yDataHistory.append(currentValue);
+    if (m_mathFunctionType == MathDerivative) {
+        double xDelta = xValue - m_lastXValue;
+        if (!m_hasLastValue) {
+            m_yDataEntries.append(0.0);
+        } else if (xDelta > 0.0) {
+            m_yDataEntries.append((currentValue - m_lastValue) / xDelta);
+        } else {
+            // Same timestamp, repeat the slope and take the difference over the next interval
+            m_yDataEntries.append(m_yDataEntries.isEmpty() ? 0.0 : m_yDataEntries.last());
+            return;
+        }
+        m_lastValue    = currentValue;
+        m_lastXValue   = xValue;
+        m_hasLastValue = true;
+        return;
+    }
+
+    int windowSize     = m_yDataHistory.size();
+    bool windowFull    = m_historyCount == windowSize;
+    double oldestValue = pushHistory(currentValue);
 
     // calculate average value
     m_meanSum += currentValue;
-    if (m_yDataHistory.size() > m_meanSamples) {
-        m_meanSum -= m_yDataHistory.first();
-        m_yDataHistory.pop_front();
+    if (windowFull) {
+        m_meanSum -= oldestValue;
     }
     // make sure to correct the sum every meanSamples steps to prevent it
     // from running away due to floating point rounding errors
     m_correctionSum += currentValue;
     if (++m_correctionCount >= m_meanSamples) {
         m_meanSum = m_correctionSum;
-        m_correctionSum = 0.0f;
+        m_correctionSum   = 0.0f;
         m_correctionCount = 0;
     }
 
-    double boxcarAvg = m_meanSum / m_yDataHistory.size();
-    if (m_mathFunction == "Standard deviation") {
-        // Calculate square of sample standard deviation, with Bessel's correction
-        double stdSum = 0;
-        for (int i = 0; i < m_yDataHistory.size(); i++) {
-            stdSum += pow(m_yDataHistory.at(i) - boxcarAvg, 2) / (m_meanSamples - 1);
+    if (m_mathFunctionType == MathStandardDeviation) {
+        // Welford's update, sliding once the window is full
+        if (!windowFull) {
+            double delta = currentValue - m_welfordMean;
+            m_welfordMean += delta / m_historyCount;
+            m_welfordM2   += delta * (currentValue - m_welfordMean);
+        } else {
+            double oldMean = m_welfordMean;
+            m_welfordMean += (currentValue - oldestValue) / windowSize;
+            m_welfordM2   += (currentValue - oldestValue) * (currentValue - m_welfordMean + oldestValue - oldMean);
+        }
+        // Resynchronise along with the sum correction, one pass over the
+        // window every meanSamples steps keeps the cost per sample constant
+        if (m_correctionCount == 0) {
+            m_welfordMean = m_meanSum / m_historyCount;
+            m_welfordM2   = 0.0;
+            for (int i = 0; i < m_historyCount; i++) {
+                double delta = m_yDataHistory.at(i) - m_welfordMean;
+                m_welfordM2 += delta * delta;
+            }
+        }
+
+        // Sample standard deviation, with Bessel's correction
+        if (m_meanSamples > 1 && m_welfordM2 > 0.0) {
+            m_yDataEntries.append(sqrt(m_welfordM2 / (m_meanSamples - 1)));
+        } else {
+            m_yDataEntries.append(0.0);
         }
-        m_yDataEntries.append(sqrt(stdSum));
     } else {
-        m_yDataEntries.append(boxcarAvg);
+        m_yDataEntries.append(m_meanSum / m_historyCount);
+    }
+}
+
+/**
+ * Collect the samples for the power spectral density and hand a block to the
+ * thread pool every half window, the blocks overlap by 50%. A block that
+ * comes due while the previous one is still being computed waits for it.
+ */
+void PlotData::calcSpectrum(double currentValue)
+{
+    if (m_historyCount == 0) {
+        m_spectrumTimer.start();
+    }
+    pushHistory(currentValue);
+    m_spectrumSamples++;
+
+    if (m_historyCount < m_fftSize || m_spectrumSamples < m_fftSize / 2 || m_spectrumBusy) {
+        return;
     }
+
+    // Sample rate of the updates since the last block
+    qint64 elapsed    = m_spectrumTimer.nsecsElapsed();
+    double sampleRate = elapsed > 0 ? 1.0e9 * m_spectrumSamples / elapsed : 1.0;
+    m_spectrumTimer.restart();
+    m_spectrumSamples = 0;
+
+    // oldest value first
+    QVector<double> samples(m_fftSize);
+    for (int i = 0; i < m_fftSize; i++) {
+        samples[i] = m_yDataHistory.at((m_historyIndex + i) % m_fftSize);
+    }
+
+    SpectrumJob *job = new SpectrumJob(samples, sampleRate);
+    connect(job, SIGNAL(finished(QVector<double>, QVector<double>)),
+            this, SLOT(spectrumReady(QVector<double>, QVector<double>)), Qt::QueuedConnection);
+    m_spectrumBusy = true;
+    QThreadPool::globalInstance()->start(job);
+}
+
+void PlotData::spectrumReady(const QVector<double> &frequencies, const QVector<double> &density)
+{
+    m_spectrumBusy = false;
+    m_xDataEntries = frequencies;
+    m_yDataEntries = density;
 }
 
 QwtPlotMarker *PlotData::createMarker(QString value)
@@ -209,9 +448,15 @@ bool SequentialPlotData::append(UAVObject *obj)
         if (!m_isEnumPlot) {
             double currentValue = m_field->getValue(m_element).toDouble() * pow(10, m_scalePower);
 
-            // Perform scope math, if necessary
-            if (m_mathFunction == "Boxcar average" || m_mathFunction == "Standard deviation") {
-                calcMathFunction(currentValue);
+            // The spectrum replaces the whole curve once per block
+            if (m_mathFunctionType == MathPowerSpectralDensity) {
+                calcSpectrum(currentValue);
+                return true;
+            }
+
+            // Perform scope math, if necessary, one x unit per sample
+            if (m_mathFunctionType != MathNone) {
+                calcMathFunction(currentValue, m_lastXValue + 1.0);
             } else {
                 m_yDataEntries.append(currentValue);
             }
@@ -259,8 +504,8 @@ bool ChronoPlotData::append(UAVObject *obj)
             double currentValue = m_field->getValue(m_element).toDouble() * pow(10, m_scalePower);
 
             // Perform scope math, if necessary
-            if (m_mathFunction == "Boxcar average" || m_mathFunction == "Standard deviation") {
-                calcMathFunction(currentValue);
+            if (m_mathFunctionType != MathNone) {
+                calcMathFunction(currentValue, xValue);
             } else {
                 m_yDataEntries.append(currentValue);
             }
@@ -39,6 +39,8 @@
 
 #include <QTimer>
 #include <QTime>
+#include <QElapsedTimer>
+#include <QRunnable>
 #include <QVector>
 #include <uavdataobject.h>
 
@@ -47,6 +49,11 @@
  */
 enum PlotType { SequentialPlot, ChronoPlot };
 
+/*!
+   \brief The math functions a curve can apply, by their names in the configuration.
+ */
+enum MathFunction { MathNone, MathBoxcarAverage, MathStandardDeviation, MathDerivative, MathPowerSpectralDensity };
+
 /*!
    \brief Base class that keeps the data for each curve in the plot.
  */
@@ -88,6 +95,12 @@ public:
         return m_isEnumPlot;
     }
 
+    // The curve shows a spectrum over frequency [Hz] instead of a time series
+    bool isSpectrum() const
+    {
+        return m_mathFunctionType == MathPowerSpectralDensity;
+    }
+
     virtual bool append(UAVObject *obj) = 0;
     virtual PlotType plotType() const   = 0;
     virtual void removeStaleData() = 0;
@@ -103,19 +116,42 @@ public:
 public slots:
     void visibilityChanged(QwtPlotItem *item);
 
+private slots:
+    void spectrumReady(const QVector<double> &frequencies, const QVector<double> &density);
+
 protected:
     // This is the power to which each value must be raised
     int m_scalePower;
     int m_meanSamples;
     double m_meanSum;
     QString m_mathFunction;
+    MathFunction m_mathFunctionType;
     double m_correctionSum;
     int m_correctionCount;
     double m_plotDataSize;
 
     QVector<double> m_xDataEntries;
     QVector<double> m_yDataEntries;
+
+    // Ring buffer of the last raw values, m_historyIndex is the next slot and the oldest value once full
     QVector<double> m_yDataHistory;
+    int m_historyIndex;
+    int m_historyCount;
+
+    // Welford accumulators of the values in the window
+    double m_welfordMean;
+    double m_welfordM2;
+
+    // Derivative state
+    double m_lastValue;
+    double m_lastXValue;
+    bool m_hasLastValue;
+
+    // Spectrum state, one block is in flight at most
+    int m_fftSize;
+    int m_spectrumSamples;
+    bool m_spectrumBusy;
+    QElapsedTimer m_spectrumTimer;
 
     UAVObject *m_object;
     UAVObjectField *m_field;
@@ -127,8 +163,32 @@ protected:
     bool m_isVisible;
     QPen m_pen;
     bool m_isEnumPlot;
-    virtual void calcMathFunction(double currentValue);
+    virtual void calcMathFunction(double currentValue, double xValue);
+    void calcSpectrum(double currentValue);
     QwtPlotMarker *createMarker(QString value);
+
+private:
+    void resetMath();
+    double pushHistory(double currentValue);
+};
+
+/*!
+   \brief Computes the power spectral density of one block of samples on the
+   global thread pool and hands the result back with a queued signal.
+ */
+class SpectrumJob : public QObject, public QRunnable {
+    Q_OBJECT
+public:
+    SpectrumJob(const QVector<double> &samples, double sampleRate);
+
+    void run();
+
+signals:
+    void finished(const QVector<double> &frequencies, const QVector<double> &density);
+
+private:
+    QVector<double> m_samples;
+    double m_sampleRate;
 };
 
 /*!
@@ -164,7 +224,12 @@ public:
                    double plotDataSize, QPen pen, bool antialiased)
         : PlotData(object, field, element, scaleFactor, meanSamples,
                    mathFunction, plotDataSize, pen, antialiased)
-    {}
+    {
+        // A spectrum cannot be shown on the time axis
+        if (m_mathFunctionType == MathPowerSpectralDensity) {
+            m_mathFunctionType = MathNone;
+        }
+    }
     ~ChronoPlotData() {}
 
     bool append(UAVObject *obj);
@@ -72,6 +72,8 @@ QWidget *ScopeGadgetOptionsPage::createPage(QWidget *parent)
     options_page->mathFunctionComboBox->addItem("None");
     options_page->mathFunctionComboBox->addItem("Boxcar average");
     options_page->mathFunctionComboBox->addItem("Standard deviation");
+    options_page->mathFunctionComboBox->addItem("Derivative");
+    options_page->mathFunctionComboBox->addItem("Power spectral density");
 
     if (options_page->cmbUAVObjects->currentIndex() >= 0) {
         on_cmbUAVObjects_currentIndexChanged(options_page->cmbUAVObjects->currentText());
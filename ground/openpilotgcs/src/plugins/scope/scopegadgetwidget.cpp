@@ -34,6 +34,7 @@
 #include "coreplugin/icore.h"
 #include "coreplugin/connectionmanager.h"
 #include <coreplugin/icore.h>
+#include <uavtalk/telemetrymanager.h>
 
 #include "qwt/src/qwt_plot_curve.h"
 #include "qwt/src/qwt_plot_grid.h"
@@ -124,10 +125,11 @@ ScopeGadgetWidget::~ScopeGadgetWidget()
     // Get the object to de-monitor
     ExtensionSystem::PluginManager *pm = ExtensionSystem::PluginManager::instance();
     UAVObjectManager *objManager = pm->getObject<UAVObjectManager>();
+    TelemetryManager *telMngr    = pm->getObject<TelemetryManager>();
     foreach(QString uavObjName, m_connectedUAVObjects) {
         UAVDataObject *obj = dynamic_cast<UAVDataObject *>(objManager->getObject(uavObjName));
 
-        disconnect(obj, SIGNAL(objectUpdated(UAVObject *)), this, SLOT(uavObjectReceived(UAVObject *)));
+        telMngr->unsubscribe(obj, this);
     }
 
     clearCurvePlots();
@@ -398,13 +400,19 @@ void ScopeGadgetWidget::addCurvePlot(QString objectName, QString fieldPlusSubFie
     connect(this, SIGNAL(visibilityChanged(QwtPlotItem *)), plotData, SLOT(visibilityChanged(QwtPlotItem *)));
     plotData->attach(this);
 
+    // A spectrum is plotted over frequency, not over the sample window
+    if (plotData->isSpectrum()) {
+        setAxisAutoScale(QwtPlot::xBottom, true);
+    }
+
     // Keep the curve details for later
     m_curvesData.insert(plotData->plotName(), plotData);
 
-    // Link to the new signal data only if this UAVObject has not been connected yet
+    // Link to the new signal data only if this UAVObject has not been connected yet,
+    // a scope plots every sample so it keeps the rate the flight side is configured for
     if (!m_connectedUAVObjects.contains(object->getName())) {
         m_connectedUAVObjects.append(object->getName());
-        connect(object, SIGNAL(objectUpdated(UAVObject *)), this, SLOT(uavObjectReceived(UAVObject *)));
+        pm->getObject<TelemetryManager>()->subscribe(object, this, "uavObjectReceived", 0);
     }
 
     m_mutex.lock();
@@ -61,6 +61,8 @@ UAVObjectBrowserWidget::UAVObjectBrowserWidget(QWidget *parent) : QWidget(parent
     showDescription(m_viewoptions->cbDescription->isChecked());
     connect(m_browser->treeView->selectionModel(), SIGNAL(currentChanged(QModelIndex, QModelIndex)),
             this, SLOT(currentChanged(QModelIndex, QModelIndex)), Qt::UniqueConnection);
+    connect(m_browser->treeView, SIGNAL(expanded(QModelIndex)), m_model, SLOT(itemExpanded(QModelIndex)));
+    connect(m_browser->treeView, SIGNAL(collapsed(QModelIndex)), m_model, SLOT(itemCollapsed(QModelIndex)));
     connect(m_viewoptions->cbMetaData, SIGNAL(toggled(bool)), this, SLOT(showMetaData(bool)));
     connect(m_viewoptions->cbCategorized, SIGNAL(toggled(bool)), this, SLOT(categorize(bool)));
     connect(m_viewoptions->cbDescription, SIGNAL(toggled(bool)), this, SLOT(showDescription(bool)));
@@ -123,6 +125,8 @@ void UAVObjectBrowserWidget::categorize(bool categorize)
     m_browser->treeView->setModel(m_model);
     showMetaData(m_viewoptions->cbMetaData->isChecked());
     connect(m_browser->treeView->selectionModel(), SIGNAL(currentChanged(QModelIndex, QModelIndex)), this, SLOT(currentChanged(QModelIndex, QModelIndex)), Qt::UniqueConnection);
+    connect(m_browser->treeView, SIGNAL(expanded(QModelIndex)), m_model, SLOT(itemExpanded(QModelIndex)));
+    connect(m_browser->treeView, SIGNAL(collapsed(QModelIndex)), m_model, SLOT(itemCollapsed(QModelIndex)));
 
     delete tmpModel;
 }
@@ -139,6 +143,8 @@ void UAVObjectBrowserWidget::useScientificNotation(bool scientific)
     m_browser->treeView->setModel(m_model);
     showMetaData(m_viewoptions->cbMetaData->isChecked());
     connect(m_browser->treeView->selectionModel(), SIGNAL(currentChanged(QModelIndex, QModelIndex)), this, SLOT(currentChanged(QModelIndex, QModelIndex)), Qt::UniqueConnection);
+    connect(m_browser->treeView, SIGNAL(expanded(QModelIndex)), m_model, SLOT(itemExpanded(QModelIndex)));
+    connect(m_browser->treeView, SIGNAL(collapsed(QModelIndex)), m_model, SLOT(itemCollapsed(QModelIndex)));
 
     delete tmpModel;
 }
@@ -44,7 +44,9 @@ UAVObjectTreeModel::UAVObjectTreeModel(QObject *parent, bool categorize, bool us
     m_recentlyUpdatedTimeout(500), // ms
     m_recentlyUpdatedColor(QColor(255, 230, 230)),
     m_manuallyChangedColor(QColor(230, 230, 255)),
-    m_unknownObjectColor(QColor(Qt::gray))
+    m_unknownObjectColor(QColor(Qt::gray)),
+    m_onlyHilightChangedValues(false),
+    m_batchUpdates(false)
 {
     ExtensionSystem::PluginManager *pm = ExtensionSystem::PluginManager::instance();
     UAVObjectManager *objManager = pm->getObject<UAVObjectManager>();
@@ -53,6 +55,12 @@ UAVObjectTreeModel::UAVObjectTreeModel(QObject *parent, bool categorize, bool us
 
     // Create highlight manager, let it run every 300 ms.
     m_highlightManager = new HighLightManager(300);
+
+    // Flush pending object updates once per frame (~60 Hz).
+    m_updateTimer.setSingleShot(true);
+    m_updateTimer.setInterval(16);
+    connect(&m_updateTimer, SIGNAL(timeout()), this, SLOT(flushUpdatedObjects()));
+
     connect(objManager, SIGNAL(newObject(UAVObject *)), this, SLOT(newObject(UAVObject *)));
     connect(objManager, SIGNAL(newInstance(UAVObject *)), this, SLOT(newObject(UAVObject *)));
 
@@ -287,17 +295,7 @@ QModelIndex UAVObjectTreeModel::index(TreeItem *item)
         return QModelIndex();
     }
 
-    QModelIndex root = index(item->parent());
-
-    for (int i = 0; i < rowCount(root); ++i) {
-        QModelIndex childIndex = index(i, 0, root);
-        TreeItem *child = static_cast<TreeItem *>(childIndex.internalPointer());
-        if (child == item) {
-            return childIndex;
-        }
-    }
-    Q_ASSERT(false);
-    return QModelIndex();
+    return createIndex(item->row(), 0, item);
 }
 
 QModelIndex UAVObjectTreeModel::parent(const QModelIndex &index) const
@@ -447,16 +445,108 @@ QVariant UAVObjectTreeModel::headerData(int section, Qt::Orientation orientation
 void UAVObjectTreeModel::highlightUpdatedObject(UAVObject *obj)
 {
     Q_ASSERT(obj);
-    ObjectTreeItem *item = findObjectTreeItem(obj);
-    Q_ASSERT(item);
-    if (!m_onlyHilightChangedValues) {
-        item->setHighlight(true);
+    m_pendingObjects.insert(obj);
+    if (!m_updateTimer.isActive()) {
+        m_updateTimer.start();
+    }
+}
+
+void UAVObjectTreeModel::flushUpdatedObjects()
+{
+    m_batchUpdates = true;
+    foreach(UAVObject * obj, m_pendingObjects) {
+        ObjectTreeItem *item = findObjectTreeItem(obj);
+
+        Q_ASSERT(item);
+        if (isExpanded(item)) {
+            if (!m_onlyHilightChangedValues) {
+                item->setHighlight(true);
+                m_batchedItems.insert(item);
+            }
+            item->update();
+            continue;
+        }
+
+        // The fields are not visible, so only the object row is touched and
+        // the field items are refreshed when the object gets expanded.
+        bool changed = true;
+        if (m_onlyHilightChangedValues) {
+            QByteArray data(obj->getNumBytes(), 0);
+            obj->pack(reinterpret_cast<quint8 *>(data.data()));
+            changed = (m_hiddenObjectData.value(obj) != data);
+            m_hiddenObjectData.insert(obj, data);
+        }
+        if (changed) {
+            m_staleItems.insert(item);
+            item->setHighlight(true);
+            m_batchedItems.insert(item);
+        }
+    }
+    m_pendingObjects.clear();
+    m_batchUpdates = false;
+    emitBatchedChanges();
+}
+
+void UAVObjectTreeModel::emitBatchedChanges()
+{
+    // Collapse all touched items into one row range per parent
+    QHash<TreeItem *, QPair<int, int> > ranges;
+    foreach(TreeItem * item, m_batchedItems) {
+        int row = item->row();
+        QHash<TreeItem *, QPair<int, int> >::iterator range = ranges.find(item->parent());
+
+        if (range == ranges.end()) {
+            ranges.insert(item->parent(), qMakePair(row, row));
+        } else {
+            range->first  = qMin(range->first, row);
+            range->second = qMax(range->second, row);
+        }
+    }
+    m_batchedItems.clear();
+
+    QHashIterator<TreeItem *, QPair<int, int> > iter(ranges);
+    while (iter.hasNext()) {
+        iter.next();
+        QModelIndex parentIndex = index(iter.key());
+        emit dataChanged(index(iter.value().first, TreeItem::TITLE_COLUMN, parentIndex),
+                         index(iter.value().second, TreeItem::DATA_COLUMN, parentIndex));
+    }
+}
+
+bool UAVObjectTreeModel::isExpanded(TreeItem *item) const
+{
+    for (; item && item != m_rootItem; item = item->parent()) {
+        if (!m_expandedItems.contains(item)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void UAVObjectTreeModel::itemExpanded(const QModelIndex &index)
+{
+    if (!index.isValid()) {
+        return;
+    }
+    m_expandedItems.insert(static_cast<TreeItem *>(index.internalPointer()));
+
+    // Bring objects that were updated while hidden up to date
+    m_batchUpdates = true;
+    foreach(ObjectTreeItem * item, m_staleItems) {
+        if (isExpanded(item)) {
+            m_staleItems.remove(item);
+            m_hiddenObjectData.remove(item->object());
+            item->update();
+        }
     }
-    item->update();
-    if (!m_onlyHilightChangedValues) {
-        QModelIndex itemIndex = index(item);
-        Q_ASSERT(itemIndex != QModelIndex());
-        emit dataChanged(itemIndex, itemIndex);
+    m_batchUpdates = false;
+    emitBatchedChanges();
+}
+
+void UAVObjectTreeModel::itemCollapsed(const QModelIndex &index)
+{
+    if (index.isValid()) {
+        m_expandedItems.remove(static_cast<TreeItem *>(index.internalPointer()));
     }
 }
 
@@ -492,6 +582,11 @@ MetaObjectTreeItem *UAVObjectTreeModel::findMetaObjectTreeItem(UAVMetaObject *ob
 
 void UAVObjectTreeModel::updateHighlight(TreeItem *item)
 {
+    if (m_batchUpdates) {
+        m_batchedItems.insert(item);
+        return;
+    }
+
     QModelIndex itemIndex = index(item);
 
     Q_ASSERT(itemIndex != QModelIndex());
@@ -32,6 +32,9 @@
 #include <QAbstractItemModel>
 #include <QtCore/QMap>
 #include <QtCore/QList>
+#include <QtCore/QSet>
+#include <QtCore/QHash>
+#include <QtCore/QTimer>
 #include <QColor>
 
 class TopTreeItem;
@@ -90,11 +93,14 @@ signals:
 
 public slots:
     void newObject(UAVObject *obj);
+    void itemExpanded(const QModelIndex &index);
+    void itemCollapsed(const QModelIndex &index);
 
 private slots:
     void updateHighlight(TreeItem *item);
     void updateIsKnown(TreeItem *item);
     void highlightUpdatedObject(UAVObject *obj);
+    void flushUpdatedObjects();
     void isKnownChanged(UAVObject *object, bool isKnown);
 
 private:
@@ -112,6 +118,8 @@ private:
     ObjectTreeItem *findObjectTreeItem(UAVObject *obj);
     DataObjectTreeItem *findDataObjectTreeItem(UAVDataObject *obj);
     MetaObjectTreeItem *findMetaObjectTreeItem(UAVMetaObject *obj);
+    bool isExpanded(TreeItem *item) const;
+    void emitBatchedChanges();
 
     TreeItem *m_rootItem;
     TopTreeItem *m_settingsTree;
@@ -126,6 +134,22 @@ private:
 
     // Highlight manager to handle highlighting of tree items.
     HighLightManager *m_highlightManager;
+
+    // Object updates are coalesced and flushed at most once per display frame.
+    QTimer m_updateTimer;
+    QSet<UAVObject *> m_pendingObjects;
+
+    // Items expanded in the view, objects whose fields are hidden and were
+    // updated since they were last shown, and the last seen data of those
+    // hidden objects (only used when highlighting changed values only).
+    QSet<TreeItem *> m_expandedItems;
+    QSet<ObjectTreeItem *> m_staleItems;
+    QHash<UAVObject *, QByteArray> m_hiddenObjectData;
+
+    // While flushing, highlight changes are collected here instead of being
+    // signalled one by one.
+    bool m_batchUpdates;
+    QSet<TreeItem *> m_batchedItems;
 };
 
 #endif // UAVOBJECTTREEMODEL_H
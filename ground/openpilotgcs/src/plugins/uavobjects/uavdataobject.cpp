@@ -35,6 +35,9 @@ UAVDataObject::UAVDataObject(quint32 objID, bool isSingleInst, bool isSettings,
 {
     m_metaObject = NULL;
     this->m_isSettings = isSettings;
+    m_notificationInterval = 0;
+    m_notificationTimer    = NULL;
+    connect(this, SIGNAL(objectUpdated(UAVObject *)), this, SLOT(propertiesUpdated()));
 }
 
 /**
@@ -58,6 +61,79 @@ void UAVDataObject::initialize(UAVMetaObject *metaObject)
     this->m_metaObject = metaObject;
 }
 
+/**
+ * Limit the rate of the property change notifications (the NOTIFY signals the
+ * QML bindings listen to). Updates that arrive within ms of the last
+ * notification are merged into one, which only reports what changed over the
+ * whole window. Each requester keeps its own interval, the shortest one is
+ * used. An interval of 0 withdraws the request, requests of destroyed
+ * requesters are withdrawn automatically.
+ */
+void UAVDataObject::setNotificationInterval(QObject *requester, int ms)
+{
+    if (ms > 0) {
+        if (!m_notificationIntervals.contains(requester)) {
+            connect(requester, SIGNAL(destroyed(QObject *)), this, SLOT(notificationRequesterDestroyed(QObject *)));
+        }
+        m_notificationIntervals.insert(requester, ms);
+    } else if (m_notificationIntervals.remove(requester)) {
+        disconnect(requester, SIGNAL(destroyed(QObject *)), this, SLOT(notificationRequesterDestroyed(QObject *)));
+    }
+
+    m_notificationInterval = 0;
+    foreach(int interval, m_notificationIntervals) {
+        if (m_notificationInterval == 0 || interval < m_notificationInterval) {
+            m_notificationInterval = interval;
+        }
+    }
+
+    if (m_notificationInterval > 0 && !m_notificationTimer) {
+        m_notificationTimer = new QTimer(this);
+        m_notificationTimer->setSingleShot(true);
+        connect(m_notificationTimer, SIGNAL(timeout()), this, SLOT(notificationTimeout()));
+    }
+    if (m_notificationInterval == 0 && m_notificationTimer && m_notificationTimer->isActive()) {
+        // flush the pending notification instead of dropping it
+        m_notificationTimer->stop();
+        notificationTimeout();
+    }
+}
+
+void UAVDataObject::notificationRequesterDestroyed(QObject *requester)
+{
+    setNotificationInterval(requester, 0);
+}
+
+void UAVDataObject::propertiesUpdated()
+{
+    if (m_notificationInterval == 0) {
+        emitNotifications();
+        return;
+    }
+    if (m_notificationTimer->isActive()) {
+        // already scheduled, that notification will include this update
+        return;
+    }
+    qint64 elapsed = m_lastNotification.isValid() ? m_lastNotification.elapsed() : m_notificationInterval;
+    if (elapsed >= m_notificationInterval) {
+        notificationTimeout();
+    } else {
+        m_notificationTimer->start(m_notificationInterval - elapsed);
+    }
+}
+
+void UAVDataObject::notificationTimeout()
+{
+    m_lastNotification.start();
+    emitNotifications();
+}
+
+/**
+ * Emit the change signals of the properties, implemented by the generated objects
+ */
+void UAVDataObject::emitNotifications()
+{}
+
 /**
  * Returns true if this is a data object holding module settings
  */
@@ -33,6 +33,9 @@
 #include "uavobjectfield.h"
 #include "uavmetaobject.h"
 #include <QList>
+#include <QMap>
+#include <QTimer>
+#include <QElapsedTimer>
 
 class UAVOBJECTS_EXPORT UAVDataObject : public UAVObject {
     Q_OBJECT
@@ -50,9 +53,24 @@ public:
     bool isSettingsObject();
     bool isDataObject();
 
+    void setNotificationInterval(QObject *requester, int ms);
+
+protected:
+    virtual void emitNotifications();
+
+private slots:
+    void propertiesUpdated();
+    void notificationTimeout();
+    void notificationRequesterDestroyed(QObject *requester);
+
 private:
     UAVMetaObject *m_metaObject;
     bool m_isSettings;
+    // property notification coalescing, see setNotificationInterval()
+    QMap<QObject *, int> m_notificationIntervals;
+    int m_notificationInterval;
+    QTimer *m_notificationTimer;
+    QElapsedTimer m_lastNotification;
 };
 
 #endif // UAVDATAOBJECT_H
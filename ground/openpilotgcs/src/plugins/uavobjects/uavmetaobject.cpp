@@ -28,23 +28,37 @@
 #include "uavmetaobject.h"
 #include "uavobjectfield.h"
 
+/**
+ * Field descriptors, the same for every metaobject
+ */
+static QList<UAVObjectFieldInfoPtr> createMetaFieldInfo()
+{
+    QStringList modesBitField;
+    modesBitField << UAVMetaObject::tr("FlightReadOnly") << UAVMetaObject::tr("GCSReadOnly") << UAVMetaObject::tr("FlightTelemetryAcked") << UAVMetaObject::tr("GCSTelemetryAcked") << UAVMetaObject::tr("FlightUpdatePeriodic") << UAVMetaObject::tr("FlightUpdateOnChange") << UAVMetaObject::tr("GCSUpdatePeriodic") << UAVMetaObject::tr("GCSUpdateOnChange") << UAVMetaObject::tr("LoggingUpdatePeriodic") << UAVMetaObject::tr("LoggingUpdateOnChange");
+    QList<UAVObjectFieldInfoPtr> fieldInfo;
+    fieldInfo.append(UAVObjectFieldInfoPtr(new UAVObjectFieldInfo(UAVMetaObject::tr("Modes"), UAVMetaObject::tr("Metadata modes"), UAVMetaObject::tr("boolean"), UAVObjectField::BITFIELD, modesBitField, QStringList())));
+    fieldInfo.append(UAVObjectFieldInfoPtr(new UAVObjectFieldInfo(UAVMetaObject::tr("Flight Telemetry Update Period"), UAVMetaObject::tr("This is how often flight side will update telemetry data"), UAVMetaObject::tr("ms"), UAVObjectField::UINT16, QStringList() << "0", QStringList())));
+    fieldInfo.append(UAVObjectFieldInfoPtr(new UAVObjectFieldInfo(UAVMetaObject::tr("GCS Telemetry Update Period"), UAVMetaObject::tr("This is how often GCS will update telemetry data"), UAVMetaObject::tr("ms"), UAVObjectField::UINT16, QStringList() << "0", QStringList())));
+    fieldInfo.append(UAVObjectFieldInfoPtr(new UAVObjectFieldInfo(UAVMetaObject::tr("Logging Update Period"), UAVMetaObject::tr("This is how often logging will be updated."), UAVMetaObject::tr("ms"), UAVObjectField::UINT16, QStringList() << "0", QStringList())));
+    return fieldInfo;
+}
+
 /**
  * Constructor
  */
 UAVMetaObject::UAVMetaObject(quint32 objID, const QString & name, UAVObject *parent) :
     UAVObject(objID, true, name)
 {
+    static const QList<UAVObjectFieldInfoPtr> fieldInfo = createMetaFieldInfo();
+
     this->parent = parent;
     // Setup default metadata of metaobject (can not be changed)
     UAVObject::MetadataInitialize(ownMetadata);
     // Setup fields
-    QStringList modesBitField;
-    modesBitField << tr("FlightReadOnly") << tr("GCSReadOnly") << tr("FlightTelemetryAcked") << tr("GCSTelemetryAcked") << tr("FlightUpdatePeriodic") << tr("FlightUpdateOnChange") << tr("GCSUpdatePeriodic") << tr("GCSUpdateOnChange") << tr("LoggingUpdatePeriodic") << tr("LoggingUpdateOnChange");
     QList<UAVObjectField *> fields;
-    fields.append(new UAVObjectField(tr("Modes"), tr("Metadata modes"), tr("boolean"), UAVObjectField::BITFIELD, modesBitField, QStringList()));
-    fields.append(new UAVObjectField(tr("Flight Telemetry Update Period"), tr("This is how often flight side will update telemetry data"), tr("ms"), UAVObjectField::UINT16, 1, QStringList()));
-    fields.append(new UAVObjectField(tr("GCS Telemetry Update Period"), tr("This is how often GCS will update telemetry data"), tr("ms"), UAVObjectField::UINT16, 1, QStringList()));
-    fields.append(new UAVObjectField(tr("Logging Update Period"), tr("This is how often logging will be updated."), tr("ms"), UAVObjectField::UINT16, 1, QStringList()));
+    foreach(const UAVObjectFieldInfoPtr &info, fieldInfo) {
+        fields.append(new UAVObjectField(info));
+    }
     // Initialize parent
     UAVObject::initialize(0);
     UAVObject::initializeFields(fields, (quint8 *)&parentMetadata, sizeof(Metadata));
@@ -94,20 +94,9 @@ void UAVObject::initializeFields(QList<UAVObjectField *> & fields, quint8 *data,
     for (int n = 0; n < fields.length(); ++n) {
         fields[n]->initialize(data, offset, this);
         offset += fields[n]->getNumBytes();
-        connect(fields[n], SIGNAL(fieldUpdated(UAVObjectField *)), this, SLOT(fieldUpdated(UAVObjectField *)));
     }
 }
 
-/**
- * Called from the fields each time they are updated
- */
-void UAVObject::fieldUpdated(UAVObjectField *field)
-{
-    Q_UNUSED(field);
-// emit objectUpdatedAuto(this); // trigger object updated event
-// emit objectUpdated(this);
-}
-
 /**
  * Get the object ID
  */
@@ -328,6 +317,63 @@ qint32 UAVObject::unpack(const quint8 *dataIn)
     return numBytes;
 }
 
+/**
+ * Unpack the object data from a byte array into the staging area instead of
+ * the object data. Does not take the object mutex, the telemetry thread uses
+ * it for streamed data and the GUI thread moves the samples into the object
+ * with commitStaged().
+ * @returns True if nothing was staged before
+ */
+bool UAVObject::stage(const quint8 *dataIn)
+{
+    QByteArray sample(numBytes, 0);
+    qint32 offset = 0;
+
+    for (int n = 0; n < fields.length(); ++n) {
+        fields[n]->unpack(&dataIn[offset], (quint8 *)sample.data());
+        offset += fields[n]->getNumBytes();
+    }
+
+    QMutexLocker locker(&stagingMutex);
+    bool first = staged.isEmpty();
+    if (staged.size() >= MAX_STAGED) {
+        staged.removeFirst();
+    }
+    staged.append(sample);
+    return first;
+}
+
+/**
+ * Drop the staged samples, the object was just updated directly
+ */
+void UAVObject::discardStaged()
+{
+    QMutexLocker locker(&stagingMutex);
+
+    staged.clear();
+}
+
+/**
+ * Copy the staged samples into the object data in the order they were
+ * received, with the same notifications as unpack()
+ */
+void UAVObject::commitStaged()
+{
+    QList<QByteArray> samples;
+    {
+        QMutexLocker locker(&stagingMutex);
+        samples.swap(staged);
+    }
+
+    foreach(const QByteArray &sample, samples) {
+        QMutexLocker locker(mutex);
+
+        memcpy(data, sample.constData(), numBytes);
+        emit objectUnpacked(this); // trigger object updated event
+        emit objectUpdated(this);
+    }
+}
+
 /**
  * Update a CRC with the object data
  * @returns The updated CRC
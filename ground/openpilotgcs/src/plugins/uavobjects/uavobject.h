@@ -35,6 +35,7 @@
 #include <QMutexLocker>
 #include <QString>
 #include <QList>
+#include <QByteArray>
 #include <QFile>
 #include <stdint.h>
 #include <QXmlStreamWriter>
@@ -114,6 +115,9 @@ public:
     quint32 getNumBytes();
     qint32 pack(quint8 *dataOut);
     qint32 unpack(const quint8 *dataIn);
+    bool stage(const quint8 *dataIn);
+    void discardStaged();
+    void commitStaged();
     quint8 updateCRC(quint8 crc = 0);
     bool save();
     bool save(QFile & file);
@@ -202,8 +206,13 @@ protected:
 private:
     bool m_isKnown;
 
-private slots:
-    void fieldUpdated(UAVObjectField *field);
+    // Received data unpacked by the telemetry thread, oldest first, waiting
+    // for commitStaged() in the GUI thread. Has its own mutex so the telemetry
+    // thread never waits for GUI readers of the object.
+    QMutex stagingMutex;
+    QList<QByteArray> staged;
+    // Beyond this the oldest staged sample is dropped
+    static const int MAX_STAGED = 256;
 };
 
 #endif // UAVOBJECT_H
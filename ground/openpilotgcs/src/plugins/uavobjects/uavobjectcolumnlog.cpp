@@ -0,0 +1,457 @@
+/**
+ ******************************************************************************
+ *
+ * @file       uavobjectcolumnlog.cpp
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2014.
+ * @see        The GNU Public License (GPL) Version 3
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup UAVObjectsPlugin UAVObjects Plugin
+ * @{
+ * @brief      The UAVUObjects GCS plugin
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+#include "uavobjectcolumnlog.h"
+#include "uavobjectlogfile.h"
+
+#include <QHash>
+#include <QMap>
+#include <QThreadPool>
+#include <QRunnable>
+#include <string.h>
+
+#define COLUMNLOG_VERSION 1
+
+static const char COLUMNLOG_MAGIC[8] = { 'O', 'P', 'C', 'O', 'L', 'S', 0, 0 };
+
+namespace {
+// On disk structures, every member is naturally aligned and all sizes are a
+// multiple of 8 so the arrays of them stay aligned. Written in host order,
+// like the .opl logs they come from.
+typedef struct {
+    char    magic[8];
+    quint32 version;
+    quint32 numTables;
+    quint32 numColumns;
+    quint32 stringsSize;
+    quint64 strings;
+} FileHeader;
+
+typedef struct {
+    quint32 objId;
+    quint32 instId;
+    quint32 name;
+    quint32 firstColumn;
+    quint32 numColumns;
+    quint32 reserved;
+    quint64 numRows;
+    quint64 timestamps;
+} TableEntry;
+
+typedef struct {
+    quint32 name;
+    quint8  type;
+    quint8  reserved;
+    quint16 width;
+    quint64 data;
+} ColumnEntry;
+
+typedef struct {
+    quint32 name;
+    quint32 srcOffset; // in the object data
+    quint32 width;
+    quint8  type;
+    quint64 data;
+} ColumnLayout;
+
+typedef struct {
+    quint32 objId;
+    quint32 instId;
+    quint32 name;
+    quint32 numBytes;
+    quint32 firstColumn;
+    quint64 timestamps;
+    QVector<int> rows; // into the log records
+    QVector<ColumnLayout> columns;
+} TableLayout;
+
+quint64 align8(quint64 pos)
+{
+    return (pos + 7) & ~(quint64)7;
+}
+
+quint32 addString(QByteArray & strings, const QString & string)
+{
+    quint32 offset = strings.size();
+
+    strings.append(string.toUtf8());
+    strings.append('\0');
+    return offset;
+}
+
+/**
+ * Fills the columns of one table, tables do not share any output
+ */
+class ColumnWriter : public QRunnable {
+public:
+    ColumnWriter(const UAVObjectLogFile *log, const TableLayout *table, uchar *out)
+        : m_log(log), m_table(table), m_out(out)
+    {}
+
+    void run()
+    {
+        const QVector<UAVObjectLogFile::Record> &records = m_log->records();
+        quint32 *timestamps = (quint32 *)(m_out + m_table->timestamps);
+        const int numColumns = m_table->columns.size();
+
+        for (int row = 0; row < m_table->rows.size(); ++row) {
+            const UAVObjectLogFile::Record &record = records[m_table->rows[row]];
+            const quint8 *src = m_log->recordData(record);
+            timestamps[row] = record.timestamp;
+            for (int n = 0; n < numColumns; ++n) {
+                const ColumnLayout &column = m_table->columns[n];
+                memcpy(m_out + column.data + (quint64)row * column.width, src + column.srcOffset, column.width);
+            }
+        }
+    }
+
+private:
+    const UAVObjectLogFile *m_log;
+    const TableLayout *m_table;
+    uchar *m_out;
+};
+}
+
+UAVObjectColumnExporter::UAVObjectColumnExporter(UAVObjectManager *objMngr)
+    : m_objMngr(objMngr), m_maxThreadCount(0), m_numRows(0), m_numSkipped(0)
+{}
+
+/**
+ * Only export these objects, all when empty
+ */
+void UAVObjectColumnExporter::setObjectFilter(const QStringList & objectNames)
+{
+    m_objectFilter = objectNames;
+}
+
+/**
+ * Limit the number of tables written in parallel, 0 for one per core
+ */
+void UAVObjectColumnExporter::setMaxThreadCount(int count)
+{
+    m_maxThreadCount = count;
+}
+
+QString UAVObjectColumnExporter::errorString() const
+{
+    return m_errorString;
+}
+
+int UAVObjectColumnExporter::numRows() const
+{
+    return m_numRows;
+}
+
+/**
+ * Updates of objects that are unknown, filtered out or of a different size
+ * than the object definitions of this GCS
+ */
+int UAVObjectColumnExporter::numSkipped() const
+{
+    return m_numSkipped;
+}
+
+/**
+ * Convert a log. The log is indexed in one pass, then each object table is
+ * written by its own thread straight into the mapped output file.
+ */
+bool UAVObjectColumnExporter::exportLog(const QString & logFileName, const QString & fileName)
+{
+    m_numRows    = 0;
+    m_numSkipped = 0;
+    m_errorString.clear();
+
+    UAVObjectLogFile log;
+    if (!log.open(logFileName)) {
+        m_errorString = log.errorString();
+        return false;
+    }
+
+    // Group the updates by object instance, ordered by ID for a stable file
+    const QVector<UAVObjectLogFile::Record> &records = log.records();
+    QHash<quint32, UAVObject *> types;
+    QMap<quint64, TableLayout> tables;
+    QByteArray strings;
+    quint32 numColumns = 0;
+    for (int i = 0; i < records.size(); ++i) {
+        const UAVObjectLogFile::Record &record = records[i];
+        quint64 key = ((quint64)record.objId << 16) | record.instId;
+        QMap<quint64, TableLayout>::iterator table = tables.find(key);
+        if (table == tables.end()) {
+            if (!types.contains(record.objId)) {
+                UAVObject *obj = m_objMngr->getObject(record.objId);
+                if (obj && !m_objectFilter.isEmpty() && !m_objectFilter.contains(obj->getName())) {
+                    obj = NULL;
+                }
+                types.insert(record.objId, obj);
+            }
+            UAVObject *obj = types.value(record.objId);
+            if (!obj) {
+                m_numSkipped++;
+                continue;
+            }
+
+            // The column layout comes from the field metadata of the object type
+            TableLayout layout;
+            layout.objId       = record.objId;
+            layout.instId      = record.instId;
+            layout.name        = addString(strings, obj->getName());
+            layout.numBytes    = obj->getNumBytes();
+            layout.firstColumn = numColumns;
+            layout.timestamps  = 0;
+            foreach(UAVObjectField * field, obj->getFields()) {
+                ColumnLayout column;
+                column.type = field->getType();
+                column.data = 0;
+                // strings and bitfields are not split, they are one column of packed bytes
+                if (field->getType() == UAVObjectField::STRING || field->getType() == UAVObjectField::BITFIELD) {
+                    column.name      = addString(strings, field->getName());
+                    column.srcOffset = field->getDataOffset();
+                    column.width     = field->getNumBytes();
+                    layout.columns.append(column);
+                    continue;
+                }
+                QStringList elementNames = field->getElementNames();
+                column.width = field->getNumBytes() / field->getNumElements();
+                for (quint32 n = 0; n < field->getNumElements(); ++n) {
+                    QString name = field->getName();
+                    if (field->getNumElements() > 1) {
+                        name += "." + ((int)n < elementNames.size() ? elementNames[n] : QString::number(n));
+                    }
+                    column.name      = addString(strings, name);
+                    column.srcOffset = field->getDataOffset() + n * column.width;
+                    layout.columns.append(column);
+                }
+            }
+            numColumns += layout.columns.size();
+            table = tables.insert(key, layout);
+        }
+        if (record.length != table->numBytes) {
+            // logged with a different version of the object
+            m_numSkipped++;
+            continue;
+        }
+        table->rows.append(i);
+    }
+
+    // Place the arrays
+    quint64 pos = sizeof(FileHeader) + tables.size() * sizeof(TableEntry) + numColumns * sizeof(ColumnEntry);
+    const quint64 stringsOffset = pos;
+    pos = align8(pos + strings.size());
+    for (QMap<quint64, TableLayout>::iterator table = tables.begin(); table != tables.end(); ++table) {
+        table->timestamps = pos;
+        pos = align8(pos + (quint64)table->rows.size() * sizeof(quint32));
+        for (int n = 0; n < table->columns.size(); ++n) {
+            table->columns[n].data = pos;
+            pos = align8(pos + (quint64)table->rows.size() * table->columns[n].width);
+        }
+        m_numRows += table->rows.size();
+    }
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadWrite | QIODevice::Truncate) || !file.resize(pos)) {
+        m_errorString = file.errorString();
+        return false;
+    }
+    uchar *out = file.map(0, pos);
+    if (!out) {
+        m_errorString = file.errorString();
+        return false;
+    }
+
+    FileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, COLUMNLOG_MAGIC, sizeof(header.magic));
+    header.version     = COLUMNLOG_VERSION;
+    header.numTables   = tables.size();
+    header.numColumns  = numColumns;
+    header.stringsSize = strings.size();
+    header.strings     = stringsOffset;
+    memcpy(out, &header, sizeof(header));
+
+    TableEntry *tableEntry   = (TableEntry *)(out + sizeof(FileHeader));
+    ColumnEntry *columnEntry = (ColumnEntry *)(tableEntry + tables.size());
+    foreach(const TableLayout &table, tables) {
+        memset(tableEntry, 0, sizeof(TableEntry));
+        tableEntry->objId       = table.objId;
+        tableEntry->instId      = table.instId;
+        tableEntry->name        = table.name;
+        tableEntry->firstColumn = table.firstColumn;
+        tableEntry->numColumns  = table.columns.size();
+        tableEntry->numRows     = table.rows.size();
+        tableEntry->timestamps  = table.timestamps;
+        tableEntry++;
+        foreach(const ColumnLayout &column, table.columns) {
+            memset(columnEntry, 0, sizeof(ColumnEntry));
+            columnEntry->name  = column.name;
+            columnEntry->type  = column.type;
+            columnEntry->width = column.width;
+            columnEntry->data  = column.data;
+            columnEntry++;
+        }
+    }
+    memcpy(out + stringsOffset, strings.constData(), strings.size());
+
+    // The tables are independent, fill them in parallel
+    QThreadPool pool;
+    if (m_maxThreadCount > 0) {
+        pool.setMaxThreadCount(m_maxThreadCount);
+    }
+    for (QMap<quint64, TableLayout>::const_iterator table = tables.constBegin(); table != tables.constEnd(); ++table) {
+        pool.start(new ColumnWriter(&log, &table.value(), out));
+    }
+    pool.waitForDone();
+
+    file.unmap(out);
+    file.close();
+    return true;
+}
+
+UAVObjectColumnReader::UAVObjectColumnReader() : m_data(0)
+{}
+
+UAVObjectColumnReader::~UAVObjectColumnReader()
+{
+    close();
+}
+
+/**
+ * Map a file and check that every array is inside it
+ */
+bool UAVObjectColumnReader::open(const QString & fileName)
+{
+    close();
+    m_errorString.clear();
+
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_errorString = m_file.errorString();
+        return false;
+    }
+    const quint64 size = m_file.size();
+    if (size < sizeof(FileHeader) || !(m_data = m_file.map(0, size))) {
+        m_errorString = size < sizeof(FileHeader) ? QString("not a column log") : m_file.errorString();
+        close();
+        return false;
+    }
+
+    const FileHeader *header = (const FileHeader *)m_data;
+    if (memcmp(header->magic, COLUMNLOG_MAGIC, sizeof(header->magic)) != 0 || header->version != COLUMNLOG_VERSION) {
+        m_errorString = QString("not a column log or unsupported version");
+        close();
+        return false;
+    }
+    const quint64 entriesEnd = sizeof(FileHeader) + (quint64)header->numTables * sizeof(TableEntry)
+                               + (quint64)header->numColumns * sizeof(ColumnEntry);
+    if (entriesEnd > size || header->strings < entriesEnd || header->strings + header->stringsSize > size
+        || (header->stringsSize > 0 && m_data[header->strings + header->stringsSize - 1] != '\0')) {
+        m_errorString = QString("corrupted column log");
+        close();
+        return false;
+    }
+
+    const char *strings = (const char *)m_data + header->strings;
+    const TableEntry *tableEntry   = (const TableEntry *)(m_data + sizeof(FileHeader));
+    const ColumnEntry *columnEntry = (const ColumnEntry *)(tableEntry + header->numTables);
+    for (quint32 t = 0; t < header->numTables; ++t, ++tableEntry) {
+        if (tableEntry->name >= header->stringsSize
+            || (quint64)tableEntry->firstColumn + tableEntry->numColumns > header->numColumns
+            || tableEntry->timestamps + tableEntry->numRows * sizeof(quint32) > size) {
+            m_errorString = QString("corrupted column log");
+            close();
+            return false;
+        }
+        Table table;
+        table.name       = QString::fromUtf8(strings + tableEntry->name);
+        table.objId      = tableEntry->objId;
+        table.instId     = tableEntry->instId;
+        table.numRows    = tableEntry->numRows;
+        table.timestamps = (const quint32 *)(m_data + tableEntry->timestamps);
+        for (quint32 n = 0; n < tableEntry->numColumns; ++n) {
+            const ColumnEntry &entry = columnEntry[tableEntry->firstColumn + n];
+            if (entry.name >= header->stringsSize || entry.data + tableEntry->numRows * entry.width > size) {
+                m_errorString = QString("corrupted column log");
+                close();
+                return false;
+            }
+            Column column;
+            column.name  = QString::fromUtf8(strings + entry.name);
+            column.type  = (UAVObjectField::FieldType)entry.type;
+            column.width = entry.width;
+            column.data  = m_data + entry.data;
+            table.columns.append(column);
+        }
+        m_tables.append(table);
+    }
+    return true;
+}
+
+void UAVObjectColumnReader::close()
+{
+    m_tables.clear();
+    if (m_data) {
+        m_file.unmap(const_cast<uchar *>(m_data));
+        m_data = 0;
+    }
+    m_file.close();
+}
+
+QString UAVObjectColumnReader::errorString() const
+{
+    return m_errorString;
+}
+
+const QList<UAVObjectColumnReader::Table> &UAVObjectColumnReader::tables() const
+{
+    return m_tables;
+}
+
+/**
+ * Find the table of an object instance, NULL if it is not in the log
+ */
+const UAVObjectColumnReader::Table *UAVObjectColumnReader::table(const QString & name, quint32 instId) const
+{
+    for (int i = 0; i < m_tables.size(); ++i) {
+        if (m_tables[i].name == name && m_tables[i].instId == instId) {
+            return &m_tables[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Find a column by name, "Field" or "Field.Element"
+ */
+const UAVObjectColumnReader::Column *UAVObjectColumnReader::column(const Table & table, const QString & name) const
+{
+    for (int i = 0; i < table.columns.size(); ++i) {
+        if (table.columns[i].name == name) {
+            return &table.columns[i];
+        }
+    }
+    return NULL;
+}
@@ -0,0 +1,120 @@
+/**
+ ******************************************************************************
+ *
+ * @file       uavobjectcolumnlog.h
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2014.
+ * @see        The GNU Public License (GPL) Version 3
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup UAVObjectsPlugin UAVObjects Plugin
+ * @{
+ * @brief      The UAVUObjects GCS plugin
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+#ifndef UAVOBJECTCOLUMNLOG_H
+#define UAVOBJECTCOLUMNLOG_H
+
+#include "uavobjects_global.h"
+#include "uavobjectmanager.h"
+#include "uavobjectfield.h"
+#include <QFile>
+#include <QList>
+#include <QStringList>
+#include <QVector>
+
+/**
+ * Columnar export of .opl logs (.opc files).
+ *
+ * Every object instance in the log becomes a table, every field element a
+ * column: a contiguous little endian array with one value per update, next
+ * to a quint32 timestamp column [ms] shared by the table. String and
+ * bitfield fields are one column of fixed width. Arrays start 8 byte
+ * aligned, so a mapped file can be handed to numpy or MATLAB without copying.
+ *
+ * Layout, all offsets from the start of the file:
+ *   header   "OPCOLS\0\0", version, table count, column count, string table size and offset
+ *   tables   object ID, instance ID, name, first column, column count, row count, timestamps offset
+ *   columns  name, UAVObjectField::FieldType, width in bytes, data offset
+ *   strings  zero terminated UTF-8, names are offsets into it
+ *   data
+ */
+class UAVOBJECTS_EXPORT UAVObjectColumnExporter {
+public:
+    explicit UAVObjectColumnExporter(UAVObjectManager *objMngr);
+
+    void setObjectFilter(const QStringList & objectNames);
+    void setMaxThreadCount(int count);
+
+    bool exportLog(const QString & logFileName, const QString & fileName);
+    QString errorString() const;
+
+    // statistics of the last export
+    int numRows() const;
+    int numSkipped() const;
+
+private:
+    UAVObjectManager *m_objMngr;
+    QStringList m_objectFilter;
+    int m_maxThreadCount;
+    int m_numRows;
+    int m_numSkipped;
+    QString m_errorString;
+};
+
+/**
+ * Memory mapped access to an .opc file, the arrays point into the mapping
+ * and stay valid until close()
+ */
+class UAVOBJECTS_EXPORT UAVObjectColumnReader {
+public:
+    typedef struct {
+        QString name;
+        UAVObjectField::FieldType type;
+        int width; // bytes per value
+        const void *data;
+    } Column;
+
+    typedef struct {
+        QString name;
+        quint32 objId;
+        quint32 instId;
+        quint64 numRows;
+        const quint32 *timestamps;
+        QList<Column> columns;
+    } Table;
+
+    UAVObjectColumnReader();
+    ~UAVObjectColumnReader();
+
+    bool open(const QString & fileName);
+    void close();
+    QString errorString() const;
+
+    const QList<Table> &tables() const;
+    const Table *table(const QString & name, quint32 instId = 0) const;
+    const Column *column(const Table & table, const QString & name) const;
+
+private:
+    Q_DISABLE_COPY(UAVObjectColumnReader)
+
+    QFile m_file;
+    const uchar *m_data;
+    QList<Table> m_tables;
+    QString m_errorString;
+};
+
+#endif // UAVOBJECTCOLUMNLOG_H
@@ -39,15 +39,31 @@ UAVObjectField::UAVObjectField(const QString & name, const QString & description
         elementNames.append(QString("%1").arg(n));
     }
     // Initialize
-    constructorInitialize(name, description, units, type, elementNames, options, limits);
+    constructorInitialize(UAVObjectFieldInfoPtr(new UAVObjectFieldInfo(name, description, units, type, elementNames, options, limits)));
 }
 
 UAVObjectField::UAVObjectField(const QString & name, const QString & description, const QString & units, FieldType type, const QStringList & elementNames, const QStringList & options, const QString &limits)
 {
-    constructorInitialize(name, description, units, type, elementNames, options, limits);
+    constructorInitialize(UAVObjectFieldInfoPtr(new UAVObjectFieldInfo(name, description, units, type, elementNames, options, limits)));
 }
 
-void UAVObjectField::constructorInitialize(const QString & name, const QString & description, const QString & units, FieldType type, const QStringList & elementNames, const QStringList & options, const QString &limits)
+UAVObjectField::UAVObjectField(const UAVObjectFieldInfoPtr & info)
+{
+    constructorInitialize(info);
+}
+
+void UAVObjectField::constructorInitialize(const UAVObjectFieldInfoPtr & info)
+{
+    this->info = info;
+    this->type = info->type;
+    this->numElements  = info->numElements;
+    this->numBytesPerElement = info->numBytesPerElement;
+    this->offset = 0;
+    this->data   = NULL;
+    this->obj    = NULL;
+}
+
+UAVObjectFieldInfo::UAVObjectFieldInfo(const QString & name, const QString & description, const QString & units, UAVObjectField::FieldType type, const QStringList & elementNames, const QStringList & options, const QString &limits)
 {
     // Copy params
     this->name         = name;
@@ -56,41 +72,38 @@ void UAVObjectField::constructorInitialize(const QString & name, const QString &
     this->type         = type;
     this->options      = options;
     this->numElements  = elementNames.length();
-    this->offset       = 0;
-    this->data         = NULL;
-    this->obj = NULL;
     this->elementNames = elementNames;
     // Set field size
     switch (type) {
-    case INT8:
+    case UAVObjectField::INT8:
         numBytesPerElement = sizeof(qint8);
         break;
-    case INT16:
+    case UAVObjectField::INT16:
         numBytesPerElement = sizeof(qint16);
         break;
-    case INT32:
+    case UAVObjectField::INT32:
         numBytesPerElement = sizeof(qint32);
         break;
-    case UINT8:
+    case UAVObjectField::UINT8:
         numBytesPerElement = sizeof(quint8);
         break;
-    case UINT16:
+    case UAVObjectField::UINT16:
         numBytesPerElement = sizeof(quint16);
         break;
-    case UINT32:
+    case UAVObjectField::UINT32:
         numBytesPerElement = sizeof(quint32);
         break;
-    case FLOAT32:
+    case UAVObjectField::FLOAT32:
         numBytesPerElement = sizeof(quint32);
         break;
-    case ENUM:
+    case UAVObjectField::ENUM:
         numBytesPerElement = sizeof(quint8);
         break;
-    case BITFIELD:
+    case UAVObjectField::BITFIELD:
         numBytesPerElement = sizeof(quint8);
-        this->options = QStringList() << tr("0") << tr("1");
+        this->options = QStringList() << UAVObjectField::tr("0") << UAVObjectField::tr("1");
         break;
-    case STRING:
+    case UAVObjectField::STRING:
         numBytesPerElement = sizeof(quint8);
         break;
     default:
@@ -99,7 +112,7 @@ void UAVObjectField::constructorInitialize(const QString & name, const QString &
     limitsInitialize(limits);
 }
 
-void UAVObjectField::limitsInitialize(const QString &limits)
+void UAVObjectFieldInfo::limitsInitialize(const QString &limits)
 {
     // Limit string format:
     // %        - start char
@@ -124,7 +137,7 @@ void UAVObjectField::limitsInitialize(const QString &limits)
     foreach(QString str, stringPerElement) {
         QStringList ruleList = str.split(",");
 
-        QList<LimitStruct> limitList;
+        QList<UAVObjectField::LimitStruct> limitList;
         foreach(QString rule, ruleList) {
             QString _str = rule.trimmed();
 
@@ -132,7 +145,7 @@ void UAVObjectField::limitsInitialize(const QString &limits)
                 continue;
             }
             QStringList valuesPerElement = _str.split(":");
-            LimitStruct lstruc;
+            UAVObjectField::LimitStruct lstruc;
             bool startFlag    = valuesPerElement.at(0).startsWith("%");
             bool maxIndexFlag = (int)(index) < (int)numElements;
             bool elemNumberSizeFlag = valuesPerElement.at(0).size() == 3;
@@ -146,15 +159,15 @@ void UAVObjectField::limitsInitialize(const QString &limits)
                     lstruc.board = 0;
                 }
                 if (valuesPerElement.at(0).right(2) == "EQ") {
-                    lstruc.type = EQUAL;
+                    lstruc.type = UAVObjectField::EQUAL;
                 } else if (valuesPerElement.at(0).right(2) == "NE") {
-                    lstruc.type = NOT_EQUAL;
+                    lstruc.type = UAVObjectField::NOT_EQUAL;
                 } else if (valuesPerElement.at(0).right(2) == "BE") {
-                    lstruc.type = BETWEEN;
+                    lstruc.type = UAVObjectField::BETWEEN;
                 } else if (valuesPerElement.at(0).right(2) == "BI") {
-                    lstruc.type = BIGGER;
+                    lstruc.type = UAVObjectField::BIGGER;
                 } else if (valuesPerElement.at(0).right(2) == "SM") {
-                    lstruc.type = SMALLER;
+                    lstruc.type = UAVObjectField::SMALLER;
                 } else {
                     qDebug() << "limits parsing failed (invalid property) on UAVObjectField" << name;
                 }
@@ -163,24 +176,24 @@ void UAVObjectField::limitsInitialize(const QString &limits)
                     QString value = _value.trimmed();
 
                     switch (type) {
-                    case UINT8:
-                    case UINT16:
-                    case UINT32:
-                    case BITFIELD:
+                    case UAVObjectField::UINT8:
+                    case UAVObjectField::UINT16:
+                    case UAVObjectField::UINT32:
+                    case UAVObjectField::BITFIELD:
                         lstruc.values.append((quint32)value.toULong());
                         break;
-                    case INT8:
-                    case INT16:
-                    case INT32:
+                    case UAVObjectField::INT8:
+                    case UAVObjectField::INT16:
+                    case UAVObjectField::INT32:
                         lstruc.values.append((qint32)value.toLong());
                         break;
-                    case FLOAT32:
+                    case UAVObjectField::FLOAT32:
                         lstruc.values.append((float)value.toFloat());
                         break;
-                    case ENUM:
+                    case UAVObjectField::ENUM:
                         lstruc.values.append((QString)value);
                         break;
-                    case STRING:
+                    case UAVObjectField::STRING:
                         lstruc.values.append((QString)value);
                         break;
                     default:
@@ -201,7 +214,7 @@ void UAVObjectField::limitsInitialize(const QString &limits)
         elementLimits.insert(index, limitList);
         ++index;
     }
-    // foreach(QList<LimitStruct> limitList, elementLimits) {
+    // foreach(QList<UAVObjectField::LimitStruct> limitList, elementLimits) {
     // foreach(LimitStruct limit, limitList) {
     // qDebug() << "Limit type" << limit.type << "for board" << limit.board << "for field" << getName();
     // foreach(QVariant var, limit.values) {
@@ -212,11 +225,11 @@ void UAVObjectField::limitsInitialize(const QString &limits)
 }
 bool UAVObjectField::isWithinLimits(QVariant var, quint32 index, int board)
 {
-    if (!elementLimits.keys().contains(index)) {
+    if (!info->elementLimits.contains(index)) {
         return true;
     }
 
-    foreach(LimitStruct struc, elementLimits.value(index)) {
+    foreach(LimitStruct struc, info->elementLimits.value(index)) {
         if ((struc.board != board) && board != 0 && struc.board != 0) {
             continue;
         }
@@ -319,11 +332,11 @@ bool UAVObjectField::isWithinLimits(QVariant var, quint32 index, int board)
             break;
         case BETWEEN:
             if (struc.values.length() < 2) {
-                qDebug() << __FUNCTION__ << "between limit with less than 1 pair, aborting; field:" << name;
+                qDebug() << __FUNCTION__ << "between limit with less than 1 pair, aborting; field:" << info->name;
                 return true;
             }
             if (struc.values.length() > 2) {
-                qDebug() << __FUNCTION__ << "between limit with more than 1 pair, using first; field" << name;
+                qDebug() << __FUNCTION__ << "between limit with more than 1 pair, using first; field" << info->name;
             }
             switch (type) {
             case INT8:
@@ -346,7 +359,7 @@ bool UAVObjectField::isWithinLimits(QVariant var, quint32 index, int board)
 
                 break;
             case ENUM:
-                if (!(options.indexOf(var.toString()) >= options.indexOf(struc.values.at(0).toString()) && options.indexOf(var.toString()) <= options.indexOf(struc.values.at(1).toString()))) {
+                if (!(info->options.indexOf(var.toString()) >= info->options.indexOf(struc.values.at(0).toString()) && info->options.indexOf(var.toString()) <= info->options.indexOf(struc.values.at(1).toString()))) {
                     return false;
                 }
                 return true;
@@ -369,11 +382,11 @@ bool UAVObjectField::isWithinLimits(QVariant var, quint32 index, int board)
             break;
         case BIGGER:
             if (struc.values.length() < 1) {
-                qDebug() << __FUNCTION__ << "BIGGER limit with less than 1 value, aborting; field:" << name;
+                qDebug() << __FUNCTION__ << "BIGGER limit with less than 1 value, aborting; field:" << info->name;
                 return true;
             }
             if (struc.values.length() > 1) {
-                qDebug() << __FUNCTION__ << "BIGGER limit with more than 1 value, using first; field" << name;
+                qDebug() << __FUNCTION__ << "BIGGER limit with more than 1 value, using first; field" << info->name;
             }
             switch (type) {
             case INT8:
@@ -396,7 +409,7 @@ bool UAVObjectField::isWithinLimits(QVariant var, quint32 index, int board)
 
                 break;
             case ENUM:
-                if (!(options.indexOf(var.toString()) >= options.indexOf(struc.values.at(0).toString()))) {
+                if (!(info->options.indexOf(var.toString()) >= info->options.indexOf(struc.values.at(0).toString()))) {
                     return false;
                 }
                 return true;
@@ -439,7 +452,7 @@ bool UAVObjectField::isWithinLimits(QVariant var, quint32 index, int board)
 
                 break;
             case ENUM:
-                if (!(options.indexOf(var.toString()) <= options.indexOf(struc.values.at(0).toString()))) {
+                if (!(info->options.indexOf(var.toString()) <= info->options.indexOf(struc.values.at(0).toString()))) {
                     return false;
                 }
                 return true;
@@ -470,8 +483,8 @@ QString UAVObjectField::getLimitsAsString(quint32 index, int board)
 {
     QString limitString;
 
-    if (elementLimits.keys().contains(index)) {
-        foreach(LimitStruct struc, elementLimits.value(index)) {
+    if (info->elementLimits.contains(index)) {
+        foreach(LimitStruct struc, info->elementLimits.value(index)) {
             if ((struc.board != board) && board != 0 && struc.board != 0) {
                 continue;
             }
@@ -520,10 +533,10 @@ QString UAVObjectField::getLimitsAsString(quint32 index, int board)
 
 QVariant UAVObjectField::getMaxLimit(quint32 index, int board)
 {
-    if (!elementLimits.keys().contains(index)) {
+    if (!info->elementLimits.contains(index)) {
         return QVariant();
     }
-    foreach(LimitStruct struc, elementLimits.value(index)) {
+    foreach(LimitStruct struc, info->elementLimits.value(index)) {
         if ((struc.board != board) && board != 0 && struc.board != 0) {
             continue;
         }
@@ -547,10 +560,10 @@ QVariant UAVObjectField::getMaxLimit(quint32 index, int board)
 }
 QVariant UAVObjectField::getMinLimit(quint32 index, int board)
 {
-    if (!elementLimits.keys().contains(index)) {
+    if (!info->elementLimits.contains(index)) {
         return QVariant();
     }
-    foreach(LimitStruct struc, elementLimits.value(index)) {
+    foreach(LimitStruct struc, info->elementLimits.value(index)) {
         if ((struc.board != board) && board != 0 && struc.board != 0) {
             return QVariant();
         }
@@ -625,7 +638,7 @@ QString UAVObjectField::getTypeAsString()
 
 QStringList UAVObjectField::getElementNames()
 {
-    return elementNames;
+    return info->elementNames;
 }
 
 UAVObject *UAVObjectField::getObject()
@@ -649,22 +662,22 @@ void UAVObjectField::clear()
 
 QString UAVObjectField::getName()
 {
-    return name;
+    return info->name;
 }
 
 QString UAVObjectField::getDescription()
 {
-    return description;
+    return info->description;
 }
 
 QString UAVObjectField::getUnits()
 {
-    return units;
+    return info->units;
 }
 
 QStringList UAVObjectField::getOptions()
 {
-    return options;
+    return info->options;
 }
 
 quint32 UAVObjectField::getNumElements()
@@ -695,11 +708,11 @@ QString UAVObjectField::toString()
 {
     QString sout;
 
-    sout.append(QString("%1: [ ").arg(name));
+    sout.append(QString("%1: [ ").arg(info->name));
     for (unsigned int n = 0; n < numElements; ++n) {
         sout.append(QString("%1 ").arg(getDouble(n)));
     }
-    sout.append(QString("] %1\n").arg(units));
+    sout.append(QString("] %1\n").arg(info->units));
     return sout;
 }
 
@@ -770,63 +783,71 @@ qint32 UAVObjectField::pack(quint8 *dataOut)
 {
     QMutexLocker locker(obj->getMutex());
 
+    return pack(dataOut, data);
+}
+
+/**
+ * Pack the field from a buffer laid out like the object data, without locking
+ */
+qint32 UAVObjectField::pack(quint8 *dataOut, const quint8 *objData)
+{
     // Pack each element in output buffer
     switch (type) {
     case INT8:
-        memcpy(dataOut, &data[offset], numElements);
+        memcpy(dataOut, &objData[offset], numElements);
         break;
     case INT16:
         for (quint32 index = 0; index < numElements; ++index) {
             qint16 value;
-            memcpy(&value, &data[offset + numBytesPerElement * index], numBytesPerElement);
+            memcpy(&value, &objData[offset + numBytesPerElement * index], numBytesPerElement);
             qToLittleEndian<qint16>(value, &dataOut[numBytesPerElement * index]);
         }
         break;
     case INT32:
         for (quint32 index = 0; index < numElements; ++index) {
             qint32 value;
-            memcpy(&value, &data[offset + numBytesPerElement * index], numBytesPerElement);
+            memcpy(&value, &objData[offset + numBytesPerElement * index], numBytesPerElement);
             qToLittleEndian<qint32>(value, &dataOut[numBytesPerElement * index]);
         }
         break;
     case UINT8:
         for (quint32 index = 0; index < numElements; ++index) {
-            dataOut[numBytesPerElement * index] = data[offset + numBytesPerElement * index];
+            dataOut[numBytesPerElement * index] = objData[offset + numBytesPerElement * index];
         }
         break;
     case UINT16:
         for (quint32 index = 0; index < numElements; ++index) {
             quint16 value;
-            memcpy(&value, &data[offset + numBytesPerElement * index], numBytesPerElement);
+            memcpy(&value, &objData[offset + numBytesPerElement * index], numBytesPerElement);
             qToLittleEndian<quint16>(value, &dataOut[numBytesPerElement * index]);
         }
         break;
     case UINT32:
         for (quint32 index = 0; index < numElements; ++index) {
             quint32 value;
-            memcpy(&value, &data[offset + numBytesPerElement * index], numBytesPerElement);
+            memcpy(&value, &objData[offset + numBytesPerElement * index], numBytesPerElement);
             qToLittleEndian<quint32>(value, &dataOut[numBytesPerElement * index]);
         }
         break;
     case FLOAT32:
         for (quint32 index = 0; index < numElements; ++index) {
             quint32 value;
-            memcpy(&value, &data[offset + numBytesPerElement * index], numBytesPerElement);
+            memcpy(&value, &objData[offset + numBytesPerElement * index], numBytesPerElement);
             qToLittleEndian<quint32>(value, &dataOut[numBytesPerElement * index]);
         }
         break;
     case ENUM:
         for (quint32 index = 0; index < numElements; ++index) {
-            dataOut[numBytesPerElement * index] = data[offset + numBytesPerElement * index];
+            dataOut[numBytesPerElement * index] = objData[offset + numBytesPerElement * index];
         }
         break;
     case BITFIELD:
         for (quint32 index = 0; index < (quint32)(1 + (numElements - 1) / 8); ++index) {
-            dataOut[numBytesPerElement * index] = data[offset + numBytesPerElement * index];
+            dataOut[numBytesPerElement * index] = objData[offset + numBytesPerElement * index];
         }
         break;
     case STRING:
-        memcpy(dataOut, &data[offset], numElements);
+        memcpy(dataOut, &objData[offset], numElements);
         break;
     }
     // Done
@@ -837,63 +858,71 @@ qint32 UAVObjectField::unpack(const quint8 *dataIn)
 {
     QMutexLocker locker(obj->getMutex());
 
+    return unpack(dataIn, data);
+}
+
+/**
+ * Unpack the field into a buffer laid out like the object data, without locking
+ */
+qint32 UAVObjectField::unpack(const quint8 *dataIn, quint8 *objData)
+{
     // Unpack each element from input buffer
     switch (type) {
     case INT8:
-        memcpy(&data[offset], dataIn, numElements);
+        memcpy(&objData[offset], dataIn, numElements);
         break;
     case INT16:
         for (quint32 index = 0; index < numElements; ++index) {
             qint16 value;
             value = qFromLittleEndian<qint16>(&dataIn[numBytesPerElement * index]);
-            memcpy(&data[offset + numBytesPerElement * index], &value, numBytesPerElement);
+            memcpy(&objData[offset + numBytesPerElement * index], &value, numBytesPerElement);
         }
         break;
     case INT32:
         for (quint32 index = 0; index < numElements; ++index) {
             qint32 value;
             value = qFromLittleEndian<qint32>(&dataIn[numBytesPerElement * index]);
-            memcpy(&data[offset + numBytesPerElement * index], &value, numBytesPerElement);
+            memcpy(&objData[offset + numBytesPerElement * index], &value, numBytesPerElement);
         }
         break;
     case UINT8:
         for (quint32 index = 0; index < numElements; ++index) {
-            data[offset + numBytesPerElement * index] = dataIn[numBytesPerElement * index];
+            objData[offset + numBytesPerElement * index] = dataIn[numBytesPerElement * index];
         }
         break;
     case UINT16:
         for (quint32 index = 0; index < numElements; ++index) {
             quint16 value;
             value = qFromLittleEndian<quint16>(&dataIn[numBytesPerElement * index]);
-            memcpy(&data[offset + numBytesPerElement * index], &value, numBytesPerElement);
+            memcpy(&objData[offset + numBytesPerElement * index], &value, numBytesPerElement);
         }
         break;
     case UINT32:
         for (quint32 index = 0; index < numElements; ++index) {
             quint32 value;
             value = qFromLittleEndian<quint32>(&dataIn[numBytesPerElement * index]);
-            memcpy(&data[offset + numBytesPerElement * index], &value, numBytesPerElement);
+            memcpy(&objData[offset + numBytesPerElement * index], &value, numBytesPerElement);
         }
         break;
     case FLOAT32:
         for (quint32 index = 0; index < numElements; ++index) {
             quint32 value;
             value = qFromLittleEndian<quint32>(&dataIn[numBytesPerElement * index]);
-            memcpy(&data[offset + numBytesPerElement * index], &value, numBytesPerElement);
+            memcpy(&objData[offset + numBytesPerElement * index], &value, numBytesPerElement);
         }
         break;
     case ENUM:
         for (quint32 index = 0; index < numElements; ++index) {
-            data[offset + numBytesPerElement * index] = dataIn[numBytesPerElement * index];
+            objData[offset + numBytesPerElement * index] = dataIn[numBytesPerElement * index];
         }
         break;
     case BITFIELD:
         for (quint32 index = 0; index < (quint32)(1 + (numElements - 1) / 8); ++index) {
-            data[offset + numBytesPerElement * index] = dataIn[numBytesPerElement * index];
+            objData[offset + numBytesPerElement * index] = dataIn[numBytesPerElement * index];
         }
         break;
     case STRING:
-        memcpy(&data[offset], dataIn, numElements);
+        memcpy(&objData[offset], dataIn, numElements);
         break;
     }
     // Done
@@ -1019,11 +1048,11 @@ QVariant UAVObjectField::getValue(quint32 index)
     {
         quint8 tmpenum;
         memcpy(&tmpenum, &data[offset + numBytesPerElement * index], numBytesPerElement);
-        if (tmpenum >= options.length()) {
-            qDebug() << "Invalid value for" << name;
+        if (tmpenum >= info->options.length()) {
+            qDebug() << "Invalid value for" << info->name;
             tmpenum = 0;
         }
-        return QVariant(options[tmpenum]);
+        return QVariant(info->options[tmpenum]);
 
         break;
     }
@@ -1076,7 +1105,7 @@ bool UAVObjectField::checkValue(const QVariant & value, quint32 index)
             break;
         case ENUM:
         {
-            qint8 tmpenum = options.indexOf(value.toString());
+            qint8 tmpenum = info->options.indexOf(value.toString());
             return (tmpenum < 0) ? false : true;
 
             break;
@@ -1147,7 +1176,7 @@ void UAVObjectField::setValue(const QVariant & value, quint32 index)
         }
         case ENUM:
         {
-            qint8 tmpenum = options.indexOf(value.toString());
+            qint8 tmpenum = info->options.indexOf(value.toString());
             // Default to 0 on invalid values.
             if (tmpenum < 0) {
                 tmpenum = 0;
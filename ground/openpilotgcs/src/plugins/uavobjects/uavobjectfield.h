@@ -34,14 +34,25 @@
 #include <QVariant>
 #include <QList>
 #include <QMap>
+#include <QSharedPointer>
 #include <QXmlStreamWriter>
 #include <QXmlStreamReader>
 #include <QJsonObject>
+#include <QCoreApplication>
 
 class UAVObject;
+class UAVObjectFieldInfo;
 
-class UAVOBJECTS_EXPORT UAVObjectField : public QObject {
-    Q_OBJECT
+typedef QSharedPointer<const UAVObjectFieldInfo> UAVObjectFieldInfoPtr;
+
+/**
+ * View of one field of an object instance: the shared UAVObjectFieldInfo plus
+ * where the field sits in the instance data. Not a QObject, an object has
+ * hundreds of fields and none of them emits signals, UAVObject does that.
+ */
+class UAVOBJECTS_EXPORT UAVObjectField {
+    Q_DECLARE_TR_FUNCTIONS(UAVObjectField)
+    Q_DISABLE_COPY(UAVObjectField)
 
 public:
     typedef enum { INT8 = 0, INT16, INT32, UINT8, UINT16, UINT32, FLOAT32, ENUM, BITFIELD, STRING } FieldType;
@@ -54,6 +65,7 @@ public:
 
     UAVObjectField(const QString & name, const QString & description, const QString & units, FieldType type, quint32 numElements, const QStringList & options, const QString & limits = QString());
     UAVObjectField(const QString & name, const QString & description, const QString & units, FieldType type, const QStringList & elementNames, const QStringList & options, const QString & limits = QString());
+    UAVObjectField(const UAVObjectFieldInfoPtr & info);
     void initialize(quint8 *data, quint32 dataOffset, UAVObject *obj);
     UAVObject *getObject();
     FieldType getType();
@@ -66,6 +78,8 @@ public:
     QStringList getOptions();
     qint32 pack(quint8 *dataOut);
     qint32 unpack(const quint8 *dataIn);
+    qint32 pack(quint8 *dataOut, const quint8 *objData);
+    qint32 unpack(const quint8 *dataIn, quint8 *objData);
     QVariant getValue(quint32 index = 0);
     bool checkValue(const QVariant & data, quint32 index = 0);
     void setValue(const QVariant & data, quint32 index = 0);
@@ -88,24 +102,41 @@ public:
     QString getLimitsAsString(quint32 index, int board = 0);
     QVariant getMaxLimit(quint32 index, int board = 0);
     QVariant getMinLimit(quint32 index, int board = 0);
-signals:
-    void fieldUpdated(UAVObjectField *field);
 
 protected:
-    QString name;
-    QString description;
-    QString units;
+    // Shared with the same field of every other instance of the object,
+    // type and sizes are copied out as pack/unpack need them all the time
+    UAVObjectFieldInfoPtr info;
     FieldType type;
-    QStringList elementNames;
-    QStringList options;
     quint32 numElements;
     quint32 numBytesPerElement;
     quint32 offset;
     quint8 *data;
     UAVObject *obj;
-    QMap<quint32, QList<LimitStruct> > elementLimits;
     void clear();
-    void constructorInitialize(const QString & name, const QString & description, const QString & units, FieldType type, const QStringList & elementNames, const QStringList & options, const QString &limits);
+    void constructorInitialize(const UAVObjectFieldInfoPtr & info);
+};
+
+/**
+ * Everything about a field that does not depend on the instance: names,
+ * options and the parsed limits. The generated objects build one per field
+ * and object type, instances and clones only add their data pointer.
+ */
+class UAVOBJECTS_EXPORT UAVObjectFieldInfo {
+public:
+    UAVObjectFieldInfo(const QString & name, const QString & description, const QString & units, UAVObjectField::FieldType type, const QStringList & elementNames, const QStringList & options, const QString & limits = QString());
+
+    QString name;
+    QString description;
+    QString units;
+    UAVObjectField::FieldType type;
+    QStringList elementNames;
+    QStringList options;
+    quint32 numElements;
+    quint32 numBytesPerElement;
+    QMap<quint32, QList<UAVObjectField::LimitStruct> > elementLimits;
+
+private:
     void limitsInitialize(const QString &limits);
 };
 
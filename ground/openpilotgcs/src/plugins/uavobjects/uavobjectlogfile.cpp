@@ -0,0 +1,167 @@
+/**
+ ******************************************************************************
+ *
+ * @file       uavobjectlogfile.cpp
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2014.
+ * @see        The GNU Public License (GPL) Version 3
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup UAVObjectsPlugin UAVObjects Plugin
+ * @{
+ * @brief      The UAVUObjects GCS plugin
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+#include "uavobjectlogfile.h"
+
+#include <QtEndian>
+#include <utils/crc.h>
+
+// Log record: timestamp(4), size(8)
+#define RECORD_HEADER_LENGTH 12
+// Same sanity limit as the replay in LogFile
+#define MAX_RECORD_LENGTH    (1024 * 1024)
+
+// UAVTalk packet: sync(1), type(1), length(2), object ID(4), instance ID(2), data, checksum(1)
+#define SYNC_VAL             0x3C
+#define TYPE_OBJ             0x20
+#define TYPE_OBJ_ACK         0x22
+#define HEADER_LENGTH        10
+#define CHECKSUM_LENGTH      1
+
+using namespace Utils;
+
+UAVObjectLogFile::UAVObjectLogFile() : m_data(0), m_size(0), m_invalid(0)
+{}
+
+UAVObjectLogFile::~UAVObjectLogFile()
+{
+    close();
+}
+
+/**
+ * Map and index a log
+ * \return false if the file could not be mapped, a truncated or corrupted
+ * tail only ends the index
+ */
+bool UAVObjectLogFile::open(const QString & fileName)
+{
+    close();
+    m_errorString.clear();
+
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_errorString = m_file.errorString();
+        return false;
+    }
+    m_size = m_file.size();
+    if (m_size > 0) {
+        m_data = m_file.map(0, m_size);
+        if (!m_data) {
+            m_errorString = m_file.errorString();
+            close();
+            return false;
+        }
+    }
+    return index();
+}
+
+void UAVObjectLogFile::close()
+{
+    if (m_data) {
+        m_file.unmap(const_cast<uchar *>(m_data));
+        m_data = 0;
+    }
+    m_file.close();
+    m_size    = 0;
+    m_invalid = 0;
+    m_records.clear();
+}
+
+QString UAVObjectLogFile::errorString() const
+{
+    return m_errorString;
+}
+
+qint64 UAVObjectLogFile::size() const
+{
+    return m_size;
+}
+
+/**
+ * The object updates in the order they were logged
+ */
+const QVector<UAVObjectLogFile::Record> &UAVObjectLogFile::records() const
+{
+    return m_records;
+}
+
+/**
+ * Number of packets dropped for a bad header or checksum
+ */
+int UAVObjectLogFile::numInvalid() const
+{
+    return m_invalid;
+}
+
+bool UAVObjectLogFile::index()
+{
+    // one small object per record is the common case
+    m_records.reserve(m_size / (RECORD_HEADER_LENGTH + HEADER_LENGTH + 16));
+
+    qint64 pos = 0;
+    while (pos + RECORD_HEADER_LENGTH <= m_size) {
+        const quint8 *record = m_data + pos;
+        quint32 timestamp    = qFromLittleEndian<quint32>(record);
+        qint64 length = qFromLittleEndian<qint64>(record + 4);
+
+        if (length < 1 || length > MAX_RECORD_LENGTH || pos + RECORD_HEADER_LENGTH + length > m_size) {
+            // the replay stops here too
+            if (length < 1 || length > MAX_RECORD_LENGTH) {
+                m_errorString = QString("unlikely record size %1 at %2").arg(length).arg(pos);
+            } else {
+                m_errorString = QString("truncated record at %1").arg(pos);
+            }
+            break;
+        }
+        const quint8 *packet = record + RECORD_HEADER_LENGTH;
+        pos += RECORD_HEADER_LENGTH + length;
+
+        // Only object updates carry data, requests and acks are skipped
+        if (length < HEADER_LENGTH + CHECKSUM_LENGTH || packet[0] != SYNC_VAL) {
+            m_invalid++;
+            continue;
+        }
+        if (packet[1] != TYPE_OBJ && packet[1] != TYPE_OBJ_ACK) {
+            continue;
+        }
+        quint16 packetLength = qFromLittleEndian<quint16>(packet + 2);
+        if (packetLength < HEADER_LENGTH || packetLength + CHECKSUM_LENGTH != length
+            || Crc::updateCRC(0, packet, packetLength) != packet[packetLength]) {
+            m_invalid++;
+            continue;
+        }
+
+        Record rec;
+        rec.timestamp = timestamp;
+        rec.objId     = qFromLittleEndian<quint32>(packet + 4);
+        rec.instId    = qFromLittleEndian<quint16>(packet + 8);
+        rec.length    = packetLength - HEADER_LENGTH;
+        rec.offset    = (packet - m_data) + HEADER_LENGTH;
+        m_records.append(rec);
+    }
+    return true;
+}
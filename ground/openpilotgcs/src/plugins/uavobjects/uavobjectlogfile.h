@@ -0,0 +1,80 @@
+/**
+ ******************************************************************************
+ *
+ * @file       uavobjectlogfile.h
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2014.
+ * @see        The GNU Public License (GPL) Version 3
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup UAVObjectsPlugin UAVObjects Plugin
+ * @{
+ * @brief      The UAVUObjects GCS plugin
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+#ifndef UAVOBJECTLOGFILE_H
+#define UAVOBJECTLOGFILE_H
+
+#include "uavobjects_global.h"
+#include <QFile>
+#include <QString>
+#include <QVector>
+
+/**
+ * Read only, memory mapped view of an .opl log as written by LogFile:
+ * a sequence of timestamp(4), size(8), UAVTalk packet(size) records.
+ * open() indexes the object updates in one pass without copying or
+ * unpacking anything, the object data stays in the mapped file.
+ */
+class UAVOBJECTS_EXPORT UAVObjectLogFile {
+public:
+    typedef struct {
+        quint32 timestamp; // [ms] as logged
+        quint32 objId;
+        quint16 instId;
+        quint16 length; // of the object data
+        qint64  offset; // of the object data in the file
+    } Record;
+
+    UAVObjectLogFile();
+    ~UAVObjectLogFile();
+
+    bool open(const QString & fileName);
+    void close();
+    QString errorString() const;
+
+    qint64 size() const;
+    const QVector<Record> &records() const;
+    const quint8 *recordData(const Record & record) const
+    {
+        return m_data + record.offset;
+    }
+    int numInvalid() const;
+
+private:
+    Q_DISABLE_COPY(UAVObjectLogFile)
+
+    bool index();
+
+    QFile m_file;
+    const quint8 *m_data;
+    qint64 m_size;
+    QVector<Record> m_records;
+    int m_invalid;
+    QString m_errorString;
+};
+
+#endif // UAVOBJECTLOGFILE_H
@@ -14,14 +14,18 @@ HEADERS += \
     uavdataobject.h \
     uavobjectfield.h \
     uavobjectsinit.h \
-    uavobjectsplugin.h
+    uavobjectsplugin.h \
+    uavobjectlogfile.h \
+    uavobjectcolumnlog.h
 SOURCES += \
     uavobject.cpp \
     uavmetaobject.cpp \
     uavobjectmanager.cpp \
     uavdataobject.cpp \
     uavobjectfield.cpp \
-    uavobjectsplugin.cpp
+    uavobjectsplugin.cpp \
+    uavobjectlogfile.cpp \
+    uavobjectcolumnlog.cpp
 
 OTHER_FILES += UAVObjects.pluginspec
 
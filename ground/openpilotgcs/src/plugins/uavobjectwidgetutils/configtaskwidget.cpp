@@ -33,9 +33,17 @@
 #include <QLineEdit>
 #include <QToolButton>
 
+// Object updates arriving within one frame are merged into a single refresh
+#define REFRESH_BATCH_INTERVAL 16
+
 ConfigTaskWidget::ConfigTaskWidget(QWidget *parent) : QWidget(parent), m_currentBoardId(-1), m_isConnected(false), m_isWidgetUpdatesAllowed(true),
     m_saveButton(NULL), m_isDirty(false), m_outOfLimitsStyle("background-color: rgb(255, 0, 0);"), m_realtimeUpdateTimer(NULL)
 {
+    m_refreshTimer = new QTimer(this);
+    m_refreshTimer->setSingleShot(true);
+    m_refreshTimer->setInterval(REFRESH_BATCH_INTERVAL);
+    connect(m_refreshTimer, SIGNAL(timeout()), this, SLOT(refreshPendingWidgetsValues()));
+
     m_pluginManager     = ExtensionSystem::PluginManager::instance();
     TelemetryManager *telMngr = m_pluginManager->getObject<TelemetryManager>();
     m_objectUtilManager = m_pluginManager->getObject<UAVObjectUtilManager>();
@@ -134,7 +142,7 @@ void ConfigTaskWidget::doAddWidgetBinding(QString objectName, QString fieldName,
         Q_ASSERT(object);
         m_updatedObjects.insert(object, true);
         connect(object, SIGNAL(objectUpdated(UAVObject *)), this, SLOT(objectUpdated(UAVObject *)));
-        connect(object, SIGNAL(objectUpdated(UAVObject *)), this, SLOT(refreshWidgetsValues(UAVObject *)), Qt::UniqueConnection);
+        connect(object, SIGNAL(objectUpdated(UAVObject *)), this, SLOT(scheduleRefreshWidgetsValues(UAVObject *)), Qt::UniqueConnection);
     }
 
     if (!fieldName.isEmpty() && object) {
@@ -334,7 +342,7 @@ void ConfigTaskWidget::refreshWidgetsValues(UAVObject *obj)
     QList<WidgetBinding *> bindings = obj == NULL ? m_widgetBindingsPerObject.values() : m_widgetBindingsPerObject.values(obj);
     foreach(WidgetBinding * binding, bindings) {
         if (binding->field() != NULL && binding->widget() != NULL) {
-            if (binding->isEnabled()) {
+            if (binding->isEnabled() && !isRefreshDeferredWhileHidden(binding)) {
                 setWidgetFromField(binding->widget(), binding->field(), binding);
             } else {
                 binding->updateValueFromObjectField();
@@ -344,6 +352,62 @@ void ConfigTaskWidget::refreshWidgetsValues(UAVObject *obj)
     setDirty(dirtyBack);
 }
 
+/**
+ * Streaming data objects (receiver activity, actuator commands) only need
+ * their widgets set while the user can see them. Their binding value is kept
+ * current and the widget is set when it is shown, see eventFilter().
+ * Settings objects are always refreshed, pages read those widgets back.
+ */
+bool ConfigTaskWidget::isRefreshDeferredWhileHidden(WidgetBinding *binding)
+{
+    UAVDataObject *object = qobject_cast<UAVDataObject *>(binding->object());
+
+    if (!object || object->isSettingsObject() || binding->widget()->isVisible()) {
+        return false;
+    }
+    if (!m_hiddenBindings.contains(binding)) {
+        m_hiddenBindings.insert(binding);
+        binding->widget()->installEventFilter(this);
+    }
+    return true;
+}
+
+void ConfigTaskWidget::refreshHiddenBindings(QWidget *widget)
+{
+    bool dirtyBack = isDirty();
+
+    foreach(WidgetBinding * binding, m_widgetBindingsPerWidget.values(widget)) {
+        if (binding->widget() == widget && m_hiddenBindings.remove(binding) && binding->isEnabled()) {
+            setWidgetFromField(binding->widget(), binding->field(), binding);
+        }
+    }
+    setDirty(dirtyBack);
+}
+
+/**
+ * Queues a refresh for an updated object, the refreshes of everything updated
+ * within REFRESH_BATCH_INTERVAL run together and once per object
+ */
+void ConfigTaskWidget::scheduleRefreshWidgetsValues(UAVObject *object)
+{
+    if (!m_pendingRefreshObjects.contains(object)) {
+        m_pendingRefreshObjects.append(object);
+    }
+    if (!m_refreshTimer->isActive()) {
+        m_refreshTimer->start();
+    }
+}
+
+void ConfigTaskWidget::refreshPendingWidgetsValues()
+{
+    m_refreshTimer->stop();
+    QList<UAVObject *> objects = m_pendingRefreshObjects;
+    m_pendingRefreshObjects.clear();
+    foreach(UAVObject * object, objects) {
+        refreshWidgetsValues(object);
+    }
+}
+
 void ConfigTaskWidget::updateObjectsFromWidgets()
 {
     emit updateObjectsFromWidgetsRequested();
@@ -511,10 +575,13 @@ bool ConfigTaskWidget::isDirty()
 
 void ConfigTaskWidget::disableObjectUpdates()
 {
+    // show what was received so far, the operation that disables the
+    // updates reads the widgets back
+    refreshPendingWidgetsValues();
     m_isWidgetUpdatesAllowed = false;
     foreach(WidgetBinding * binding, m_widgetBindingsPerWidget) {
         if (binding->object()) {
-            disconnect(binding->object(), SIGNAL(objectUpdated(UAVObject *)), this, SLOT(refreshWidgetsValues(UAVObject *)));
+            disconnect(binding->object(), SIGNAL(objectUpdated(UAVObject *)), this, SLOT(scheduleRefreshWidgetsValues(UAVObject *)));
         }
     }
 }
@@ -524,7 +591,7 @@ void ConfigTaskWidget::enableObjectUpdates()
     m_isWidgetUpdatesAllowed = true;
     foreach(WidgetBinding * binding, m_widgetBindingsPerWidget) {
         if (binding->object()) {
-            connect(binding->object(), SIGNAL(objectUpdated(UAVObject *)), this, SLOT(refreshWidgetsValues(UAVObject *)), Qt::UniqueConnection);
+            connect(binding->object(), SIGNAL(objectUpdated(UAVObject *)), this, SLOT(scheduleRefreshWidgetsValues(UAVObject *)), Qt::UniqueConnection);
         }
     }
 }
@@ -1118,6 +1185,10 @@ void ConfigTaskWidget::disableMouseWheelEvents()
 
 bool ConfigTaskWidget::eventFilter(QObject *obj, QEvent *evt)
 {
+    // Catch up on the refreshes skipped while the widget was hidden
+    if (evt->type() == QEvent::Show && !m_hiddenBindings.isEmpty()) {
+        refreshHiddenBindings(qobject_cast<QWidget *>(obj));
+    }
     // Filter all wheel events, and ignore them
     if (evt->type() == QEvent::Wheel &&
         (qobject_cast<QAbstractSpinBox *>(obj) ||
@@ -32,6 +32,8 @@
 #include "uavobject.h"
 #include "uavobjectutilmanager.h"
 #include <QQueue>
+#include <QTimer>
+#include <QSet>
 #include <QWidget>
 #include <QList>
 #include <QLabel>
@@ -187,6 +189,8 @@ private slots:
     void objectUpdated(UAVObject *object);
     void defaultButtonClicked();
     void reloadButtonClicked();
+    void scheduleRefreshWidgetsValues(UAVObject *object);
+    void refreshPendingWidgetsValues();
 
 private:
     struct objectComparator {
@@ -230,6 +234,15 @@ private:
     QString m_outOfLimitsStyle;
     QTimer *m_realtimeUpdateTimer;
 
+    // objects updated since the last batched refresh, in update order
+    QList<UAVObject *> m_pendingRefreshObjects;
+    QTimer *m_refreshTimer;
+    // bindings to data objects that were not refreshed while their widget was hidden
+    QSet<WidgetBinding *> m_hiddenBindings;
+
+    bool isRefreshDeferredWhileHidden(WidgetBinding *binding);
+    void refreshHiddenBindings(QWidget *widget);
+
     bool setWidgetFromField(QWidget *widget, UAVObjectField *field, WidgetBinding *binding);
 
     QVariant getVariantFromWidget(QWidget *widget, WidgetBinding *binding);
@@ -31,6 +31,7 @@
 #include <QTime>
 #include <QtGlobal>
 #include <stdlib.h>
+#include <algorithm>
 #include <QDebug>
 
 /**
@@ -40,6 +41,12 @@ Telemetry::Telemetry(UAVTalk *utalk, UAVObjectManager *objMngr) : objMngr(objMng
 {
     mutex = new QMutex(QMutex::Recursive);
 
+    // Setup the periodic timer before objects get scheduled
+    updateClock.start();
+    updateTimer = new QTimer(this);
+    updateTimer->setSingleShot(true);
+    connect(updateTimer, SIGNAL(timeout()), this, SLOT(processPeriodicUpdates()));
+
     // Register all objects in the list
     foreach(QList<UAVObject *> instances, objMngr->getObjects()) {
         foreach(UAVObject * object, instances) {
@@ -63,11 +70,8 @@ Telemetry::Telemetry(UAVTalk *utalk, UAVObjectManager *objMngr) : objMngr(objMng
     // Get GCS stats object
     gcsStatsObj = GCSTelemetryStats::GetInstance(objMngr);
 
-    // Setup and start the periodic timer
-    timeToNextUpdateMs = 0;
-    updateTimer = new QTimer(this);
-    connect(updateTimer, SIGNAL(timeout()), this, SLOT(processPeriodicUpdates()));
-    updateTimer->start(1000);
+    // Start the periodic timer
+    restartUpdateTimer();
 
     // Setup and start the stats timer
     txErrors  = 0;
@@ -103,19 +107,18 @@ void Telemetry::registerObject(UAVObject *obj)
 void Telemetry::addObject(UAVObject *obj)
 {
     // Check if object type is already in the list
-    for (int n = 0; n < objList.length(); ++n) {
-        if (objList[n].obj->getObjID() == obj->getObjID()) {
-            // Object type (not instance!) is already in the list, do nothing
-            return;
-        }
+    if (objTimeInfo.contains(obj->getObjID())) {
+        // Object type (not instance!) is already in the list, do nothing
+        return;
     }
 
     // If this point is reached, then the object type is new, let's add it
     ObjectTimeInfo timeInfo;
     timeInfo.obj = obj;
-    timeInfo.timeToNextUpdateMs = 0;
-    timeInfo.updatePeriodMs     = 0;
-    objList.append(timeInfo);
+    timeInfo.updatePeriodMs = 0;
+    timeInfo.nextUpdateMs   = 0;
+    timeInfo.generation     = 0;
+    objTimeInfo.insert(obj->getObjID(), timeInfo);
 }
 
 /**
@@ -124,14 +127,57 @@ void Telemetry::addObject(UAVObject *obj)
 void Telemetry::setUpdatePeriod(UAVObject *obj, qint32 periodMs)
 {
     // Find object type (not instance!) and update its period
-    for (int n = 0; n < objList.length(); ++n) {
-        if (objList[n].obj->getObjID() == obj->getObjID()) {
-            objList[n].updatePeriodMs     = periodMs;
-            objList[n].timeToNextUpdateMs = quint32((float)periodMs * (float)qrand() / (float)RAND_MAX); // avoid bunching of updates
-        }
+    QHash<quint32, ObjectTimeInfo>::iterator info = objTimeInfo.find(obj->getObjID());
+
+    if (info == objTimeInfo.end() || info->updatePeriodMs == periodMs) {
+        // keep the current schedule if nothing changed
+        return;
+    }
+    info->updatePeriodMs = periodMs;
+    ++info->generation;
+    if (periodMs > 0) {
+        info->nextUpdateMs = updateClock.elapsed() + qint64((float)periodMs * (float)qrand() / (float)RAND_MAX); // avoid bunching of updates
+        scheduleUpdate(*info);
+        restartUpdateTimer();
     }
 }
 
+/**
+ * Push the next update of an object onto the timing heap
+ */
+void Telemetry::scheduleUpdate(const ObjectTimeInfo & info)
+{
+    ScheduledUpdate update;
+
+    update.dueMs      = info.nextUpdateMs;
+    update.objId      = info.obj->getObjID();
+    update.generation = info.generation;
+    updateHeap.append(update);
+    std::push_heap(updateHeap.begin(), updateHeap.end(), laterUpdate);
+}
+
+/**
+ * Heap ordering, the earliest update ends up at the front
+ */
+bool Telemetry::laterUpdate(const ScheduledUpdate & a, const ScheduledUpdate & b)
+{
+    return a.dueMs > b.dueMs;
+}
+
+/**
+ * Arm the update timer for the earliest pending update
+ */
+void Telemetry::restartUpdateTimer()
+{
+    qint32 delay = MAX_UPDATE_PERIOD_MS;
+
+    if (!updateHeap.isEmpty()) {
+        delay = qBound<qint64>(MIN_UPDATE_PERIOD_MS, updateHeap.first().dueMs - updateClock.elapsed(), MAX_UPDATE_PERIOD_MS);
+    }
+    // objects can be registered from other threads, the timer must be started from its own
+    QMetaObject::invokeMethod(updateTimer, "start", Qt::AutoConnection, Q_ARG(int, delay));
+}
+
 /**
  * Connect to all instances of an object depending on the event mask specified
  */
@@ -449,59 +495,41 @@ void Telemetry::processObjectQueue()
 }
 
 /**
- * Check is any objects are pending for periodic updates
- * TODO: Clean-up
+ * Send all objects whose periodic update is due, the timer is then
+ * rearmed for the next entry on the timing heap
  */
 void Telemetry::processPeriodicUpdates()
 {
     QMutexLocker locker(mutex);
 
-    // Stop timer
-    updateTimer->stop();
-
-    // Iterate through each object and update its timer, if zero then transmit object.
-    // Also calculate smallest delay to next update (will be used for setting timeToNextUpdateMs)
-    qint32 minDelay  = MAX_UPDATE_PERIOD_MS;
-    ObjectTimeInfo *objinfo;
-    qint32 elapsedMs = 0;
-    QTime time;
-    qint32 offset;
-    bool allInstances;
-    for (int n = 0; n < objList.length(); ++n) {
-        objinfo = &objList[n];
-        // If object is configured for periodic updates
-        if (objinfo->updatePeriodMs > 0) {
-            objinfo->timeToNextUpdateMs -= timeToNextUpdateMs;
-            // Check if time for the next update
-            if (objinfo->timeToNextUpdateMs <= 0) {
-                // Reset timer
-                offset = (-objinfo->timeToNextUpdateMs) % objinfo->updatePeriodMs;
-                objinfo->timeToNextUpdateMs = objinfo->updatePeriodMs - offset;
-                // Send object
-                time.start();
-                allInstances = !objinfo->obj->isSingleInstance();
-                processObjectUpdates(objinfo->obj, EV_UPDATED_PERIODIC, allInstances, false);
-                elapsedMs    = time.elapsed();
-                // Update timeToNextUpdateMs with the elapsed delay of sending the object;
-                timeToNextUpdateMs += elapsedMs;
-            }
-            // Update minimum delay
-            if (objinfo->timeToNextUpdateMs < minDelay) {
-                minDelay = objinfo->timeToNextUpdateMs;
-            }
+    qint64 now = updateClock.elapsed();
+
+    while (!updateHeap.isEmpty() && updateHeap.first().dueMs <= now) {
+        std::pop_heap(updateHeap.begin(), updateHeap.end(), laterUpdate);
+        ScheduledUpdate update = updateHeap.takeLast();
+
+        // Skip entries that were superseded by a period change
+        QHash<quint32, ObjectTimeInfo>::iterator info = objTimeInfo.find(update.objId);
+        if (info == objTimeInfo.end() || info->generation != update.generation || info->updatePeriodMs <= 0) {
+            continue;
         }
-    }
 
-    // Check if delay for the next update is too short
-    if (minDelay < MIN_UPDATE_PERIOD_MS) {
-        minDelay = MIN_UPDATE_PERIOD_MS;
-    }
+        // Stay on the period grid, skip the updates we were too late for
+        qint64 period = info->updatePeriodMs;
+        info->nextUpdateMs += period;
+        if (info->nextUpdateMs <= now) {
+            info->nextUpdateMs += ((now - info->nextUpdateMs) / period + 1) * period;
+        }
+        scheduleUpdate(*info);
 
-    // Done
-    timeToNextUpdateMs = minDelay;
+        // Send object
+        UAVObject *obj    = info->obj;
+        bool allInstances = !obj->isSingleInstance();
+        processObjectUpdates(obj, EV_UPDATED_PERIODIC, allInstances, false);
+        now = updateClock.elapsed();
+    }
 
-    // Restart timer
-    updateTimer->start(timeToNextUpdateMs);
+    restartUpdateTimer();
 }
 
 Telemetry::TelemetryStats Telemetry::getStats()
@@ -36,6 +36,9 @@
 #include <QTimer>
 #include <QQueue>
 #include <QMap>
+#include <QHash>
+#include <QVector>
+#include <QElapsedTimer>
 
 class ObjectTransactionInfo : public QObject {
     Q_OBJECT
@@ -103,9 +106,16 @@ private:
     typedef struct {
         UAVObject *obj;
         qint32    updatePeriodMs; /** Update period in ms or 0 if no periodic updates are needed */
-        qint32    timeToNextUpdateMs; /** Time delay to the next update */
+        qint64    nextUpdateMs; /** Time of the next update on updateClock */
+        quint32   generation; /** Incremented on every reschedule, invalidates older heap entries */
     } ObjectTimeInfo;
 
+    typedef struct {
+        qint64  dueMs;
+        quint32 objId;
+        quint32 generation;
+    } ScheduledUpdate;
+
     typedef struct {
         UAVObject *obj;
         EventMask event;
@@ -116,14 +126,15 @@ private:
     UAVObjectManager *objMngr;
     UAVTalk *utalk;
     GCSTelemetryStats *gcsStatsObj;
-    QList<ObjectTimeInfo> objList;
+    QHash<quint32, ObjectTimeInfo> objTimeInfo;
+    QVector<ScheduledUpdate> updateHeap; /** Min-heap on dueMs, stale entries are skipped when popped */
+    QElapsedTimer updateClock;
     QQueue<ObjectQueueInfo> objQueue;
     QQueue<ObjectQueueInfo> objPriorityQueue;
     QMap<quint32, QMap<quint32, ObjectTransactionInfo *> *> transMap;
     QMutex *mutex;
     QTimer *updateTimer;
     QTimer *statsTimer;
-    qint32 timeToNextUpdateMs;
     quint32 txErrors;
     quint32 txRetries;
 
@@ -131,6 +142,9 @@ private:
     void registerObject(UAVObject *obj);
     void addObject(UAVObject *obj);
     void setUpdatePeriod(UAVObject *obj, qint32 periodMs);
+    void scheduleUpdate(const ObjectTimeInfo & info);
+    void restartUpdateTimer();
+    static bool laterUpdate(const ScheduledUpdate & a, const ScheduledUpdate & b);
     void connectToObjectInstances(UAVObject *obj, quint32 eventMask);
     void connectToObject(UAVObject *obj, quint32 eventMask);
     void updateObject(UAVObject *obj, quint32 eventMask);
@@ -31,9 +31,17 @@
 #include <extensionsystem/pluginmanager.h>
 #include <coreplugin/icore.h>
 #include <coreplugin/threadmanager.h>
+#include <QMetaMethod>
+#include <QDebug>
+#include <algorithm>
 
-TelemetryManager::TelemetryManager() : m_connectionState(TELEMETRY_DISCONNECTED)
+TelemetryManager::TelemetryManager() : m_subscriptionLock(QMutex::Recursive), m_connectionState(TELEMETRY_DISCONNECTED)
 {
+    m_dispatchClock.start();
+    m_dispatchTimer = new QTimer(this);
+    m_dispatchTimer->setSingleShot(true);
+    connect(m_dispatchTimer, SIGNAL(timeout()), this, SLOT(dispatchPendingUpdates()));
+
     moveToThread(Core::ICore::instance()->threadManager()->getRealTimeThread());
     // Get UAVObjectManager instance
     ExtensionSystem::PluginManager *pm = ExtensionSystem::PluginManager::instance();
@@ -106,6 +114,9 @@ void TelemetryManager::onStart()
 
 void TelemetryManager::stop()
 {
+    // Give the flight side its own rates back while the link is still up
+    restoreFlightRates();
+
     m_connectionState = TELEMETRY_DISCONNECTING;
     emit disconnecting();
     emit myStop();
@@ -128,6 +139,15 @@ void TelemetryManager::onStop()
 void TelemetryManager::onConnect()
 {
     m_connectionState = TELEMETRY_CONNECTED;
+
+    // The metadata was just retrieved from the flight side, apply the subscribed rates on top of it.
+    // The saved metadata is kept: after a link loss the flight side may still run at the rates
+    // set during the previous connection, they must not become the new originals.
+    {
+        QMutexLocker locker(&m_subscriptionLock);
+        updateFlightRates();
+    }
+
     emit connected();
 }
 
@@ -142,6 +162,329 @@ void TelemetryManager::onTelemetryUpdate(double txRate, double rxRate)
     emit telemetryUpdated(txRate, rxRate);
 }
 
+/**
+ * Subscribe to updates of an object at a limited rate.
+ * The member is invoked with the object as argument at most once every minPeriodMs,
+ * updates that arrive in between are coalesced into one delivered at the end of the period.
+ * The flight side is asked to send periodic objects no faster than the fastest subscriber
+ * needs, but never faster than its own configured period.
+ * \param[in] obj the object instance to watch
+ * \param[in] subscriber receiver, the subscription ends when it is destroyed
+ * \param[in] member name of a slot or Q_INVOKABLE method taking a UAVObject *, or NULL to only
+ * declare the rate, for subscribers that get the data by other means such as property bindings
+ * \param[in] minPeriodMs minimum time between notifications, 0 for every update, those subscribers
+ * are connected straight to the object so that they get the update as soon as the object signals it
+ */
+void TelemetryManager::subscribe(UAVObject *obj, QObject *subscriber, const char *member, quint32 minPeriodMs)
+{
+    QMutexLocker locker(&m_subscriptionLock);
+
+    QList<Subscription> &subscriptions = m_subscriptions[obj];
+    for (int i = 0; i < subscriptions.size(); ++i) {
+        if (subscriptions[i].subscriber == subscriber) {
+            connectDirectly(obj, subscriptions[i], false);
+            subscriptions[i].member   = member;
+            subscriptions[i].periodMs = minPeriodMs;
+            connectDirectly(obj, subscriptions[i], true);
+            updateFlightRate(obj);
+            return;
+        }
+    }
+
+    Subscription subscription;
+    subscription.subscriber     = subscriber;
+    subscription.member         = member;
+    subscription.periodMs       = minPeriodMs;
+    subscription.nextDispatchMs = 0;
+    subscription.pending        = false;
+    subscriptions.append(subscription);
+    connectDirectly(obj, subscription, true);
+
+    connect(obj, SIGNAL(objectUpdated(UAVObject *)), this, SLOT(subscribedObjectUpdated(UAVObject *)), Qt::UniqueConnection);
+    // direct, so the subscription is gone before the subscriber is
+    connect(subscriber, SIGNAL(destroyed(QObject *)), this, SLOT(subscriberDestroyed(QObject *)),
+            Qt::ConnectionType(Qt::DirectConnection | Qt::UniqueConnection));
+
+    updateFlightRate(obj);
+}
+
+void TelemetryManager::unsubscribe(UAVObject *obj, QObject *subscriber)
+{
+    QMutexLocker locker(&m_subscriptionLock);
+
+    QHash<UAVObject *, QList<Subscription> >::iterator it = m_subscriptions.find(obj);
+    if (it == m_subscriptions.end()) {
+        return;
+    }
+    for (int i = it->size() - 1; i >= 0; --i) {
+        // QPointer is already cleared when called from the destroyed() signal
+        if ((*it)[i].subscriber == subscriber || (*it)[i].subscriber.isNull()) {
+            // a destroyed subscriber is disconnected already
+            if (!(*it)[i].subscriber.isNull()) {
+                connectDirectly(obj, (*it)[i], false);
+            }
+            it->removeAt(i);
+        }
+    }
+    if (it->isEmpty()) {
+        m_subscriptions.erase(it);
+        disconnect(obj, SIGNAL(objectUpdated(UAVObject *)), this, SLOT(subscribedObjectUpdated(UAVObject *)));
+    }
+    updateFlightRate(obj);
+}
+
+void TelemetryManager::subscriberDestroyed(QObject *subscriber)
+{
+    QMutexLocker locker(&m_subscriptionLock);
+
+    foreach(UAVObject * obj, m_subscriptions.keys()) {
+        unsubscribe(obj, subscriber);
+    }
+    releaseFlightRates(subscriber);
+}
+
+/**
+ * Keep the flight side at its own rates for all objects.
+ * Consumers that take every update without subscribing, like logging,
+ * would otherwise only get the rate the subscribers asked for.
+ * \param[in] consumer holder of the rates, released when it is destroyed
+ */
+void TelemetryManager::holdFlightRates(QObject *consumer)
+{
+    QMutexLocker locker(&m_subscriptionLock);
+
+    if (m_rateHolders.contains(consumer)) {
+        return;
+    }
+    m_rateHolders.append(consumer);
+    connect(consumer, SIGNAL(destroyed(QObject *)), this, SLOT(subscriberDestroyed(QObject *)),
+            Qt::ConnectionType(Qt::DirectConnection | Qt::UniqueConnection));
+    updateFlightRates();
+}
+
+void TelemetryManager::releaseFlightRates(QObject *consumer)
+{
+    QMutexLocker locker(&m_subscriptionLock);
+
+    if (m_rateHolders.removeAll(consumer) > 0) {
+        updateFlightRates();
+    }
+}
+
+/**
+ * Send the original rates of all objects whose rate subscriptions changed to the flight side.
+ * Called on disconnection and shutdown. The metadata is sent from the telemetry thread, the
+ * request is queued there without waiting for it: stop() queues the stop request behind it,
+ * so the metadata is still sent before the link is torn down.
+ */
+void TelemetryManager::restoreFlightRates()
+{
+    if (!isConnected()) {
+        // kept for the next connection
+        return;
+    }
+    QMetaObject::invokeMethod(this, "onRestoreFlightRates", Qt::AutoConnection);
+}
+
+void TelemetryManager::onRestoreFlightRates()
+{
+    QMutexLocker locker(&m_subscriptionLock);
+
+    foreach(quint32 objId, m_savedMetadata.keys()) {
+        UAVObject *obj = m_uavobjectManager->getObject(objId);
+        if (obj) {
+            obj->setMetadata(m_savedMetadata.value(objId));
+        }
+    }
+    m_savedMetadata.clear();
+}
+
+void TelemetryManager::subscribedObjectUpdated(UAVObject *obj)
+{
+    QMutexLocker locker(&m_subscriptionLock);
+
+    QHash<UAVObject *, QList<Subscription> >::iterator it = m_subscriptions.find(obj);
+    if (it == m_subscriptions.end()) {
+        return;
+    }
+
+    qint64 now = m_dispatchClock.elapsed();
+    bool scheduled = false;
+    for (int i = 0; i < it->size(); ++i) {
+        Subscription &subscription = (*it)[i];
+        if (subscription.member.isEmpty() || subscription.periodMs == 0) {
+            // only declares a rate, or connected to the object directly
+            continue;
+        }
+        if (now >= subscription.nextDispatchMs) {
+            dispatch(obj, subscription, now);
+        } else if (!subscription.pending) {
+            // too early, deliver the latest data once the period is over
+            subscription.pending = true;
+            PendingDispatch pending;
+            pending.dueMs      = subscription.nextDispatchMs;
+            pending.obj        = obj;
+            pending.subscriber = subscription.subscriber;
+            m_dispatchHeap.append(pending);
+            std::push_heap(m_dispatchHeap.begin(), m_dispatchHeap.end(), laterDispatch);
+            scheduled = true;
+        }
+    }
+    if (scheduled) {
+        restartDispatchTimer();
+    }
+}
+
+/**
+ * Deliver all coalesced updates whose rate limit expired
+ */
+void TelemetryManager::dispatchPendingUpdates()
+{
+    QMutexLocker locker(&m_subscriptionLock);
+
+    qint64 now = m_dispatchClock.elapsed();
+
+    while (!m_dispatchHeap.isEmpty() && m_dispatchHeap.first().dueMs <= now) {
+        std::pop_heap(m_dispatchHeap.begin(), m_dispatchHeap.end(), laterDispatch);
+        PendingDispatch pending = m_dispatchHeap.takeLast();
+
+        // the subscription may be gone by now
+        QHash<UAVObject *, QList<Subscription> >::iterator it = m_subscriptions.find(pending.obj);
+        if (it == m_subscriptions.end()) {
+            continue;
+        }
+        for (int i = 0; i < it->size(); ++i) {
+            Subscription &subscription = (*it)[i];
+            if (subscription.subscriber == pending.subscriber && subscription.pending) {
+                dispatch(pending.obj, subscription, now);
+                break;
+            }
+        }
+    }
+
+    restartDispatchTimer();
+}
+
+bool TelemetryManager::laterDispatch(const PendingDispatch & a, const PendingDispatch & b)
+{
+    return a.dueMs > b.dueMs;
+}
+
+void TelemetryManager::dispatch(UAVObject *obj, Subscription & subscription, qint64 now)
+{
+    subscription.pending = false;
+    subscription.nextDispatchMs = now + subscription.periodMs;
+    if (subscription.subscriber.isNull()) {
+        return;
+    }
+    QMetaObject::invokeMethod(subscription.subscriber, subscription.member.constData(), Qt::AutoConnection, Q_ARG(UAVObject *, obj));
+}
+
+/**
+ * Connect or disconnect a subscriber that takes every update straight to the object's updated signal.
+ * Going through subscribedObjectUpdated() would queue the update twice, once to the telemetry
+ * thread and once to the subscriber, and the subscriber would read data that is newer than
+ * the update it was notified for.
+ */
+void TelemetryManager::connectDirectly(UAVObject *obj, const Subscription & subscription, bool connected)
+{
+    if (subscription.member.isEmpty() || subscription.periodMs != 0 || subscription.subscriber.isNull()) {
+        return;
+    }
+
+    const QMetaObject *subscriberMeta = subscription.subscriber->metaObject();
+    int memberIndex = subscriberMeta->indexOfMethod(QMetaObject::normalizedSignature((subscription.member + "(UAVObject*)").constData()));
+    if (memberIndex < 0) {
+        qWarning() << "TelemetryManager: no method" << subscription.member << "(UAVObject *) in" << subscriberMeta->className();
+        return;
+    }
+    QMetaMethod updated = obj->metaObject()->method(obj->metaObject()->indexOfSignal("objectUpdated(UAVObject*)"));
+    QMetaMethod member  = subscriberMeta->method(memberIndex);
+
+    if (connected) {
+        connect(obj, updated, subscription.subscriber, member, Qt::UniqueConnection);
+    } else {
+        disconnect(obj, updated, subscription.subscriber, member);
+    }
+}
+
+void TelemetryManager::restartDispatchTimer()
+{
+    if (m_dispatchHeap.isEmpty()) {
+        return;
+    }
+    int delay = qMax<qint64>(0, m_dispatchHeap.first().dueMs - m_dispatchClock.elapsed());
+    // subscriptions come from the gadgets' thread, the timer must be started from its own
+    QMetaObject::invokeMethod(m_dispatchTimer, "start", Qt::AutoConnection, Q_ARG(int, delay));
+}
+
+/**
+ * Apply the subscribed rates to all subscribed objects, and give the others
+ * their original rate back
+ */
+void TelemetryManager::updateFlightRates()
+{
+    QList<UAVObject *> objects = m_subscriptions.keys();
+
+    foreach(quint32 objId, m_savedMetadata.keys()) {
+        UAVObject *obj = m_uavobjectManager->getObject(objId);
+        if (obj && !objects.contains(obj)) {
+            objects.append(obj);
+        }
+    }
+    foreach(UAVObject * obj, objects) {
+        updateFlightRate(obj);
+    }
+}
+
+/**
+ * Ask the flight side for the rate the subscribers of an object type need.
+ * Only periodic and throttled objects are touched, and only slowed down.
+ * Nothing is slowed down while a consumer holds the flight rates.
+ */
+void TelemetryManager::updateFlightRate(UAVObject *obj)
+{
+    quint32 objId    = obj->getObjID();
+    quint32 periodMs = 0;
+    bool subscribed  = false;
+
+    for (QHash<UAVObject *, QList<Subscription> >::const_iterator it = m_subscriptions.constBegin(); it != m_subscriptions.constEnd(); ++it) {
+        if (it.key()->getObjID() != objId) {
+            continue;
+        }
+        foreach(const Subscription &subscription, it.value()) {
+            periodMs   = subscribed ? qMin(periodMs, subscription.periodMs) : subscription.periodMs;
+            subscribed = true;
+        }
+    }
+
+    if (!isConnected()) {
+        // applied on connection
+        return;
+    }
+
+    if (!subscribed || periodMs == 0 || !m_rateHolders.isEmpty()) {
+        // nobody limits the rate (anymore), restore what the flight side had
+        if (m_savedMetadata.contains(objId)) {
+            obj->setMetadata(m_savedMetadata.take(objId));
+        }
+        return;
+    }
+
+    if (!m_savedMetadata.contains(objId)) {
+        m_savedMetadata.insert(objId, obj->getMetadata());
+    }
+    UAVObject::Metadata mdata = m_savedMetadata.value(objId);
+    UAVObject::UpdateMode updateMode = UAVObject::GetFlightTelemetryUpdateMode(mdata);
+    if (updateMode != UAVObject::UPDATEMODE_PERIODIC && updateMode != UAVObject::UPDATEMODE_THROTTLED) {
+        return;
+    }
+    mdata.flightTelemetryUpdatePeriod = qMin<quint32>(qMax<quint32>(mdata.flightTelemetryUpdatePeriod, periodMs), 0xffff);
+    if (mdata.flightTelemetryUpdatePeriod != obj->getMetadata().flightTelemetryUpdatePeriod) {
+        obj->setMetadata(mdata);
+    }
+}
+
 IODeviceReader::IODeviceReader(UAVTalk *uavTalk) : m_uavTalk(uavTalk)
 {}
 
@@ -33,6 +33,12 @@
 #include "uavobjectmanager.h"
 #include <QIODevice>
 #include <QObject>
+#include <QPointer>
+#include <QHash>
+#include <QVector>
+#include <QMutex>
+#include <QTimer>
+#include <QElapsedTimer>
 
 class Telemetry;
 class TelemetryMonitor;
@@ -56,6 +62,12 @@ public:
     bool isConnected() const;
     ConnectionState connectionState() const;
 
+    void subscribe(UAVObject *obj, QObject *subscriber, const char *member, quint32 minPeriodMs);
+    void unsubscribe(UAVObject *obj, QObject *subscriber);
+    void holdFlightRates(QObject *consumer);
+    void releaseFlightRates(QObject *consumer);
+    void restoreFlightRates();
+
 signals:
     void connecting();
     void connected();
@@ -71,8 +83,41 @@ private slots:
     void onTelemetryUpdate(double txRate, double rxRate);
     void onStart();
     void onStop();
+    void subscribedObjectUpdated(UAVObject *obj);
+    void subscriberDestroyed(QObject *subscriber);
+    void dispatchPendingUpdates();
+    void onRestoreFlightRates();
 
 private:
+    struct Subscription {
+        QPointer<QObject> subscriber;
+        QByteArray member;
+        quint32    periodMs;
+        qint64     nextDispatchMs; /** Earliest time the subscriber may be notified again */
+        bool pending; /** An update arrived too early and waits on the dispatch heap */
+    };
+
+    struct PendingDispatch {
+        qint64    dueMs;
+        UAVObject *obj;
+        QObject   *subscriber;
+    };
+
+    static bool laterDispatch(const PendingDispatch & a, const PendingDispatch & b);
+    void dispatch(UAVObject *obj, Subscription & subscription, qint64 now);
+    void connectDirectly(UAVObject *obj, const Subscription & subscription, bool connected);
+    void updateFlightRate(UAVObject *obj);
+    void updateFlightRates();
+    void restartDispatchTimer();
+
+    QMutex m_subscriptionLock;
+    QHash<UAVObject *, QList<Subscription> > m_subscriptions;
+    QHash<quint32, UAVObject::Metadata> m_savedMetadata; /** Flight metadata before subscriptions changed it, kept across reconnects */
+    QList<QObject *> m_rateHolders; /** Consumers that need every update of every object, e.g. logging */
+    QVector<PendingDispatch> m_dispatchHeap;
+    QElapsedTimer m_dispatchClock;
+    QTimer *m_dispatchTimer;
+
     UAVObjectManager *m_uavobjectManager;
     UAVTalk *m_uavTalk;
     Telemetry *m_telemetry;
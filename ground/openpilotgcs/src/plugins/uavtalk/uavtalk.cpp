@@ -68,6 +68,9 @@ UAVTalk::UAVTalk(QIODevice *iodev, UAVObjectManager *objMngr) : io(iodev), objMn
         connect(udpSocketTx, SIGNAL(readyRead()), this, SLOT(dummyUDPRead()));
         connect(udpSocketRx, SIGNAL(readyRead()), this, SLOT(dummyUDPRead()));
     }
+
+    updateQueue = new UAVTalkUpdateQueue();
+    updateQueue->moveToThread(QCoreApplication::instance()->thread());
 }
 
 UAVTalk::~UAVTalk()
@@ -76,6 +79,8 @@ UAVTalk::~UAVTalk()
     // disconnect(io, SIGNAL(readyRead()), worker, SLOT(processInputStream()));
 
     closeAllTransactions();
+    // the queue lives in the GUI thread
+    updateQueue->deleteLater();
 }
 
 /**
@@ -372,6 +377,9 @@ bool UAVTalk::processInputByte(quint8 rxbyte)
             // Determine data length
             if (rxType == TYPE_OBJ_REQ || rxType == TYPE_ACK || rxType == TYPE_NACK) {
                 rxLength = 0;
+            } else if (rxType == TYPE_OBJ_DELTA) {
+                // Delta updates have a variable length
+                rxLength = packetSize - rxPacketLength;
             } else {
                 if (rxObj) {
                     rxLength = rxObj->getNumBytes();
@@ -474,8 +482,6 @@ bool UAVTalk::processInputByte(quint8 rxbyte)
  */
 bool UAVTalk::receiveObject(quint8 type, quint32 objId, quint16 instId, quint8 *data, qint32 length)
 {
-    Q_UNUSED(length);
-
     UAVObject *obj    = NULL;
     bool error        = false;
     bool allInstances = (instId == ALL_INSTANCES);
@@ -485,12 +491,18 @@ bool UAVTalk::receiveObject(quint8 type, quint32 objId, quint16 instId, quint8 *
     case TYPE_OBJ:
         // All instances, not allowed for OBJ messages
         if (!allInstances) {
-            // Get object and update its data
-            obj = updateObject(objId, instId, data);
+            // Get object and update its data, streamed data objects are committed by the GUI thread
+            obj = objMngr->getObject(objId, instId);
+            if (obj != NULL && canDeferUpdate(obj, objId, instId)) {
+                updateQueue->stage(obj, data);
+            } else {
+                obj = updateObject(objId, instId, data);
+            }
 #ifdef VERBOSE_UAVTALK
             VERBOSE_FILTER(objId) qDebug() << "UAVTalk - received object" << objId << instId << (obj != NULL ? obj->toStringBrief() : "<null object>");
 #endif
             if (obj != NULL) {
+                resyncRequests.remove(((quint64)objId << 16) | instId);
                 // Check if this object acks a pending OBJ_REQ message
                 // any OBJ message can ack a pending OBJ_REQ message
                 // even one that was not sent in response to the OBJ_REQ message
@@ -503,6 +515,27 @@ bool UAVTalk::receiveObject(quint8 type, quint32 objId, quint16 instId, quint8 *
         }
         break;
 
+    case TYPE_OBJ_DELTA:
+        // All instances, not allowed for OBJ_DELTA messages
+        if (!allInstances) {
+            // A delta update can only be applied to an existing instance
+            obj = objMngr->getObject(objId, instId);
+#ifdef VERBOSE_UAVTALK
+            VERBOSE_FILTER(objId) qDebug() << "UAVTalk - received object (delta)" << objId << instId << (obj != NULL ? obj->toStringBrief() : "<null object>");
+#endif
+            if (obj == NULL || !applyDelta(obj, data, length)) {
+                // Out of sync with the sender, request a full update once
+                quint64 key = ((quint64)objId << 16) | instId;
+                if (!resyncRequests.contains(key)) {
+                    resyncRequests.insert(key);
+                    transmitObject(TYPE_OBJ_REQ, objId, instId, NULL);
+                }
+            }
+        } else {
+            error = true;
+        }
+        break;
+
     case TYPE_OBJ_ACK:
         // All instances, not allowed for OBJ_ACK messages
         if (!allInstances) {
@@ -512,6 +545,10 @@ bool UAVTalk::receiveObject(quint8 type, quint32 objId, quint16 instId, quint8 *
             VERBOSE_FILTER(objId) qDebug() << "UAVTalk - received object (acked)" << objId << instId << (obj != NULL ? obj->toStringBrief() : "<null object>");
 #endif
             if (obj != NULL) {
+                // Acked updates are the keyframes the next delta updates refer to
+                quint64 key = ((quint64)objId << 16) | instId;
+                deltaKeyframes.insert(key, QByteArray((const char *)data, length));
+                resyncRequests.remove(key);
                 // Object updated or created, transmit ACK
                 error = !transmitObject(TYPE_ACK, objId, instId, obj);
             } else {
@@ -594,6 +631,62 @@ bool UAVTalk::receiveObject(quint8 type, quint32 objId, quint16 instId, quint8 *
     return !error;
 }
 
+/**
+ * Apply a delta update to an object.
+ * The update holds the CRC16 of the complete object followed by the runs of bytes that
+ * differ from the last acked update (the keyframe), each encoded as offset(1), length(1), data(length).
+ * \param[in] obj The object to update
+ * \param[in] data Delta update
+ * \param[in] length Length of the delta update
+ * \return Success (true), Failure (false) if the update does not match the keyframe
+ */
+bool UAVTalk::applyDelta(UAVObject *obj, quint8 *data, qint32 length)
+{
+    quint8 objData[MAX_PAYLOAD_LENGTH];
+    qint32 numBytes = obj->getNumBytes();
+    QByteArray keyframe = deltaKeyframes.value(((quint64)obj->getObjID() << 16) | obj->getInstID());
+
+    if (length < DELTA_CRC_LENGTH || keyframe.size() != numBytes || numBytes > MAX_PAYLOAD_LENGTH) {
+        return false;
+    }
+    memcpy(objData, keyframe.constData(), numBytes);
+
+    qint32 pos = DELTA_CRC_LENGTH;
+    while (pos < length) {
+        if (pos + 2 > length) {
+            return false;
+        }
+        qint32 offset    = data[pos++];
+        qint32 runLength = data[pos++];
+        if (runLength == 0 || offset + runLength > numBytes || pos + runLength > length) {
+            return false;
+        }
+        memcpy(&objData[offset], &data[pos], runLength);
+        pos += runLength;
+    }
+
+    if (Crc::updateCRC16(0, objData, numBytes) != (data[0] | (data[1] << 8))) {
+        return false;
+    }
+    if (canDeferUpdate(obj, obj->getObjID(), obj->getInstID())) {
+        updateQueue->stage(obj, objData);
+    } else {
+        updateQueue->discard(obj);
+        obj->unpack(objData);
+    }
+    return true;
+}
+
+/**
+ * Check if an update can be left to the GUI thread.
+ * Only streamed data objects are, settings, metadata and objects with a
+ * pending transaction must hold the new data when the transaction completes.
+ */
+bool UAVTalk::canDeferUpdate(UAVObject *obj, quint32 objId, quint16 instId)
+{
+    return obj->isDataObject() && !obj->isSettingsObject() && findTransaction(objId, instId) == NULL;
+}
+
 /**
  * Update the data of an object from a byte array (unpack).
  * If the object instance could not be found in the list, then a
@@ -626,7 +719,8 @@ UAVObject *UAVTalk::updateObject(quint32 objId, quint16 instId, quint8 *data)
         instObj->unpack(data);
         return instObj;
     } else {
-        // Unpack data into object instance
+        // Unpack data into object instance, older queued updates must not overwrite it
+        updateQueue->discard(obj);
         obj->unpack(data);
         return obj;
     }
@@ -788,7 +882,12 @@ bool UAVTalk::transmitSingleObject(quint8 type, quint32 objId, quint16 instId, U
     // Send buffer, check that the transmit backlog does not grow above limit
     if (!io.isNull() && io->isWritable()) {
         if (io->bytesToWrite() < TX_BUFFER_SIZE) {
-            io->write((const char *)txBuffer, HEADER_LENGTH + length + CHECKSUM_LENGTH);
+            if (io->write((const char *)txBuffer, HEADER_LENGTH + length + CHECKSUM_LENGTH) < HEADER_LENGTH + length + CHECKSUM_LENGTH) {
+                // the device refused the packet, e.g. the HID write ring is full
+                qWarning() << "UAVTalk - error transmitting : io device busy";
+                ++stats.txErrors;
+                return false;
+            }
             if (useUDPMirror) {
                 udpSocketRx->writeDatagram((const char *)txBuffer, HEADER_LENGTH + length + CHECKSUM_LENGTH, QHostAddress::LocalHost, udpSocketTx->localPort());
             }
@@ -883,6 +982,11 @@ const char *UAVTalk::typeToString(quint8 type)
 
         break;
 
+    case TYPE_OBJ_DELTA:
+        return "object (delta)";
+
+        break;
+
     case TYPE_OBJ_REQ:
         return "object request";
 
@@ -900,3 +1004,70 @@ const char *UAVTalk::typeToString(quint8 type)
     }
     return "<error>";
 }
+
+UAVTalkUpdateQueue::UAVTalkUpdateQueue()
+{
+    timer = new QTimer(this);
+    timer->setSingleShot(true);
+    connect(timer, SIGNAL(timeout()), this, SLOT(apply()));
+    sinceApply.start();
+}
+
+/**
+ * Unpack an update into the staging area of the object, called from the telemetry thread.
+ * The GUI thread is woken once per batch, not once per update.
+ */
+void UAVTalkUpdateQueue::stage(UAVObject *obj, const quint8 *data)
+{
+    if (!obj->stage(data)) {
+        // already waiting for the next frame
+        return;
+    }
+
+    bool wake;
+    {
+        QMutexLocker locker(&mutex);
+
+        wake = pending.isEmpty();
+        pending.append(obj);
+    }
+    if (wake) {
+        QMetaObject::invokeMethod(this, "schedule", Qt::QueuedConnection);
+    }
+}
+
+/**
+ * Drop the staged updates of an object that was just updated directly
+ */
+void UAVTalkUpdateQueue::discard(UAVObject *obj)
+{
+    obj->discardStaged();
+}
+
+/**
+ * Apply the next batch at the next frame
+ */
+void UAVTalkUpdateQueue::schedule()
+{
+    if (!timer->isActive()) {
+        timer->start(qMax(0, FRAME_INTERVAL - (int)sinceApply.elapsed()));
+    }
+}
+
+/**
+ * Swap out the objects with staged data and commit their samples
+ */
+void UAVTalkUpdateQueue::apply()
+{
+    QList<UAVObject *> objects;
+    {
+        QMutexLocker locker(&mutex);
+
+        objects.swap(pending);
+    }
+    sinceApply.restart();
+
+    foreach(UAVObject * obj, objects) {
+        obj->commitStaged();
+    }
+}
@@ -36,8 +36,11 @@
 #include <QMutexLocker>
 #include <QMap>
 #include <QThread>
+#include <QElapsedTimer>
 #include <QtNetwork/QUdpSocket>
 
+class UAVTalkUpdateQueue;
+
 class UAVTALK_EXPORT UAVTalk : public QObject {
     Q_OBJECT
 
@@ -86,13 +89,17 @@ private:
     } Transaction;
 
     // Constants
-    static const int TYPE_MASK     = 0xF8;
-    static const int TYPE_VER      = 0x20;
-    static const int TYPE_OBJ      = (TYPE_VER | 0x00);
-    static const int TYPE_OBJ_REQ  = (TYPE_VER | 0x01);
-    static const int TYPE_OBJ_ACK  = (TYPE_VER | 0x02);
-    static const int TYPE_ACK      = (TYPE_VER | 0x03);
-    static const int TYPE_NACK     = (TYPE_VER | 0x04);
+    static const int TYPE_MASK      = 0xF8;
+    static const int TYPE_VER       = 0x20;
+    static const int TYPE_OBJ       = (TYPE_VER | 0x00);
+    static const int TYPE_OBJ_REQ   = (TYPE_VER | 0x01);
+    static const int TYPE_OBJ_ACK   = (TYPE_VER | 0x02);
+    static const int TYPE_ACK       = (TYPE_VER | 0x03);
+    static const int TYPE_NACK      = (TYPE_VER | 0x04);
+    static const int TYPE_OBJ_DELTA = (TYPE_VER | 0x05);
+
+    // delta update : CRC16 of the complete object, then runs of offset(1), length(1), data(length)
+    static const int DELTA_CRC_LENGTH = 2;
 
     // header : sync(1), type (1), size(2), object ID(4), instance ID(2)
     static const int HEADER_LENGTH = 10;
@@ -145,11 +152,21 @@ private:
     QUdpSocket *udpSocketRx;
     QByteArray rxDataArray;
 
+    // Objects for which a full update was requested after a delta update could not be applied
+    QSet<quint64> resyncRequests;
+    // Data of the last acked update of each object, the reference of its delta updates
+    QHash<quint64, QByteArray> deltaKeyframes;
+
+    // Streamed data object updates waiting to be unpacked in the GUI thread
+    UAVTalkUpdateQueue *updateQueue;
+
     // Methods
     bool objectTransaction(quint8 type, quint32 objId, quint16 instId, UAVObject *obj);
     bool processInputByte(quint8 rxbyte);
     bool receiveObject(quint8 type, quint32 objId, quint16 instId, quint8 *data, qint32 length);
     UAVObject *updateObject(quint32 objId, quint16 instId, quint8 *data);
+    bool canDeferUpdate(UAVObject *obj, quint32 objId, quint16 instId);
+    bool applyDelta(UAVObject *obj, quint8 *data, qint32 length);
     void updateAck(quint8 type, quint32 objId, quint16 instId, UAVObject *obj);
     void updateNack(quint32 objId, quint16 instId, UAVObject *obj);
     bool transmitObject(quint8 type, quint32 objId, quint16 instId, UAVObject *obj);
@@ -163,4 +180,37 @@ private:
     const char *typeToString(quint8 type);
 };
 
+/**
+ * Hands received streamed data from the telemetry thread to the GUI thread.
+ * The telemetry thread reads, decodes and unpacks the link data into the
+ * staging area of each object (UAVObject::stage()), without touching the
+ * object mutex. The GUI thread swaps out the list of objects with staged data
+ * once per frame and commits their samples in the order they were received,
+ * so GUI readers never wait for the telemetry thread and a burst of packets
+ * costs one event instead of one queued signal each.
+ */
+class UAVTalkUpdateQueue : public QObject {
+    Q_OBJECT
+
+public:
+    UAVTalkUpdateQueue();
+
+    void stage(UAVObject *obj, const quint8 *data);
+    void discard(UAVObject *obj);
+
+private slots:
+    void schedule();
+    void apply();
+
+private:
+    // One GUI frame
+    static const int FRAME_INTERVAL = 16;
+
+    QMutex mutex;
+    // Objects that got staged data since the last frame
+    QList<UAVObject *> pending;
+    QTimer *timer;
+    QElapsedTimer sinceApply;
+};
+
 #endif // UAVTALK_H
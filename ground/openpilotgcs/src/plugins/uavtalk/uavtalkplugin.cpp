@@ -63,7 +63,10 @@ bool UAVTalkPlugin::initialize(const QStringList & arguments, QString *errorStri
 }
 
 void UAVTalkPlugin::shutdown()
-{}
+{
+    // Do not leave the flight side at the rates the gadgets asked for
+    telMngr->restoreFlightRates();
+}
 
 void UAVTalkPlugin::onDeviceConnect(QIODevice *dev)
 {
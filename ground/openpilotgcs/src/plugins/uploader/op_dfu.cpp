@@ -29,12 +29,18 @@
 #include <cmath>
 #include <qwaitcondition.h>
 #include <QMetaType>
+#include <QVector>
 #include <QtWidgets/QApplication>
 
 using namespace OP_DFU;
 
+static quint32 unpackUint32(const char *buf)
+{
+    return (quint32)(quint8)buf[0] << 24 | (quint32)(quint8)buf[1] << 16 | (quint32)(quint8)buf[2] << 8 | (quint8)buf[3];
+}
+
 DFUObject::DFUObject(bool _debug, bool _use_serial, QString portname) :
-    debug(_debug), use_serial(_use_serial), mready(true)
+    debug(_debug), use_serial(_use_serial), mready(true), activeDevice(0)
 {
     info = NULL;
     numberOfDevices = 0;
@@ -172,6 +178,7 @@ bool DFUObject::enterDFU(int const &devNumber)
     if (debug) {
         qDebug() << "EnterDFU: " << result << " bytes sent";
     }
+    activeDevice = devNumber;
     return true;
 }
 
@@ -180,7 +187,7 @@ bool DFUObject::enterDFU(int const &devNumber)
    erase the memory to make room for the data. You will have to query
    its status to wait until erase is done before doing the actual upload.
  */
-bool DFUObject::StartUpload(qint32 const & numberOfBytes, TransferTypes const & type, quint32 crc)
+bool DFUObject::StartUpload(qint32 const & numberOfBytes, TransferTypes const & type, quint32 crc, bool stream, quint32 eraseMask)
 {
     int lastPacketCount;
     qint32 numberOfPackets = numberOfBytes / 4 / 14;
@@ -205,6 +212,17 @@ bool DFUObject::StartUpload(qint32 const & numberOfBytes, TransferTypes const &
     buf[9]  = crc >> 16;
     buf[10] = crc >> 8;
     buf[11] = crc;
+    // a stream transfer erases only the sectors in eraseMask, bit n is
+    // entry n of RequestSectorCRCs()
+    quint32 magic = stream ? DFU_UPLOAD_STREAM_MAGIC : 0;
+    buf[12] = magic >> 24;
+    buf[13] = magic >> 16;
+    buf[14] = magic >> 8;
+    buf[15] = magic;
+    buf[16] = eraseMask >> 24;
+    buf[17] = eraseMask >> 16;
+    buf[18] = eraseMask >> 8;
+    buf[19] = eraseMask;
     if (debug) {
         qDebug() << "Number of packets:" << numberOfPackets << " Size of last packet:" << lastPacketCount;
     }
@@ -253,7 +271,7 @@ bool DFUObject::UploadData(qint32 const & numberOfBytes, QByteArray & data)
             printProgBar((int)percentage, "UPLOADING");
         }
         laspercentage = (int)percentage;
-        if (packetcount == numberOfPackets) {
+        if (packetcount == numberOfPackets - 1) {
             packetsize = lastPacketCount;
         } else {
             packetsize = 14;
@@ -314,7 +332,16 @@ OP_DFU::Status DFUObject::UploadDescription(QVariant desc)
         array = desc.toByteArray();
     }
 
-    if (!StartUpload(array.length(), OP_DFU::Descript, 0)) {
+    // the description is written in the sectors the firmware upload erased,
+    // a stream transfer is refused by the bootloader if that did not happen
+    bool stream = (activeDevice < devices.length()) && devices[activeDevice].SupportsStream;
+    if (stream) {
+        QList<QPair<quint32, quint32> > ranges;
+        ranges.append(qMakePair((quint32)0, (quint32)array.length()));
+        array = CompressStream(array, ranges);
+    }
+
+    if (!StartUpload(array.length(), OP_DFU::Descript, 0, stream)) {
         return OP_DFU::abort;
     }
     if (!UploadData(array.length(), array)) {
@@ -641,6 +668,7 @@ bool DFUObject::findDevices()
             receiveData(buf, BUF_LEN);
             devices[x].ID = buf[14];
             devices[x].ID = devices[x].ID << 8 | (quint8)buf[15];
+            devices[x].SupportsStream = buf[16] & DFU_FEATURE_STREAM;
             devices[x].BL_Version = buf[7];
             devices[x].SizeOfDesc = buf[8];
 
@@ -670,6 +698,7 @@ bool DFUObject::findDevices()
                 qDebug() << "Device SizeOfDesc=" << devices[x].SizeOfDesc;
                 qDebug() << "BL Version=" << devices[x].BL_Version;
                 qDebug() << "FW CRC=" << devices[x].FW_CRC;
+                qDebug() << "Stream uploads=" << devices[x].SupportsStream;
             }
         }
     }
@@ -761,7 +790,35 @@ OP_DFU::Status DFUObject::UploadFirmwareT(const QString &sfile, const bool &veri
         qDebug() << "NEW FIRMWARE CRC=" << crc;
     }
 
-    if (!StartUpload(arr.length(), OP_DFU::FW, crc)) {
+    // Differential upload: only the sectors whose CRC differs from the new
+    // image are sent, compressed, and only those get erased
+    QByteArray payload = arr;
+    QList<sector> sectors;
+    quint32 eraseMask  = 0;
+    bool stream = devices[device].SupportsStream && RequestSectorCRCs(sectors) && (sectors.length() <= 32);
+    if (stream) {
+        const quint32 sizeOfCode = devices[device].SizeOfCode;
+        QByteArray image = arr + QByteArray(sizeOfCode - arr.length(), 255);
+        QList<QPair<quint32, quint32> > ranges;
+        for (int i = 0; i < sectors.length(); i++) {
+            const sector &s = sectors[i];
+            // the sectors holding the description are rewritten after the
+            // firmware, so they are always erased
+            if (s.Offset >= sizeOfCode) {
+                eraseMask |= 1u << i;
+            } else if (s.Offset + s.Size > sizeOfCode || CRCFromBlock(image, s.Offset, s.Size) != s.CRC) {
+                ranges.append(qMakePair(s.Offset, qMin(s.Size, sizeOfCode - s.Offset)));
+                eraseMask |= 1u << i;
+            }
+        }
+        payload = CompressStream(image, ranges);
+        if (debug) {
+            qDebug() << "Differential upload:" << ranges.length() << "of" << sectors.length() << "sectors,"
+                     << payload.length() << "bytes instead of" << arr.length();
+        }
+    }
+
+    if (!StartUpload(payload.length(), OP_DFU::FW, crc, stream, eraseMask)) {
         ret = StatusRequest();
         if (debug) {
             qDebug() << "StartUpload failed";
@@ -794,7 +851,7 @@ OP_DFU::Status DFUObject::UploadFirmwareT(const QString &sfile, const bool &veri
     }
 
     emit operationProgress(QString("Uploading firmware"));
-    if (!UploadData(arr.length(), arr)) {
+    if (!UploadData(payload.length(), payload)) {
         ret = StatusRequest();
         if (debug) {
             qDebug() << "Upload failed (upload data)";
@@ -863,6 +920,19 @@ OP_DFU::Status DFUObject::CompareFirmware(const QString &sfile, const CompareTyp
         } else {
             cout << "Compare failed CRC DONT MATCH!\n";
         }
+        QList<sector> sectors;
+        if (devices[device].SupportsStream && RequestSectorCRCs(sectors)) {
+            const quint32 sizeOfCode = devices[device].SizeOfCode;
+            QByteArray image = arr + QByteArray(sizeOfCode - qMin((quint32)arr.length(), sizeOfCode), 255);
+            int differ = 0;
+            foreach(const sector &s, sectors) {
+                // the sector with the description can't be compared
+                if (s.Offset + s.Size <= sizeOfCode && CRCFromBlock(image, s.Offset, s.Size) != s.CRC) {
+                    differ++;
+                }
+            }
+            cout << differ << " of " << sectors.length() << " sectors differ\n";
+        }
         return StatusRequest();
     } else {
         QByteArray arr2;
@@ -1022,6 +1092,170 @@ quint32 DFUObject::CRCFromQBArray(QByteArray array, quint32 Size)
     return ret;
 }
 
+/**
+   CRC of size bytes of array from offset on, as the bootloader calculates
+   it for a flash sector
+ */
+quint32 DFUObject::CRCFromBlock(const QByteArray &array, int offset, int size)
+{
+    QVector<quint32> t(size / 4);
+
+    for (int x = 0; x < t.size(); x++) {
+        const uchar *b = (const uchar *)array.constData() + offset + x * 4;
+        t[x] = b[0] | b[1] << 8 | b[2] << 16 | (quint32)b[3] << 24;
+    }
+    return DFUObject::CRC32WideFast(0xFFFFFFFF, t.size(), t.data());
+}
+
+static inline int streamHash(const uchar *p, int bits)
+{
+    return ((p[0] << 16 | p[1] << 8 | p[2]) * 2654435761u) >> (32 - bits);
+}
+
+// stream literal tokens for count bytes of image from start on
+static void appendLiterals(QByteArray &out, const QByteArray &image, int start, int count)
+{
+    for (int l = 0; l < count; l += 0x80) {
+        const int n = qMin(0x80, count - l);
+        out.append((char)(n - 1));
+        out.append(image.mid(start + l, n));
+    }
+}
+
+/**
+   Encodes the byte ranges (offset, length) of image as a bootloader stream
+   transfer, see op_dfu.c for the format. Greedy LZ77 on hash chains, the
+   ranges must be word aligned and in ascending order.
+
+   Matches may reach back into the gaps between the ranges: the device only
+   skips sectors that already hold the same bytes as image.
+ */
+QByteArray DFUObject::CompressStream(const QByteArray &image, const QList<QPair<quint32, quint32> > &ranges)
+{
+    static const int HASH_BITS    = 15;
+    static const int MIN_MATCH    = 3;
+    static const int MAX_MATCH    = 0xFE - 0x80 + MIN_MATCH;
+    static const int MAX_DISTANCE = 0xFFFF;
+    static const int MAX_CHAIN    = 64;
+
+    const uchar *data = (const uchar *)image.constData();
+    const int size    = image.size();
+    QVector<int> head(1 << HASH_BITS, -1);
+    QVector<int> prev(size, -1);
+    QByteArray out;
+    int literalStart = 0, literalCount = 0;
+    int hashed = 0;
+    int pos    = 0;
+
+    for (int r = 0; r <= ranges.length(); r++) {
+        // seek to the next range, or end the stream
+        const quint32 seek = (r < ranges.length()) ? ranges[r].first : 0xFFFFFFFF;
+        if (seek != (quint32)pos) {
+            appendLiterals(out, image, literalStart, literalCount);
+            literalCount = 0;
+            out.append((char)0xFF);
+            out.append((char)(seek >> 24));
+            out.append((char)(seek >> 16));
+            out.append((char)(seek >> 8));
+            out.append((char)seek);
+            if (r == ranges.length()) {
+                break;
+            }
+            pos = seek;
+        }
+        const int end = qMin(size, (int)(ranges[r].first + ranges[r].second));
+
+        while (pos < end) {
+            // everything below pos is in flash by the time this match is decoded
+            for (; hashed < pos && hashed + MIN_MATCH <= size; hashed++) {
+                const int h = streamHash(data + hashed, HASH_BITS);
+                prev[hashed] = head[h];
+                head[h] = hashed;
+            }
+
+            int bestLength = 0, bestDistance = 0;
+            if (pos + MIN_MATCH <= end) {
+                const int maxLength = qMin(MAX_MATCH, end - pos);
+                int chain = 0;
+                for (int c = head[streamHash(data + pos, HASH_BITS)]; c >= 0 && pos - c <= MAX_DISTANCE && chain < MAX_CHAIN; c = prev[c], chain++) {
+                    int length = 0;
+                    while (length < maxLength && data[c + length] == data[pos + length]) {
+                        length++;
+                    }
+                    if (length > bestLength) {
+                        bestLength   = length;
+                        bestDistance = pos - c;
+                        if (length == maxLength) {
+                            break;
+                        }
+                    }
+                }
+            }
+
+            if (bestLength >= MIN_MATCH) {
+                appendLiterals(out, image, literalStart, literalCount);
+                literalCount = 0;
+                out.append((char)(0x80 + bestLength - MIN_MATCH));
+                out.append((char)(bestDistance >> 8));
+                out.append((char)bestDistance);
+                pos += bestLength;
+            } else {
+                if (literalCount == 0) {
+                    literalStart = pos;
+                }
+                literalCount++;
+                pos++;
+            }
+        }
+    }
+
+    // the bootloader ignores whatever follows the end
+    while (out.length() % 4) {
+        out.append((char)0);
+    }
+    return out;
+}
+
+/**
+   Asks the bootloader for offset, size and CRC of the flash sectors holding
+   the firmware and its description
+ */
+bool DFUObject::RequestSectorCRCs(QList<sector> &sectors)
+{
+    char buf[BUF_LEN];
+    int total = 1;
+
+    sectors.clear();
+    while (sectors.length() < total) {
+        memset(buf, 0, BUF_LEN);
+        buf[0] = 0x02; // reportID
+        buf[1] = OP_DFU::Req_SectorCRCs; // DFU Command
+        buf[2] = sectors.length() >> 24; // DFU Count, first sector
+        buf[3] = sectors.length() >> 16;
+        buf[4] = sectors.length() >> 8;
+        buf[5] = sectors.length();
+        if (sendData(buf, BUF_LEN) < 1 || receiveData(buf, BUF_LEN) < 1 || buf[1] != OP_DFU::Rep_SectorCRCs) {
+            return false;
+        }
+        const int count = (quint8)buf[6];
+        total = (quint8)buf[7];
+        if (count == 0) {
+            return false;
+        }
+        for (int x = 0; x < count; ++x) {
+            sector s;
+            s.Offset = unpackUint32(&buf[8 + 12 * x]);
+            s.Size   = unpackUint32(&buf[12 + 12 * x]);
+            s.CRC    = unpackUint32(&buf[16 + 12 * x]);
+            sectors.append(s);
+        }
+    }
+    if (debug) {
+        qDebug() << "Device reported" << sectors.length() << "sectors";
+    }
+    return true;
+}
+
 
 /**
    Send data to the bootloader, either through the serial port
@@ -13,6 +13,7 @@
 #include <QMetaType>
 #include <QCryptographicHash>
 #include <QList>
+#include <QPair>
 #include <QVariant>
 #include <iostream>
 #include "delay.h"
@@ -30,6 +31,10 @@ using namespace std;
 #define MAX_PACKET_DATA_LEN 255
 #define MAX_PACKET_BUF_SIZE (1 + 1 + MAX_PACKET_DATA_LEN + 2)
 
+// must match the bootloader's common.h
+#define DFU_FEATURE_STREAM      0x01
+#define DFU_UPLOAD_STREAM_MAGIC 0x5354524D
+
 namespace OP_DFU {
 enum TransferTypes {
     FW,
@@ -85,6 +90,8 @@ enum Commands {
     Download, // 10
     Status_Request, // 11
     Status_Rep, // 12
+    Req_SectorCRCs, // 13
+    Rep_SectorCRCs, // 14
 };
 
 enum eBoardType {
@@ -103,6 +110,13 @@ struct device {
     quint32 SizeOfCode;
     bool    Readable;
     bool    Writable;
+    bool    SupportsStream; // sector CRCs and compressed differential uploads
+};
+
+struct sector {
+    quint32 Offset; // from the start of the firmware
+    quint32 Size;
+    quint32 CRC;
 };
 
 
@@ -111,6 +125,8 @@ class DFUObject : public QThread {
 
 public:
     static quint32 CRCFromQBArray(QByteArray array, quint32 Size);
+    static quint32 CRCFromBlock(const QByteArray &array, int offset, int size);
+    static QByteArray CompressStream(const QByteArray &image, const QList<QPair<quint32, quint32> > &ranges);
     // DFUObject(bool debug);
     DFUObject(bool debug, bool use_serial, QString port);
 
@@ -189,7 +205,9 @@ private:
 
     void CopyWords(char *source, char *destination, int count);
     void printProgBar(int const & percent, QString const & label);
-    bool StartUpload(qint32 const &numberOfBytes, TransferTypes const & type, quint32 crc);
+    bool StartUpload(qint32 const &numberOfBytes, TransferTypes const & type, quint32 crc, bool stream = false, quint32 eraseMask = 0);
+    bool RequestSectorCRCs(QList<sector> &sectors);
+    int activeDevice;
     bool UploadData(qint32 const & numberOfPackets, QByteArray & data);
 
     // Thread management:
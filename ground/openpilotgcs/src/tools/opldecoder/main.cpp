@@ -0,0 +1,415 @@
+/**
+ ******************************************************************************
+ *
+ * @file       main.cpp
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2014.
+ * @brief      Headless .opl log decoder and benchmark.
+ *
+ * @see        The GNU Public License (GPL) Version 3
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+#include <QtCore/QCoreApplication>
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QThread>
+#include <QVector>
+#include <QWaitCondition>
+#include <iostream>
+
+#include "uavobjectmanager.h"
+#include "uavobjectsinit.h"
+#include "uavobjectfield.h"
+#include "uavobjectlogfile.h"
+#include "uavobjectcolumnlog.h"
+
+#define RETURN_ERR_USAGE 1
+#define RETURN_ERR_LOG   2
+#define RETURN_OK        0
+
+// Updates per chunk, a chunk is decoded by one thread
+#define CHUNK_SIZE       16384
+// Decoded chunks waiting to be written, per thread
+#define CHUNKS_AHEAD     4
+
+using namespace std;
+
+/**
+ * print usage info
+ */
+void usage()
+{
+    cout << "Usage: opldecoder [options] log.opl" << endl;
+    cout << "Decodes an OpenPilot log without the GCS, one line per object update:" << endl;
+    cout << "timestamp [ms], object, instance, then field=value,value,... separated by tabs." << endl;
+    cout << "Options: " << endl;
+    cout << "\t--object name    only decode this object, can be repeated" << endl;
+    cout << "\t--from ms        skip updates logged before ms" << endl;
+    cout << "\t--to ms          skip updates logged after ms" << endl;
+    cout << "\t--threads n      decode with n threads, default one per core" << endl;
+    cout << "\t--output file    write to file instead of the standard output" << endl;
+    cout << "\t--columns file   write a columnar .opc file instead of text" << endl;
+    cout << "\t--bench          unpack without writing anything and report the throughput" << endl;
+    cout << "\t-h, --help       this help" << endl;
+}
+
+/**
+ * inform user of invalid usage
+ */
+int usage_err()
+{
+    cout << "Invalid usage!" << endl;
+    usage();
+    return RETURN_ERR_USAGE;
+}
+
+namespace {
+/**
+ * The decoded chunks, in log order. Decoders run at most CHUNKS_AHEAD
+ * chunks per thread ahead of the writer.
+ */
+typedef struct {
+    const UAVObjectLogFile *log;
+    const QVector<int> *selected; // updates to decode, into the log records
+    int numChunks;
+    int aheadLimit;
+    bool text;
+
+    QAtomicInt nextChunk;
+    QAtomicInt numDecoded;
+    QAtomicInt numSkipped;
+
+    QMutex mutex;
+    QWaitCondition decoded;
+    QWaitCondition written;
+    QVector<QByteArray> output;
+    QVector<bool> done;
+    int numWritten;
+} Chunks;
+
+/**
+ * Decodes chunks into its own object instances, so the threads never share an object
+ */
+class Decoder : public QThread {
+public:
+    Decoder(Chunks *chunks) : m_chunks(chunks)
+    {}
+
+protected:
+    void run()
+    {
+        // The objects live until the tool exits
+        UAVObjectManager *objMngr = new UAVObjectManager();
+
+        UAVObjectsInitialize(objMngr);
+        QHash<quint64, UAVObject *> objects;
+
+        const QVector<UAVObjectLogFile::Record> &records = m_chunks->log->records();
+        const QVector<int> &selected = *m_chunks->selected;
+        for (;;) {
+            int chunk = m_chunks->nextChunk.fetchAndAddRelaxed(1);
+            if (chunk >= m_chunks->numChunks) {
+                break;
+            }
+            m_chunks->mutex.lock();
+            while (chunk >= m_chunks->numWritten + m_chunks->aheadLimit) {
+                m_chunks->written.wait(&m_chunks->mutex);
+            }
+            m_chunks->mutex.unlock();
+
+            QByteArray out;
+            int numDecoded = 0;
+            int numSkipped = 0;
+            const int end  = qMin(selected.size(), (chunk + 1) * CHUNK_SIZE);
+            for (int i = chunk * CHUNK_SIZE; i < end; ++i) {
+                const UAVObjectLogFile::Record &record = records[selected[i]];
+                UAVObject *obj = object(objMngr, objects, record.objId, record.instId);
+                if (!obj || record.length != obj->getNumBytes()) {
+                    numSkipped++;
+                    continue;
+                }
+                obj->unpack(m_chunks->log->recordData(record));
+                numDecoded++;
+                if (m_chunks->text) {
+                    format(out, record, obj);
+                }
+            }
+            m_chunks->numDecoded.fetchAndAddRelaxed(numDecoded);
+            m_chunks->numSkipped.fetchAndAddRelaxed(numSkipped);
+
+            m_chunks->mutex.lock();
+            m_chunks->output[chunk] = out;
+            m_chunks->done[chunk]   = true;
+            m_chunks->decoded.wakeAll();
+            m_chunks->mutex.unlock();
+        }
+    }
+
+private:
+    /**
+     * Get an object instance, instances that are not known yet are created
+     * like UAVTalk does when it receives them
+     */
+    UAVObject *object(UAVObjectManager *objMngr, QHash<quint64, UAVObject *> &objects, quint32 objId, quint16 instId)
+    {
+        const quint64 key = ((quint64)objId << 16) | instId;
+        UAVObject *obj    = objects.value(key);
+
+        if (obj) {
+            return obj;
+        }
+        obj = objMngr->getObject(objId, instId);
+        if (!obj) {
+            UAVDataObject *dataObj = dynamic_cast<UAVDataObject *>(objMngr->getObject(objId));
+            if (!dataObj) {
+                return NULL;
+            }
+            UAVDataObject *instObj = dataObj->clone(instId);
+            if (!objMngr->registerObject(instObj)) {
+                delete instObj;
+                return NULL;
+            }
+            obj = instObj;
+        }
+        objects.insert(key, obj);
+        return obj;
+    }
+
+    void format(QByteArray &out, const UAVObjectLogFile::Record &record, UAVObject *obj)
+    {
+        out += QByteArray::number(record.timestamp);
+        out += '\t';
+        out += obj->getName().toUtf8();
+        out += '\t';
+        out += QByteArray::number(record.instId);
+        foreach(UAVObjectField * field, obj->getFields()) {
+            out += '\t';
+            out += field->getName().toUtf8();
+            out += '=';
+            // a string is a single value
+            const quint32 numValues = field->getType() == UAVObjectField::STRING ? 1 : field->getNumElements();
+            for (quint32 n = 0; n < numValues; ++n) {
+                if (n > 0) {
+                    out += ',';
+                }
+                out += field->getValue(n).toString().toUtf8();
+            }
+        }
+        out += '\n';
+    }
+
+    Chunks *m_chunks;
+};
+
+double rate(double amount, qint64 ms)
+{
+    return ms > 0 ? amount * 1000.0 / ms : 0.0;
+}
+}
+
+/**
+ * entrance
+ */
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    QStringList arguments = a.arguments();
+
+    arguments.removeFirst();
+
+    if (arguments.removeAll("-h") > 0 || arguments.removeAll("--help") > 0) {
+        usage();
+        return RETURN_OK;
+    }
+
+    QString logFileName;
+    QString outputFileName;
+    QString columnsFileName;
+    QStringList objectNames;
+    quint32 from = 0;
+    quint32 to   = 0xFFFFFFFF;
+    int numThreads = QThread::idealThreadCount();
+    bool bench     = false;
+
+    // process arguments
+    for (int argi = 0; argi < arguments.length(); argi++) {
+        const QString arg = arguments.at(argi);
+        if (arg == "--bench") {
+            bench = true;
+            continue;
+        }
+        if (!arg.startsWith("--")) {
+            if (!logFileName.isEmpty()) {
+                return usage_err();
+            }
+            logFileName = arg;
+            continue;
+        }
+        // everything else takes a value
+        if (argi + 1 >= arguments.length()) {
+            return usage_err();
+        }
+        const QString value = arguments.at(++argi);
+        bool ok = true;
+        if (arg == "--object") {
+            objectNames << value;
+        } else if (arg == "--from") {
+            from = value.toUInt(&ok);
+        } else if (arg == "--to") {
+            to = value.toUInt(&ok);
+        } else if (arg == "--threads") {
+            numThreads = value.toInt(&ok);
+            ok = ok && numThreads > 0;
+        } else if (arg == "--output") {
+            outputFileName = value;
+        } else if (arg == "--columns") {
+            columnsFileName = value;
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            return usage_err();
+        }
+    }
+    if (logFileName.isEmpty()) {
+        return usage_err();
+    }
+
+    // Object definitions for the filter and the columnar export
+    UAVObjectManager objMngr;
+    UAVObjectsInitialize(&objMngr);
+    QSet<quint32> objIds;
+    foreach(QString name, objectNames) {
+        UAVObject *obj = objMngr.getObject(name);
+        if (!obj) {
+            cerr << "Unknown object " << name.toStdString() << endl;
+            return RETURN_ERR_USAGE;
+        }
+        objIds.insert(obj->getObjID());
+    }
+
+    if (!columnsFileName.isEmpty()) {
+        UAVObjectColumnExporter exporter(&objMngr);
+        exporter.setObjectFilter(objectNames);
+        exporter.setMaxThreadCount(numThreads);
+        if (!exporter.exportLog(logFileName, columnsFileName)) {
+            cerr << "Export failed: " << exporter.errorString().toStdString() << endl;
+            return RETURN_ERR_LOG;
+        }
+        cerr << "Exported " << exporter.numRows() << " updates, skipped " << exporter.numSkipped() << endl;
+        return RETURN_OK;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    UAVObjectLogFile log;
+    if (!log.open(logFileName)) {
+        cerr << "Can not read " << logFileName.toStdString() << ": " << log.errorString().toStdString() << endl;
+        return RETURN_ERR_LOG;
+    }
+    if (!log.errorString().isEmpty()) {
+        cerr << "Log ends early: " << log.errorString().toStdString() << endl;
+    }
+    const qint64 indexTime = timer.elapsed();
+
+    const QVector<UAVObjectLogFile::Record> &records = log.records();
+    QVector<int> selected;
+    selected.reserve(records.size());
+    for (int i = 0; i < records.size(); ++i) {
+        const UAVObjectLogFile::Record &record = records[i];
+        if (record.timestamp >= from && record.timestamp <= to
+            && (objIds.isEmpty() || objIds.contains(record.objId))) {
+            selected.append(i);
+        }
+    }
+
+    QFile output;
+    if (!bench) {
+        bool opened;
+        if (outputFileName.isEmpty()) {
+            opened = output.open(stdout, QIODevice::WriteOnly);
+        } else {
+            output.setFileName(outputFileName);
+            opened = output.open(QIODevice::WriteOnly | QIODevice::Truncate);
+        }
+        if (!opened) {
+            cerr << "Can not write " << outputFileName.toStdString() << ": " << output.errorString().toStdString() << endl;
+            return RETURN_ERR_LOG;
+        }
+    }
+
+    Chunks chunks;
+    chunks.log        = &log;
+    chunks.selected   = &selected;
+    chunks.numChunks  = (selected.size() + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    chunks.aheadLimit = numThreads * CHUNKS_AHEAD;
+    chunks.text       = !bench;
+    chunks.output.resize(chunks.numChunks);
+    chunks.done.fill(false, chunks.numChunks);
+    chunks.numWritten = 0;
+
+    timer.restart();
+    QList<Decoder *> decoders;
+    for (int n = 0; n < numThreads; ++n) {
+        decoders << new Decoder(&chunks);
+        decoders.last()->start();
+    }
+
+    // Write the chunks in log order as they become available
+    for (int chunk = 0; chunk < chunks.numChunks; ++chunk) {
+        chunks.mutex.lock();
+        while (!chunks.done[chunk]) {
+            chunks.decoded.wait(&chunks.mutex);
+        }
+        QByteArray out = chunks.output[chunk];
+        chunks.output[chunk].clear();
+        chunks.numWritten = chunk + 1;
+        chunks.written.wakeAll();
+        chunks.mutex.unlock();
+
+        if (!bench) {
+            output.write(out);
+        }
+    }
+    foreach(Decoder * decoder, decoders) {
+        decoder->wait();
+    }
+    qDeleteAll(decoders);
+    output.close();
+    const qint64 decodeTime = timer.elapsed();
+
+    const int numDecoded = chunks.numDecoded.load();
+    const int numSkipped = chunks.numSkipped.load() + log.numInvalid();
+    if (bench) {
+        const double megabytes = log.size() / (1024.0 * 1024.0);
+        cout << "log        " << log.size() << " bytes, " << records.size() << " updates" << endl;
+        cout << "index      " << indexTime << " ms, " << rate(megabytes, indexTime) << " MB/s, "
+             << rate(records.size(), indexTime) << " objects/s" << endl;
+        cout << "unpack     " << decodeTime << " ms with " << numThreads << " threads, "
+             << rate(megabytes, decodeTime) << " MB/s, " << rate(numDecoded, decodeTime) << " objects/s" << endl;
+    }
+    cerr << "Decoded " << numDecoded << " updates, skipped " << numSkipped << endl;
+
+    return RETURN_OK;
+}
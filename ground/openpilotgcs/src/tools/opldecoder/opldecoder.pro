@@ -0,0 +1,26 @@
+#
+# Qmake project for the headless .opl log decoder.
+# Copyright (c) 2014, The OpenPilot Team, http://www.openpilot.org
+#
+
+include(../../../openpilotgcs.pri)
+
+QT -= gui
+TARGET = opldecoder
+CONFIG += console
+CONFIG -= app_bundle
+TEMPLATE = app
+DESTDIR = $$GCS_APP_PATH
+
+SOURCES += main.cpp
+
+# The UAVObjects plugin library is linked like any other library, without the plugin manager
+LIBS += -L$$GCS_PLUGIN_PATH/OpenPilot
+include(../../plugins/uavobjects/uavobjects.pri)
+
+linux-* {
+    QMAKE_RPATHDIR = \'\$$ORIGIN\'/$$relative_path($$GCS_LIBRARY_PATH, $$GCS_APP_PATH)
+    QMAKE_RPATHDIR += \'\$$ORIGIN\'/$$relative_path($$GCS_PLUGIN_PATH/OpenPilot, $$GCS_APP_PATH)
+    QMAKE_RPATHDIR += \'\$$ORIGIN\'/$$relative_path($$GCS_QT_LIBRARY_PATH, $$GCS_APP_PATH)
+    include(../../rpath.pri)
+}
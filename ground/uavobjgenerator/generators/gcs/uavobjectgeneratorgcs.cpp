@@ -188,8 +188,9 @@ bool UAVObjectGeneratorGCS::process_object(ObjectInfo *info)
                     QString("    void %1_%2Changed(%3 value);\n")
                     .arg(field->name).arg(elementName).arg(type);
                 propertyNotificationsImpl +=
-                    QString("        //if (data.%1[%2] != oldData.%1[%2])\n"
-                            "            emit %1_%3Changed(data.%1[%2]);\n")
+                    QString("    if (notifiedData.%1[%2] != oldData.%1[%2]) {\n"
+                            "        emit %1_%3Changed(notifiedData.%1[%2]);\n"
+                            "    }\n")
                     .arg(field->name).arg(elementIndex).arg(elementName);
             }
         } else {
@@ -222,8 +223,9 @@ bool UAVObjectGeneratorGCS::process_object(ObjectInfo *info)
                 QString("    void %1Changed(%2 value);\n")
                 .arg(field->name).arg(type);
             propertyNotificationsImpl +=
-                QString("        //if (data.%1 != oldData.%1)\n"
-                        "            emit %1Changed(data.%1);\n")
+                QString("    if (notifiedData.%1 != oldData.%1) {\n"
+                        "        emit %1Changed(notifiedData.%1);\n"
+                        "    }\n")
                 .arg(field->name);
         }
     }
@@ -234,6 +236,14 @@ bool UAVObjectGeneratorGCS::process_object(ObjectInfo *info)
     outInclude.replace(QString("$(PROPERTY_NOTIFICATIONS)"), propertyNotifications);
 
     outCode.replace(QString("$(PROPERTIES_IMPL)"), propertiesImpl);
+    // Diff against the data of the last notification, the update that got us
+    // here may be one of several merged ones or may not have changed anything
+    if (!propertyNotificationsImpl.isEmpty()) {
+        propertyNotificationsImpl.prepend("    mutex->lock();\n"
+                                          "    const DataFields oldData = notifiedData;\n"
+                                          "    notifiedData = data;\n"
+                                          "    mutex->unlock();\n\n");
+    }
     outCode.replace(QString("$(NOTIFY_PROPERTIES_CHANGED)"), propertyNotificationsImpl);
 
     // Replace the $(FIELDSINIT) tag
@@ -259,7 +269,7 @@ bool UAVObjectGeneratorGCS::process_object(ObjectInfo *info)
                              .arg(varOptionName)
                              .arg(options[m]));
             }
-            finit.append(QString("    fields.append( new UAVObjectField(QString(\"%1\"), tr(\"%2\"), QString(\"%3\"), UAVObjectField::ENUM, %4, %5, QString(\"%6\")));\n")
+            finit.append(QString("    fieldInfo.append(UAVObjectFieldInfoPtr(new UAVObjectFieldInfo(QString(\"%1\"), " + info->name + "::tr(\"%2\"), QString(\"%3\"), UAVObjectField::ENUM, %4, %5, QString(\"%6\"))));\n")
                          .arg(info->fields[n]->name)
                          .arg(info->fields[n]->description)
                          .arg(info->fields[n]->units)
@@ -269,7 +279,7 @@ bool UAVObjectGeneratorGCS::process_object(ObjectInfo *info)
         }
         // For all other types
         else {
-            finit.append(QString("    fields.append( new UAVObjectField(QString(\"%1\"), tr(\"%2\"), QString(\"%3\"), UAVObjectField::%4, %5, QStringList(), QString(\"%6\")));\n")
+            finit.append(QString("    fieldInfo.append(UAVObjectFieldInfoPtr(new UAVObjectFieldInfo(QString(\"%1\"), " + info->name + "::tr(\"%2\"), QString(\"%3\"), UAVObjectField::%4, %5, QStringList(), QString(\"%6\"))));\n")
                          .arg(info->fields[n]->name)
                          .arg(info->fields[n]->description)
                          .arg(info->fields[n]->units)
@@ -92,7 +92,6 @@ SRC += $(PIOSCOMMON)/pios_sensors.c
 ## Misc library functions
 SRC += $(FLIGHTLIB)/sanitycheck.c
 SRC += $(FLIGHTLIB)/CoordinateConversions.c
-SRC += $(MATHLIB)/sin_lookup.c
 
 ## PID library functions
 SRC += $(MATHLIB)/pid.c
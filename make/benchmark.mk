@@ -0,0 +1,54 @@
+###############################################################################
+# @file       benchmark.mk
+# @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2014
+# @addtogroup 
+# @{
+# @addtogroup 
+# @{
+# @brief Makefile template for benchmarks
+###############################################################################
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+# or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+# for more details.
+#
+# You should have received a copy of the GNU General Public License along
+# with this program; if not, write to the Free Software Foundation, Inc.,
+# 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+#
+
+# Use native toolchain and disable THUMB mode for benchmarks
+override ARM_SDK_PREFIX :=
+override THUMB :=
+
+# Benchmark source files
+ALLSRC     := $(SRC) $(wildcard ./*.c)
+ALLSRCBASE := $(notdir $(basename $(ALLSRC)))
+ALLOBJ     := $(addprefix $(OUTDIR)/, $(addsuffix .o, $(ALLSRCBASE)))
+
+$(foreach src,$(ALLSRC),$(eval $(call COMPILE_C_TEMPLATE,$(src))))
+$(eval $(call LINK_TEMPLATE,$(OUTDIR)/$(TARGET).elf,$(ALLOBJ)))
+
+# Flags passed to the C compiler
+CONLYFLAGS += -std=gnu99
+
+# Timings only mean something with the optimisation the firmware is built with
+CFLAGS += -O2 -g
+CFLAGS += -Wall -Werror
+CFLAGS += $(patsubst %,-I%,$(EXTRAINCDIRS))
+
+LDFLAGS += -lm
+
+.PHONY: elf
+elf: $(OUTDIR)/$(TARGET).elf
+
+.PHONY: run
+run: $(OUTDIR)/$(TARGET).elf
+	$(V0) @echo " BENCH RUN $(MSG_EXTRA)  $(call toprel, $<)"
+	$(V1) $<